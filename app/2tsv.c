@@ -13,6 +13,8 @@
 #include "zsv_command.h"
 
 #include <zsv/utils/utf8.h>
+#include <zsv/utils/file.h>
+#include <zsv/utils/pool.h>
 
 enum zsv_2tsv_status {
   zsv_2tsv_status_ok = 0,
@@ -30,6 +32,8 @@ struct static_buff {
 struct zsv_2tsv_data {
   zsv_parser parser;
   struct static_buff out;
+  unsigned char skip_header : 1;
+  unsigned char _ : 7;
 };
 
 __attribute__((always_inline)) static inline void zsv_2tsv_flush(struct static_buff *b) {
@@ -109,6 +113,10 @@ __attribute__((always_inline)) static inline void zsv_2tsv_cell(struct zsv_2tsv_
 
 static void zsv_2tsv_row(void *ctx) {
   struct zsv_2tsv_data *data = ctx;
+  if (VERY_UNLIKELY(data->skip_header)) {
+    data->skip_header = 0;
+    return;
+  }
   unsigned int cols = zsv_cell_count(data->parser);
   if (cols) {
     struct zsv_cell cell = zsv_get_cell(data->parser, 0);
@@ -129,14 +137,71 @@ static void zsv_2tsv_row(void *ctx) {
   zsv_2tsv_write(&data->out, (const unsigned char *)"\n", 1);
 }
 
+struct zsv_2tsv_input {
+  const char *path; // NULL for stdin
+  struct zsv_opts opts;
+  struct zsv_prop_handler *custom_prop_handler;
+  const char *opts_used;
+  FILE *out;     // final output
+  FILE *tmp_out; // if running in parallel, where output is held until its turn
+  unsigned char skip_header;
+  int err;
+};
+
+static void zsv_2tsv_input_run(void *arg) {
+  struct zsv_2tsv_input *input = arg;
+  struct zsv_opts *opts = &input->opts;
+  struct zsv_2tsv_data data = {0};
+  data.skip_header = input->skip_header;
+  data.out.stream = input->tmp_out ? input->tmp_out : input->out;
+  if (input->path && !(opts->stream = fopen(input->path, "rb"))) {
+    fprintf(stderr, "Unable to open for reading: %s\n", input->path);
+    input->err = 1;
+    return;
+  }
+
+  opts->row_handler = zsv_2tsv_row;
+  opts->ctx = &data;
+  if (zsv_new_with_properties(opts, input->custom_prop_handler, input->path, input->opts_used, &data.parser) ==
+      zsv_status_ok) {
+    char output[ZSV_2TSV_BUFF_SIZE];
+    data.out.buff = output;
+
+    enum zsv_status status;
+    while (!zsv_signal_interrupted && (status = zsv_parse_more(data.parser)) == zsv_status_ok)
+      ;
+    zsv_finish(data.parser);
+    zsv_delete(data.parser);
+    zsv_2tsv_flush(&data.out);
+  }
+  if (input->path)
+    fclose(opts->stream);
+}
+
+static void zsv_2tsv_input_complete(void *arg) {
+  struct zsv_2tsv_input *input = arg;
+  if (input->tmp_out) {
+    rewind(input->tmp_out);
+    if (!input->err && zsv_copy_file_ptr(input->tmp_out, input->out))
+      perror("2tsv");
+    fclose(input->tmp_out);
+    input->tmp_out = NULL;
+  }
+}
+
 int zsv_2tsv_usage(int rc) {
   static const char *zsv_2tsv_usage_msg[] = {
     APPNAME ": convert CSV to TSV (tab-delimited text) suitable for simple-delimiter",
     "          text processing. By default, embedded tabs or multilines will be escaped",
     "          to \\t, \\n or \\r, respectively",
     "",
-    "Usage: " APPNAME " [filename] [-o <output_filename>]",
+    "Usage: " APPNAME " [filename ...] [-o <output_filename>] [--threads <n>]",
     "  e.g. " APPNAME " < file.csv > file.tsv",
+    "",
+    "Multiple inputs are converted into a single output. Each input is assumed to",
+    "have its own header row, and only the first input's header row is output.",
+    "--threads converts multiple inputs in parallel using n threads (0 = one per",
+    "processor; default: 1)",
     NULL,
   };
 
@@ -148,65 +213,77 @@ int zsv_2tsv_usage(int rc) {
 
 int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *opts,
                                struct zsv_prop_handler *custom_prop_handler, const char *opts_used) {
-  struct zsv_2tsv_data data = {0};
-  const char *input_path = NULL;
-  int err = 0;
+  struct zsv_2tsv_input *inputs = calloc(argc > 1 ? argc : 1, sizeof(*inputs));
+  size_t input_count = 0;
+  unsigned int thread_count = 1;
+  FILE *out = NULL;
+  int err = !inputs;
   for (int i = 1; !err && i < argc; i++) {
     if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+      free(inputs);
       return zsv_2tsv_usage(0);
     } else if (!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output")) {
       if (++i >= argc)
         fprintf(stderr, "%s option requires a filename value\n", argv[i - 1]), err = 1;
-      else if (data.out.stream && data.out.stream != stdout)
+      else if (out && out != stdout)
         fprintf(stderr, "Output file specified more than once\n"), err = 1;
-      else if (!(data.out.stream = fopen(argv[i], "wb")))
+      else if (!(out = fopen(argv[i], "wb")))
         fprintf(stderr, "Unable to open for writing: %s\n", argv[i]), err = 1;
-    } else {
-      if (opts->stream)
-        fprintf(stderr, "Input file specified more than once\n"), err = 1;
-      else if (!(opts->stream = fopen(argv[i], "rb")))
-        fprintf(stderr, "Unable to open for reading: %s\n", argv[i]), err = 1;
-      else
-        input_path = argv[i];
-    }
+    } else if (!strcmp(argv[i], "--threads")) {
+      if (++i >= argc || zsv_pool_threads_arg(argv[i], &thread_count))
+        fprintf(stderr, "%s option requires a number of threads (0 for one per processor)\n", argv[i - 1]), err = 1;
+    } else
+      inputs[input_count++].path = argv[i];
   }
 
   if (err) {
     goto exit_2tsv;
   }
 
-  if (!opts->stream) {
+  if (!input_count) {
 #ifdef NO_STDIN
     fprintf(stderr, "Please specify an input file\n");
     err = 1;
     goto exit_2tsv;
 #else
-    opts->stream = stdin;
+    input_count = 1; // stdin
 #endif
   }
 
-  if (!data.out.stream)
-    data.out.stream = stdout;
+  if (!out)
+    out = stdout;
 
-  opts->row_handler = zsv_2tsv_row;
-  opts->ctx = &data;
-  if (zsv_new_with_properties(opts, custom_prop_handler, input_path, opts_used, &data.parser) == zsv_status_ok) {
-    char output[ZSV_2TSV_BUFF_SIZE];
-    data.out.buff = output;
+  zsv_pool pool = NULL;
+  if (input_count > 1 && thread_count != 1 && !(pool = zsv_pool_new(thread_count)))
+    fprintf(stderr, "Unable to start threads; continuing without\n");
+  zsv_pool_group group = zsv_pool_group_new(pool, 0);
+  if (!group)
+    err = 1;
 
-    zsv_handle_ctrl_c_signal();
-    enum zsv_status status;
-    while (!zsv_signal_interrupted && (status = zsv_parse_more(data.parser)) == zsv_status_ok)
-      ;
-    zsv_finish(data.parser);
-    zsv_delete(data.parser);
-    zsv_2tsv_flush(&data.out);
+  zsv_handle_ctrl_c_signal();
+  for (size_t i = 0; !err && !zsv_signal_interrupted && i < input_count; i++) {
+    struct zsv_2tsv_input *input = &inputs[i];
+    input->opts = *opts;
+    input->custom_prop_handler = custom_prop_handler;
+    input->opts_used = opts_used;
+    input->out = out;
+    input->skip_header = i > 0;
+    if (pool && !(input->tmp_out = tmpfile())) {
+      perror("2tsv: unable to create temporary file");
+      err = 1;
+    } else
+      err = zsv_pool_submit(group, zsv_2tsv_input_run, zsv_2tsv_input_complete, input);
   }
+  zsv_pool_group_delete(group);
+  zsv_pool_delete(pool);
+  for (size_t i = 0; i < input_count; i++)
+    err = err || inputs[i].err;
 
 exit_2tsv:
   if (opts->stream && opts->stream != stdin)
     fclose(opts->stream);
-  if (data.out.stream && data.out.stream != stdout)
-    fclose(data.out.stream);
+  if (out && out != stdout)
+    fclose(out);
+  free(inputs);
   return err;
 }
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+/*
+ * Compare number formatting by zsv_u64toa(), zsv_dtoa() and zsv_ldtoa_fixed() with snprintf()
+ * Usage: num [count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <zsv/utils/num.h>
+
+static double elapsed(struct timespec *start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (double)(end.tv_sec - start->tv_sec) + (double)(end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static uint64_t next_random(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *state = x;
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? strtoul(argv[1], NULL, 10) : 5000000;
+  uint64_t *ints = malloc(count * sizeof(*ints));
+  double *dbls = malloc(count * sizeof(*dbls));
+  if (!ints || !dbls || !count) {
+    fprintf(stderr, "Out of memory!\n");
+    return 1;
+  }
+
+  uint64_t state = 88172645463325252ULL;
+  for (size_t i = 0; i < count; i++) {
+    ints[i] = next_random(&state) >> (next_random(&state) % 64);
+    // mix of prices, coordinates and arbitrary values
+    switch (i % 3) {
+    case 0:
+      dbls[i] = (double)(next_random(&state) % 1000000) / 100;
+      break;
+    case 1:
+      dbls[i] = (double)(int64_t)(next_random(&state) % 360000000) / 1e6 - 180;
+      break;
+    default:
+      dbls[i] = (double)(next_random(&state) >> 11) / (double)(1 + next_random(&state) % 100000);
+    }
+  }
+
+  char buff[64];
+  size_t total = 0; // keep the compiler from dropping the loops
+  struct timespec start;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < count; i++)
+    total += (size_t)snprintf(buff, sizeof(buff), "%" PRIu64, ints[i]);
+  printf("integer, snprintf            : %.3f\n", elapsed(&start));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < count; i++)
+    total += zsv_u64toa(ints[i], buff);
+  printf("integer, zsv_u64toa          : %.3f\n", elapsed(&start));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < count; i++)
+    total += (size_t)snprintf(buff, sizeof(buff), "%.17g", dbls[i]);
+  printf("double, snprintf %%.17g       : %.3f\n", elapsed(&start));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < count; i++)
+    total += zsv_dtoa(dbls[i], buff);
+  printf("double, zsv_dtoa (shortest)  : %.3f\n", elapsed(&start));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < count; i++)
+    total += (size_t)snprintf(buff, sizeof(buff), "%.2Lf", (long double)dbls[i]);
+  printf("long double, snprintf %%.2Lf  : %.3f\n", elapsed(&start));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < count; i++)
+    total += zsv_ldtoa_fixed((long double)dbls[i], 2, buff);
+  printf("long double, zsv_ldtoa_fixed : %.3f\n", elapsed(&start));
+
+  fprintf(stderr, "(%zu values, %zu bytes)\n", count, total);
+  free(ints);
+  free(dbls);
+  return 0;
+}
@@ -50,6 +50,8 @@ static int main_help(int argc, const char *argv[]) {
     "  -S,--keep-blank-headers  : disable default behavior of ignoring leading blank rows",
     "  -0,--header-row <header> : insert the provided CSV as the first row (in position 0)",
     "                             e.g. --header-row 'col1,col2,\"my col 3\"'",
+    "  -E,--encoding <enc>      : input encoding: auto, utf8, utf16le, utf16be or latin1 (Windows-1252).",
+    "                             defaults to auto, which is utf8 unless the input starts with a UTF-16 BOM",
     "  -v,--verbose             : verbose output",
     "",
     "Commands that parse CSV or other tabular data:",
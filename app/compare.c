@@ -15,7 +15,6 @@
 #include <jsonwriter.h>
 
 #include <sqlite3.h>
-extern sqlite3_module CsvModule;
 
 #include <zsv/utils/string.h>
 #include <zsv/utils/writer.h>
@@ -445,11 +444,16 @@ static void zsv_compare_set_sorted_callbacks(struct zsv_compare_data *data) {
   data->input_init = input_init_sorted;
 }
 
-static enum zsv_compare_status zsv_compare_init_sorted(struct zsv_compare_data *data) {
+static enum zsv_compare_status zsv_compare_init_sorted(struct zsv_compare_data *data, struct zsv_opts *opts,
+                                                       struct zsv_prop_handler *custom_prop_handler) {
   int rc;
   const char *db_url = data->sort_in_memory ? "file::memory:" : "";
+  data->sort_module_opts.parser_opts = *opts;
+  if (custom_prop_handler)
+    data->sort_module_opts.custom_prop_handler = *custom_prop_handler;
   if ((rc = sqlite3_open_v2(db_url, &data->sort_db, SQLITE_OPEN_URI | SQLITE_OPEN_READWRITE, NULL)) == SQLITE_OK &&
-      data->sort_db && (rc = sqlite3_create_module(data->sort_db, "csv", &CsvModule, 0) == SQLITE_OK)) {
+      data->sort_db &&
+      (rc = sqlite3_create_module(data->sort_db, "csv", &CsvModule, &data->sort_module_opts) == SQLITE_OK)) {
     zsv_compare_set_sorted_callbacks(data);
     return zsv_compare_status_ok;
   }
@@ -716,24 +720,12 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       input_filenames[input_count++] = arg;
   }
 
-  struct zsv_opts original_default_opts;
-  struct zsv_prop_handler original_default_custom_prop_handler;
   if (data->sort) {
     if (!data->key_count) {
       fprintf(stderr, "Error: --sort requires one or more keys\n");
       data->status = zsv_compare_status_error;
-    } else {
-      original_default_opts = zsv_get_default_opts();
-      zsv_set_default_opts(*opts);
-
-      if (custom_prop_handler) {
-        original_default_custom_prop_handler = zsv_get_default_custom_prop_handler();
-        zsv_set_default_custom_prop_handler(*custom_prop_handler);
-      }
-
-      if (data->status == zsv_compare_status_ok)
-        data->status = zsv_compare_init_sorted(data);
-    }
+    } else if (data->status == zsv_compare_status_ok)
+      data->status = zsv_compare_init_sorted(data, opts, custom_prop_handler);
   }
 
   if (err && data->status == zsv_compare_status_ok)
@@ -895,12 +887,6 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
 
   err = data->status == zsv_compare_status_ok ? 0 : 1;
 
-  if (data->sort) {
-    zsv_set_default_opts(original_default_opts); // restore default options
-    if (custom_prop_handler)
-      zsv_set_default_custom_prop_handler(original_default_custom_prop_handler);
-  }
-
   if (data->return_count) {
     if (err)
       err = -1;
@@ -3,6 +3,7 @@
 
 #include <sglib.h>
 #include <sqlite3.h>
+#include "sqlite3_csv_vtab-zsv.h"
 
 typedef struct zsv_compare_unique_colname {
   struct zsv_compare_unique_colname *next; // retain order via linked list
@@ -104,6 +105,7 @@ struct zsv_compare_data {
                                         const char *opts_used);
 
   sqlite3 *sort_db; // used when --sort option was specified
+  struct sqlite3_zsv_module_opts sort_module_opts;
 
   struct {
     double value;
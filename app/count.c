@@ -13,6 +13,8 @@
 #define ZSV_COMMAND count
 #include "zsv_command.h"
 
+#include <zsv/utils/pool.h>
+
 struct data {
   zsv_parser parser;
   size_t rows;
@@ -22,73 +24,118 @@ static void row(void *ctx) {
   ((struct data *)ctx)->rows++;
 }
 
+struct zsv_count_input {
+  const char *path; // NULL for stdin
+  struct zsv_opts opts;
+  struct zsv_prop_handler *custom_prop_handler;
+  const char *opts_used;
+  size_t rows;
+  int err;
+};
+
+static void zsv_count_input_run(void *arg) {
+  struct zsv_count_input *input = arg;
+  struct data data = {0};
+  struct zsv_opts *opts = &input->opts;
+  if (input->path && !(opts->stream = fopen(input->path, "rb"))) {
+    fprintf(stderr, "Unable to open for reading: %s\n", input->path);
+    input->err = 1;
+    return;
+  }
+
+  opts->row_handler = row;
+  opts->ctx = &data;
+  if (zsv_new_with_properties(opts, input->custom_prop_handler, input->path, input->opts_used, &data.parser) !=
+      zsv_status_ok) {
+    fprintf(stderr, "Unable to initialize parser\n");
+    input->err = 1;
+  } else {
+    enum zsv_status status;
+    while ((status = zsv_parse_more(data.parser)) == zsv_status_ok)
+      ;
+    zsv_finish(data.parser);
+    zsv_delete(data.parser);
+    input->rows = data.rows > 0 ? data.rows - 1 : 0;
+  }
+  if (input->path)
+    fclose(opts->stream);
+}
+
 static int count_usage() {
-  static const char *usage = "Usage: count [options]\n"
-                             "\n"
-                             "Options:\n"
-                             "  -h,--help             : show usage\n"
-                             "  -i,--input <filename> : use specified file input\n";
+  static const char *usage =
+    "Usage: count [options]\n"
+    "\n"
+    "Options:\n"
+    "  -h,--help             : show usage\n"
+    "  -i,--input <filename> : use specified file input. If more than one is given, the total count is output\n"
+    "  --threads <n>         : count multiple inputs in parallel using n threads (0 = one per processor)\n";
   printf("%s\n", usage);
   return 0;
 }
 
 int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *opts,
                                struct zsv_prop_handler *custom_prop_handler, const char *opts_used) {
-  struct data data = {0};
-  const char *input_path = NULL;
-  int err = 0;
+  struct zsv_count_input *inputs = calloc(argc > 1 ? argc : 1, sizeof(*inputs));
+  size_t input_count = 0;
+  unsigned int thread_count = 1;
+  int err = !inputs;
   for (int i = 1; !err && i < argc; i++) {
     const char *arg = argv[i];
     if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
       count_usage();
       goto count_done;
     }
-    if (!strcmp(arg, "-i") || !strcmp(arg, "--input") || *arg != '-') {
-      err = 1;
+    if (!strcmp(arg, "--threads")) {
+      if (++i >= argc || zsv_pool_threads_arg(argv[i], &thread_count))
+        err = fprintf(stderr, "%s option requires a number of threads (0 for one per processor)\n", arg);
+    } else if (!strcmp(arg, "-i") || !strcmp(arg, "--input") || *arg != '-') {
       if ((!strcmp(arg, "-i") || !strcmp(arg, "--input")) && ++i >= argc)
-        fprintf(stderr, "%s option requires a filename\n", arg);
-      else {
-        if (opts->stream)
-          fprintf(stderr, "Input may not be specified more than once\n");
-        else if (!(opts->stream = fopen(argv[i], "rb")))
-          fprintf(stderr, "Unable to open for reading: %s\n", argv[i]);
-        else {
-          input_path = argv[i];
-          err = 0;
-        }
-      }
+        err = fprintf(stderr, "%s option requires a filename\n", arg);
+      else
+        inputs[input_count++].path = argv[i];
     } else {
       fprintf(stderr, "Unrecognized option: %s\n", arg);
       err = 1;
     }
   }
 
+  if (!err && !input_count) {
 #ifdef NO_STDIN
-  if (!opts->stream || opts->stream == stdin) {
     fprintf(stderr, "Please specify an input file\n");
     err = 1;
-  }
+#else
+    input_count = 1; // stdin
 #endif
+  }
 
   if (!err) {
-    opts->row_handler = row;
-    opts->ctx = &data;
-    if (zsv_new_with_properties(opts, custom_prop_handler, input_path, opts_used, &data.parser) != zsv_status_ok) {
-      fprintf(stderr, "Unable to initialize parser\n");
+    zsv_pool pool = NULL;
+    if (input_count > 1 && thread_count != 1 && !(pool = zsv_pool_new(thread_count)))
+      fprintf(stderr, "Unable to start threads; continuing without\n");
+    zsv_pool_group group = zsv_pool_group_new(pool, 0);
+    if (!group)
       err = 1;
-    } else {
-      enum zsv_status status;
-      while ((status = zsv_parse_more(data.parser)) == zsv_status_ok)
-        ;
-      zsv_finish(data.parser);
-      zsv_delete(data.parser);
-      printf("%zu\n", data.rows > 0 ? data.rows - 1 : 0);
+    for (size_t i = 0; !err && i < input_count; i++) {
+      inputs[i].opts = *opts;
+      inputs[i].custom_prop_handler = custom_prop_handler;
+      inputs[i].opts_used = opts_used;
+      err = zsv_pool_submit(group, zsv_count_input_run, NULL, &inputs[i]);
+    }
+    zsv_pool_group_delete(group);
+    zsv_pool_delete(pool);
+
+    size_t rows = 0;
+    for (size_t i = 0; i < input_count; i++) {
+      rows += inputs[i].rows;
+      err = err || inputs[i].err;
     }
+    if (!err)
+      printf("%zu\n", rows);
   }
 
 count_done:
   if (opts->stream && opts->stream != stdin)
     fclose(opts->stream);
-
+  free(inputs);
   return err;
 }
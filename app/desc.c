@@ -20,9 +20,11 @@
 #include "zsv_command.h"
 
 #include <zsv/utils/writer.h>
+#include <zsv/utils/num.h>
 #include <zsv/utils/file.h>
 #include <zsv/utils/mem.h>
 #include <zsv/utils/string.h>
+#include <zsv/utils/pool.h>
 
 #define ZSV_DESC_MAX_COLS_DEFAULT 32768
 #define ZSV_DESC_MAX_COLS_DEFAULT_S "32768"
@@ -51,6 +53,8 @@ void zsv_desc_string_list_free(struct zsv_desc_string_list *e) {
 typedef struct zsv_desc_unique_key {
   unsigned char color : 1;
   unsigned char _ : 7;
+  uint64_t hash;
+  size_t len;
   unsigned char *value;
   struct zsv_desc_unique_key *left;
   struct zsv_desc_unique_key *right;
@@ -64,13 +68,15 @@ struct zsv_desc_unique_key_container {
   unsigned char dummy : 7;
 };
 
-static struct zsv_desc_unique_key *zsv_desc_unique_key_new(const unsigned char *value, size_t len) {
+static struct zsv_desc_unique_key *zsv_desc_unique_key_new(const unsigned char *value, size_t len, uint64_t hash) {
   zsv_desc_unique_key *key = calloc(1, sizeof(*key));
   if (!key || !(key->value = malloc(len + 1)))
     ; // handle out-of-memory error!
   else {
     memcpy(key->value, value, len);
     key->value[len] = '\0';
+    key->len = len;
+    key->hash = hash;
   }
   return key;
 }
@@ -81,8 +87,13 @@ static void zsv_desc_unique_key_delete(zsv_desc_unique_key *e) {
   free(e);
 }
 
+// order by hash first, so that most comparisons never touch the values
 static int zsv_desc_unique_key_cmp(zsv_desc_unique_key *x, zsv_desc_unique_key *y) {
-  return strcmp((const char *)x->value, (const char *)y->value);
+  if (x->hash != y->hash)
+    return x->hash < y->hash ? -1 : 1;
+  if (x->len != y->len)
+    return x->len < y->len ? -1 : 1;
+  return memcmp(x->value, y->value, x->len);
 }
 
 SGLIB_DEFINE_RBTREE_PROTOTYPES(zsv_desc_unique_key, left, right, color, zsv_desc_unique_key_cmp);
@@ -199,7 +210,9 @@ struct zsv_desc_data {
   size_t overflow_count;
 
   unsigned char quick : 1;
-  unsigned char _ : 7;
+  unsigned char with_filename : 1; // output a leading File column (used when describing multiple inputs)
+  unsigned char without_header : 1;
+  unsigned char _ : 5;
 };
 
 static void zsv_desc_finalize(struct zsv_desc_data *data) {
@@ -211,8 +224,11 @@ static void write_headers(struct zsv_desc_data *data) {
   // TO DO: adjust header for ZSV_DESC_FLAG options
   const char *headers1[] = {"#", "Column name", "Min Length", "Max Length", NULL};
   const char *headers2[] = {"Count", "Blank %", "Example 1", "Example 2", "Example 3", "Example 4", "Example 5", NULL};
+  if (data->with_filename)
+    zsv_writer_cell_s(data->csv_writer, 1, (const unsigned char *)"File", 0);
   for (int i = 0; headers1[i]; i++)
-    zsv_writer_cell(data->csv_writer, i == 0, (const unsigned char *)headers1[i], strlen(headers1[i]), 1);
+    zsv_writer_cell(data->csv_writer, i == 0 && !data->with_filename, (const unsigned char *)headers1[i],
+                    strlen(headers1[i]), 1);
 
   if (data->flags & ZSV_DESC_FLAG_UNIQUE)
     zsv_writer_cell_s(data->csv_writer, 0, (const unsigned char *)"Unique", 0);
@@ -224,17 +240,29 @@ static void write_headers(struct zsv_desc_data *data) {
     zsv_writer_cell(data->csv_writer, 0, (const unsigned char *)headers2[i], strlen(headers2[i]), 1);
 }
 
+// start an output row, beginning with the File column if applicable. Returns the new_row
+// value for the next cell
+static char zsv_desc_print_row_start(struct zsv_desc_data *data) {
+  if (!data->with_filename)
+    return 1;
+  const char *filename = data->input_filename ? data->input_filename : "-";
+  zsv_writer_cell(data->csv_writer, 1, (const unsigned char *)filename, strlen(filename), 1);
+  return 0;
+}
+
 static void zsv_desc_print(struct zsv_desc_data *data) {
   if (data->header_only) {
     for (unsigned int i = 0; i < data->col_count; i++) {
       struct zsv_desc_column_data *c = &data->columns[i];
-      zsv_writer_cell(data->csv_writer, 1, (const unsigned char *)c->name, c->name ? strlen(c->name) : 0, 1);
+      zsv_writer_cell(data->csv_writer, zsv_desc_print_row_start(data), (const unsigned char *)c->name,
+                      c->name ? strlen(c->name) : 0, 1);
     }
   } else {
-    write_headers(data);
+    if (!data->without_header)
+      write_headers(data);
     for (unsigned int i = 0; i < data->col_count; i++) {
       struct zsv_desc_column_data *c = &data->columns[i];
-      zsv_writer_cell_zu(data->csv_writer, 1, i + 1);
+      zsv_writer_cell_zu(data->csv_writer, zsv_desc_print_row_start(data), i + 1);
       zsv_writer_cell_s(data->csv_writer, 0, (unsigned char *)c->name, 1);
       if (c->lengths.lo) {
         zsv_writer_cell_zu(data->csv_writer, 0, c->lengths.lo);
@@ -263,10 +291,19 @@ static void zsv_desc_print(struct zsv_desc_data *data) {
 
       for (struct zsv_desc_string_list *sl = c->examples; sl; sl = sl->next) {
         if (sl->count) {
-          char *tmp;
-          asprintf(&tmp, "%s (%zu)", sl->value, sl->count + 1);
-          zsv_writer_cell_s(data->csv_writer, 0, (unsigned char *)tmp, 1);
-          free(tmp);
+          // "<value> (<count>)"
+          char count[ZSV_NUM_BUFF_SIZE];
+          size_t count_len = zsv_u64toa(sl->count + 1, count);
+          size_t value_len = strlen((const char *)sl->value);
+          unsigned char *tmp = malloc(value_len + count_len + 3);
+          if (tmp) {
+            memcpy(tmp, sl->value, value_len);
+            memcpy(tmp + value_len, " (", 2);
+            memcpy(tmp + value_len + 2, count, count_len);
+            tmp[value_len + 2 + count_len] = ')';
+            zsv_writer_cell(data->csv_writer, 0, tmp, value_len + count_len + 3, 1);
+            free(tmp);
+          }
         } else
           zsv_writer_cell_s(data->csv_writer, 0, sl->value, 1);
       }
@@ -287,15 +324,18 @@ static void zsv_desc_set_err(struct zsv_desc_data *data, enum zsv_desc_status er
 // zsv_desc_column_update_unique(): return 1 if unique, 0 if dupe
 static int zsv_desc_column_update_unique(struct zsv_desc_unique_key_container *key_container,
                                          const unsigned char *utf8_value, size_t len) {
-  zsv_desc_unique_key *key = zsv_desc_unique_key_new(utf8_value, len);
-  if (sglib_zsv_desc_unique_key_find_member(key_container->key, key)) { // not unique
+  zsv_desc_unique_key lookup = {0};
+  lookup.hash = zsv_hash_bytes(utf8_value, len, 0, 0);
+  lookup.len = len;
+  lookup.value = (unsigned char *)utf8_value;
+  if (sglib_zsv_desc_unique_key_find_member(key_container->key, &lookup)) { // not unique
     if (key_container->count > key_container->max_count) {
       zsv_desc_column_unique_values_delete(&key_container->key);
       key_container->not_enum = 1;
     }
-    zsv_desc_unique_key_delete(key);
     return 0;
   } else {
+    zsv_desc_unique_key *key = zsv_desc_unique_key_new(utf8_value, len, lookup.hash);
     sglib_zsv_desc_unique_key_add(&key_container->key, key);
     key_container->count++;
     return 1;
@@ -419,7 +459,7 @@ static void zsv_desc_row(void *ctx) {
 const char *zsv_desc_usage_msg[] = {
   APPNAME ": get column-level information about a table's content",
   "",
-  "Usage: " APPNAME " [options] <filename>",
+  "Usage: " APPNAME " [options] <filename> [filename ...]",
   "",
   "Options:",
   "  -b,--with-bom            : output with BOM",
@@ -427,7 +467,12 @@ const char *zsv_desc_usage_msg[] = {
   "  -H                       : output header names only",
   "  -q,--quick               : minimize example counts",
   "  -a,--all                 : calculate all metadata (for now, this only adds uniqueness info)",
-  "  -o <filename>            : filename to save output to (default: stdout)",
+  "  -o <filename>            : filename to save output to (default: stdout); compressed if it ends in .gz or .zst",
+  "  --threads <n>            : describe multiple inputs in parallel using n threads",
+  "                             (0 = one per processor; default: 1)",
+  "",
+  "When multiple inputs are given, each is described separately, and a leading",
+  "File column is added to the output",
   NULL,
 };
 
@@ -486,6 +531,38 @@ static void zsv_desc_execute(struct zsv_desc_data *data, struct zsv_prop_handler
   }
 }
 
+struct zsv_desc_input {
+  struct zsv_desc_data data;
+  struct zsv_opts opts;
+  struct zsv_prop_handler *custom_prop_handler;
+  const char *opts_used;
+  const char *path; // NULL for stdin
+};
+
+static void zsv_desc_input_run(void *arg) {
+  struct zsv_desc_input *input = arg;
+  struct zsv_desc_data *data = &input->data;
+  data->opts = &input->opts;
+  data->column_names_tail = &data->column_names;
+  if (input->path) {
+    if (!(input->opts.stream = fopen(input->path, "rb"))) {
+      data->err = zsv_printerr(zsv_desc_status_file, "Could not open for reading: %s", input->path);
+      return;
+    }
+    data->input_filename = input->path;
+  }
+  zsv_desc_execute(data, input->custom_prop_handler, input->path, input->opts_used);
+  zsv_desc_finalize(data);
+}
+
+static void zsv_desc_input_complete(void *arg) {
+  struct zsv_desc_input *input = arg;
+  if (!input->data.err)
+    zsv_desc_print(&input->data);
+  input->data.csv_writer = NULL; // shared; deleted by the caller
+  zsv_desc_cleanup(&input->data);
+}
+
 int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *opts,
                                struct zsv_prop_handler *custom_prop_handler, const char *opts_used) {
   if (argc < 1)
@@ -494,14 +571,17 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
     zsv_desc_usage();
   else {
     struct zsv_desc_data data = {0};
-    const char *input_path = NULL;
-    int err = 0;
+    const char **input_paths = calloc(argc, sizeof(*input_paths));
+    size_t input_count = 0;
+    unsigned int thread_count = 1;
     if (opts->malformed_utf8_replace != ZSV_MALFORMED_UTF8_DO_NOT_REPLACE) // user specified to be 'none'
       opts->malformed_utf8_replace = '?';
 
     data.opts = opts;
     data.max_cols = ZSV_DESC_MAX_COLS_DEFAULT; // default
     data.column_names_tail = &data.column_names;
+    if (!input_paths)
+      data.err = zsv_printerr(zsv_desc_status_memory, "Out of memory!");
 
     struct zsv_csv_writer_options writer_opts = zsv_writer_get_default_opts();
 
@@ -511,6 +591,10 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       else if (!strcmp(argv[arg_i], "-o") || !strcmp(argv[arg_i], "--output")) {
         if (++arg_i >= argc)
           data.err = zsv_printerr(zsv_desc_status_error, "%s option requires a filename", argv[arg_i - 1]);
+        else if ((writer_opts.compress = zsv_compression_from_filename(argv[arg_i])) &&
+                 !zsv_compression_supported(writer_opts.compress))
+          data.err =
+            zsv_printerr(zsv_desc_status_error, "Compressed output is not supported by this build: %s", argv[arg_i]);
         else if (!(writer_opts.stream = fopen(argv[arg_i], "wb")))
           data.err = zsv_printerr(zsv_desc_status_error, "Unable to open for write: %s", argv[arg_i]);
       } else if (!strcmp(argv[arg_i], "-a") || !strcmp(argv[arg_i], "--all"))
@@ -526,21 +610,14 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
                                   "-C (max cols) invalid: should be positive integer > 9 (got %s)", argv[arg_i]);
         else
           data.max_cols = atoi(argv[arg_i]);
-      } else {
-        if (data.opts->stream) {
-          err = 1;
-          fprintf(stderr, "Input file specified twice, or unrecognized argument: %s\n", argv[arg_i]);
-        } else if (!(data.opts->stream = fopen(argv[arg_i], "rb"))) {
-          err = 1;
-          fprintf(stderr, "Could not open for reading: %s\n", argv[arg_i]);
-        } else
-          input_path = argv[arg_i];
-
-        if (data.opts->stream && data.opts->stream != stdin)
-          data.input_filename = argv[arg_i];
-        if (err)
-          data.err = err;
-      }
+      } else if (!strcmp(argv[arg_i], "--threads")) {
+        if (++arg_i >= argc || zsv_pool_threads_arg(argv[arg_i], &thread_count))
+          data.err = zsv_printerr(zsv_desc_status_argument,
+                                  "%s option requires a number of threads (0 for one per processor)", argv[arg_i - 1]);
+      } else if (*argv[arg_i] == '-' && argv[arg_i][1])
+        data.err = zsv_printerr(zsv_desc_status_argument, "Unrecognized argument: %s", argv[arg_i]);
+      else
+        input_paths[input_count++] = argv[arg_i];
     }
 
     zsv_handle_ctrl_c_signal();
@@ -548,23 +625,49 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
     if (!data.err && !(data.csv_writer = zsv_writer_new(&writer_opts)))
       data.err = zsv_printerr(zsv_desc_status_error, "Unable to create csv writer");
 
-    if (!data.opts->stream) {
+    if (!data.err && !input_count) {
 #ifdef NO_STDIN
       data.err = zsv_printerr(zsv_desc_status_error, "Please specify an input file");
 #else
-      data.opts->stream = stdin;
+      input_count = 1; // stdin
 #endif
     }
 
+    struct zsv_desc_input *inputs = NULL;
+    if (!data.err && !(inputs = calloc(input_count, sizeof(*inputs))))
+      data.err = zsv_printerr(zsv_desc_status_memory, "Out of memory!");
+
     if (data.err) {
       zsv_desc_cleanup(&data);
+      free(input_paths);
       return 1;
     }
 
-    zsv_desc_execute(&data, custom_prop_handler, input_path, opts_used);
-    zsv_desc_finalize(&data);
-    zsv_desc_print(&data);
+    zsv_pool pool = NULL;
+    if (input_count > 1 && thread_count != 1 && !(pool = zsv_pool_new(thread_count)))
+      fprintf(stderr, "Unable to start threads; continuing without\n");
+    zsv_pool_group group = zsv_pool_group_new(pool, 0);
+    int err = !group;
+    for (size_t i = 0; !err && !zsv_signal_interrupted && i < input_count; i++) {
+      struct zsv_desc_input *input = &inputs[i];
+      input->data = data; // settings only: results are collected separately for each input
+      input->data.with_filename = input_count > 1;
+      input->data.without_header = i > 0;
+      input->opts = *opts;
+      input->custom_prop_handler = custom_prop_handler;
+      input->opts_used = opts_used;
+      input->path = input_paths[i];
+      err = zsv_pool_submit(group, zsv_desc_input_run, zsv_desc_input_complete, input);
+    }
+    zsv_pool_group_delete(group);
+    zsv_pool_delete(pool);
+    for (size_t i = 0; i < input_count; i++)
+      err = err || inputs[i].data.err;
+
     zsv_desc_cleanup(&data);
+    free(inputs);
+    free(input_paths);
+    return err;
   }
   return 0;
 }
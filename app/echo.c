@@ -22,10 +22,6 @@
 #include <zsv/utils/string.h>
 #include <zsv/utils/mem.h>
 
-enum zsv_echo_overwrite_input_type {
-  zsv_echo_overwrite_input_type_sqlite3 = 0
-};
-
 struct zsv_echo_data {
   FILE *in;
   const char *input_path;
@@ -33,15 +29,6 @@ struct zsv_echo_data {
   zsv_parser parser;
   size_t row_ix;
 
-  struct {
-    size_t row_ix;
-    size_t col_ix;
-    const unsigned char *str;
-    size_t len;
-    char eof;
-  } overwrite;
-
-  enum zsv_echo_overwrite_input_type overwrite_input_type;
   struct {
     struct {
       char *filename;
@@ -74,21 +61,24 @@ static int zsv_echo_sqlite3_check_stmt(sqlite3_stmt *stmt) {
 }
 
 /**
+ * Fetch the next (row, column, value) overwrite from the sqlite3 query, for
+ * zsv_overwrite_type_fetch. Rows may be returned in any order
  * TO DO: verify original value
  */
-void zsv_echo_get_next_overwrite(struct zsv_echo_data *data) {
-  if (!data->overwrite.eof) {
-    sqlite3_stmt *stmt = data->o.sqlite3.stmt;
-    if (stmt) {
-      if (sqlite3_step(stmt) == SQLITE_ROW) {
-        // row, column, value
-        data->overwrite.row_ix = sqlite3_column_int64(stmt, 0);
-        data->overwrite.col_ix = sqlite3_column_int64(stmt, 1);
-        data->overwrite.str = sqlite3_column_text(stmt, 2);
-        data->overwrite.len = sqlite3_column_bytes(stmt, 2);
-      } else
-        data->overwrite.eof = 1;
-    }
+static int zsv_echo_sqlite3_fetch(void *ctx, size_t *row_ix, size_t *col_ix, const unsigned char **val, size_t *len) {
+  sqlite3_stmt *stmt = ctx;
+  switch (sqlite3_step(stmt)) {
+  case SQLITE_ROW:
+    *row_ix = (size_t)sqlite3_column_int64(stmt, 0);
+    *col_ix = (size_t)sqlite3_column_int64(stmt, 1);
+    *val = sqlite3_column_text(stmt, 2);
+    *len = (size_t)sqlite3_column_bytes(stmt, 2);
+    return 1;
+  case SQLITE_DONE:
+    return 0;
+  default:
+    fprintf(stderr, "%s\n", sqlite3_errmsg(sqlite3_db_handle(stmt)));
+    return -1;
   }
 }
 
@@ -112,29 +102,16 @@ static void zsv_echo_row(void *hook) {
   if (UNLIKELY(data->trim_columns && j > data->max_nonempty_cols))
     j = data->max_nonempty_cols;
 
-  if (VERY_UNLIKELY(data->row_ix == 0)) { // header
+  if (VERY_UNLIKELY(data->row_ix > 0 && data->contiguous && zsv_row_is_blank(data->parser))) {
+    zsv_abort(data->parser);
+  } else {
+    // any overwrites are applied by the parser
     for (size_t i = 0; i < j; i++) {
       struct zsv_cell cell = zsv_get_cell(data->parser, i);
       if (UNLIKELY(data->trim_white))
         cell.str = (unsigned char *)zsv_strtrim(cell.str, &cell.len);
       zsv_writer_cell(data->csv_writer, i == 0, cell.str, cell.len, cell.quoted);
     }
-  } else if (VERY_UNLIKELY(data->contiguous && zsv_row_is_blank(data->parser))) {
-    zsv_abort(data->parser);
-  } else {
-    for (size_t i = 0; i < j; i++) {
-      if (VERY_UNLIKELY(data->overwrite.row_ix == data->row_ix && data->overwrite.col_ix == i)) {
-        zsv_writer_cell(data->csv_writer, i == 0, data->overwrite.str, data->overwrite.len, 1);
-        zsv_echo_get_next_overwrite(data);
-      } else {
-        struct zsv_cell cell = zsv_get_cell(data->parser, i);
-        if (UNLIKELY(data->trim_white))
-          cell.str = (unsigned char *)zsv_strtrim(cell.str, &cell.len);
-        zsv_writer_cell(data->csv_writer, i == 0, cell.str, cell.len, cell.quoted);
-      }
-    }
-    while (!data->overwrite.eof && data->overwrite.row_ix <= data->row_ix)
-      zsv_echo_get_next_overwrite(data);
   }
   data->row_ix++;
 }
@@ -165,10 +142,12 @@ const char *zsv_echo_usage_msg[] = {
   "",
   "For --overwrite, the <source> may be:",
   "- sqlite3://<filename>[?sql=<query>]",
-  "  e.g. sqlite3://overwrites.db?sql=select row, column, value from overwrites order by row, column",
+  "  e.g. sqlite3://overwrites.db?sql=select row, column, value from overwrites",
   "",
   "- /path/to/file.csv",
-  "  path to CSV file with columns row,col,val (in that order) and rows pre-sorted by row and column",
+  "  path to CSV file with columns row,col,val (in that order)",
+  "",
+  "Overwrites may be in any order. If a cell is overwritten more than once, the last value is used",
   NULL,
 };
 
@@ -226,7 +205,7 @@ static int zsv_echo_parse_overwrite_source(struct zsv_echo_data *data, const cha
     if (!data->o.sqlite3.sql) {
       // to do: detect it from the db
       fprintf(stderr, "Missing sql select statement for sqlite3 echo data e.g.:\n"
-                      "  select row, column, value from overwrites order by row, column\n");
+                      "  select row, column, value from overwrites\n");
       return 1;
     }
 
@@ -236,8 +215,12 @@ static int zsv_echo_parse_overwrite_source(struct zsv_echo_data *data, const cha
       return 1;
     }
 
+    if (zsv_echo_sqlite3_check_stmt(data->o.sqlite3.stmt)) {
+      fprintf(stderr, "sqlite3 overwrite query must return row, column and value\n");
+      return 1;
+    }
+
     // successful sqlite3 connection
-    data->overwrite.eof = 0;
     return 0;
   }
 
@@ -254,13 +237,11 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
 
   struct zsv_csv_writer_options writer_opts = zsv_writer_get_default_opts();
   struct zsv_echo_data data = {0};
-  data.overwrite_input_type = zsv_echo_overwrite_input_type_sqlite3;
 
   int err = 0;
 
   const char *overwrites_csv = NULL;
 
-  data.overwrite.eof = 1;
   for (int arg_i = 1; !err && arg_i < argc; arg_i++) {
     const char *arg = argv[arg_i];
     if (!strcmp(arg, "-b"))
@@ -385,7 +366,11 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
   opts->ctx = &data;
   data.csv_writer = zsv_writer_new(&writer_opts);
 
-  if (overwrites_csv) {
+  if (data.o.sqlite3.stmt) {
+    opts->overwrite.type = zsv_overwrite_type_fetch;
+    opts->overwrite.ctx = data.o.sqlite3.stmt;
+    opts->overwrite.fetch = zsv_echo_sqlite3_fetch;
+  } else if (overwrites_csv) {
     if (!(opts->overwrite.ctx = fopen(overwrites_csv, "rb"))) {
       fprintf(stderr, "Unable to open for write: %s\n", overwrites_csv);
       zsv_echo_cleanup(&data);
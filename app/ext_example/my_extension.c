@@ -198,6 +198,7 @@ static enum zsv_ext_status echo_main(zsv_execution_context ctx, int argc, const
    *   -R,--skip-head <n>: skip specified number of initial rows
    *   -d,--header-row-span <n>: apply header depth (rowspan) of n
    *   -S,--keep-blank-headers: disable default behavior of ignoring leading blank rows
+   *   -E,--encoding <enc>: input encoding (auto, utf8, utf16le, utf16be or latin1)
    *   -v,--verbose: verbose output
    * ```
    *
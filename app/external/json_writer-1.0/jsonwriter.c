@@ -2,6 +2,10 @@
 #include <string.h>
 #include <jsonwriter.h>
 
+#ifdef JSONWRITER_USE_ZSV_NUM
+#include <zsv/utils/num.h>
+#endif
+
 #ifdef INCLUDE_UTILS
 #include "utils.c"
 #else
@@ -316,13 +320,28 @@ int jsonwriter_dblf(jsonwriter_handle data, long double d, const char *format_st
 }
 
 int jsonwriter_dbl(jsonwriter_handle data, long double d) {
+#ifdef JSONWRITER_USE_ZSV_NUM
+  // shortest text that reads back as the same double
+  if(data->depth < JSONWRITER_MAX_NESTING) {
+    jsonwriter_indent(data, 0);
+    size_t len = zsv_dtoa((double)d, data->tmp);
+    jsonwriter_output_buff_write(&data->out, (unsigned char *)data->tmp, len);
+    return 0;
+  }
+  return 1;
+#else
   return jsonwriter_dblf(data, d, NULL, 1);
+#endif
 }
 
 int jsonwriter_int(jsonwriter_handle data, jsw_int64 i) {
   if(data->depth < JSONWRITER_MAX_NESTING) {
     jsonwriter_indent(data, 0);
+#ifdef JSONWRITER_USE_ZSV_NUM
+    size_t len = zsv_i64toa(i, data->tmp);
+#else
     int len = snprintf(data->tmp, sizeof(data->tmp), JSW_INT64_PRINTF_FMT, i);
+#endif
     jsonwriter_output_buff_write(&data->out, (unsigned char *)data->tmp, len);
     return 0;
   }
@@ -1,2 +1,6 @@
+/* allow wide tables: 32767 is the largest column limit supported by SQLite */
+#ifndef SQLITE_MAX_COLUMN
+#define SQLITE_MAX_COLUMN 32767
+#endif
 #include "sqlite3.c"
 #include "sqlite3_csv_vtab-zsv.c"
@@ -46,11 +46,15 @@ SQLITE_EXTENSION_INIT1
 #include <assert.h>
 #include <stdarg.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <zsv.h>
 #include <zsv/utils/string.h>
 #include <zsv/utils/arg.h>
 #include <zsv/utils/prop.h>
+#include "sqlite3_csv_vtab-zsv.h"
 
 #ifndef SQLITE_OMIT_VIRTUALTABLE
 
@@ -100,14 +104,29 @@ typedef struct zsvTable {
   enum zsv_status parser_status;
   zsv_parser parser;
   sqlite_int64 rowCount;
+  sqlite_int64 rowTotal;          /* Data rows in the file, once a scan has reached the end */
+  sqlite_int64 fileSize;
+  size_t nCol;                    /* Number of columns in the schema */
+  unsigned int inferTypes;        /* Data rows to sample for column types, or 0 */
+  unsigned char *colTypes;        /* ZSVTAB_TYPE_* of each column, or NULL if all are TEXT */
 } zsvTable;
 
-struct zsvTable *zsvTable_new() {
+/*
+** Options come from the module client data if provided, else from the
+** calling thread's default options
+*/
+struct zsvTable *zsvTable_new(const struct sqlite3_zsv_module_opts *mopts) {
   struct zsvTable *z = sqlite3_malloc(sizeof(*z));
   if(z) {
     memset(z, 0, sizeof(*z));
-    z->parser_opts = zsv_get_default_opts();
-    z->custom_prop_handler = zsv_get_default_custom_prop_handler();
+    if(mopts) {
+      z->parser_opts = mopts->parser_opts;
+      z->custom_prop_handler = mopts->custom_prop_handler;
+      z->inferTypes = mopts->infer_types;
+    } else {
+      z->parser_opts = zsv_get_default_opts();
+      z->custom_prop_handler = zsv_get_default_custom_prop_handler();
+    }
   }
   return z;
 }
@@ -115,9 +134,37 @@ struct zsvTable *zsvTable_new() {
 /* Allowed values for tstFlags */
 #define CSVTEST_FIDX  0x0001      /* Pretend that constrained searchs cost less*/
 
+/*
+** Constraints that zsvtabBestIndex() claims are applied by zsvtabNext() to
+** the raw cells of each row, so that rows that cannot match are skipped
+** before SQLite converts any of their values. SQLite still checks each row
+** that is returned, so a filter only rejects a row if SQLite certainly would
+*/
+#define ZSVTAB_OP_EQ '='
+#define ZSVTAB_OP_IN 'I'
+#define ZSVTAB_OP_LT '<'
+#define ZSVTAB_OP_LE 'l'
+#define ZSVTAB_OP_GT '>'
+#define ZSVTAB_OP_GE 'g'
+#define ZSVTAB_OP_LIKE 'L'
+
+struct zsvtab_value {
+  unsigned char *str;
+  size_t len;
+};
+
+struct zsvtab_filter {
+  int col;
+  char op;                        /* One of ZSVTAB_OP_* */
+  struct zsvtab_value *values;    /* The value to compare with, or the IN list */
+  size_t count;                   /* 0 if the filter cannot be applied to raw text */
+};
+
 /* A cursor for the CSV virtual table */
 typedef struct zsvCursor {
   sqlite3_vtab_cursor base;       /* Base class.  Must be first */
+  struct zsvtab_filter *filters;
+  int filterCount;
 } zsvCursor;
 
 
@@ -147,6 +194,7 @@ static void zsvTable_delete(struct zsvTable *z) {
     zsvTable_free(z);
     sqlite3_free(z->zFilename);
     sqlite3_free(z->opts_used);
+    sqlite3_free(z->colTypes);
     sqlite3_free(z);
   }
 }
@@ -154,20 +202,221 @@ static void zsvTable_delete(struct zsvTable *z) {
 #include "vtab_helper.c"
 
 #define BLANK_COLUMN_NAME_PREFIX "Blank_Column"
-unsigned blank_column_name_count = 0;
+
+/* row cells are allocated by the parser on demand, so the default can be the max */
+#ifndef SQLITE_MAX_COLUMN
+#define SQLITE_MAX_COLUMN 2000
+#endif
+#define ZSVTAB_MAX_COLUMNS SQLITE_MAX_COLUMN
+
+/* as for the --header-row-span command-line option */
+#define ZSVTAB_MAX_HEADER_SPAN 7
+
+/*
+** Declared column types, in the order that a sampled column is widened to.
+** ZSVTAB_TYPE_EMPTY is a column whose sampled cells are all blank
+*/
+#define ZSVTAB_TYPE_EMPTY 0
+#define ZSVTAB_TYPE_INTEGER 1
+#define ZSVTAB_TYPE_REAL 2
+#define ZSVTAB_TYPE_TEXT 3
+
+/* Magnitude below which every integer is exactly representable as a double */
+#define ZSVTAB_REAL_INT_MAX 4503599627370496.0
+
+static const char *zsvtab_type_name(unsigned char type){
+  switch(type){
+  case ZSVTAB_TYPE_INTEGER: return "INTEGER";
+  case ZSVTAB_TYPE_REAL: return "REAL";
+  default: return "TEXT";
+  }
+}
+
+/*
+** Parse text as a column with numeric affinity would: an integer literal that
+** fits in 64 bits is an integer, and any other decimal literal is a real.
+** Surrounding spaces are allowed, hexadecimal is not.
+** Return ZSVTAB_TYPE_INTEGER and set *pInt, ZSVTAB_TYPE_REAL and set
+** *pReal, or ZSVTAB_TYPE_TEXT if the text is not a number
+*/
+static unsigned char zsvtab_number(const unsigned char *s, size_t len, sqlite3_int64 *pInt, double *pReal){
+  /* Powers of ten that are exact doubles */
+  static const double pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  size_t i = 0, start, digits, frac = 0;
+  sqlite3_uint64 u = 0;
+  int neg = 0, overflow = 0, exp = 0;
+  char buff[64];
+
+  while(i < len && isspace(s[i]))
+    i++;
+  while(len > i && isspace(s[len-1]))
+    len--;
+  start = i;
+  if(i < len && (s[i] == '-' || s[i] == '+'))
+    neg = s[i++] == '-';
+  for(digits = i; i < len && isdigit(s[i]); i++){
+    if(u > ((sqlite3_uint64)-1 - 9) / 10)
+      overflow = 1;
+    else
+      u = u * 10 + (s[i] - '0');
+  }
+  digits = i - digits;
+  if(i == len){
+    if(!digits)
+      return ZSVTAB_TYPE_TEXT;
+    if(!overflow && u <= ((sqlite3_uint64)1 << 63) - !neg){
+      *pInt = neg ? (sqlite3_int64)(0 - u) : (sqlite3_int64)u;
+      return ZSVTAB_TYPE_INTEGER;
+    }
+  } else {
+    if(s[i] == '.'){
+      for(i++; i < len && isdigit(s[i]); i++, frac++){
+        if(u > ((sqlite3_uint64)-1 - 9) / 10)
+          overflow = 1;
+        else
+          u = u * 10 + (s[i] - '0');
+      }
+    }
+    if(!digits && !frac)
+      return ZSVTAB_TYPE_TEXT;
+    if(i < len && (s[i] == 'e' || s[i] == 'E')){
+      size_t e;
+      int eneg = 0;
+      if(++i < len && (s[i] == '-' || s[i] == '+'))
+        eneg = s[i++] == '-';
+      for(e = i; i < len && isdigit(s[i]); i++)
+        if(exp < 10000)
+          exp = exp * 10 + (s[i] - '0');
+      if(i == e)
+        return ZSVTAB_TYPE_TEXT;
+      if(eneg)
+        exp = -exp;
+    }
+    if(i != len)
+      return ZSVTAB_TYPE_TEXT;
+  }
+
+  // if the digits and the power of ten are exact doubles, one multiply or divide is correctly rounded
+  exp -= (int)frac;
+  if(!overflow && u <= ((sqlite3_uint64)1 << 53) && exp >= -22 && exp <= 22){
+    double d = (double)u;
+    d = exp < 0 ? d / pow10[-exp] : d * pow10[exp];
+    *pReal = neg ? -d : d;
+    return ZSVTAB_TYPE_REAL;
+  }
+
+  // else strtod(), which needs a NUL-terminated copy of the cell
+  if(len - start >= sizeof(buff))
+    return ZSVTAB_TYPE_TEXT;
+  memcpy(buff, s + start, len - start);
+  buff[len - start] = '\0';
+  *pReal = strtod(buff, NULL);
+  return ZSVTAB_TYPE_REAL;
+}
+
+/*
+** Declare each column INTEGER or REAL if every non-blank cell of the first
+** sample_rows data rows is a number of that type, using a parser of its own
+** so that the table's parser stays on the header row
+*/
+static int zsvtab_infer_types(zsvTable *pTab, unsigned int sample_rows){
+  struct zsv_opts opts = pTab->parser_opts;
+  zsv_parser parser = NULL;
+  int typed = 0;
+
+  if(!pTab->nCol)
+    return SQLITE_OK;
+  if(!(pTab->colTypes = sqlite3_malloc64(pTab->nCol)))
+    return SQLITE_NOMEM;
+  memset(pTab->colTypes, ZSVTAB_TYPE_EMPTY, pTab->nCol);
+  if(!(opts.stream = fopen(pTab->zFilename, "rb")))
+    return SQLITE_CANTOPEN;
+  if(zsv_new_with_properties(&opts, &pTab->custom_prop_handler, pTab->zFilename, pTab->opts_used,
+                             &parser) == zsv_status_ok && zsv_next_row(parser) == zsv_status_row){
+    for(unsigned int row = 0; row < sample_rows && zsv_next_row(parser) == zsv_status_row; row++){
+      size_t n = zsv_cell_count(parser);
+      if(n > pTab->nCol)
+        n = pTab->nCol;
+      for(size_t i = 0; i < n; i++){
+        if(pTab->colTypes[i] == ZSVTAB_TYPE_TEXT)
+          continue;
+        struct zsv_cell c = zsv_get_cell(parser, i);
+        sqlite3_int64 iValue;
+        double rValue;
+        unsigned char type;
+        size_t len = c.len;
+        zsv_strtrim(c.str, &len);
+        if(!len)
+          continue;
+        if((type = zsvtab_number(c.str, c.len, &iValue, &rValue)) > pTab->colTypes[i])
+          pTab->colTypes[i] = type;
+      }
+    }
+  }
+  zsv_delete(parser);
+  fclose(opts.stream);
+
+  for(size_t i = 0; i < pTab->nCol; i++){
+    if(pTab->colTypes[i] == ZSVTAB_TYPE_EMPTY)
+      pTab->colTypes[i] = ZSVTAB_TYPE_TEXT;
+    else if(pTab->colTypes[i] != ZSVTAB_TYPE_TEXT)
+      typed = 1;
+  }
+  if(!typed){
+    sqlite3_free(pTab->colTypes);
+    pTab->colTypes = NULL;
+  }
+  return SQLITE_OK;
+}
+
+/*
+** Parse an optionally quoted integer parameter value into *pN.
+** Return SQLITE_OK, SQLITE_NOMEM, or SQLITE_ERROR if the value is not an
+** integer between 0 and max
+*/
+static int zsvtab_uint_parameter(const char *zValue, long max, unsigned int *pN){
+  char *z = sqlite3_mprintf("%s", zValue);
+  char *zEnd;
+  long n;
+  int rc = SQLITE_ERROR;
+  if( !z ) return SQLITE_NOMEM;
+  csv_dequote(z);
+  errno = 0;
+  n = strtol(z, &zEnd, 10);
+  while( isspace((unsigned char)*zEnd) ) zEnd++;
+  if( zEnd!=z && !*zEnd && !errno && n>=0 && n<=max ){
+    *pN = (unsigned int)n;
+    rc = SQLITE_OK;
+  }
+  sqlite3_free(z);
+  return rc;
+}
 
 /**
  * Parameters:
  *    filename=FILENAME          Name of file containing CSV content
  *    options_used=OPTIONS_USED  Used options (passed to zsv_new_with_properties())
  *    max_columns=N              Error out if we encounter more cols than this
+ *    delimiter=C                Single-character delimiter, or \t for tab
+ *    header_row_span=N          Number of rows to merge into the header row
+ *    rows_to_ignore=N           Number of rows to skip before the header row
+ *    infer_types=N              Declare a column INTEGER or REAL if all its non-blank
+ *                               values in the first N data rows are of that type
  *
+ * These take precedence over the module client data or default options
  * The number of columns in the first row of the input file determines the
  * column names and column count
+ *
+ * A typed column returns each value that is a number as an integer or real,
+ * as a column of that affinity in an ordinary table would store it, and any
+ * other value as text
  */
 static int zsvtabConnect(
   sqlite3 *db,
-  void *_pAux,
+  void *pAux,
   int argc, const char *const*argv,
   sqlite3_vtab **ppVtab,
   char **pzErr
@@ -183,13 +432,13 @@ static int zsvtabConnect(
 # define ZSV_OPTS_USED (azPValue[1])
 
   char *schema = NULL;
-  pNew = zsvTable_new();
+  unsigned blank_column_name_count = 0;
+  pNew = zsvTable_new(pAux);
   if(!pNew)
     return SQLITE_NOMEM;
 
-  pNew->parser_opts.max_columns = 2000; /* default max columns */
+  pNew->parser_opts.max_columns = ZSVTAB_MAX_COLUMNS; /* default max columns */
 
-  (void)(_pAux);
   memset(azPValue, 0, sizeof(azPValue));
 
   char *errmsg = NULL;
@@ -207,8 +456,45 @@ static int zsvtabConnect(
       // optional values
     if( (zValue = csv_parameter("max_columns",11,z))!=0 ){
       pNew->parser_opts.max_columns = atoi(zValue);
-      if(pNew->parser_opts.max_columns<=0 || pNew->parser_opts.max_columns > 2000){
-        asprintf(&errmsg, "max_columns= value must be > 0 and < 2000");
+      if(pNew->parser_opts.max_columns<=0 || pNew->parser_opts.max_columns > ZSVTAB_MAX_COLUMNS){
+        asprintf(&errmsg, "max_columns= value must be > 0 and <= %i", ZSVTAB_MAX_COLUMNS);
+        goto zsvtab_connect_error;
+      }
+    }else
+    if( (zValue = csv_parameter("delimiter",9,z))!=0 ){
+      char *delim = sqlite3_mprintf("%s", zValue);
+      if(!delim)
+        goto zsvtab_connect_oom;
+      csv_trim_whitespace(delim);
+      csv_dequote(delim);
+      if(!strcmp(delim, "\\t"))
+        strcpy(delim, "\t");
+      if(strlen(delim) != 1 || *delim == '\n' || *delim == '\r' || *delim == '"') {
+        asprintf(&errmsg, "delimiter= value must be a single character other than a newline or double-quote");
+        sqlite3_free(delim);
+        goto zsvtab_connect_error;
+      }
+      pNew->parser_opts.delimiter = *delim;
+      sqlite3_free(delim);
+    }else
+    if( (zValue = csv_parameter("header_row_span",15,z))!=0 ){
+      if( (rc = zsvtab_uint_parameter(zValue, ZSVTAB_MAX_HEADER_SPAN, &pNew->parser_opts.header_span)) ){
+        if( rc==SQLITE_NOMEM ) goto zsvtab_connect_oom;
+        asprintf(&errmsg, "header_row_span= value must be an integer between 0 and %i", ZSVTAB_MAX_HEADER_SPAN);
+        goto zsvtab_connect_error;
+      }
+    }else
+    if( (zValue = csv_parameter("rows_to_ignore",14,z))!=0 ){
+      if( (rc = zsvtab_uint_parameter(zValue, INT_MAX, &pNew->parser_opts.rows_to_ignore)) ){
+        if( rc==SQLITE_NOMEM ) goto zsvtab_connect_oom;
+        asprintf(&errmsg, "rows_to_ignore= value must be an integer between 0 and %i", INT_MAX);
+        goto zsvtab_connect_error;
+      }
+    }else
+    if( (zValue = csv_parameter("infer_types",11,z))!=0 ){
+      if( (rc = zsvtab_uint_parameter(zValue, INT_MAX, &pNew->inferTypes)) ){
+        if( rc==SQLITE_NOMEM ) goto zsvtab_connect_oom;
+        asprintf(&errmsg, "infer_types= value must be an integer between 0 and %i", INT_MAX);
         goto zsvtab_connect_error;
       }
     }else
@@ -228,6 +514,11 @@ static int zsvtabConnect(
     goto zsvtab_connect_error;
   }
 
+  {
+    struct stat st;
+    if(!stat(CSV_FILENAME, &st))
+      pNew->fileSize = st.st_size;
+  }
   pNew->zFilename = CSV_FILENAME;
   pNew->opts_used = ZSV_OPTS_USED;
   CSV_FILENAME = ZSV_OPTS_USED = 0; // in use; don't free
@@ -242,6 +533,12 @@ static int zsvtabConnect(
 
   *ppVtab = (sqlite3_vtab*)pNew;
 
+  pNew->nCol = zsv_cell_count(pNew->parser);
+  if(pNew->inferTypes && (rc = zsvtab_infer_types(pNew, pNew->inferTypes)) != SQLITE_OK){
+    asprintf(&errmsg, "Unable to infer column types of %s", pNew->zFilename);
+    goto zsvtab_connect_error;
+  }
+
   // generate the CREATE TABLE statement
   sqlite3_str *pStr = sqlite3_str_new(0);
   sqlite3_str_appendf(pStr, "CREATE TABLE x(");
@@ -251,14 +548,16 @@ static int zsvtabConnect(
     struct zsv_cell cell = zsv_get_cell(pNew->parser, i);
     size_t len = cell.len;
     unsigned char *utf8_value = (unsigned char *)zsv_strtrim(cell.str, &len);
+    const char *type = zsvtab_type_name(pNew->colTypes ? pNew->colTypes[i] : ZSVTAB_TYPE_TEXT);
 
     if(!len) {
       if(blank_column_name_count++)
-        sqlite3_str_appendf(pStr, "%s\"%s_%u\" TEXT", i > 0 ? "," : "", BLANK_COLUMN_NAME_PREFIX, blank_column_name_count - 1);
+        sqlite3_str_appendf(pStr, "%s\"%s_%u\" %s", i > 0 ? "," : "", BLANK_COLUMN_NAME_PREFIX,
+                            blank_column_name_count - 1, type);
       else
-        sqlite3_str_appendf(pStr, "%s\"%s\" TEXT", i > 0 ? "," : "", BLANK_COLUMN_NAME_PREFIX);
+        sqlite3_str_appendf(pStr, "%s\"%s\" %s", i > 0 ? "," : "", BLANK_COLUMN_NAME_PREFIX, type);
     } else
-      sqlite3_str_appendf(pStr, "%s\"%.*w\" TEXT", i > 0 ? "," : "", len, utf8_value);
+      sqlite3_str_appendf(pStr, "%s\"%.*w\" %s", i > 0 ? "," : "", len, utf8_value, type);
     // to do: deal with duplicate column names
   }
 
@@ -315,18 +614,91 @@ zsvtab_connect_error:
   return rc;
 }
 
+/* Used to estimate the row count of a file that has not yet been scanned to the end */
+#define ZSVTAB_ROW_BYTES_ESTIMATE 100
+
 /*
-** Only a forward full table scan is supported.  xBestIndex is mostly
-** a no-op.  If CSVTEST_FIDX is set, then the presence of equality
-** constraints lowers the estimated cost, which is fiction, but is useful
-** for testing certain kinds of virtual table behavior.
+** Relative cost of reading a row and testing its raw cells, and of returning
+** a row to SQLite (which converts and tests each value it uses). These are
+** about the same
+*/
+#define ZSVTAB_SCAN_COST 1
+#define ZSVTAB_ROW_COST 1
+
+/*
+** Only a forward full table scan is supported, but =, <, <=, >, >=, LIKE
+** and (with SQLite 3.38 or later) IN constraints on a column are claimed and
+** applied to raw cells as the file is scanned. The plan is passed to
+** zsvtabFilter() in idxStr as colUsed (in hex) and ":", then one
+** "<op><column>;" per argv value.
+**
+** Comparisons are claimed only with the BINARY collation. SQLite still checks
+** each row that is returned (omit is not set), because the filters can only
+** be applied to text values, which are not known until xFilter.
+**
+** Before SQLite 3.38, an IN constraint is passed as =, and SQLite calls
+** xFilter (which scans the whole file) once per value. Because that cannot
+** be told apart from a single =, a plan that claims = is priced as two scans,
+** so that SQLite prefers to test IN itself on a single scan.
+**
+** Constraints on INTEGER and REAL columns are left to SQLite, which compares
+** their values as numbers.
 */
 static int zsvtabBestIndex(
   sqlite3_vtab *tab,
   sqlite3_index_info *pIdxInfo
 ){
-  (void)(tab);
-  pIdxInfo->estimatedCost = 1000000;
+  zsvTable *pTab = (zsvTable*)tab;
+  double nRow = pTab->rowTotal ? pTab->rowTotal : pTab->fileSize / ZSVTAB_ROW_BYTES_ESTIMATE + 1;
+  double nOut = nRow;
+  double nScan = 1;
+  int argc = 0;
+  sqlite3_str *idx = sqlite3_str_new(0);
+
+  sqlite3_str_appendf(idx, "%llx:", (unsigned long long)pIdxInfo->colUsed);
+  for(int i = 0; i < pIdxInfo->nConstraint; i++){
+    const struct sqlite3_index_constraint *c = &pIdxInfo->aConstraint[i];
+    char op;
+    double selectivity;
+    if(!c->usable || c->iColumn < 0)
+      continue;
+    if(pTab->colTypes && (size_t)c->iColumn < pTab->nCol && pTab->colTypes[c->iColumn] != ZSVTAB_TYPE_TEXT)
+      continue;
+    switch(c->op){
+    case SQLITE_INDEX_CONSTRAINT_EQ:
+      op = ZSVTAB_OP_EQ, selectivity = 0.1;
+#if SQLITE_VERSION_NUMBER >= 3038000
+      if(sqlite3_vtab_in(pIdxInfo, i, 1))
+        op = ZSVTAB_OP_IN, selectivity = 0.25;
+#endif
+      break;
+    case SQLITE_INDEX_CONSTRAINT_LT: op = ZSVTAB_OP_LT, selectivity = 0.33; break;
+    case SQLITE_INDEX_CONSTRAINT_LE: op = ZSVTAB_OP_LE, selectivity = 0.33; break;
+    case SQLITE_INDEX_CONSTRAINT_GT: op = ZSVTAB_OP_GT, selectivity = 0.33; break;
+    case SQLITE_INDEX_CONSTRAINT_GE: op = ZSVTAB_OP_GE, selectivity = 0.33; break;
+    case SQLITE_INDEX_CONSTRAINT_LIKE: op = ZSVTAB_OP_LIKE, selectivity = 0.2; break;
+    default:
+      continue;
+    }
+    if(op != ZSVTAB_OP_LIKE && sqlite3_stricmp(sqlite3_vtab_collation(pIdxInfo, i), "BINARY"))
+      continue;
+    sqlite3_str_appendf(idx, "%c%d;", op, c->iColumn);
+    pIdxInfo->aConstraintUsage[i].argvIndex = ++argc;
+    nOut *= selectivity;
+#if SQLITE_VERSION_NUMBER < 3038000
+    if(op == ZSVTAB_OP_EQ)
+      nScan = 2;
+#endif
+  }
+
+  pIdxInfo->idxNum = argc;
+  if(!(pIdxInfo->idxStr = sqlite3_str_finish(idx)))
+    return SQLITE_NOMEM;
+  pIdxInfo->needToFreeIdxStr = 1;
+  if(nOut < 1)
+    nOut = 1;
+  pIdxInfo->estimatedCost = nScan * nRow * ZSVTAB_SCAN_COST + nOut * ZSVTAB_ROW_COST;
+  pIdxInfo->estimatedRows = (sqlite3_int64)nOut;
   return SQLITE_OK;
 }
 
@@ -351,28 +723,215 @@ static int zsvtabOpen(sqlite3_vtab *p, sqlite3_vtab_cursor **ppCursor){
   return SQLITE_OK;
 }
 
+static void zsvtab_filters_free(zsvCursor *pCur){
+  for(int i = 0; i < pCur->filterCount; i++){
+    for(size_t j = 0; j < pCur->filters[i].count; j++)
+      sqlite3_free(pCur->filters[i].values[j].str);
+    sqlite3_free(pCur->filters[i].values);
+  }
+  sqlite3_free(pCur->filters);
+  pCur->filters = NULL;
+  pCur->filterCount = 0;
+}
+
 /*
 ** Destructor for a zsvCursor.
 */
 static int zsvtabClose(sqlite3_vtab_cursor *cur){
+  zsvtab_filters_free((zsvCursor*)cur);
   sqlite3_free(cur);
   return SQLITE_OK;
 }
 
 /*
-** Only a full table scan is supported.  So xFilter simply rewinds to
-** the beginning.
+** Set v to the text of a constraint value, or to the literal prefix of a
+** LIKE pattern. Return 0 if the filter cannot be applied: the value is not
+** text (its comparison with a cell then depends on affinity), or the
+** pattern starts with a wildcard
+*/
+static int zsvtab_value_set(struct zsvtab_value *v, sqlite3_value *value, char op){
+  if(sqlite3_value_type(value) != SQLITE_TEXT)
+    return 0;
+  const unsigned char *s = sqlite3_value_text(value);
+  size_t len = (size_t)sqlite3_value_bytes(value);
+  if(op == ZSVTAB_OP_LIKE){
+    // LIKE folds the case of ASCII letters only, so the prefix ends at the first non-ASCII byte
+    size_t i;
+    for(i = 0; i < len && s[i] != '%' && s[i] != '_' && s[i] < 0x80; i++)
+      ;
+    if(!(len = i))
+      return 0;
+  }
+  if(!(v->str = sqlite3_malloc64(len + 1)))
+    return -1;
+  memcpy(v->str, s, len);
+  v->str[len] = '\0';
+  v->len = len;
+  return 1;
+}
+
+static int zsvtab_filter_set(struct zsvtab_filter *f, sqlite3_value *value){
+  size_t count = 1;
+  int ok;
+#if SQLITE_VERSION_NUMBER >= 3038000
+  sqlite3_value *v;
+  int rc;
+  if(f->op == ZSVTAB_OP_IN){
+    count = 0;
+    for(rc = sqlite3_vtab_in_first(value, &v); rc == SQLITE_OK && v; rc = sqlite3_vtab_in_next(value, &v))
+      count++;
+    if(rc != SQLITE_OK && rc != SQLITE_DONE)
+      return rc;
+    if(!count)
+      return SQLITE_OK;
+  }
+#endif
+  if(!(f->values = sqlite3_malloc64(count * sizeof(*f->values))))
+    return SQLITE_NOMEM;
+#if SQLITE_VERSION_NUMBER >= 3038000
+  if(f->op == ZSVTAB_OP_IN){
+    ok = 1;
+    for(rc = sqlite3_vtab_in_first(value, &v); ok == 1 && rc == SQLITE_OK && v && f->count < count;
+        rc = sqlite3_vtab_in_next(value, &v))
+      if((ok = zsvtab_value_set(&f->values[f->count], v, f->op)) == 1)
+        f->count++;
+  } else
+#endif
+  if((ok = zsvtab_value_set(f->values, value, f->op)) == 1)
+    f->count = 1;
+
+  if(ok != 1){
+    // the filter cannot be applied to every value, so it is not applied at all
+    for(size_t j = 0; j < f->count; j++)
+      sqlite3_free(f->values[j].str);
+    f->count = 0;
+  }
+  return ok < 0 ? SQLITE_NOMEM : SQLITE_OK;
+}
+
+static int zsvtab_cmp(const unsigned char *s, size_t len, const struct zsvtab_value *v){
+  size_t n = len < v->len ? len : v->len;
+  int c = n ? memcmp(s, v->str, n) : 0;
+  return c ? c : len < v->len ? -1 : len > v->len;
+}
+
+/*
+** A cell that looks like a number is compared as one if the other operand
+** has numeric affinity, and a number is less than any text
+*/
+static int zsvtab_maybe_number(const unsigned char *s, size_t len){
+  size_t i = 0;
+  while(i < len && isspace(s[i]))
+    i++;
+  if(i < len && (s[i] == '-' || s[i] == '+'))
+    i++;
+  return i < len && (isdigit(s[i]) || s[i] == '.');
+}
+
+static int zsvtab_filter_matches(const struct zsvtab_filter *f, struct zsv_cell c){
+  const unsigned char *s = c.str ? c.str : (const unsigned char *)"";
+  size_t len = c.len;
+  switch(f->op){
+  case ZSVTAB_OP_EQ:
+  case ZSVTAB_OP_IN:
+    for(size_t j = 0; j < f->count; j++)
+      if(len == f->values[j].len && !zsvtab_cmp(s, len, &f->values[j]))
+        return 1;
+    return 0;
+  case ZSVTAB_OP_LT:
+    return zsvtab_cmp(s, len, f->values) < 0 || zsvtab_maybe_number(s, len);
+  case ZSVTAB_OP_LE:
+    return zsvtab_cmp(s, len, f->values) <= 0 || zsvtab_maybe_number(s, len);
+  case ZSVTAB_OP_GT:
+    return zsvtab_cmp(s, len, f->values) > 0;
+  case ZSVTAB_OP_GE:
+    return zsvtab_cmp(s, len, f->values) >= 0;
+  case ZSVTAB_OP_LIKE:
+    if(len < f->values->len)
+      return 0;
+    for(size_t j = 0; j < f->values->len; j++)
+      if(tolower(s[j]) != tolower(f->values->str[j]))
+        return 0;
+    return 1;
+  }
+  return 1;
+}
+
+/*
+** Advance past rows that do not match the cursor's filters
+*/
+static void zsvtab_skip(zsvTable *pTab, zsvCursor *pCur){
+  while(pTab->parser_status == zsv_status_row){
+    int i;
+    for(i = 0; i < pCur->filterCount; i++){
+      const struct zsvtab_filter *f = &pCur->filters[i];
+      if(f->count && !zsvtab_filter_matches(f, zsv_get_cell(pTab->parser, f->col)))
+        break;
+    }
+    if(i == pCur->filterCount)
+      return;
+    pTab->parser_status = zsv_next_row(pTab->parser);
+    pTab->rowCount++;
+  }
+  pTab->rowTotal = pTab->rowCount - 1;
+}
+
+/*
+** Have the parser process only the cells of the columns that the statement
+** uses (and that are filtered). colUsed has a bit for each of the first 63
+** columns, and its last bit is set if any later column is used
+*/
+static int zsvtab_set_columns(zsvTable *pTab, zsvCursor *pCur, sqlite3_uint64 colUsed){
+  unsigned char *used;
+  int all = 1;
+  if(!pTab->nCol || !(used = sqlite3_malloc64(pTab->nCol)))
+    return pTab->nCol ? SQLITE_NOMEM : SQLITE_OK;
+  for(size_t i = 0; i < pTab->nCol; i++)
+    if(!(used[i] = (colUsed >> (i < 63 ? i : 63)) & 1))
+      all = 0;
+  for(int i = 0; i < pCur->filterCount; i++)
+    if(pCur->filters[i].col >= 0 && (size_t)pCur->filters[i].col < pTab->nCol)
+      used[pCur->filters[i].col] = 1;
+  enum zsv_status stat = all ? zsv_status_ok : zsv_set_column_mask(pTab->parser, pTab->nCol, used);
+  sqlite3_free(used);
+  return stat == zsv_status_ok ? SQLITE_OK : SQLITE_NOMEM;
+}
+
+/*
+** xFilter rewinds to the beginning, and sets the filters and the columns to
+** parse from the plan built by zsvtabBestIndex()
 */
 static int zsvtabFilter(
   sqlite3_vtab_cursor *pVtabCursor,
   int idxNum, const char *idxStr,
   int argc, sqlite3_value **argv
 ){
-  (void)(idxNum);
-  (void)(idxStr);
-  (void)(argc);
-  (void)(argv);
+  zsvCursor *pCur = (zsvCursor*)pVtabCursor;
   zsvTable *pTab = (zsvTable*)pVtabCursor->pVtab;
+  sqlite3_uint64 colUsed = ~(sqlite3_uint64)0;
+  int rc;
+
+  zsvtab_filters_free(pCur);
+  if(idxStr){
+    char *end;
+    colUsed = strtoull(idxStr, &end, 16);
+    idxStr = *end == ':' ? end + 1 : end;
+  }
+  if(idxNum > 0 && idxStr && argc == idxNum){
+    if(!(pCur->filters = sqlite3_malloc64(argc * sizeof(*pCur->filters))))
+      return SQLITE_NOMEM;
+    memset(pCur->filters, 0, argc * sizeof(*pCur->filters));
+    pCur->filterCount = argc;
+    for(int i = 0; i < argc && *idxStr; i++){
+      char *end;
+      struct zsvtab_filter *f = &pCur->filters[i];
+      f->op = *idxStr;
+      f->col = (int)strtol(idxStr + 1, &end, 10);
+      idxStr = *end == ';' ? end + 1 : end;
+      if((rc = zsvtab_filter_set(f, argv[i])) != SQLITE_OK)
+        return rc;
+    }
+  }
 
   zsvTable_free(pTab);
   fseek(pTab->parser_opts.stream, 0, SEEK_SET);
@@ -382,20 +941,24 @@ static int zsvtabFilter(
                              &pTab->parser) != zsv_status_ok
      || (pTab->parser_status = zsv_next_row(pTab->parser)) != zsv_status_row)
     return SQLITE_ERROR;
+  if((rc = zsvtab_set_columns(pTab, pCur, colUsed)) != SQLITE_OK)
+    return rc;
   pTab->parser_status = zsv_next_row(pTab->parser);
   pTab->rowCount = 1;
+  zsvtab_skip(pTab, pCur);
   return SQLITE_OK;
 }
 
 
 /*
-** Advance a zsvCursor to its next row of input.
+** Advance a zsvCursor to its next row of input that matches its filters.
 ** Set the EOF marker via pTab->parser_status if we reach the end of input.
 */
 static int zsvtabNext(sqlite3_vtab_cursor *cur){
   zsvTable *pTab = (zsvTable*)cur->pVtab;
   pTab->parser_status = zsv_next_row(pTab->parser);
   pTab->rowCount++;
+  zsvtab_skip(pTab, (zsvCursor*)cur);
   return SQLITE_OK;
 }
 
@@ -419,6 +982,26 @@ static int zsvtabColumn(
 ){
   zsvTable *pTab = (zsvTable*)cur->pVtab;
   struct zsv_cell c = zsv_get_cell(pTab->parser, i);
+  if(pTab->colTypes && (size_t)i < pTab->nCol && pTab->colTypes[i] != ZSVTAB_TYPE_TEXT){
+    sqlite3_int64 iValue;
+    double rValue;
+    switch(zsvtab_number(c.str, c.len, &iValue, &rValue)){
+    case ZSVTAB_TYPE_INTEGER:
+      if(pTab->colTypes[i] == ZSVTAB_TYPE_REAL)
+        sqlite3_result_double(ctx, (double)iValue);
+      else
+        sqlite3_result_int64(ctx, iValue);
+      return SQLITE_OK;
+    case ZSVTAB_TYPE_REAL:
+      // INTEGER affinity stores a real that has an exact integer value as an integer
+      if(pTab->colTypes[i] == ZSVTAB_TYPE_INTEGER && rValue > -ZSVTAB_REAL_INT_MAX && rValue < ZSVTAB_REAL_INT_MAX
+         && rValue == (double)(sqlite3_int64)rValue)
+        sqlite3_result_int64(ctx, (sqlite3_int64)rValue);
+      else
+        sqlite3_result_double(ctx, rValue);
+      return SQLITE_OK;
+    }
+  }
   sqlite3_result_text(ctx, (char *)c.str, c.len, SQLITE_STATIC);
   return SQLITE_OK;
 }
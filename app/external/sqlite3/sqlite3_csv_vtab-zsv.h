@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021 Liquidaty and zsv contributors. All rights reserved.
+ *
+ * This file is part of zsv/lib, distributed under the MIT license as defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef SQLITE3_CSV_VTAB_ZSV_H
+#define SQLITE3_CSV_VTAB_ZSV_H
+
+#include "sqlite3.h"
+#include <zsv.h>
+#include <zsv/utils/prop.h>
+
+/**
+ * Parser options for the zsv-based "csv" virtual table module
+ *
+ * To pass parser options to the module without touching any global or
+ * thread-local defaults, register the module with a pointer to this struct as
+ * its client data:
+ *
+ *   struct sqlite3_zsv_module_opts mopts = { .parser_opts = opts };
+ *   sqlite3_create_module(db, "csv", &CsvModule, &mopts);
+ *
+ * The struct must remain valid for as long as the db connection is open.
+ * If the module is registered without client data, each table uses
+ * zsv_get_default_opts() and zsv_get_default_custom_prop_handler() instead.
+ * Either way, options can be further set per table via CREATE VIRTUAL TABLE
+ * parameters (see zsvtabConnect())
+ */
+struct sqlite3_zsv_module_opts {
+  struct zsv_opts parser_opts;
+  struct zsv_prop_handler custom_prop_handler;
+
+  /**
+   * If non-zero, sample this many data rows to declare columns INTEGER or
+   * REAL instead of TEXT (see the infer_types= parameter of zsvtabConnect())
+   */
+  unsigned int infer_types;
+};
+
+extern sqlite3_module CsvModule;
+
+#endif
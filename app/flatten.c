@@ -137,6 +137,8 @@ typedef struct flatten_output_column {
   unsigned char *name;
   size_t name_len;
   unsigned char *compare_name; // same as name, unless case-insensitive in which case, lower case
+  size_t compare_name_len;
+  uint64_t compare_hash; // case-insensitive zsv_hash_bytes() of compare_name
   unsigned char *current_value;
 
   struct flatten_output_column *left;
@@ -151,8 +153,25 @@ void flatten_output_column_free(struct flatten_output_column *e) {
   FREEIF(e->current_value);
 }
 
+static inline unsigned char flatten_ascii_tolower(unsigned char c) {
+  return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+// order by hash first, so that most comparisons never touch the names. Names are
+// compared with ASCII case folding so that an ASCII lookup value need not be
+// lower-cased first; a stored compare_name is already lower case
 int flatten_output_column_compare(flatten_output_column *x, flatten_output_column *y) {
-  return strcmp((char *)x->compare_name, (char *)y->compare_name);
+  if (x->compare_hash != y->compare_hash)
+    return x->compare_hash < y->compare_hash ? -1 : 1;
+  if (x->compare_name_len != y->compare_name_len)
+    return x->compare_name_len < y->compare_name_len ? -1 : 1;
+  for (size_t i = 0; i < x->compare_name_len; i++) {
+    unsigned char cx = flatten_ascii_tolower(x->compare_name[i]);
+    unsigned char cy = flatten_ascii_tolower(y->compare_name[i]);
+    if (cx != cy)
+      return cx < cy ? -1 : 1;
+  }
+  return 0;
 }
 
 SGLIB_DEFINE_RBTREE_PROTOTYPES(flatten_output_column, left, right, color, flatten_output_column_compare);
@@ -208,17 +227,21 @@ struct flatten_data {
   unsigned char dummy : 5;
 };
 
-static int flatten_output_column_add(struct flatten_data *data, const unsigned char *utf8_value, size_t len,
-                                     unsigned char *compare_name) {
-  if (data->output_column_total_count == data->max_cols) {
-    free(compare_name);
+static int flatten_output_column_add(struct flatten_data *data, const unsigned char *utf8_value, size_t len) {
+  if (data->output_column_total_count == data->max_cols)
     return zsv_printerr(1, "ERROR: Maximum number of columns (%i) exceeded", data->max_cols);
-  }
+
+  size_t compare_name_len = len;
+  unsigned char *compare_name = zsv_strtolowercase(utf8_value, &compare_name_len);
+  if (!compare_name)
+    return 0;
 
   struct flatten_output_column *new_output_column = calloc(1, sizeof(*new_output_column));
   new_output_column->name = zsv_memdup(utf8_value, len);
   new_output_column->name_len = len;
   new_output_column->compare_name = compare_name;
+  new_output_column->compare_name_len = compare_name_len;
+  new_output_column->compare_hash = zsv_hash_bytes(compare_name, compare_name_len, 0, ZSV_HASH_CASE_INSENSITIVE);
 
   // add to rbtree
   sglib_flatten_output_column_add(&data->output_columns_by_value, new_output_column);
@@ -231,21 +254,26 @@ static int flatten_output_column_add(struct flatten_data *data, const unsigned c
 }
 
 static flatten_output_column *flatten_output_column_find(struct flatten_data *data, const unsigned char *utf8_value,
-                                                         size_t len, unsigned char **compare_name) {
-  flatten_output_column node, *found;
-  node.compare_name = zsv_strtolowercase(utf8_value, &len);
-  if (node.compare_name) {
-    if ((found = sglib_flatten_output_column_find_member(data->output_columns_by_value, &node))) {
-      free(node.compare_name);
-      return found;
-    }
-    // not found
-    if (compare_name)
-      *compare_name = node.compare_name;
-    else
-      free(node.compare_name);
+                                                         size_t len) {
+  flatten_output_column node;
+  size_t i = 0;
+  while (i < len && utf8_value[i] < 0x80)
+    i++;
+  if (i == len) { // ASCII: the hash and compare fold case, so no lower-cased copy is needed
+    node.compare_name = (unsigned char *)utf8_value;
+    node.compare_name_len = len;
+    node.compare_hash = zsv_hash_bytes(utf8_value, len, 0, ZSV_HASH_CASE_INSENSITIVE);
+    return sglib_flatten_output_column_find_member(data->output_columns_by_value, &node);
+  }
+
+  flatten_output_column *found = NULL;
+  node.compare_name_len = len;
+  if ((node.compare_name = zsv_strtolowercase(utf8_value, &node.compare_name_len))) {
+    node.compare_hash = zsv_hash_bytes(node.compare_name, node.compare_name_len, 0, ZSV_HASH_CASE_INSENSITIVE);
+    found = sglib_flatten_output_column_find_member(data->output_columns_by_value, &node);
+    free(node.compare_name);
   }
-  return NULL;
+  return found;
 }
 
 static void set_cnx(struct flatten_column_name_and_ix *cnx, const unsigned char *utf8_value, size_t len,
@@ -274,9 +302,8 @@ static void flatten_cell1(void *hook, unsigned char *utf8_value, size_t len) {
           set_cnx(cnxlist[i], utf8_value, len, data->current_column_index);
     } else if (data->current_column_index + 1 == data->column_name_column.ix_plus_1) {
       // we are in the "column name" column, so make sure we've added this to our columns to output
-      unsigned char *compare_name = NULL;
-      if (!flatten_output_column_find(data, utf8_value, len, &compare_name) && compare_name)
-        data->cancelled = flatten_output_column_add(data, utf8_value, len, compare_name);
+      if (!flatten_output_column_find(data, utf8_value, len))
+        data->cancelled = flatten_output_column_add(data, utf8_value, len);
     }
   }
   data->current_column_index++;
@@ -310,7 +337,7 @@ static void flatten_cell2(void *hook, unsigned char *utf8_value, size_t len) {
       }
 
       if (data->current_column_index + 1 == data->column_name_column.ix_plus_1) // column name
-        data->current_column_name_column = flatten_output_column_find(data, utf8_value, len, NULL);
+        data->current_column_name_column = flatten_output_column_find(data, utf8_value, len);
 
       else if (data->current_column_index + 1 == data->value_column.ix_plus_1) // value
         data->current_column_name_value = zsv_memdup(utf8_value, len);
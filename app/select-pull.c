@@ -17,6 +17,8 @@
 #include <time.h>
 #include <stdarg.h>
 
+#include <sglib.h>
+
 #define ZSV_COMMAND select_pull
 #include "zsv_command.h"
 
@@ -25,13 +27,19 @@
 #include <zsv/utils/string.h>
 #include <zsv/utils/mem.h>
 #include <zsv/utils/arg.h>
+#include <zsv/utils/search.h>
+#include <zsv/utils/regex.h>
+#include <zsv/utils/where.h>
 
 struct zsv_select_search_str {
   struct zsv_select_search_str *next;
   const char *value;
   size_t len;
+  char regex;               // value is a /<pattern>/
+  unsigned int regex_flags; // ZSV_REGEX_ flags from the pattern's modifiers
 };
 
+
 static void zsv_select_search_str_delete(struct zsv_select_search_str *ss) {
   for (struct zsv_select_search_str *next; ss; ss = next) {
     next = ss->next;
@@ -44,6 +52,71 @@ struct zsv_select_uint_list {
   unsigned int value;
 };
 
+/**
+ * Column names are indexed by their lower-cased value, so that header matching
+ * is not quadratic in the number of columns
+ */
+typedef struct zsv_select_colname {
+  unsigned char *name; // lower-cased
+  unsigned int ix;
+  unsigned char color;
+  struct zsv_select_colname *left;
+  struct zsv_select_colname *right;
+} zsv_select_colname;
+
+static int zsv_select_colname_cmp(zsv_select_colname *x, zsv_select_colname *y) {
+  return strcmp((const char *)x->name, (const char *)y->name);
+}
+
+SGLIB_DEFINE_RBTREE_PROTOTYPES(zsv_select_colname, left, right, color, zsv_select_colname_cmp);
+SGLIB_DEFINE_RBTREE_FUNCTIONS(zsv_select_colname, left, right, color, zsv_select_colname_cmp);
+
+static unsigned char *zsv_select_colname_lc(const unsigned char *name) {
+  size_t len = name ? strlen((const char *)name) : 0;
+  if (len)
+    return zsv_strtolowercase(name, &len);
+  return calloc(1, 2);
+}
+
+static void zsv_select_colname_tree_delete(zsv_select_colname **tree) {
+  if (tree && *tree) {
+    struct sglib_zsv_select_colname_iterator it;
+    struct zsv_select_colname *e;
+    for (e = sglib_zsv_select_colname_it_init(&it, *tree); e; e = sglib_zsv_select_colname_it_next(&it)) {
+      free(e->name);
+      free(e);
+    }
+    *tree = NULL;
+  }
+}
+
+// zsv_select_colname_add(): add name unless already present. return err
+static int zsv_select_colname_add(zsv_select_colname **tree, const unsigned char *name, unsigned int ix) {
+  zsv_select_colname *e = calloc(1, sizeof(*e));
+  if (!e || !(e->name = zsv_select_colname_lc(name))) {
+    free(e);
+    return zsv_printerr(1, "Out of memory!");
+  }
+  e->ix = ix;
+  zsv_select_colname *member;
+  if (!sglib_zsv_select_colname_add_if_not_member(tree, e, &member)) { // already have; keep the first one
+    free(e->name);
+    free(e);
+  }
+  return 0;
+}
+
+// zsv_select_colname_find(): return the index of the given name, plus 1, or 0 if not found
+static unsigned int zsv_select_colname_find(zsv_select_colname *tree, const unsigned char *name) {
+  zsv_select_colname key = {0};
+  zsv_select_colname *found = NULL;
+  if (tree && (key.name = zsv_select_colname_lc(name))) {
+    found = sglib_zsv_select_colname_find_member(tree, &key);
+    free(key.name);
+  }
+  return found ? found->ix + 1 : 0;
+}
+
 struct zsv_select_data {
   FILE *in;
   unsigned int current_column_ix;
@@ -66,7 +139,8 @@ struct zsv_select_data {
     } merge;
   } *out2in; // array of .output_cols_count length; out2in[x] = y where x = output ix, y = input info
 
-  unsigned int output_cols_count; // total count of output columns
+  unsigned int output_cols_count;     // total count of output columns
+  unsigned int output_cols_allocated; // allocated size of out2in
 
 #define MAX_EXCLUSIONS 1024
   const unsigned char *exclusions[MAX_EXCLUSIONS];
@@ -75,6 +149,10 @@ struct zsv_select_data {
   unsigned int header_name_count;
   unsigned char **header_names;
 
+  zsv_select_colname *header_name_index; // header name => first input index
+  zsv_select_colname *output_name_index; // header name => output index (used with --distinct / --merge)
+  zsv_select_colname *exclusion_index;   // excluded names
+
   const char *prepend_header; // --prepend-header
 
   char header_finished;
@@ -89,6 +167,22 @@ struct zsv_select_data {
   size_t skip_data_rows;
 
   struct zsv_select_search_str *search_strings;
+  zsv_search search; // compiled from search_strings that are not regexes
+  zsv_regex *regexes; // compiled from search_strings that are regexes
+  unsigned int regex_count;
+  zsv_search regex_prefilter; // literals required by the regexes, if every regex requires one
+
+  struct zsv_select_search_str *search_columns; // --search-column names
+  unsigned char *search_column_mask;            // input columns to search, or NULL to search all
+  unsigned int search_column_mask_len;
+
+  char *where_expr; // --where expressions, joined with `and`
+  zsv_where where;
+  struct {
+    unsigned char *buff;
+    size_t size;
+  } where_buffs[2];            // copies of cells that --where cleans; a test may use two cells
+  unsigned char where_buff_ix; // where_buffs entry used last
 
   zsv_csv_writer csv_writer;
 
@@ -101,6 +195,7 @@ struct zsv_select_data {
   } fixed;
   */
   unsigned char whitespace_clean_flags;
+  unsigned int clean_flags; // ZSV_STRCLEAN_XXX flags, set from the cleaning options
 
   unsigned char print_all_cols : 1;
   unsigned char use_header_indexes : 1;
@@ -117,7 +212,9 @@ struct zsv_select_data {
                               // non-null value)
 
   unsigned char no_header : 1;
-  unsigned char _ : 4;
+  unsigned char search_case_insensitive : 1;
+  unsigned char search_row_block : 1; // search each row's memory block, instead of cell by cell
+  unsigned char _ : 2;
 };
 
 enum zsv_select_column_index_selection_type {
@@ -165,34 +262,25 @@ static inline char zsv_select_excluded_current_header_name(struct zsv_select_dat
           break;
         }
       }
-    } else {
-      if (header_name) {
-        for (unsigned int i = 0; i < data->exclusion_count; i++)
-          if (!zsv_stricmp(header_name, data->exclusions[i]))
-            return 1;
-      }
-    }
+    } else if (header_name && zsv_select_colname_find(data->exclusion_index, header_name))
+      return 1;
   }
   return 0;
 }
 
-// zsv_select_find_header(): return 1-based index, or 0 if not found
+// zsv_select_find_header(): return 1-based output index, or 0 if not found
 static int zsv_select_find_header(struct zsv_select_data *data, const unsigned char *header_name) {
-  if (header_name) {
-    for (unsigned int i = 0; i < data->output_cols_count; i++) {
-      unsigned char *prior_header_name = zsv_select_get_header_name(data, data->out2in[i].ix);
-      if (prior_header_name && !zsv_stricmp(header_name, prior_header_name))
-        return i + 1;
-    }
-  }
+  if (header_name)
+    return zsv_select_colname_find(data->output_name_index, header_name);
   return 0;
 }
 
 static int zsv_select_add_output_col(struct zsv_select_data *data, unsigned in_ix) {
   int err = 0;
   if (data->output_cols_count < data->opts->max_columns) {
-    int found = zsv_select_find_header(data, zsv_select_get_header_name(data, in_ix));
-    if (data->distinct && found) {
+    unsigned char *header_name = zsv_select_get_header_name(data, in_ix);
+    int found = data->distinct ? zsv_select_find_header(data, header_name) : 0;
+    if (found) {
       if (data->distinct == ZSV_SELECT_DISTINCT_MERGE) {
         // add this index
         struct zsv_select_uint_list *ix = calloc(1, sizeof(*ix));
@@ -211,27 +299,32 @@ static int zsv_select_add_output_col(struct zsv_select_data *data, unsigned in_i
     }
     if (zsv_select_excluded_current_header_name(data, in_ix))
       return err;
+    if (data->output_cols_count == data->output_cols_allocated) {
+      unsigned int new_allocated = data->output_cols_allocated ? data->output_cols_allocated * 2 : 256;
+      if (new_allocated > data->opts->max_columns)
+        new_allocated = data->opts->max_columns;
+      void *out2in = realloc(data->out2in, new_allocated * sizeof(*data->out2in));
+      if (!out2in)
+        return zsv_printerr(1, "Out of memory!");
+      data->out2in = out2in;
+      memset(data->out2in + data->output_cols_allocated, 0,
+             (new_allocated - data->output_cols_allocated) * sizeof(*data->out2in));
+      data->output_cols_allocated = new_allocated;
+    }
+    if (data->distinct && header_name)
+      err = zsv_select_colname_add(&data->output_name_index, header_name, data->output_cols_count);
     data->out2in[data->output_cols_count++].ix = in_ix;
   }
   return err;
 }
 
-// not very fast, but we don't need it to be
-static inline unsigned int str_array_ifind(const unsigned char *needle, unsigned char *haystack[], unsigned hay_count) {
-  for (unsigned int i = 0; i < hay_count; i++) {
-    if (!(needle && *needle) && !(haystack[i] && *haystack[i]))
-      return i + 1;
-    if (!(needle && *needle && haystack[i] && *haystack[i]))
-      continue;
-    if (!zsv_stricmp(needle, haystack[i]))
-      return i + 1;
-  }
-  return 0;
-}
-
 static int zsv_select_set_output_columns(struct zsv_select_data *data) {
   int err = 0;
   unsigned int header_name_count = data->header_name_count;
+  if (!data->use_header_indexes) {
+    for (unsigned int i = 0; !err && i < data->exclusion_count; i++)
+      err = zsv_select_colname_add(&data->exclusion_index, data->exclusions[i], i);
+  }
   if (!data->col_argc) {
     for (unsigned int i = 0; !err && i < header_name_count; i++)
       err = zsv_select_add_output_col(data, i);
@@ -262,10 +355,12 @@ static int zsv_select_set_output_columns(struct zsv_select_data *data) {
       }
     }
   } else { // using header names
+    for (unsigned int i = 0; !err && i < header_name_count; i++)
+      err = zsv_select_colname_add(&data->header_name_index, data->header_names[i], i);
     for (int arg_i = 0; !err && arg_i < data->col_argc; arg_i++) {
       // find the location of the matching header name, if any
       unsigned int in_pos =
-        str_array_ifind((const unsigned char *)data->col_argv[arg_i], data->header_names, header_name_count);
+        zsv_select_colname_find(data->header_name_index, (const unsigned char *)data->col_argv[arg_i]);
       if (!in_pos) {
         fprintf(stderr, "Column %s not found\n", data->col_argv[arg_i]);
         err = -1;
@@ -276,12 +371,22 @@ static int zsv_select_set_output_columns(struct zsv_select_data *data) {
   return err;
 }
 
-static void zsv_select_add_search(struct zsv_select_data *data, const char *value) {
+static void zsv_select_add_search(struct zsv_select_search_str **list, const char *value, char allow_regex) {
   struct zsv_select_search_str *ss = calloc(1, sizeof(*ss));
   ss->value = value;
   ss->len = value ? strlen(value) : 0;
-  ss->next = data->search_strings;
-  data->search_strings = ss;
+  ss->next = *list;
+  *list = ss;
+
+  // /<pattern>/<modifiers>
+  const char *end = allow_regex && ss->len > 1 && *value == '/' ? strrchr(value, '/') : NULL;
+  if (end && end > value && strspn(end + 1, "gi") == strlen(end + 1)) {
+    ss->regex = 1;
+    ss->value = value + 1;
+    ss->len = end - value - 1;
+    if (strchr(end + 1, 'i'))
+      ss->regex_flags |= ZSV_REGEX_CASE_INSENSITIVE;
+  }
 }
 
 #ifndef NDEBUG
@@ -289,53 +394,237 @@ __attribute__((always_inline)) static inline
 #endif
   unsigned char *
   zsv_select_cell_clean(struct zsv_select_data *data, unsigned char *utf8_value, char quoted, size_t *lenp) {
-  size_t len = *lenp;
-  // to do: option to replace or warn non-printable chars 0 - 31:
-  // vectorized scan
-  // replace or warn if found
-
-  if (UNLIKELY(!data->no_trim_whitespace))
-    utf8_value = (unsigned char *)zsv_strtrim(utf8_value, &len);
-
-  if (UNLIKELY(data->clean_white))
-    len = zsv_strwhite(utf8_value, len, data->whitespace_clean_flags); // to do: zsv_clean
-
-  if (UNLIKELY(data->embedded_lineend && quoted)) {
-    unsigned char *tmp;
-    const char *to_replace[] = {"\r\n", "\r", "\n"};
-    for (int i = 0; i < 3; i++) {
-      while ((tmp = memmem(utf8_value, len, to_replace[i], strlen(to_replace[i])))) {
-        if (strlen(to_replace[i]) == 1)
-          *tmp = data->embedded_lineend;
-        else {
-          size_t right_len = utf8_value + len - tmp;
-          memmove(tmp + 1, tmp + 2, right_len - 2);
-          *tmp = data->embedded_lineend;
-          len--;
+  return zsv_strclean(utf8_value, lenp, &quoted, data->clean_flags, (unsigned char)data->embedded_lineend);
+}
+
+static enum zsv_status zsv_select_search_compile(struct zsv_select_data *data) {
+  unsigned int literal_count = 0, regex_count = 0;
+  for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next) {
+    if (ss->regex)
+      regex_count++;
+    else
+      literal_count++;
+  }
+
+  // cleaning that changes cell contents in place must be done before searching
+  // each cell; trimming does not, and is applied when checking each match
+  data->search_row_block = !(data->clean_white || data->embedded_lineend);
+
+  if (literal_count) {
+    if (!(data->search = zsv_search_new(data->search_case_insensitive ? ZSV_SEARCH_CASE_INSENSITIVE : 0)))
+      return zsv_printerr(1, "Out of memory!");
+    for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next)
+      if (!ss->regex && zsv_search_add(data->search, (const unsigned char *)ss->value, ss->len))
+        return zsv_printerr(1, "Out of memory!");
+    if (zsv_search_compile(data->search))
+      return zsv_printerr(1, "Out of memory!");
+  }
+
+  if (regex_count) {
+    if (!(data->regexes = calloc(regex_count, sizeof(*data->regexes))))
+      return zsv_printerr(1, "Out of memory!");
+    unsigned int prefilter_flags = 0;
+    char prefilter = 1;
+    for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next) {
+      if (!ss->regex)
+        continue;
+      const char *err = NULL;
+      unsigned int flags = ss->regex_flags | (data->search_case_insensitive ? ZSV_REGEX_CASE_INSENSITIVE : 0);
+      zsv_regex re = zsv_regex_new((const unsigned char *)ss->value, ss->len, flags, &err);
+      if (!re)
+        return zsv_printerr(1, "Invalid search pattern /%.*s/: %s", (int)ss->len, ss->value, err);
+      data->regexes[data->regex_count++] = re;
+      size_t len;
+      if (!zsv_regex_literal(re, &len))
+        prefilter = 0;
+      if (flags & ZSV_REGEX_CASE_INSENSITIVE)
+        prefilter_flags = ZSV_SEARCH_CASE_INSENSITIVE;
+    }
+
+    // rows that contain none of the literals that the regexes require can be skipped without running any regex
+    if (prefilter && data->search_row_block) {
+      if (!(data->regex_prefilter = zsv_search_new(prefilter_flags)))
+        return zsv_printerr(1, "Out of memory!");
+      for (unsigned int i = 0; i < data->regex_count; i++) {
+        size_t len;
+        const unsigned char *literal = zsv_regex_literal(data->regexes[i], &len);
+        if (zsv_search_add(data->regex_prefilter, literal, len))
+          return zsv_printerr(1, "Out of memory!");
+      }
+      if (zsv_search_compile(data->regex_prefilter))
+        return zsv_printerr(1, "Out of memory!");
+    }
+  }
+  return zsv_status_ok;
+}
+
+/**
+ * Add a --where expression; if more than one is given, rows must satisfy all of them
+ */
+static int zsv_select_add_where(struct zsv_select_data *data, const char *value) {
+  char *expr;
+  if (!data->where_expr)
+    expr = strdup(value);
+  else if (asprintf(&expr, "(%s) and (%s)", data->where_expr, value) == -1)
+    expr = NULL;
+  if (!expr)
+    return zsv_printerr(1, "Out of memory!");
+  free(data->where_expr);
+  data->where_expr = expr;
+  return 0;
+}
+
+static enum zsv_status zsv_select_where_compile(struct zsv_select_data *data) {
+  const char *err = NULL;
+  if (!(data->where = zsv_where_new((const unsigned char *)data->where_expr, strlen(data->where_expr), &err)))
+    return zsv_printerr(1, "Invalid --where expression: %s", err);
+  return zsv_status_ok;
+}
+
+struct zsv_select_where_row {
+  struct zsv_select_data *data;
+  zsv_parser parser;
+};
+
+/**
+ * Get a cell for --where to test. Cleaning may change a cell in place, and the
+ * cell is cleaned again if the row is output, so such cleaning is done on a copy
+ */
+static const unsigned char *zsv_select_where_get_cell(void *ctx, size_t ix, size_t *len) {
+  struct zsv_select_where_row *r = ctx;
+  struct zsv_select_data *data = r->data;
+  struct zsv_cell cell = {0};
+  if (ix < zsv_cell_count(r->parser))
+    cell = zsv_get_cell(r->parser, ix);
+  if (UNLIKELY(data->any_clean != 0) && cell.len) {
+    if (data->clean_white || data->embedded_lineend) {
+      data->where_buff_ix = !data->where_buff_ix;
+      unsigned char **buff = &data->where_buffs[data->where_buff_ix].buff;
+      size_t *size = &data->where_buffs[data->where_buff_ix].size;
+      if (cell.len > *size) {
+        unsigned char *tmp = realloc(*buff, cell.len);
+        if (!tmp) {
+          zsv_printerr(1, "Out of memory!");
+          data->cancelled = 1;
+          *len = 0;
+          return (const unsigned char *)"";
         }
+        *buff = tmp;
+        *size = cell.len;
       }
+      memcpy(*buff, cell.str, cell.len);
+      cell.str = *buff;
     }
-    if (data->no_trim_whitespace)
-      utf8_value = (unsigned char *)zsv_strtrim(utf8_value, &len);
+    cell.str = zsv_select_cell_clean(data, cell.str, cell.quoted, &cell.len);
   }
-  *lenp = len;
-  return utf8_value;
+  *len = cell.len;
+  return cell.str ? cell.str : (const unsigned char *)"";
+}
+
+static int zsv_select_where_bind(struct zsv_select_data *data) {
+  const char *missing = NULL;
+  if (zsv_where_bind(data->where, data->header_names, data->header_name_count, &missing)) {
+    zsv_printerr(1, "Column not found: %s", missing);
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Flag the input columns that --search-column restricts searching to
+ */
+static int zsv_select_set_search_columns(struct zsv_select_data *data) {
+  if (!(data->search_column_mask = calloc(data->header_name_count + 1, 1))) {
+    zsv_printerr(1, "Out of memory!");
+    return 1;
+  }
+  data->search_column_mask_len = data->header_name_count;
+  for (struct zsv_select_search_str *ss = data->search_columns; ss; ss = ss->next) {
+    char found = 0;
+    for (unsigned int i = 0; i < data->header_name_count; i++) {
+      if (data->header_names[i] && !zsv_stricmp(data->header_names[i], (const unsigned char *)ss->value)) {
+        data->search_column_mask[i] = 1;
+        found = 1;
+      }
+    }
+    if (!found) {
+      zsv_printerr(1, "Search column not found: %s", ss->value);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static inline char zsv_select_search_column(const unsigned char *mask, unsigned int mask_len, unsigned int i) {
+  return !mask || (i < mask_len && mask[i]);
+}
+
+struct zsv_select_search_row {
+  zsv_parser parser;
+  const unsigned char *start; // start of the row's memory block
+  unsigned int cell_count;
+  char trim;
+  const unsigned char *column_mask; // columns to search, or NULL for all
+  unsigned int column_mask_len;
+};
+
+/**
+ * Accept a match in a row's memory block only if it is within a single cell.
+ * The block also contains delimiters, quotes and, after unescaping of
+ * embedded dbl-quotes, leftover bytes, none of which may be matched
+ */
+static int zsv_select_search_accept(void *ctx, size_t offset, size_t len) {
+  struct zsv_select_search_row *r = ctx;
+  const unsigned char *match = r->start + offset;
+  unsigned int lo = 0, hi = r->cell_count;
+  while (hi - lo > 1) { // find the last cell that starts at or before the match
+    unsigned int mid = lo + (hi - lo) / 2;
+    if (zsv_get_cell(r->parser, mid).str <= match)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  if (!zsv_select_search_column(r->column_mask, r->column_mask_len, lo))
+    return 0;
+  struct zsv_cell cell = zsv_get_cell(r->parser, lo);
+  if (r->trim)
+    cell.str = (unsigned char *)zsv_strtrim(cell.str, &cell.len);
+  return cell.str <= match && match + len <= cell.str + cell.len;
 }
 
 static inline char zsv_select_row_search_hit(struct zsv_select_data *data, zsv_parser p) {
-  if (!data->search_strings)
+  if (!data->search && !data->regex_count)
     return 1;
 
   unsigned int j = zsv_cell_count(p);
+  if (LIKELY(data->search_row_block)) {
+    // search the whole row at once (see docs/memory.md), then map any match back to its cell
+    struct zsv_cell first = zsv_get_cell(p, 0);
+    struct zsv_cell last = zsv_get_cell(p, j - 1);
+    size_t len = first.str && last.str + last.len > first.str ? (size_t)(last.str + last.len - first.str) : 0;
+    struct zsv_select_search_row r = {p, first.str, j, !data->no_trim_whitespace, data->search_column_mask,
+                                      data->search_column_mask_len};
+    if (data->search && len && zsv_search_scan(data->search, first.str, len, zsv_select_search_accept, &r))
+      return 1;
+    if (!data->regex_count)
+      return 0;
+    if (data->regex_prefilter &&
+        !(len && zsv_search_scan(data->regex_prefilter, first.str, len, zsv_select_search_accept, &r)))
+      return 0;
+  }
+
   for (unsigned int i = 0; i < j; i++) {
+    if (!zsv_select_search_column(data->search_column_mask, data->search_column_mask_len, i))
+      continue;
     struct zsv_cell cell = zsv_get_cell(p, i);
     if (UNLIKELY(data->any_clean != 0))
       cell.str = zsv_select_cell_clean(data, cell.str, cell.quoted, &cell.len);
-    if (cell.len) {
-      for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next)
-        if (ss->value && *ss->value && memmem(cell.str, cell.len, ss->value, ss->len))
-          return 1;
-    }
+    if (data->search && !data->search_row_block && cell.len &&
+        zsv_search_scan(data->search, cell.str, cell.len, NULL, NULL))
+      return 1;
+    for (unsigned int k = 0; k < data->regex_count; k++)
+      if (zsv_regex_match(data->regexes[k], cell.str, cell.len) > 0)
+        return 1;
   }
   return 0;
 }
@@ -458,9 +747,14 @@ static void zsv_select_data_row(struct zsv_select_data *data, zsv_parser p) {
   }
 
   if (LIKELY(!data->skip_this_row)) {
-    // if we have a search filter, check that
+    // if we have a --where or search filter, check that
     char skip = 0;
-    skip = !zsv_select_row_search_hit(data, p);
+    if (data->where) {
+      struct zsv_select_where_row r = {data, p};
+      skip = !zsv_where_eval(data->where, zsv_select_where_get_cell, &r);
+    }
+    if (!skip)
+      skip = !zsv_select_row_search_hit(data, p);
     if (!skip) {
 
       // print the data row
@@ -500,6 +794,13 @@ static void zsv_select_header_row(struct zsv_select_data *data, zsv_parser p) {
 
   unsigned int cols = zsv_cell_count(p);
   unsigned int max_header_ix = 0;
+  if (cols > data->opts->max_columns)
+    cols = data->opts->max_columns;
+  if (cols && !(data->header_names = calloc(cols, sizeof(*data->header_names)))) {
+    zsv_printerr(1, "Out of memory!");
+    data->cancelled = 1;
+    return;
+  }
   for (unsigned int i = 0; i < cols; i++) {
     struct zsv_cell cell = zsv_get_cell(p, i);
     if (UNLIKELY(data->any_clean != 0))
@@ -518,6 +819,14 @@ static void zsv_select_header_row(struct zsv_select_data *data, zsv_parser p) {
   if (max_header_ix > data->header_name_count)
     data->header_name_count = max_header_ix;
 
+  if (data->search_columns && zsv_select_set_search_columns(data)) {
+    data->cancelled = 1;
+    return;
+  }
+  if (data->where && zsv_select_where_bind(data)) {
+    data->cancelled = 1;
+    return;
+  }
   zsv_select_header_finish(data);
 }
 
@@ -546,8 +855,15 @@ const char *zsv_select_usage_msg[] = {
   "  --no-header                  : do not output header row",
   "  --prepend-header <value>     : prepend each column header with the given text <value>",
   "  -s, --search <value>         : only output rows with at least one cell containing <value>",
-  // TO DO: " -s, --search /<pattern>/modifiers: search on regex pattern; modifiers include 'g' (global) and 'i'
-  // (case-insensitive)",
+  "                                 may be specified more than once, to search for any of several values",
+  "  -s, --search /<pattern>/<mod>: only output rows with at least one cell matching the regex <pattern>",
+  "                                 <mod> may include 'i' (case-insensitive) and 'g' (global, which has no effect)",
+  "  -i, --case-insensitive       : with -s, ignore the case of ASCII letters",
+  "  --search-column <name>       : with -s, only search the named column. can be specified more than once",
+  "  --where <expression>         : only output rows that satisfy <expression>, e.g. --where \"amount > 1000 and",
+  "                                 status in ('OPEN', 'HELD')\". operators: = != < <= > >=, [not] in (...),",
+  "                                 [not] contains/startswith/endswith, and, or, not. comparisons to numbers",
+  "                                 are numeric. can be specified more than once; rows must satisfy each",
   "  --sample-every <num_of_rows> : output a sample consisting of the first row, then every nth row",
   "  --sample-pct <percentage>    : output a randomly-selected sample (32 bits of randomness) of n%% of input rows",
   "  -d,--header-row-span <n>     : apply header depth (rowspan) of n",
@@ -577,7 +893,7 @@ const char *zsv_select_usage_msg[] = {
   "  -L,--max-row-size <n>        : set the maximum memory used for a single row",
   "                                 Default: " ZSV_ROW_MAX_SIZE_MIN_S " (min), " ZSV_ROW_MAX_SIZE_DEFAULT_S " (max)",
 #endif
-  "  -o <filename>                : filename to save output to",
+  "  -o <filename>                : filename to save output to; compressed if it ends in .gz or .zst",
   NULL,
 };
 
@@ -592,6 +908,18 @@ static void zsv_select_cleanup(struct zsv_select_data *data) {
 
   zsv_writer_delete(data->csv_writer);
   zsv_select_search_str_delete(data->search_strings);
+  zsv_search_delete(data->search);
+  for (unsigned int i = 0; i < data->regex_count; i++)
+    zsv_regex_delete(data->regexes[i]);
+  free(data->regexes);
+  zsv_search_delete(data->regex_prefilter);
+  zsv_select_search_str_delete(data->search_columns);
+  free(data->search_column_mask);
+  free(data->where_expr);
+  zsv_where_delete(data->where);
+  free(data->where_buffs[0].buff);
+  free(data->where_buffs[1].buff);
+
 
   if (data->distinct == ZSV_SELECT_DISTINCT_MERGE) {
     for (unsigned int i = 0; i < data->output_cols_count; i++) {
@@ -607,6 +935,10 @@ static void zsv_select_cleanup(struct zsv_select_data *data) {
     free(data->header_names[i]);
   free(data->header_names);
 
+  zsv_select_colname_tree_delete(&data->header_name_index);
+  zsv_select_colname_tree_delete(&data->output_name_index);
+  zsv_select_colname_tree_delete(&data->exclusion_index);
+
   // free(data->fixed.offsets);
 }
 
@@ -669,6 +1001,9 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
         stat = zsv_printerr(1, "%s option requires parameter", argv[arg_i - 1]);
       else if (writer_opts.stream && writer_opts.stream != stdout)
         stat = zsv_printerr(1, "Output file specified more than once");
+      else if ((writer_opts.compress = zsv_compression_from_filename(argv[arg_i])) &&
+               !zsv_compression_supported(writer_opts.compress))
+        stat = zsv_printerr(1, "Compressed output is not supported by this build: %s", argv[arg_i]);
       else if (!(writer_opts.stream = fopen(argv[arg_i], "wb")))
         stat = zsv_printerr(1, "Unable to open for writing: %s", argv[arg_i]);
       else if (data.opts->verbose)
@@ -677,10 +1012,24 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       data.prepend_line_number = 1;
     } else if (!strcmp(argv[arg_i], "-n"))
       data.use_header_indexes = 1;
+    else if (!strcmp(argv[arg_i], "-i") || !strcmp(argv[arg_i], "--case-insensitive"))
+      data.search_case_insensitive = 1;
     else if (!strcmp(argv[arg_i], "-s") || !strcmp(argv[arg_i], "--search")) {
       arg_i++;
       if (arg_i < argc && strlen(argv[arg_i]))
-        zsv_select_add_search(&data, argv[arg_i]);
+        zsv_select_add_search(&data.search_strings, argv[arg_i], 1);
+      else
+        stat = zsv_printerr(1, "%s option requires a value", argv[arg_i - 1]);
+    } else if (!strcmp(argv[arg_i], "--where")) {
+      arg_i++;
+      if (arg_i < argc && strlen(argv[arg_i]))
+        stat = zsv_select_add_where(&data, argv[arg_i]);
+      else
+        stat = zsv_printerr(1, "%s option requires a value", argv[arg_i - 1]);
+    } else if (!strcmp(argv[arg_i], "--search-column")) {
+      arg_i++;
+      if (arg_i < argc && strlen(argv[arg_i]))
+        zsv_select_add_search(&data.search_columns, argv[arg_i], 0);
       else
         stat = zsv_printerr(1, "%s option requires a value", argv[arg_i - 1]);
     } else if (!strcmp(argv[arg_i], "-v") || !strcmp(argv[arg_i], "--verbose")) {
@@ -774,17 +1123,25 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       data.col_argc = argc - col_index_arg_i;
     }
 
-    data.header_names = calloc(data.opts->max_columns, sizeof(*data.header_names));
     assert(data.opts->max_columns > 0);
-    data.out2in = calloc(data.opts->max_columns, sizeof(*data.out2in));
     data.csv_writer = zsv_writer_new(&writer_opts);
-    if (!(data.header_names && data.csv_writer))
+    if (!data.csv_writer)
       stat = zsv_status_memory;
     else {
       zsv_parser parser;
       if (zsv_new_with_properties(data.opts, custom_prop_handler, input_path, opts_used, &parser) == zsv_status_ok) {
         // all done with
         data.any_clean = !data.no_trim_whitespace || data.clean_white || data.embedded_lineend;
+        data.clean_flags = (data.no_trim_whitespace ? 0 : ZSV_STRCLEAN_TRIM) |
+                           (data.clean_white ? ZSV_STRCLEAN_WHITE : 0) |
+                           (data.whitespace_clean_flags ? ZSV_STRCLEAN_WHITE_NO_NEWLINE : 0) |
+                           (data.embedded_lineend
+                              ? ZSV_STRCLEAN_LINEEND | (data.no_trim_whitespace ? ZSV_STRCLEAN_LINEEND_TRIM : 0)
+                              : 0);
+        if (data.search_strings && (stat = zsv_select_search_compile(&data)) != zsv_status_ok)
+          data.cancelled = 1;
+        if (data.where_expr && (stat = zsv_select_where_compile(&data)) != zsv_status_ok)
+          data.cancelled = 1;
 
         // TO DO: support fixed input
         // if (data.fixed.count && zsv_set_fixed_offsets(parser, data.fixed.count, data.fixed.offsets) != zsv_status_ok)
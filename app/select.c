@@ -16,6 +16,10 @@
 #include <ctype.h>
 #include <time.h>
 #include <stdarg.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#include <sglib.h>
 
 #define ZSV_COMMAND select
 #include "zsv_command.h"
@@ -25,11 +29,16 @@
 #include <zsv/utils/string.h>
 #include <zsv/utils/mem.h>
 #include <zsv/utils/arg.h>
+#include <zsv/utils/search.h>
+#include <zsv/utils/regex.h>
+#include <zsv/utils/where.h>
 
 struct zsv_select_search_str {
   struct zsv_select_search_str *next;
   const char *value;
   size_t len;
+  char regex;               // value is a /<pattern>/
+  unsigned int regex_flags; // ZSV_REGEX_ flags from the pattern's modifiers
 };
 
 static void zsv_select_search_str_delete(struct zsv_select_search_str *ss) {
@@ -44,6 +53,71 @@ struct zsv_select_uint_list {
   unsigned int value;
 };
 
+/**
+ * Column names are indexed by their lower-cased value, so that header matching
+ * is not quadratic in the number of columns
+ */
+typedef struct zsv_select_colname {
+  unsigned char *name; // lower-cased
+  unsigned int ix;
+  unsigned char color;
+  struct zsv_select_colname *left;
+  struct zsv_select_colname *right;
+} zsv_select_colname;
+
+static int zsv_select_colname_cmp(zsv_select_colname *x, zsv_select_colname *y) {
+  return strcmp((const char *)x->name, (const char *)y->name);
+}
+
+SGLIB_DEFINE_RBTREE_PROTOTYPES(zsv_select_colname, left, right, color, zsv_select_colname_cmp);
+SGLIB_DEFINE_RBTREE_FUNCTIONS(zsv_select_colname, left, right, color, zsv_select_colname_cmp);
+
+static unsigned char *zsv_select_colname_lc(const unsigned char *name) {
+  size_t len = name ? strlen((const char *)name) : 0;
+  if (len)
+    return zsv_strtolowercase(name, &len);
+  return calloc(1, 2);
+}
+
+static void zsv_select_colname_tree_delete(zsv_select_colname **tree) {
+  if (tree && *tree) {
+    struct sglib_zsv_select_colname_iterator it;
+    struct zsv_select_colname *e;
+    for (e = sglib_zsv_select_colname_it_init(&it, *tree); e; e = sglib_zsv_select_colname_it_next(&it)) {
+      free(e->name);
+      free(e);
+    }
+    *tree = NULL;
+  }
+}
+
+// zsv_select_colname_add(): add name unless already present. return err
+static int zsv_select_colname_add(zsv_select_colname **tree, const unsigned char *name, unsigned int ix) {
+  zsv_select_colname *e = calloc(1, sizeof(*e));
+  if (!e || !(e->name = zsv_select_colname_lc(name))) {
+    free(e);
+    return zsv_printerr(1, "Out of memory!");
+  }
+  e->ix = ix;
+  zsv_select_colname *member;
+  if (!sglib_zsv_select_colname_add_if_not_member(tree, e, &member)) { // already have; keep the first one
+    free(e->name);
+    free(e);
+  }
+  return 0;
+}
+
+// zsv_select_colname_find(): return the index of the given name, plus 1, or 0 if not found
+static unsigned int zsv_select_colname_find(zsv_select_colname *tree, const unsigned char *name) {
+  zsv_select_colname key = {0};
+  zsv_select_colname *found = NULL;
+  if (tree && (key.name = zsv_select_colname_lc(name))) {
+    found = sglib_zsv_select_colname_find_member(tree, &key);
+    free(key.name);
+  }
+  return found ? found->ix + 1 : 0;
+}
+
 struct fixed {
   size_t *offsets;
   size_t count;
@@ -72,7 +146,8 @@ struct zsv_select_data {
     } merge;
   } *out2in; // array of .output_cols_count length; out2in[x] = y where x = output ix, y = input info
 
-  unsigned int output_cols_count; // total count of output columns
+  unsigned int output_cols_count;     // total count of output columns
+  unsigned int output_cols_allocated; // allocated size of out2in
 
 #define MAX_EXCLUSIONS 1024
   const unsigned char *exclusions[MAX_EXCLUSIONS];
@@ -81,6 +156,10 @@ struct zsv_select_data {
   unsigned int header_name_count;
   unsigned char **header_names;
 
+  zsv_select_colname *header_name_index; // header name => first input index
+  zsv_select_colname *output_name_index; // header name => output index (used with --distinct / --merge)
+  zsv_select_colname *exclusion_index;   // excluded names
+
   const char *prepend_header; // --prepend-header
 
   char header_finished;
@@ -95,6 +174,26 @@ struct zsv_select_data {
   size_t skip_data_rows;
 
   struct zsv_select_search_str *search_strings;
+  zsv_search search; // compiled from search_strings that are not regexes
+  zsv_regex *regexes; // compiled from search_strings that are regexes
+  unsigned int regex_count;
+  zsv_search regex_prefilter; // literals required by the regexes, if every regex requires one
+
+  struct zsv_select_search_str *search_columns; // --search-column names
+  unsigned char *search_column_mask;            // input columns to search, or NULL to search all
+  unsigned int search_column_mask_len;
+
+  char *where_expr; // --where expressions, joined with `and`
+  zsv_where where;
+  struct {
+    unsigned char *buff;
+    size_t size;
+  } where_buffs[2];            // copies of cells that --where cleans; a test may use two cells
+  unsigned char where_buff_ix; // where_buffs entry used last
+
+  unsigned int threads;                 // --threads
+  struct zsv_checkpoint parallel_start; // position of the first data row, if processed by zsv_select_parallel()
+  struct zsv_select_chunk *chunk;       // in a --threads worker, the chunk whose output rows are being recorded
 
   zsv_csv_writer csv_writer;
 
@@ -103,6 +202,7 @@ struct zsv_select_data {
   struct fixed fixed;
 
   unsigned char whitespace_clean_flags;
+  unsigned int clean_flags; // ZSV_STRCLEAN_XXX flags, set from the cleaning options
 
   unsigned char print_all_cols : 1;
   unsigned char use_header_indexes : 1;
@@ -119,7 +219,10 @@ struct zsv_select_data {
                               // non-null value)
   unsigned char unescape : 1;
   unsigned char no_header : 1; // --no-header
-  unsigned char _ : 3;
+  unsigned char search_case_insensitive : 1;
+  unsigned char search_row_block : 1; // search each row's memory block, instead of cell by cell
+  unsigned char parallel : 1;         // data rows are to be processed by zsv_select_parallel()
+  unsigned char raw_rows : 1;         // rows that need no change may be output as their raw bytes
 };
 
 enum zsv_select_column_index_selection_type {
@@ -168,33 +271,26 @@ static inline char zsv_select_excluded_current_header_name(struct zsv_select_dat
       }
     } else {
       unsigned char *header_name = zsv_select_get_header_name(data, in_ix);
-      if (header_name) {
-        for (unsigned int i = 0; i < data->exclusion_count; i++)
-          if (!zsv_stricmp(header_name, data->exclusions[i]))
-            return 1;
-      }
+      if (header_name && zsv_select_colname_find(data->exclusion_index, header_name))
+        return 1;
     }
   }
   return 0;
 }
 
-// zsv_select_find_header(): return 1-based index, or 0 if not found
+// zsv_select_find_header(): return 1-based output index, or 0 if not found
 static int zsv_select_find_header(struct zsv_select_data *data, const unsigned char *header_name) {
-  if (header_name) {
-    for (unsigned int i = 0; i < data->output_cols_count; i++) {
-      unsigned char *prior_header_name = zsv_select_get_header_name(data, data->out2in[i].ix);
-      if (prior_header_name && !zsv_stricmp(header_name, prior_header_name))
-        return i + 1;
-    }
-  }
+  if (header_name)
+    return zsv_select_colname_find(data->output_name_index, header_name);
   return 0;
 }
 
 static int zsv_select_add_output_col(struct zsv_select_data *data, unsigned in_ix) {
   int err = 0;
   if (data->output_cols_count < data->opts->max_columns) {
-    int found = zsv_select_find_header(data, zsv_select_get_header_name(data, in_ix));
-    if (data->distinct && found) {
+    unsigned char *header_name = zsv_select_get_header_name(data, in_ix);
+    int found = data->distinct ? zsv_select_find_header(data, header_name) : 0;
+    if (found) {
       if (data->distinct == ZSV_SELECT_DISTINCT_MERGE) {
         // add this index
         struct zsv_select_uint_list *ix = calloc(1, sizeof(*ix));
@@ -213,27 +309,32 @@ static int zsv_select_add_output_col(struct zsv_select_data *data, unsigned in_i
     }
     if (zsv_select_excluded_current_header_name(data, in_ix))
       return err;
+    if (data->output_cols_count == data->output_cols_allocated) {
+      unsigned int new_allocated = data->output_cols_allocated ? data->output_cols_allocated * 2 : 256;
+      if (new_allocated > data->opts->max_columns)
+        new_allocated = data->opts->max_columns;
+      void *out2in = realloc(data->out2in, new_allocated * sizeof(*data->out2in));
+      if (!out2in)
+        return zsv_printerr(1, "Out of memory!");
+      data->out2in = out2in;
+      memset(data->out2in + data->output_cols_allocated, 0,
+             (new_allocated - data->output_cols_allocated) * sizeof(*data->out2in));
+      data->output_cols_allocated = new_allocated;
+    }
+    if (data->distinct && header_name)
+      err = zsv_select_colname_add(&data->output_name_index, header_name, data->output_cols_count);
     data->out2in[data->output_cols_count++].ix = in_ix;
   }
   return err;
 }
 
-// not very fast, but we don't need it to be
-static inline unsigned int str_array_ifind(const unsigned char *needle, unsigned char *haystack[], unsigned hay_count) {
-  for (unsigned int i = 0; i < hay_count; i++) {
-    if (!(needle && *needle) && !(haystack[i] && *haystack[i]))
-      return i + 1;
-    if (!(needle && *needle && haystack[i] && *haystack[i]))
-      continue;
-    if (!zsv_stricmp(needle, haystack[i]))
-      return i + 1;
-  }
-  return 0;
-}
-
 static int zsv_select_set_output_columns(struct zsv_select_data *data) {
   int err = 0;
   unsigned int header_name_count = data->header_name_count;
+  if (!data->use_header_indexes) {
+    for (unsigned int i = 0; !err && i < data->exclusion_count; i++)
+      err = zsv_select_colname_add(&data->exclusion_index, data->exclusions[i], i);
+  }
   if (!data->col_argc) {
     for (unsigned int i = 0; !err && i < header_name_count; i++)
       err = zsv_select_add_output_col(data, i);
@@ -264,10 +365,12 @@ static int zsv_select_set_output_columns(struct zsv_select_data *data) {
       }
     }
   } else { // using header names
+    for (unsigned int i = 0; !err && i < header_name_count; i++)
+      err = zsv_select_colname_add(&data->header_name_index, data->header_names[i], i);
     for (int arg_i = 0; !err && arg_i < data->col_argc; arg_i++) {
       // find the location of the matching header name, if any
       unsigned int in_pos =
-        str_array_ifind((const unsigned char *)data->col_argv[arg_i], data->header_names, header_name_count);
+        zsv_select_colname_find(data->header_name_index, (const unsigned char *)data->col_argv[arg_i]);
       if (!in_pos) {
         fprintf(stderr, "Column %s not found\n", data->col_argv[arg_i]);
         err = -1;
@@ -278,12 +381,22 @@ static int zsv_select_set_output_columns(struct zsv_select_data *data) {
   return err;
 }
 
-static void zsv_select_add_search(struct zsv_select_data *data, const char *value) {
+static void zsv_select_add_search(struct zsv_select_search_str **list, const char *value, char allow_regex) {
   struct zsv_select_search_str *ss = calloc(1, sizeof(*ss));
   ss->value = value;
   ss->len = value ? strlen(value) : 0;
-  ss->next = data->search_strings;
-  data->search_strings = ss;
+  ss->next = *list;
+  *list = ss;
+
+  // /<pattern>/<modifiers>
+  const char *end = allow_regex && ss->len > 1 && *value == '/' ? strrchr(value, '/') : NULL;
+  if (end && end > value && strspn(end + 1, "gi") == strlen(end + 1)) {
+    ss->regex = 1;
+    ss->value = value + 1;
+    ss->len = end - value - 1;
+    if (strchr(end + 1, 'i'))
+      ss->regex_flags |= ZSV_REGEX_CASE_INSENSITIVE;
+  }
 }
 
 #ifndef NDEBUG
@@ -291,61 +404,231 @@ __attribute__((always_inline)) static inline
 #endif
   unsigned char *
   zsv_select_cell_clean(struct zsv_select_data *data, unsigned char *utf8_value, char *quoted, size_t *lenp) {
+  return zsv_strclean(utf8_value, lenp, quoted, data->clean_flags, (unsigned char)data->embedded_lineend);
+}
+
+static enum zsv_status zsv_select_search_compile(struct zsv_select_data *data) {
+  unsigned int literal_count = 0, regex_count = 0;
+  for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next) {
+    if (ss->regex)
+      regex_count++;
+    else
+      literal_count++;
+  }
+
+  // cleaning that changes cell contents in place must be done before searching
+  // each cell; trimming does not, and is applied when checking each match
+  data->search_row_block = !(data->clean_white || data->embedded_lineend || data->unescape);
+
+  if (literal_count) {
+    if (!(data->search = zsv_search_new(data->search_case_insensitive ? ZSV_SEARCH_CASE_INSENSITIVE : 0)))
+      return zsv_printerr(1, "Out of memory!");
+    for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next)
+      if (!ss->regex && zsv_search_add(data->search, (const unsigned char *)ss->value, ss->len))
+        return zsv_printerr(1, "Out of memory!");
+    if (zsv_search_compile(data->search))
+      return zsv_printerr(1, "Out of memory!");
+  }
 
-  size_t len = *lenp;
-  // to do: option to replace or warn non-printable chars 0 - 31:
-  // vectorized scan
-  // replace or warn if found
-  if (UNLIKELY(data->unescape)) {
-    size_t new_len = zsv_strunescape_backslash(utf8_value, len);
-    if (new_len != len) {
-      *quoted = 1;
-      len = new_len;
+  if (regex_count) {
+    if (!(data->regexes = calloc(regex_count, sizeof(*data->regexes))))
+      return zsv_printerr(1, "Out of memory!");
+    unsigned int prefilter_flags = 0;
+    char prefilter = 1;
+    for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next) {
+      if (!ss->regex)
+        continue;
+      const char *err = NULL;
+      unsigned int flags = ss->regex_flags | (data->search_case_insensitive ? ZSV_REGEX_CASE_INSENSITIVE : 0);
+      zsv_regex re = zsv_regex_new((const unsigned char *)ss->value, ss->len, flags, &err);
+      if (!re)
+        return zsv_printerr(1, "Invalid search pattern /%.*s/: %s", (int)ss->len, ss->value, err);
+      data->regexes[data->regex_count++] = re;
+      size_t len;
+      if (!zsv_regex_literal(re, &len))
+        prefilter = 0;
+      if (flags & ZSV_REGEX_CASE_INSENSITIVE)
+        prefilter_flags = ZSV_SEARCH_CASE_INSENSITIVE;
+    }
+
+    // rows that contain none of the literals that the regexes require can be skipped without running any regex
+    if (prefilter && data->search_row_block) {
+      if (!(data->regex_prefilter = zsv_search_new(prefilter_flags)))
+        return zsv_printerr(1, "Out of memory!");
+      for (unsigned int i = 0; i < data->regex_count; i++) {
+        size_t len;
+        const unsigned char *literal = zsv_regex_literal(data->regexes[i], &len);
+        if (zsv_search_add(data->regex_prefilter, literal, len))
+          return zsv_printerr(1, "Out of memory!");
+      }
+      if (zsv_search_compile(data->regex_prefilter))
+        return zsv_printerr(1, "Out of memory!");
     }
   }
+  return zsv_status_ok;
+}
 
-  if (UNLIKELY(!data->no_trim_whitespace))
-    utf8_value = (unsigned char *)zsv_strtrim(utf8_value, &len);
+/**
+ * Add a --where expression; if more than one is given, rows must satisfy all of them
+ */
+static int zsv_select_add_where(struct zsv_select_data *data, const char *value) {
+  char *expr;
+  if (!data->where_expr)
+    expr = strdup(value);
+  else if (asprintf(&expr, "(%s) and (%s)", data->where_expr, value) == -1)
+    expr = NULL;
+  if (!expr)
+    return zsv_printerr(1, "Out of memory!");
+  free(data->where_expr);
+  data->where_expr = expr;
+  return 0;
+}
 
-  if (UNLIKELY(data->clean_white))
-    len = zsv_strwhite(utf8_value, len, data->whitespace_clean_flags); // to do: zsv_clean
+static enum zsv_status zsv_select_where_compile(struct zsv_select_data *data) {
+  const char *err = NULL;
+  if (!(data->where = zsv_where_new((const unsigned char *)data->where_expr, strlen(data->where_expr), &err)))
+    return zsv_printerr(1, "Invalid --where expression: %s", err);
+  return zsv_status_ok;
+}
 
-  if (UNLIKELY(data->embedded_lineend && *quoted)) {
-    unsigned char *tmp;
-    const char *to_replace[] = {"\r\n", "\r", "\n"};
-    for (int i = 0; i < 3; i++) {
-      while ((tmp = memmem(utf8_value, len, to_replace[i], strlen(to_replace[i])))) {
-        if (strlen(to_replace[i]) == 1)
-          *tmp = data->embedded_lineend;
-        else {
-          size_t right_len = utf8_value + len - tmp;
-          memmove(tmp + 1, tmp + 2, right_len - 2);
-          *tmp = data->embedded_lineend;
-          len--;
+/**
+ * Get a cell for --where to test. Cleaning may change a cell in place, and the
+ * cell is cleaned again if the row is output, so such cleaning is done on a copy
+ */
+static const unsigned char *zsv_select_where_get_cell(void *ctx, size_t ix, size_t *len) {
+  struct zsv_select_data *data = ctx;
+  struct zsv_cell cell = {0};
+  if (ix < zsv_cell_count(data->parser))
+    cell = zsv_get_cell(data->parser, ix);
+  if (UNLIKELY(data->any_clean != 0) && cell.len) {
+    if (data->clean_white || data->embedded_lineend || data->unescape) {
+      data->where_buff_ix = !data->where_buff_ix;
+      unsigned char **buff = &data->where_buffs[data->where_buff_ix].buff;
+      size_t *size = &data->where_buffs[data->where_buff_ix].size;
+      if (cell.len > *size) {
+        unsigned char *tmp = realloc(*buff, cell.len);
+        if (!tmp) {
+          zsv_printerr(1, "Out of memory!");
+          data->cancelled = 1;
+          *len = 0;
+          return (const unsigned char *)"";
         }
+        *buff = tmp;
+        *size = cell.len;
       }
+      memcpy(*buff, cell.str, cell.len);
+      cell.str = *buff;
     }
-    if (data->no_trim_whitespace)
-      utf8_value = (unsigned char *)zsv_strtrim(utf8_value, &len);
+    cell.str = zsv_select_cell_clean(data, cell.str, &cell.quoted, &cell.len);
   }
-  *lenp = len;
-  return utf8_value;
+  *len = cell.len;
+  return cell.str ? cell.str : (const unsigned char *)"";
+}
+
+static int zsv_select_where_bind(struct zsv_select_data *data) {
+  const char *missing = NULL;
+  if (zsv_where_bind(data->where, data->header_names, data->header_name_count, &missing)) {
+    zsv_printerr(1, "Column not found: %s", missing);
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Flag the input columns that --search-column restricts searching to
+ */
+static int zsv_select_set_search_columns(struct zsv_select_data *data) {
+  if (!(data->search_column_mask = calloc(data->header_name_count + 1, 1))) {
+    zsv_printerr(1, "Out of memory!");
+    return 1;
+  }
+  data->search_column_mask_len = data->header_name_count;
+  for (struct zsv_select_search_str *ss = data->search_columns; ss; ss = ss->next) {
+    char found = 0;
+    for (unsigned int i = 0; i < data->header_name_count; i++) {
+      if (data->header_names[i] && !zsv_stricmp(data->header_names[i], (const unsigned char *)ss->value)) {
+        data->search_column_mask[i] = 1;
+        found = 1;
+      }
+    }
+    if (!found) {
+      zsv_printerr(1, "Search column not found: %s", ss->value);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static inline char zsv_select_search_column(const unsigned char *mask, unsigned int mask_len, unsigned int i) {
+  return !mask || (i < mask_len && mask[i]);
+}
+
+struct zsv_select_search_row {
+  zsv_parser parser;
+  const unsigned char *start; // start of the row's memory block
+  unsigned int cell_count;
+  char trim;
+  const unsigned char *column_mask; // columns to search, or NULL for all
+  unsigned int column_mask_len;
+};
+
+/**
+ * Accept a match in a row's memory block only if it is within a single cell.
+ * The block also contains delimiters, quotes and, after unescaping of
+ * embedded dbl-quotes, leftover bytes, none of which may be matched
+ */
+static int zsv_select_search_accept(void *ctx, size_t offset, size_t len) {
+  struct zsv_select_search_row *r = ctx;
+  const unsigned char *match = r->start + offset;
+  unsigned int lo = 0, hi = r->cell_count;
+  while (hi - lo > 1) { // find the last cell that starts at or before the match
+    unsigned int mid = lo + (hi - lo) / 2;
+    if (zsv_get_cell(r->parser, mid).str <= match)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  if (!zsv_select_search_column(r->column_mask, r->column_mask_len, lo))
+    return 0;
+  struct zsv_cell cell = zsv_get_cell(r->parser, lo);
+  if (r->trim)
+    cell.str = (unsigned char *)zsv_strtrim(cell.str, &cell.len);
+  return cell.str <= match && match + len <= cell.str + cell.len;
 }
 
 static inline char zsv_select_row_search_hit(struct zsv_select_data *data) {
-  if (!data->search_strings)
+  if (!data->search && !data->regex_count)
     return 1;
 
   unsigned int j = zsv_cell_count(data->parser);
+  if (LIKELY(data->search_row_block)) {
+    // search the whole row at once (see docs/memory.md), then map any match back to its cell
+    struct zsv_cell first = zsv_get_cell(data->parser, 0);
+    struct zsv_cell last = zsv_get_cell(data->parser, j - 1);
+    size_t len = first.str && last.str + last.len > first.str ? (size_t)(last.str + last.len - first.str) : 0;
+    struct zsv_select_search_row r = {data->parser, first.str, j, !data->no_trim_whitespace, data->search_column_mask,
+                                      data->search_column_mask_len};
+    if (data->search && len && zsv_search_scan(data->search, first.str, len, zsv_select_search_accept, &r))
+      return 1;
+    if (!data->regex_count)
+      return 0;
+    if (data->regex_prefilter &&
+        !(len && zsv_search_scan(data->regex_prefilter, first.str, len, zsv_select_search_accept, &r)))
+      return 0;
+  }
+
   for (unsigned int i = 0; i < j; i++) {
+    if (!zsv_select_search_column(data->search_column_mask, data->search_column_mask_len, i))
+      continue;
     struct zsv_cell cell = zsv_get_cell(data->parser, i);
     if (UNLIKELY(data->any_clean != 0))
       cell.str = zsv_select_cell_clean(data, cell.str, &cell.quoted, &cell.len);
-    if (cell.len) {
-      for (struct zsv_select_search_str *ss = data->search_strings; ss; ss = ss->next)
-        if (ss->value && *ss->value && memmem(cell.str, cell.len, ss->value, ss->len))
-          return 1;
-    }
+    if (data->search && !data->search_row_block && cell.len &&
+        zsv_search_scan(data->search, cell.str, cell.len, NULL, NULL))
+      return 1;
+    for (unsigned int k = 0; k < data->regex_count; k++)
+      if (zsv_regex_match(data->regexes[k], cell.str, cell.len) > 0)
+        return 1;
   }
   return 0;
 }
@@ -416,9 +699,60 @@ static double demo_random_bw_1_and_100() {
 }
 
 // zsv_select_output_row(): output row data
+/**
+ * Rows can be output as their raw bytes if every input column is output in the
+ * same order, nothing is added to them and cleaning, other than trimming and
+ * replacing line ends in quoted cells, is off
+ */
+static void zsv_select_set_raw_rows(struct zsv_select_data *data) {
+  data->raw_rows = 0;
+  if (data->prepend_line_number || data->clean_white || data->unescape || data->fixed.count ||
+      data->distinct == ZSV_SELECT_DISTINCT_MERGE || (data->opts->delimiter && data->opts->delimiter != ','))
+    return;
+  if (data->output_cols_count != data->header_name_count)
+    return;
+  for (unsigned int i = 0; i < data->output_cols_count; i++)
+    if (data->out2in[i].ix != i)
+      return;
+  data->raw_rows = 1;
+}
+
+/**
+ * Get the raw bytes of the current row if they are the same as what would be
+ * output cell by cell: the row has one cell per output column, and each cell is
+ * unquoted, would not be trimmed, and sits in the input right after the delimiter
+ * that follows the prior cell (which an overwritten cell does not)
+ */
+static const unsigned char *zsv_select_row_raw(struct zsv_select_data *data, size_t *len) {
+  size_t cnt = zsv_cell_count(data->parser);
+  if (cnt != data->output_cols_count)
+    return NULL;
+  const unsigned char *raw = zsv_row_raw_bytes(data->parser);
+  const unsigned char *next = raw;
+  for (size_t i = 0; i < cnt; i++) {
+    struct zsv_cell cell = zsv_get_cell(data->parser, i);
+    if (cell.quoted || cell.str != next)
+      return NULL;
+    if (cell.len && !data->no_trim_whitespace &&
+        (*cell.str == ' ' || *cell.str >= 128 || cell.str[cell.len - 1] == ' ' || cell.str[cell.len - 1] >= 128))
+      return NULL;
+    next = cell.str + cell.len + 1;
+  }
+  *len = zsv_row_length_raw_bytes(data->parser);
+  return next - 1 == raw + *len ? raw : NULL;
+}
+
 static void zsv_select_output_data_row(struct zsv_select_data *data) {
   unsigned int cnt = data->output_cols_count;
   char first = 1;
+  if (data->raw_rows) {
+    size_t len;
+    const unsigned char *raw = zsv_select_row_raw(data, &len);
+    if (raw) {
+      zsv_writer_row_raw(data->csv_writer, raw, len);
+      return;
+    }
+  }
   if (data->prepend_line_number) {
     zsv_writer_cell_zu(data->csv_writer, first, data->data_row_count);
     first = 0;
@@ -449,6 +783,8 @@ static void zsv_select_output_data_row(struct zsv_select_data *data) {
   }
 }
 
+static void zsv_select_chunk_add_row(struct zsv_select_data *data);
+
 static void zsv_select_data_row(void *ctx) {
   struct zsv_select_data *data = ctx;
   data->data_row_count++;
@@ -470,13 +806,18 @@ static void zsv_select_data_row(void *ctx) {
   }
 
   if (LIKELY(!data->skip_this_row)) {
-    // if we have a search filter, check that
+    // if we have a --where or search filter, check that
     char skip = 0;
-    skip = !zsv_select_row_search_hit(data);
+    if (data->where)
+      skip = !zsv_where_eval(data->where, zsv_select_where_get_cell, data);
+    if (!skip)
+      skip = !zsv_select_row_search_hit(data);
     if (!skip) {
 
       // print the data row
       zsv_select_output_data_row(data);
+      if (UNLIKELY(data->chunk != NULL))
+        zsv_select_chunk_add_row(data);
       if (UNLIKELY(data->data_rows_limit > 0))
         if (data->data_row_count + 1 >= data->data_rows_limit)
           data->cancelled = 1;
@@ -503,8 +844,14 @@ static void zsv_select_header_finish(struct zsv_select_data *data) {
   if (zsv_select_set_output_columns(data))
     data->cancelled = 1;
   else {
+    zsv_select_set_raw_rows(data);
     zsv_select_print_header_row(data);
-    zsv_set_row_handler(data->parser, zsv_select_data_row);
+    if (data->threads > 1 && zsv_checkpoint(data->parser, &data->parallel_start) == zsv_status_ok) {
+      // stop here; data rows are processed by zsv_select_parallel()
+      data->parallel = 1;
+      zsv_abort(data->parser);
+    } else
+      zsv_set_row_handler(data->parser, zsv_select_data_row);
   }
 }
 
@@ -516,6 +863,13 @@ static void zsv_select_header_row(void *ctx) {
 
   unsigned int cols = zsv_cell_count(data->parser);
   unsigned int max_header_ix = 0;
+  if (cols > data->opts->max_columns)
+    cols = data->opts->max_columns;
+  if (cols && !(data->header_names = calloc(cols, sizeof(*data->header_names)))) {
+    zsv_printerr(1, "Out of memory!");
+    data->cancelled = 1;
+    return;
+  }
   for (unsigned int i = 0; i < cols; i++) {
     struct zsv_cell cell = zsv_get_cell(data->parser, i);
     if (UNLIKELY(data->any_clean != 0))
@@ -534,6 +888,14 @@ static void zsv_select_header_row(void *ctx) {
   if (max_header_ix > data->header_name_count)
     data->header_name_count = max_header_ix;
 
+  if (data->search_columns && zsv_select_set_search_columns(data)) {
+    data->cancelled = 1;
+    return;
+  }
+  if (data->where && zsv_select_where_bind(data)) {
+    data->cancelled = 1;
+    return;
+  }
   zsv_select_header_finish(data);
 }
 
@@ -564,8 +926,15 @@ const char *zsv_select_usage_msg[] = {
   "  --no-header                  : do not output header row",
   "  --prepend-header <value>     : prepend each column header with the given text <value>",
   "  -s,--search <value>          : only output rows with at least one cell containing <value>",
-  // TO DO: " -s,--search /<pattern>/modifiers: search on regex pattern; modifiers include 'g' (global) and 'i'
-  // (case-insensitive)",
+  "                                 may be specified more than once, to search for any of several values",
+  "  -s,--search /<pattern>/<mod> : only output rows with at least one cell matching the regex <pattern>",
+  "                                 <mod> may include 'i' (case-insensitive) and 'g' (global, which has no effect)",
+  "  -i,--case-insensitive        : with -s, ignore the case of ASCII letters",
+  "  --search-column <name>       : with -s, only search the named column. can be specified more than once",
+  "  --where <expression>         : only output rows that satisfy <expression>, e.g. --where \"amount > 1000 and",
+  "                                 status in ('OPEN', 'HELD')\". operators: = != < <= > >=, [not] in (...),",
+  "                                 [not] contains/startswith/endswith, and, or, not. comparisons to numbers",
+  "                                 are numeric. can be specified more than once; rows must satisfy each",
   "  --sample-every <num_of_rows> : output a sample consisting of the first row, then every nth row",
   "  --sample-pct <percentage>    : output a randomly-selected sample (32 bits of randomness) of n%% of input rows",
   "  --distinct                   : skip subsequent occurrences of columns with the same name",
@@ -595,7 +964,11 @@ const char *zsv_select_usage_msg[] = {
   "  -L,--max-row-size <n>        : set the maximum memory used for a single row",
   "                                 Default: " ZSV_ROW_MAX_SIZE_MIN_S " (min), " ZSV_ROW_MAX_SIZE_DEFAULT_S " (max)",
 #endif
-  "  -o <filename>                : filename to save output to",
+  "  -o <filename>                : filename to save output to; compressed if it ends in .gz or .zst",
+  "  --async-output               : write output from a separate thread, so that output overlaps with processing",
+  "  --output-buffer-size <n>     : size in bytes of each output buffer. Default: 262144",
+  "  --threads <n>                : process data rows with n threads. Output is the same as with one thread.",
+  "                                 Only used if the input is a file, and not with --fixed, --sample-pct or -b",
   NULL,
 };
 
@@ -604,12 +977,30 @@ static void zsv_select_usage() {
     fprintf(stdout, "%s\n", zsv_select_usage_msg[i]);
 }
 
+/**
+ * Free the search state compiled by zsv_select_search_compile(), and --where buffers
+ */
+static void zsv_select_filters_delete(struct zsv_select_data *data) {
+  zsv_search_delete(data->search);
+  for (unsigned int i = 0; i < data->regex_count; i++)
+    zsv_regex_delete(data->regexes[i]);
+  free(data->regexes);
+  zsv_search_delete(data->regex_prefilter);
+  free(data->where_buffs[0].buff);
+  free(data->where_buffs[1].buff);
+}
+
 static void zsv_select_cleanup(struct zsv_select_data *data) {
   if (data->opts->stream && data->opts->stream != stdin)
     fclose(data->opts->stream);
 
   zsv_writer_delete(data->csv_writer);
   zsv_select_search_str_delete(data->search_strings);
+  zsv_select_filters_delete(data);
+  zsv_select_search_str_delete(data->search_columns);
+  free(data->search_column_mask);
+  free(data->where_expr);
+  zsv_where_delete(data->where);
 
   if (data->distinct == ZSV_SELECT_DISTINCT_MERGE) {
     for (unsigned int i = 0; i < data->output_cols_count; i++) {
@@ -625,6 +1016,10 @@ static void zsv_select_cleanup(struct zsv_select_data *data) {
     free(data->header_names[i]);
   free(data->header_names);
 
+  zsv_select_colname_tree_delete(&data->header_name_index);
+  zsv_select_colname_tree_delete(&data->output_name_index);
+  zsv_select_colname_tree_delete(&data->exclusion_index);
+
   free(data->fixed.offsets);
 }
 
@@ -751,6 +1146,487 @@ auto_detect_fixed_column_sizes_exit:
   return stat;
 }
 
+/**
+ * --threads: data rows are split by byte offset into chunks, which workers parse
+ * and format concurrently, each into its own buffer. Buffers are written in
+ * input order
+ *
+ * A chunk's first row is guessed to start after the first newline at or after
+ * the chunk's nominal start. The guess is wrong if that newline is in a quoted
+ * cell, so it is checked: each chunk is parsed until a row starts at or after
+ * its nominal end, and that is where the next chunk must start. If the next
+ * chunk was parsed from anywhere else, it is parsed again before it is written
+ *
+ * Row numbers are not known until the preceding chunks are done, so workers do
+ * not apply options that depend on them (--sample-every, -N, -H and skipped
+ * rows). Instead, when these options are used, workers record the number and
+ * output position of each output row, and the options are applied as rows are
+ * written
+ */
+#define ZSV_SELECT_CHUNK_SIZE_MIN (64 * 1024)
+#define ZSV_SELECT_CHUNK_SIZE_MAX (16 * 1024 * 1024)
+#define ZSV_SELECT_MAX_THREADS 256
+
+struct zsv_select_chunk_row {
+  size_t row_count;          // data_row_count of the row, within its chunk
+  size_t nonempty_row_count; // count of rows with cells, up to and including this one, within its chunk
+  size_t end;                // end of the row's output in the chunk's output buffer
+};
+
+struct zsv_select_chunk {
+  uint64_t start;       // offset of the first row
+  uint32_t start_flags; // ZSV_CHECKPOINT_ flags at start
+  uint64_t end;         // rows that start at or after this offset are in the next chunk
+  uint64_t next_start;  // offset of the first row after this chunk's rows
+  uint32_t next_flags;  // ZSV_CHECKPOINT_ flags at next_start
+
+  size_t row_count;
+  size_t nonempty_row_count;
+
+  unsigned char *out; // output rows, each preceded by a newline
+  size_t out_len;
+  size_t out_size;
+
+  struct zsv_select_chunk_row *rows; // output rows, if recorded
+  size_t rows_count;
+  size_t rows_size;
+
+  char done;
+  char error;
+};
+
+struct zsv_select_parallel {
+  struct zsv_select_data *data;
+  const char *input_path;
+  uint64_t size; // input size
+
+  struct zsv_select_chunk *chunks;
+  size_t chunk_count;
+  size_t next_chunk; // next chunk for a worker to take
+  size_t written;    // count of chunks written
+  size_t window;     // maximum count of chunks taken but not yet written
+  volatile char stop;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+
+  char record_rows; // workers record output rows, for options applied when rows are written
+
+  char started; // anything has been output
+};
+
+struct zsv_select_worker {
+  struct zsv_select_parallel *parallel;
+  struct zsv_select_data data; // copy of the main data, with its own parser, writer and search state
+  struct zsv_select_chunk *chunk;
+  FILE *f;
+  uint64_t pos;       // offset of the next row
+  uint32_t pos_flags; // ZSV_CHECKPOINT_ flags at pos
+  unsigned char writer_buff[512];
+};
+
+static size_t zsv_select_chunk_write(const void *restrict buff, size_t size, size_t n, void *restrict ctx) {
+  struct zsv_select_chunk *c = ctx;
+  size_t len = size * n;
+  if (c->out_len + len > c->out_size) {
+    size_t new_size = c->out_size ? c->out_size : ZSV_SELECT_CHUNK_SIZE_MIN;
+    while (new_size < c->out_len + len)
+      new_size *= 2;
+    unsigned char *out = realloc(c->out, new_size);
+    if (!out) {
+      c->error = 1;
+      return 0;
+    }
+    c->out = out;
+    c->out_size = new_size;
+  }
+  memcpy(c->out + c->out_len, buff, len);
+  c->out_len += len;
+  return n;
+}
+
+static void zsv_select_chunk_add_row(struct zsv_select_data *data) {
+  struct zsv_select_chunk *c = data->chunk;
+  zsv_writer_flush(data->csv_writer);
+  if (c->rows_count == c->rows_size) {
+    size_t new_size = c->rows_size ? c->rows_size * 2 : 1024;
+    struct zsv_select_chunk_row *rows = realloc(c->rows, new_size * sizeof(*rows));
+    if (!rows) {
+      c->error = 1;
+      zsv_abort(data->parser);
+      return;
+    }
+    c->rows = rows;
+    c->rows_size = new_size;
+  }
+  struct zsv_select_chunk_row *r = &c->rows[c->rows_count++];
+  r->row_count = data->data_row_count;
+  r->nonempty_row_count = c->nonempty_row_count;
+  r->end = c->out_len;
+}
+
+static void zsv_select_chunk_row(void *ctx) {
+  struct zsv_select_worker *w = ctx;
+  struct zsv_select_chunk *c = w->chunk;
+  if (w->pos >= c->end) { // this row is the next chunk's first row
+    zsv_abort(w->data.parser);
+    return;
+  }
+  struct zsv_checkpoint cp;
+  if (zsv_checkpoint(w->data.parser, &cp) != zsv_status_ok) {
+    c->error = 1;
+    zsv_abort(w->data.parser);
+    return;
+  }
+  w->pos = cp.offset;
+  w->pos_flags = cp.flags;
+  if (zsv_cell_count(w->data.parser))
+    c->nonempty_row_count++;
+  zsv_select_data_row(&w->data);
+}
+
+/**
+ * Guess where a chunk's first row starts: after the first newline at or after `offset`
+ */
+static void zsv_select_chunk_guess_start(struct zsv_select_worker *w, struct zsv_select_chunk *c, uint64_t offset) {
+  struct zsv_select_parallel *p = w->parallel;
+  c->start = p->size;
+  c->start_flags = p->data->parallel_start.flags & ~ZSV_CHECKPOINT_SKIP_LF;
+  if (fseeko(w->f, (off_t)(offset - 1), SEEK_SET))
+    return;
+  unsigned char buff[4096];
+  size_t n;
+  for (uint64_t pos = offset - 1; (n = fread(buff, 1, sizeof(buff), w->f)) > 0; pos += n) {
+    const unsigned char *nl = memchr(buff, '\n', n);
+    if (nl) {
+      c->start = pos + (size_t)(nl - buff) + 1;
+      return;
+    }
+  }
+}
+
+/**
+ * Parse and format the rows of a chunk, from c->start
+ * @return 0 on success
+ */
+static int zsv_select_chunk_run(struct zsv_select_worker *w, struct zsv_select_chunk *c) {
+  struct zsv_select_parallel *p = w->parallel;
+  c->next_start = c->start;
+  c->next_flags = c->start_flags;
+  c->row_count = c->nonempty_row_count = 0;
+  c->out_len = c->rows_count = 0;
+  c->error = 0;
+  if (c->start >= c->end)
+    return 0;
+
+  struct zsv_opts opts = *p->data->opts;
+  opts.stream = w->f;
+  opts.row_handler = zsv_select_chunk_row;
+  opts.ctx = w;
+  struct zsv_checkpoint cp = p->data->parallel_start;
+  cp.offset = c->start;
+  cp.flags = c->start_flags;
+  cp.data_row_count = 0;
+  if (!(w->data.parser = zsv_new_from_checkpoint(&opts, &cp)))
+    return c->error = 1;
+
+  struct zsv_csv_writer_options writer_opts = {0};
+  writer_opts.write = zsv_select_chunk_write;
+  writer_opts.stream = c;
+  if (!(w->data.csv_writer = zsv_writer_new(&writer_opts))) {
+    zsv_delete(w->data.parser);
+    return c->error = 1;
+  }
+  zsv_writer_set_temp_buff(w->data.csv_writer, w->writer_buff, sizeof(w->writer_buff));
+  // start the writer without output, so that every row is preceded by a newline
+  zsv_writer_cell(w->data.csv_writer, ZSV_WRITER_NEW_ROW, NULL, 0, 0);
+
+  w->chunk = c;
+  w->pos = c->start;
+  w->pos_flags = c->start_flags;
+  w->data.chunk = p->record_rows ? c : NULL;
+  w->data.data_row_count = 0;
+  enum zsv_status status = zsv_status_ok;
+  while (status == zsv_status_ok && !p->stop && !c->error)
+    status = zsv_parse_more(w->data.parser);
+  if (status == zsv_status_no_more_input) {
+    zsv_finish(w->data.parser);
+    w->pos = p->size; // all rows to the end of the input are in this chunk
+    w->pos_flags = 0;
+  }
+  zsv_delete(w->data.parser);
+  w->data.parser = NULL;
+
+  zsv_writer_flush(w->data.csv_writer);
+  size_t out_len = c->out_len;
+  zsv_writer_delete(w->data.csv_writer); // writes a final newline, which is not wanted
+  w->data.csv_writer = NULL;
+  c->out_len = out_len;
+
+  c->next_start = w->pos;
+  c->next_flags = w->pos_flags;
+  c->row_count = w->data.data_row_count;
+  return c->error;
+}
+
+static int zsv_select_worker_init(struct zsv_select_worker *w, struct zsv_select_parallel *p) {
+  memset(w, 0, sizeof(*w));
+  w->parallel = p;
+  w->data = *p->data;
+  w->data.search = NULL;
+  w->data.regexes = NULL;
+  w->data.regex_count = 0;
+  w->data.regex_prefilter = NULL;
+  memset(w->data.where_buffs, 0, sizeof(w->data.where_buffs));
+  w->data.sample_every_n = 0;
+  w->data.skip_data_rows = 0;
+  w->data.data_rows_limit = 0;
+  w->data.prepend_line_number = 0;
+  w->data.verbose = 0;
+  zsv_select_set_raw_rows(&w->data);
+  if (w->data.search_strings && zsv_select_search_compile(&w->data) != zsv_status_ok)
+    return 1;
+  if (!(w->f = fopen(p->input_path, "rb")))
+    return zsv_printerr(1, "Could not open for reading: %s", p->input_path);
+  return 0;
+}
+
+static void zsv_select_worker_delete(struct zsv_select_worker *w) {
+  zsv_select_filters_delete(&w->data);
+  if (w->f)
+    fclose(w->f);
+}
+
+static void *zsv_select_worker_main(void *arg) {
+  struct zsv_select_worker *w = arg;
+  struct zsv_select_parallel *p = w->parallel;
+  pthread_mutex_lock(&p->mutex);
+  for (;;) {
+    while (!p->stop && p->next_chunk < p->chunk_count && p->next_chunk >= p->written + p->window)
+      pthread_cond_wait(&p->cond, &p->mutex);
+    if (p->stop || p->next_chunk >= p->chunk_count)
+      break;
+    size_t i = p->next_chunk++;
+    pthread_mutex_unlock(&p->mutex);
+
+    struct zsv_select_chunk *c = &p->chunks[i];
+    if (i > 0)
+      zsv_select_chunk_guess_start(w, c, p->chunks[i - 1].end);
+    zsv_select_chunk_run(w, c);
+
+    pthread_mutex_lock(&p->mutex);
+    c->done = 1;
+    pthread_cond_broadcast(&p->cond);
+  }
+  pthread_mutex_unlock(&p->mutex);
+  return NULL;
+}
+
+// output goes through the main writer, after the header, so that it shares its buffering and compression
+static void zsv_select_parallel_out(struct zsv_select_parallel *p, const unsigned char *s, size_t len) {
+  if (len)
+    zsv_writer_write(p->data->csv_writer, s, len);
+}
+
+/**
+ * Write a chunk's output, applying the options that depend on row numbers
+ * @return 1 if no more rows should be written
+ */
+static char zsv_select_chunk_output(struct zsv_select_parallel *p, struct zsv_select_chunk *c, size_t row_base,
+                                    size_t nonempty_row_base) {
+  struct zsv_select_data *data = p->data;
+  if (!p->record_rows) {
+    if (c->out_len) {
+      // skip the first row's newline if nothing has been output yet
+      zsv_select_parallel_out(p, c->out + !p->started, c->out_len - !p->started);
+      p->started = 1;
+    }
+    return 0;
+  }
+
+  size_t start = 0;
+  for (size_t i = 0; i < c->rows_count; start = c->rows[i++].end) {
+    const struct zsv_select_chunk_row *r = &c->rows[i];
+    size_t row_count = row_base + r->row_count;
+    if (nonempty_row_base + r->nonempty_row_count <= data->skip_data_rows)
+      continue;
+    if (data->sample_every_n && row_count % data->sample_every_n != 1)
+      continue;
+
+    const unsigned char *row = c->out + start;
+    size_t len = r->end - start;
+    if (data->prepend_line_number) {
+      char s[32];
+      int n = snprintf(s, sizeof(s), "%s%zu", p->started ? "\n" : "", row_count);
+      zsv_select_parallel_out(p, (const unsigned char *)s, (size_t)n);
+      if (len) // replace the row's newline with a delimiter
+        zsv_select_parallel_out(p, (const unsigned char *)",", 1);
+      p->started = 1;
+    } else if (len && !p->started)
+      p->started = 1;
+    else if (len)
+      zsv_select_parallel_out(p, (const unsigned char *)"\n", 1);
+    if (len)
+      zsv_select_parallel_out(p, row + 1, len - 1);
+
+    if (data->data_rows_limit > 0 && row_count + 1 >= data->data_rows_limit)
+      return 1;
+  }
+  return 0;
+}
+
+/**
+ * Process data rows from data->parallel_start with data->threads threads
+ */
+static enum zsv_status zsv_select_parallel(struct zsv_select_data *data, const char *input_path) {
+  struct zsv_select_parallel p;
+  memset(&p, 0, sizeof(p));
+  p.data = data;
+  p.input_path = input_path;
+
+  struct stat st;
+  if (stat(input_path, &st))
+    return zsv_printerr(1, "Could not open for reading: %s", input_path);
+  p.size = (uint64_t)st.st_size;
+
+  uint64_t start = data->parallel_start.offset;
+  uint64_t len = p.size > start ? p.size - start : 0;
+  uint64_t chunk_size = len / ((uint64_t)data->threads * 8);
+  if (chunk_size < ZSV_SELECT_CHUNK_SIZE_MIN)
+    chunk_size = ZSV_SELECT_CHUNK_SIZE_MIN;
+  if (chunk_size > ZSV_SELECT_CHUNK_SIZE_MAX)
+    chunk_size = ZSV_SELECT_CHUNK_SIZE_MAX;
+  p.chunk_count = (size_t)((len + chunk_size - 1) / chunk_size);
+  if (!p.chunk_count)
+    return zsv_status_ok;
+  if (!(p.chunks = calloc(p.chunk_count, sizeof(*p.chunks))))
+    return zsv_printerr(1, "Out of memory!");
+  for (size_t i = 0; i < p.chunk_count; i++)
+    p.chunks[i].end = i + 1 < p.chunk_count ? start + (i + 1) * chunk_size : UINT64_MAX;
+  p.chunks[0].start = start;
+  p.chunks[0].start_flags = data->parallel_start.flags;
+
+  unsigned int thread_count = data->threads;
+  if (thread_count > p.chunk_count)
+    thread_count = (unsigned int)p.chunk_count;
+  p.window = (size_t)thread_count * 2;
+  p.record_rows = data->sample_every_n || data->skip_data_rows || data->data_rows_limit || data->prepend_line_number;
+  char header_started = !data->no_header && (data->output_cols_count || data->prepend_line_number);
+  p.started = header_started;
+
+  enum zsv_status stat = zsv_status_ok;
+  struct zsv_select_worker *workers = calloc(thread_count, sizeof(*workers));
+  pthread_t *threads = calloc(thread_count, sizeof(*threads));
+  struct zsv_select_worker redo;
+  memset(&redo, 0, sizeof(redo));
+  unsigned int started_count = 0;
+  size_t redo_count = 0;
+  if (!workers || !threads)
+    stat = zsv_printerr(1, "Out of memory!");
+  else {
+    pthread_mutex_init(&p.mutex, NULL);
+    pthread_cond_init(&p.cond, NULL);
+    for (; started_count < thread_count; started_count++) {
+      struct zsv_select_worker *w = &workers[started_count];
+      if (zsv_select_worker_init(w, &p) || pthread_create(&threads[started_count], NULL, zsv_select_worker_main, w)) {
+        zsv_select_worker_delete(w);
+        stat = zsv_status_error;
+        break;
+      }
+    }
+    if (data->opts->verbose)
+      fprintf(stderr, "Processing %zu chunks with %u threads\n", p.chunk_count, started_count);
+
+    size_t row_base = 0, nonempty_row_base = 0;
+    for (size_t i = 0; i < p.chunk_count && started_count && stat == zsv_status_ok; i++) {
+      struct zsv_select_chunk *c = &p.chunks[i];
+      pthread_mutex_lock(&p.mutex);
+      while (!c->done)
+        pthread_cond_wait(&p.cond, &p.mutex);
+      pthread_mutex_unlock(&p.mutex);
+
+      if (i > 0 && c->start != p.chunks[i - 1].next_start) {
+        // the guessed start was not a row start: parse this chunk again, from where the last chunk ended
+        if (!redo.parallel && zsv_select_worker_init(&redo, &p))
+          stat = zsv_status_error;
+        else {
+          c->start = p.chunks[i - 1].next_start;
+          c->start_flags = p.chunks[i - 1].next_flags;
+          zsv_select_chunk_run(&redo, c);
+          redo_count++;
+        }
+      }
+      if (stat == zsv_status_ok && c->error)
+        stat = zsv_printerr(1, "Error processing %s", input_path);
+      if (stat == zsv_status_ok) {
+        if (zsv_select_chunk_output(&p, c, row_base, nonempty_row_base) || zsv_signal_interrupted)
+          p.stop = 1;
+        row_base += c->row_count;
+        nonempty_row_base += c->nonempty_row_count;
+      }
+
+      free(c->out);
+      c->out = NULL;
+      free(c->rows);
+      c->rows = NULL;
+      pthread_mutex_lock(&p.mutex);
+      p.written = i + 1;
+      if (p.stop || stat != zsv_status_ok)
+        p.stop = 1;
+      pthread_cond_broadcast(&p.cond);
+      pthread_mutex_unlock(&p.mutex);
+      if (p.stop)
+        break;
+    }
+
+    pthread_mutex_lock(&p.mutex);
+    p.stop = 1;
+    pthread_cond_broadcast(&p.cond);
+    pthread_mutex_unlock(&p.mutex);
+    for (unsigned int i = 0; i < started_count; i++) {
+      pthread_join(threads[i], NULL);
+      zsv_select_worker_delete(&workers[i]);
+    }
+    if (redo.parallel)
+      zsv_select_worker_delete(&redo);
+    pthread_cond_destroy(&p.cond);
+    pthread_mutex_destroy(&p.mutex);
+    if (data->opts->verbose && redo_count)
+      fprintf(stderr, "Re-parsed %zu chunks that did not start at a row\n", redo_count);
+  }
+
+  // rows are terminated as the main writer would have terminated them: with a final newline
+  // from zsv_writer_delete() if it wrote the header, and otherwise here
+  if (p.started && !header_started)
+    zsv_select_parallel_out(&p, (const unsigned char *)"\n", 1);
+
+  for (size_t i = 0; i < p.chunk_count; i++) {
+    free(p.chunks[i].out);
+    free(p.chunks[i].rows);
+  }
+  free(p.chunks);
+  free(workers);
+  free(threads);
+  return stat;
+}
+
+/**
+ * --threads is only used if workers can each open and seek the input, and
+ * rows are output the same way regardless of where parsing started
+ */
+static char zsv_select_parallel_ok(struct zsv_select_data *data, const char *input_path,
+                                   const struct zsv_csv_writer_options *writer_opts, char fixed_auto) {
+  struct stat st;
+  if (!input_path || stat(input_path, &st) || !S_ISREG(st.st_mode))
+    return 0;
+  if (data->fixed.count || fixed_auto || data->sample_pct || (writer_opts->with_bom && data->no_header))
+    return 0;
+#ifdef ZSV_EXTRAS
+  if (data->opts->max_rows || data->opts->overwrite.type > zsv_overwrite_type_none)
+    return 0;
+#endif
+  return 1;
+}
+
 int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *opts,
                                struct zsv_prop_handler *custom_prop_handler, const char *opts_used) {
   if (argc > 1 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))) {
@@ -818,6 +1694,9 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
         stat = zsv_printerr(1, "%s option requires parameter", argv[arg_i - 1]);
       else if (writer_opts.stream && writer_opts.stream != stdout)
         stat = zsv_printerr(1, "Output file specified more than once");
+      else if ((writer_opts.compress = zsv_compression_from_filename(argv[arg_i])) &&
+               !zsv_compression_supported(writer_opts.compress))
+        stat = zsv_printerr(1, "Compressed output is not supported by this build: %s", argv[arg_i]);
       else if (!(writer_opts.stream = fopen(argv[arg_i], "wb")))
         stat = zsv_printerr(1, "Unable to open for writing: %s", argv[arg_i]);
       else if (data.opts->verbose)
@@ -826,12 +1705,40 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       data.prepend_line_number = 1;
     } else if (!strcmp(argv[arg_i], "-n"))
       data.use_header_indexes = 1;
+    else if (!strcmp(argv[arg_i], "-i") || !strcmp(argv[arg_i], "--case-insensitive"))
+      data.search_case_insensitive = 1;
     else if (!strcmp(argv[arg_i], "-s") || !strcmp(argv[arg_i], "--search")) {
       arg_i++;
       if (arg_i < argc && strlen(argv[arg_i]))
-        zsv_select_add_search(&data, argv[arg_i]);
+        zsv_select_add_search(&data.search_strings, argv[arg_i], 1);
       else
         stat = zsv_printerr(1, "%s option requires a value", argv[arg_i - 1]);
+    } else if (!strcmp(argv[arg_i], "--where")) {
+      arg_i++;
+      if (arg_i < argc && strlen(argv[arg_i]))
+        stat = zsv_select_add_where(&data, argv[arg_i]);
+      else
+        stat = zsv_printerr(1, "%s option requires a value", argv[arg_i - 1]);
+    } else if (!strcmp(argv[arg_i], "--search-column")) {
+      arg_i++;
+      if (arg_i < argc && strlen(argv[arg_i]))
+        zsv_select_add_search(&data.search_columns, argv[arg_i], 0);
+      else
+        stat = zsv_printerr(1, "%s option requires a value", argv[arg_i - 1]);
+    } else if (!strcmp(argv[arg_i], "--async-output")) {
+      writer_opts.async = 1;
+    } else if (!strcmp(argv[arg_i], "--output-buffer-size")) {
+      long long n = 0;
+      if (++arg_i >= argc || sscanf(argv[arg_i], "%lld", &n) != 1 || n < 1024)
+        stat = zsv_printerr(1, "--output-buffer-size value must be an integer of at least 1024");
+      else
+        writer_opts.output_buffsize = (size_t)n;
+    } else if (!strcmp(argv[arg_i], "--threads")) {
+      int n = 0;
+      if (++arg_i >= argc || sscanf(argv[arg_i], "%d", &n) != 1 || n < 1 || n > ZSV_SELECT_MAX_THREADS)
+        stat = zsv_printerr(1, "--threads value must be an integer between 1 and %i", ZSV_SELECT_MAX_THREADS);
+      else
+        data.threads = (unsigned int)n;
     } else if (!strcmp(argv[arg_i], "-v") || !strcmp(argv[arg_i], "--verbose")) {
       data.verbose = 1;
     } else if (!strcmp(argv[arg_i], "--unescape")) {
@@ -938,6 +1845,13 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
                                                 opts->verbose);
       }
     }
+
+    if (stat == zsv_status_ok && data.threads > 1 &&
+        !zsv_select_parallel_ok(&data, input_path, &writer_opts, fixed_auto)) {
+      if (data.opts->verbose)
+        fprintf(stderr, "Ignoring --threads for this input or these options\n");
+      data.threads = 1;
+    }
   }
 
   if (stat == zsv_status_ok) {
@@ -948,11 +1862,9 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       data.col_argc = argc - col_index_arg_i;
     }
 
-    data.header_names = calloc(data.opts->max_columns, sizeof(*data.header_names));
     assert(data.opts->max_columns > 0);
-    data.out2in = calloc(data.opts->max_columns, sizeof(*data.out2in));
     data.csv_writer = zsv_writer_new(&writer_opts);
-    if (!(data.header_names && data.csv_writer))
+    if (!data.csv_writer)
       stat = zsv_status_memory;
     else {
       data.opts->row_handler = zsv_select_header_row;
@@ -961,7 +1873,17 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
           zsv_status_ok) {
         // all done with
         data.any_clean = !data.no_trim_whitespace || data.clean_white || data.embedded_lineend || data.unescape;
-        ;
+        data.clean_flags = (data.unescape ? ZSV_STRCLEAN_UNESCAPE : 0) |
+                           (data.no_trim_whitespace ? 0 : ZSV_STRCLEAN_TRIM) |
+                           (data.clean_white ? ZSV_STRCLEAN_WHITE : 0) |
+                           (data.whitespace_clean_flags ? ZSV_STRCLEAN_WHITE_NO_NEWLINE : 0) |
+                           (data.embedded_lineend
+                              ? ZSV_STRCLEAN_LINEEND | (data.no_trim_whitespace ? ZSV_STRCLEAN_LINEEND_TRIM : 0)
+                              : 0);
+        if (data.search_strings && (stat = zsv_select_search_compile(&data)) != zsv_status_ok)
+          data.cancelled = 1;
+        if (data.where_expr && (stat = zsv_select_where_compile(&data)) != zsv_status_ok)
+          data.cancelled = 1;
 
         // set to fixed if applicable
         if (data.fixed.count &&
@@ -983,10 +1905,15 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
         if (status == zsv_status_no_more_input)
           status = zsv_finish(data.parser);
         zsv_delete(data.parser);
+        if (data.parallel && !zsv_signal_interrupted && stat == zsv_status_ok)
+          stat = zsv_select_parallel(&data, input_path);
       }
     }
   }
   free(preview_buff);
+  if (data.csv_writer && zsv_writer_delete(data.csv_writer) != zsv_writer_status_ok && stat == zsv_status_ok)
+    stat = zsv_printerr(1, "Error writing output");
+  data.csv_writer = NULL;
   zsv_select_cleanup(&data);
   if (writer_opts.stream && writer_opts.stream != stdout)
     fclose(writer_opts.stream);
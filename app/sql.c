@@ -7,7 +7,9 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
+#include <ctype.h>
 #include <sys/stat.h>
 #include <sqlite3.h>
 
@@ -15,12 +17,24 @@
 #include "zsv_command.h"
 
 #include <zsv/utils/writer.h>
+#include <zsv/utils/num.h>
 #include <zsv/utils/file.h>
 #include <zsv/utils/string.h>
+#include <zsv/utils/cache.h>
+#include <zsv/utils/os.h>
+#include <zsv/utils/pool.h>
 
 #include <unistd.h> // unlink
 
-extern sqlite3_module CsvModule;
+// must not exceed SQLITE_MAX_COLUMN as set in external/sqlite3/sqlite3_and_csv_vtab.c
+#define ZSV_SQL_MAX_COLS 32767
+#define ZSV_SQL_MAX_COLS_S "32767"
+
+#define ZSV_SQL_JOIN_MEMORY_DEFAULT ((size_t)1024 * 1024 * 1024)
+#define ZSV_SQL_INFER_TYPES_ROWS 1000
+#define ZSV_SQL_INFER_TYPES_ROWS_S "1000"
+
+#include "sqlite3_csv_vtab-zsv.h"
 
 #ifndef STRING_LIST
 #define STRING_LIST
@@ -46,16 +60,32 @@ const char *zsv_sql_usage_msg[] = {
   "Loads your CSV file into a table named 'data', then runs your sql, which must start with 'select '.",
   "If multiple files are specified, tables will be named data, data2, data3, ...",
   "",
+  "The select may be preceded by other statements, which are run without output, e.g. to query another",
+  "file with its own parser options:",
+  "  e.g. " APPNAME " file.csv \"create virtual table temp.t using csv(filename='file.txt', delimiter='\\t');",
+  "                 select * from data join t using (id)\"",
+  "where the csv module accepts filename=, max_columns=, delimiter=, header_row_span= and rows_to_ignore=",
+  "",
   "Options:",
   "  --join-indexes <n1...>: specify one or more column names to join multiple files by",
   "                          each n is treated as an index in the first input file that determines a column",
   "                          of the join. For example, if joining two files that, respectively, have columns",
   "                          A,B,C,D and X,B,C,A,Y then `--join-indexes 1,3` will join on columns A and C.",
   "                          When using this option, do not include an sql statement",
+  "  --join-memory <size>  : memory to join in before using temp files, e.g. 500m or 2g (default: 1g)",
   "  -b                    : output with BOM",
-  "  -C,--max-cols <n>     : change the maximum allowable columns. must be > 0 and < 2000",
-  "  -o <filename>         : filename to save output to",
+  "  -C,--max-cols <n>     : change the maximum allowable columns. must be > 0 and <= " ZSV_SQL_MAX_COLS_S,
+  "  -o <filename>         : filename to save output to; compressed if it ends in .gz or .zst",
+  "  --infer-types         : declare a column INTEGER or REAL, instead of TEXT, if all its non-blank values in",
+  "                          the first " ZSV_SQL_INFER_TYPES_ROWS_S " data rows are numbers of that type, so that",
+  "                          they are compared, sorted and aggregated as numbers without conversion",
   "  --memory              : use in-memory instead of temporary db (see https://www.sqlite.org/inmemorydb.html)",
+  "  --cache               : the first time a file is queried, save its parsed data to a database in the file's",
+  "                          " ZSV_CACHE_DIR " cache folder. Later queries use that database instead of parsing",
+  "                          the file again, until the file or the parser options change",
+  "  --cache-index <col>   : with --cache, index column <col> of table 'data'. May be specified more than once",
+  "  --threads <n>         : with --cache, build the caches of multiple inputs in parallel using n threads",
+  "                          (0 = one per processor)",
   NULL,
 };
 
@@ -71,8 +101,12 @@ struct zsv_sql_data {
   char *sql_dynamic;  // will hold contents of sql file, if any
   char *join_indexes; // will hold contents of join_indexes arg, prefixed and suffixed with a comma
   struct string_list *join_column_names;
+  struct string_list *cache_indexes;
+  size_t join_memory;
+  unsigned int threads;
   unsigned char in_memory : 1;
-  unsigned char _ : 7;
+  unsigned char use_cache : 1;
+  unsigned char _ : 6;
 };
 
 static void zsv_sql_finalize(struct zsv_sql_data *data) {
@@ -100,38 +134,336 @@ static void zsv_sql_cleanup(struct zsv_sql_data *data) {
       free(tmp);
     }
   }
+
+  if (data->cache_indexes) {
+    struct string_list *next;
+    for (struct string_list *tmp = data->cache_indexes; tmp; tmp = next) {
+      next = tmp->next;
+      free(tmp);
+    }
+  }
   (void)data;
 }
 
-static int create_virtual_csv_table(const char *fname, sqlite3 *db, const char *opts_used, int max_columns,
-                                    char **err_msg, int table_ix) {
-  // TO DO: set customizable maximum number of columns to prevent
-  // runaway in case no line ends found
-  char *sql = NULL;
-  char table_name_suffix[64];
-
+// table_name: data, data2, data3, ...
+static int zsv_sql_table_name(char *table_name, size_t size, int table_ix) {
   if (table_ix == 0)
-    *table_name_suffix = '\0';
+    snprintf(table_name, size, "data");
   else if (table_ix < 0 || table_ix > 1000)
     return -1;
   else
-    snprintf(table_name_suffix, sizeof(table_name_suffix), "%i", table_ix + 1);
+    snprintf(table_name, size, "data%i", table_ix + 1);
+  return 0;
+}
+
+static int create_virtual_csv_table(const char *fname, sqlite3 *db, const char *opts_used, int max_columns,
+                                    char **err_msg, const char *table_name) {
+  // TO DO: set customizable maximum number of columns to prevent
+  // runaway in case no line ends found
+  char *sql = NULL;
 
   if (max_columns)
-    sql = sqlite3_mprintf("CREATE VIRTUAL TABLE data%s USING csv(filename=%Q,options_used=%Q,max_columns=%i)",
-                          table_name_suffix, fname, opts_used, max_columns);
+    sql = sqlite3_mprintf("CREATE VIRTUAL TABLE %s USING csv(filename=%Q,options_used=%Q,max_columns=%i)", table_name,
+                          fname, opts_used, max_columns);
   else
-    sql = sqlite3_mprintf("CREATE VIRTUAL TABLE data%s USING csv(filename=%Q,options_used=%Q)", table_name_suffix,
-                          fname, opts_used);
+    sql = sqlite3_mprintf("CREATE VIRTUAL TABLE %s USING csv(filename=%Q,options_used=%Q)", table_name, fname,
+                          opts_used);
 
   int rc = sqlite3_exec(db, sql, NULL, NULL, err_msg);
   sqlite3_free(sql);
   return rc;
 }
 
+#include "sql_join.c"
+
+// parse a size such as 65536, 500k, 200m or 2g; return 0 if invalid
+static size_t zsv_sql_parse_size(const char *s) {
+  char *end;
+  unsigned long long n = strtoull(s, &end, 10);
+  if (end == s)
+    return 0;
+  switch (*end) {
+  case 'g':
+  case 'G':
+    n *= 1024;
+    // fall through
+  case 'm':
+  case 'M':
+    n *= 1024;
+    // fall through
+  case 'k':
+  case 'K':
+    n *= 1024;
+    end++;
+    break;
+  }
+  return *end ? 0 : (size_t)n;
+}
+
+static int zsv_sql_execf(sqlite3 *db, char **err_msg, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  char *sql = sqlite3_vmprintf(fmt, args);
+  va_end(args);
+  int rc = sql ? sqlite3_exec(db, sql, NULL, NULL, err_msg) : SQLITE_NOMEM;
+  sqlite3_free(sql);
+  return rc;
+}
+
+#if defined(__APPLE__)
+#define ZSV_SQL_STAT_NSEC(st, t) ((long long)(st).st_##t##timespec.tv_nsec)
+#elif defined(_WIN32)
+#define ZSV_SQL_STAT_NSEC(st, t) 0LL
+#else
+#define ZSV_SQL_STAT_NSEC(st, t) ((long long)(st).st_##t##tim.tv_nsec)
+#endif
+
+/**
+ * Key that a cache database must match to be used: the identity, size and
+ * modification and change times of the file and of its properties (see `zsv
+ * prop`), and the parser and module options. Times include nanoseconds so
+ * that a file rewritten within a second, to the same size, is seen as changed
+ */
+static char *zsv_sql_cache_key(const char *fname, const struct sqlite3_zsv_module_opts *mopts, int max_columns) {
+  const struct zsv_opts *opts = &mopts->parser_opts;
+  struct stat st, props_st;
+  if (stat(fname, &st))
+    return NULL;
+  unsigned char *props_fn = zsv_cache_filepath((const unsigned char *)fname, zsv_cache_type_property, 0, 0);
+  if (!props_fn || stat((const char *)props_fn, &props_st))
+    memset(&props_st, 0, sizeof(props_st));
+  free(props_fn);
+  return sqlite3_mprintf("2;%lld;%lld;%lld.%09lld;%lld.%09lld;%lld;%lld.%09lld;%lld.%09lld;"
+                         "%i;%u;%u;%i;%i;%Q;%u;%u;%i;%i;%i;%lld;%u",
+                         (long long)st.st_ino, (long long)st.st_size, (long long)st.st_mtime, ZSV_SQL_STAT_NSEC(st, m),
+                         (long long)st.st_ctime, ZSV_SQL_STAT_NSEC(st, c), (long long)props_st.st_size,
+                         (long long)props_st.st_mtime, ZSV_SQL_STAT_NSEC(props_st, m), (long long)props_st.st_ctime,
+                         ZSV_SQL_STAT_NSEC(props_st, c), max_columns, opts->max_columns, opts->max_row_size,
+                         opts->delimiter, opts->no_quotes, opts->insert_header_row, opts->header_span,
+                         opts->rows_to_ignore, opts->keep_empty_header_rows, opts->malformed_utf8_replace,
+                         (int)opts->encoding, (long long)opts->max_rows, mopts->infer_types);
+}
+
+// return 1 if the attached database `schema` is a cache with the given key
+static char zsv_sql_cache_matches(sqlite3 *db, const char *schema, const char *key) {
+  char match = 0;
+  sqlite3_stmt *stmt = NULL;
+  char *sql = sqlite3_mprintf("select key from \"%w\".zsv_cache_key", schema);
+  if (sql && sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+    const char *s = (const char *)sqlite3_column_text(stmt, 0);
+    match = s && !strcmp(s, key);
+  }
+  sqlite3_finalize(stmt);
+  sqlite3_free(sql);
+  return match;
+}
+
+// name of the data table in the attached cache database `schema`; caller must sqlite3_free()
+static char *zsv_sql_cache_table(sqlite3 *db, const char *schema) {
+  char *name = NULL;
+  sqlite3_stmt *stmt = NULL;
+  char *sql = sqlite3_mprintf("select name from \"%w\".sqlite_master where type = 'table' and name <> 'zsv_cache_key'",
+                              schema);
+  if (sql && sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+    name = sqlite3_mprintf("%s", sqlite3_column_text(stmt, 0));
+  sqlite3_finalize(stmt);
+  sqlite3_free(sql);
+  return name;
+}
+
+// return 1 if table schema.table_name has the given column
+static char zsv_sql_has_column(sqlite3 *db, const char *schema, const char *table_name, const char *column) {
+  char found = 0;
+  sqlite3_stmt *stmt = NULL;
+  char *sql = sqlite3_mprintf("select 1 from \"%w\".pragma_table_info(%Q) where name = %Q", schema, table_name, column);
+  if (sql && sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+    found = 1;
+  sqlite3_finalize(stmt);
+  sqlite3_free(sql);
+  return found;
+}
+
+/**
+ * Attach the cache database of a file, as schema zsv_cache_<table_name>,
+ * building it first if it does not exist or was built from a different
+ * version of the file or with different options. The cache holds the file's
+ * data in a regular table named table_name, which, since main and temp have no
+ * table of that name, is what the query's unqualified table_name refers to
+ */
+static int create_cached_csv_table(const char *fname, sqlite3 *db, const char *opts_used, int max_columns,
+                                   const struct sqlite3_zsv_module_opts *mopts, char **err_msg,
+                                   const char *table_name) {
+  char schema[80];
+  snprintf(schema, sizeof(schema), "zsv_cache_%s", table_name);
+  char *key = zsv_sql_cache_key(fname, mopts, max_columns);
+  unsigned char *cache_fn = key ? zsv_cache_filepath((const unsigned char *)fname, zsv_cache_type_sql, 1, 0) : NULL;
+  unsigned char *tmp_fn = cache_fn ? zsv_cache_filepath((const unsigned char *)fname, zsv_cache_type_sql, 1, 1) : NULL;
+  int rc = SQLITE_ERROR;
+  if (tmp_fn) {
+    if (zsv_file_exists((const char *)cache_fn) &&
+        (rc = zsv_sql_execf(db, NULL, "attach %Q as \"%w\"", cache_fn, schema)) == SQLITE_OK) {
+      char *cached_table = zsv_sql_cache_matches(db, schema, key) ? zsv_sql_cache_table(db, schema) : NULL;
+      if (!cached_table)
+        rc = SQLITE_ERROR;
+      else if (strcmp(cached_table, table_name)) // cached when the file was a different input, e.g. data2 vs data
+        rc = zsv_sql_execf(db, NULL, "alter table \"%w\".\"%w\" rename to \"%w\"", schema, cached_table, table_name);
+      if (rc != SQLITE_OK)
+        zsv_sql_execf(db, NULL, "detach \"%w\"", schema);
+      sqlite3_free(cached_table);
+    }
+
+    if (rc != SQLITE_OK) { // build the cache in a temp file, then move it into place
+      unlink((const char *)tmp_fn);
+      if ((rc = zsv_sql_execf(db, err_msg, "attach %Q as \"%w\"", tmp_fn, schema)) == SQLITE_OK) {
+        if ((rc = zsv_sql_execf(db, err_msg, "pragma \"%w\".journal_mode = off; pragma \"%w\".synchronous = off",
+                                schema, schema)) == SQLITE_OK &&
+            (rc = create_virtual_csv_table(fname, db, opts_used, max_columns, err_msg, "temp.zsv_cache_source")) ==
+              SQLITE_OK &&
+            (rc = zsv_sql_execf(db, err_msg, "create table \"%w\".\"%w\" as select * from temp.zsv_cache_source",
+                                schema, table_name)) == SQLITE_OK)
+          rc = zsv_sql_execf(db, err_msg, "create table \"%w\".zsv_cache_key(key text); "
+                             "insert into \"%w\".zsv_cache_key values(%Q)", schema, schema, key);
+        zsv_sql_execf(db, NULL, "drop table if exists temp.zsv_cache_source");
+        zsv_sql_execf(db, NULL, "detach \"%w\"", schema);
+        if (rc == SQLITE_OK) {
+          if (zsv_replace_file(tmp_fn, cache_fn))
+            rc = SQLITE_CANTOPEN;
+          else
+            rc = zsv_sql_execf(db, err_msg, "attach %Q as \"%w\"", cache_fn, schema);
+        }
+        if (rc != SQLITE_OK)
+          unlink((const char *)tmp_fn);
+      }
+    }
+  }
+  sqlite3_free(key);
+  free(cache_fn);
+  free(tmp_fn);
+  return rc;
+}
+
+// return 1 if fname is the same file as `first`, or as any input in `more` before `stop`
+static char zsv_sql_earlier_input(const char *fname, const char *first, struct string_list *more,
+                                  struct string_list *stop) {
+  struct stat st, st2;
+  if (stat(fname, &st))
+    return 0;
+  if (!stat(first, &st2) && st.st_dev == st2.st_dev && st.st_ino == st2.st_ino)
+    return 1;
+  for (struct string_list *sl = more; sl && sl != stop; sl = sl->next)
+    if (!stat(sl->value, &st2) && st.st_dev == st2.st_dev && st.st_ino == st2.st_ino)
+      return 1;
+  return 0;
+}
+
+struct zsv_sql_cache_input {
+  const char *fname;
+  const char *opts_used;
+  int max_columns;
+  struct sqlite3_zsv_module_opts *module_opts;
+  char table_name[64];
+};
+
+// pool task: bring the cache of one input up to date, on a connection of its own
+static void zsv_sql_cache_input_run(void *arg) {
+  struct zsv_sql_cache_input *input = arg;
+  sqlite3 *db = NULL;
+  if (sqlite3_open_v2("", &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL) == SQLITE_OK &&
+      sqlite3_create_module(db, "csv", &CsvModule, input->module_opts) == SQLITE_OK)
+    create_cached_csv_table(input->fname, db, input->opts_used, input->max_columns, input->module_opts, NULL,
+                            input->table_name);
+  sqlite3_close(db);
+}
+
+/**
+ * Build the missing or stale caches of multiple inputs in parallel, so that
+ * the inputs are ready in about the time that the largest one takes. The
+ * caches are then attached as usual, which retries any that failed here
+ */
+static void zsv_sql_cache_inputs(const char *first, struct string_list *more, const char *opts_used, int max_columns,
+                                 struct sqlite3_zsv_module_opts *module_opts, unsigned int thread_count) {
+  size_t count = 1;
+  for (struct string_list *sl = more; sl; sl = sl->next)
+    count++;
+  struct zsv_sql_cache_input *inputs = calloc(count, sizeof(*inputs));
+  zsv_pool pool = inputs ? zsv_pool_new(thread_count) : NULL;
+  zsv_pool_group group = pool ? zsv_pool_group_new(pool, 0) : NULL;
+  if (!group)
+    fprintf(stderr, "Unable to start threads; continuing without\n");
+  else {
+    struct string_list *sl = NULL;
+    for (size_t i = 0; i < count; i++) {
+      struct zsv_sql_cache_input *input = &inputs[i];
+      if (i) {
+        sl = sl ? sl->next : more;
+        if (zsv_sql_earlier_input(sl->value, first, more, sl))
+          continue; // repeated inputs are not cached
+      }
+      input->fname = i ? sl->value : first;
+      input->opts_used = opts_used;
+      input->max_columns = max_columns;
+      input->module_opts = module_opts;
+      zsv_sql_table_name(input->table_name, sizeof(input->table_name), (int)i);
+      if (zsv_pool_submit(group, zsv_sql_cache_input_run, NULL, input))
+        break;
+    }
+    zsv_pool_group_delete(group);
+  }
+  zsv_pool_delete(pool);
+  free(inputs);
+}
+
+/**
+ * Create table data, data2, ... for the table_ix-th input file: from the
+ * file's cache if use_cache is set, and else (or if the cache cannot be used)
+ * as a csv virtual table
+ */
+static int create_csv_table(const char *fname, sqlite3 *db, const char *opts_used, int max_columns,
+                            const struct sqlite3_zsv_module_opts *mopts, char use_cache, char **err_msg,
+                            int table_ix) {
+  char table_name[64];
+  if (zsv_sql_table_name(table_name, sizeof(table_name), table_ix))
+    return -1;
+  if (use_cache) {
+    char *cache_err = NULL;
+    if (create_cached_csv_table(fname, db, opts_used, max_columns, mopts, &cache_err, table_name) == SQLITE_OK)
+      return SQLITE_OK;
+    fprintf(stderr, "Unable to use cache for %s%s%s; querying the file directly\n", fname, cache_err ? ": " : "",
+            cache_err ? cache_err : "");
+    sqlite3_free(cache_err);
+  }
+  return create_virtual_csv_table(fname, db, opts_used, max_columns, err_msg, table_name);
+}
+
+static char is_sql_prefix(const char *s, const char *prefix) {
+  return strlen(s) > strlen(prefix) &&
+         !zsv_strincmp((const unsigned char *)prefix, strlen(prefix), (const unsigned char *)s, strlen(prefix));
+}
+
+// sql is a select, optionally preceded by e.g. create virtual table statements
 static char is_select_sql(const char *s) {
-  return strlen(s) > strlen("select ") && !zsv_strincmp((const unsigned char *)"select ", strlen("select "),
-                                                        (const unsigned char *)s, strlen("select "));
+  return is_sql_prefix(s, "select ") || is_sql_prefix(s, "create ");
+}
+
+/**
+ * @return non-zero if s contains anything other than whitespace, semicolons
+ *         and comments, i.e. another statement
+ */
+static char zsv_sql_has_statement(const char *s) {
+  while (*s) {
+    if (isspace((unsigned char)*s) || *s == ';')
+      s++;
+    else if (s[0] == '-' && s[1] == '-')
+      s += strcspn(s, "\n");
+    else if (s[0] == '/' && s[1] == '*') {
+      const char *end = strstr(s + 2, "*/");
+      if (!end)
+        return 0;
+      s = end + 2;
+    } else
+      return 1;
+  }
+  return 0;
 }
 
 int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *opts,
@@ -146,28 +478,27 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
    * For file path and options_used, we will pass as part of the
    * CREATE VIRTUAL TABLE
    * command. For everything else, rather than having to sync all the
-   * CREATE VIRTUAL TABLE options with all the zsv options, we will just use
-   * zsv_set_default_opts() here to effectively pass the options when the sql
-   * module calls zsv_get_default_opts()
+   * CREATE VIRTUAL TABLE options with all the zsv options, we pass them as the
+   * module's client data. This leaves the default options untouched, so that
+   * independent queries can run concurrently in the same process
    */
   int err = 0;
   if (argc < 2 || !strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))
     err = zsv_sql_usage(argc < 2 ? stderr : stdout);
   else {
     struct zsv_sql_data data = {0};
+    data.join_memory = ZSV_SQL_JOIN_MEMORY_DEFAULT;
+    data.threads = 1;
     int max_cols = 0; // TO DO: remove this; use parser_opts.max_columns
     const char *input_filename = NULL;
     const char *my_sql = NULL;
     struct string_list **next_input_filename = &data.more_input_filenames;
 
-    // save current default opts so that we can restore them later
-    struct zsv_opts original_default_opts = zsv_get_default_opts();
-    struct zsv_prop_handler original_default_custom_prop_handler = zsv_get_default_custom_prop_handler();
-
-    // set parser opts that the sql module will get via zsv_get_default_opts()
-    zsv_set_default_opts(*opts);
+    // parser opts that the sql module will get via its client data
+    struct sqlite3_zsv_module_opts module_opts = {0};
+    module_opts.parser_opts = *opts;
     if (custom_prop_handler)
-      zsv_set_default_custom_prop_handler(*custom_prop_handler);
+      module_opts.custom_prop_handler = *custom_prop_handler;
 
     struct zsv_csv_writer_options writer_opts = zsv_writer_get_default_opts();
     int err = 0;
@@ -203,6 +534,16 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
               fprintf(stderr, "--join-indexes index values must be greater than zero\n"), err = 1;
           }
         }
+      } else if (!strcmp(arg, "--threads")) {
+        if (!(++arg_i < argc) || zsv_pool_threads_arg(argv[arg_i], &data.threads)) {
+          fprintf(stderr, "%s option requires a number of threads (0 for one per processor)\n", arg);
+          err = 1;
+        }
+      } else if (!strcmp(arg, "--join-memory")) {
+        if (!(++arg_i < argc) || !(data.join_memory = zsv_sql_parse_size(argv[arg_i]))) {
+          fprintf(stderr, "%s option requires a size, e.g. 500m or 2g\n", arg);
+          err = 1;
+        }
       } else if (!my_sql && ((*arg == '@' && arg[1]) || is_select_sql(arg))) {
         if (is_select_sql(arg))
           my_sql = arg;
@@ -234,19 +575,41 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
         if (!(++arg_i < argc)) {
           fprintf(stderr, "option %s requires a filename\n", arg);
           err = 1;
+        } else if ((writer_opts.compress = zsv_compression_from_filename(argv[arg_i])) &&
+                   !zsv_compression_supported(writer_opts.compress)) {
+          fprintf(stderr, "Compressed output is not supported by this build: %s\n", argv[arg_i]);
+          err = 1;
         } else if (!(writer_opts.stream = fopen(argv[arg_i], "wb"))) {
           fprintf(stderr, "Could not open for writing: %s\n", argv[arg_i]);
           err = 1;
         }
       } else if (!strcmp(arg, "--memory"))
         data.in_memory = 1;
+      else if (!strcmp(arg, "--infer-types"))
+        module_opts.infer_types = ZSV_SQL_INFER_TYPES_ROWS;
+      else if (!strcmp(arg, "--cache"))
+        data.use_cache = 1;
+      else if (!strcmp(arg, "--cache-index")) {
+        struct string_list *tmp;
+        if (!(++arg_i < argc)) {
+          fprintf(stderr, "%s option requires a column name\n", arg);
+          err = 1;
+        } else if (!(tmp = calloc(1, sizeof(*tmp)))) {
+          fprintf(stderr, "Out of memory!\n");
+          err = 1;
+        } else {
+          tmp->value = (char *)argv[arg_i];
+          tmp->next = data.cache_indexes;
+          data.cache_indexes = tmp;
+        }
+      }
       else if (!strcmp(arg, "-b"))
         writer_opts.with_bom = 1;
       else if (!strcmp(arg, "-C") || !strcmp(arg, "--max-cols")) {
-        if (arg_i + 1 < argc && atoi(argv[arg_i + 1]) > 0 && atoi(argv[arg_i + 1]) <= 2000)
+        if (arg_i + 1 < argc && atoi(argv[arg_i + 1]) > 0 && atoi(argv[arg_i + 1]) <= ZSV_SQL_MAX_COLS)
           max_cols = atoi(argv[++arg_i]);
         else {
-          fprintf(stderr, "maximum columns value not provided or not between 0 and 2000\n");
+          fprintf(stderr, "maximum columns value not provided or not between 0 and %i\n", ZSV_SQL_MAX_COLS);
           err = 1;
         }
       } else if (*arg != '-') {
@@ -293,12 +656,13 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       err = 1;
     }
 
+    if (data.cache_indexes && !data.use_cache) {
+      fprintf(stderr, "--cache-index requires --cache\n");
+      err = 1;
+    }
+
     if (err) {
       zsv_sql_cleanup(&data);
-      if (custom_prop_handler) {
-        zsv_set_default_opts(original_default_opts); // restore default options
-        zsv_set_default_custom_prop_handler(original_default_custom_prop_handler);
-      }
       return 1;
     }
 
@@ -347,16 +711,39 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
 
       char *err_msg = NULL;
       const char *db_url = data.in_memory ? "file::memory:" : "";
-      if ((rc = sqlite3_open_v2(db_url, &db, SQLITE_OPEN_URI | SQLITE_OPEN_READWRITE, NULL)) == SQLITE_OK && db &&
-          (rc = sqlite3_create_module(db, "csv", &CsvModule, 0) == SQLITE_OK) &&
-          (rc = create_virtual_csv_table(tmpfn ? tmpfn : input_filename, db, opts_used, max_cols, &err_msg, 0)) ==
-            SQLITE_OK) {
+      // databases attached by --cache are opened with the same flags
+      int open_flags = SQLITE_OPEN_URI | SQLITE_OPEN_READWRITE | (data.use_cache ? SQLITE_OPEN_CREATE : 0);
+      if (data.use_cache && !tmpfn && data.more_input_filenames && data.threads != 1)
+        zsv_sql_cache_inputs(input_filename, data.more_input_filenames, opts_used, max_cols, &module_opts,
+                             data.threads);
+      if ((rc = sqlite3_open_v2(db_url, &db, open_flags, NULL)) == SQLITE_OK && db &&
+          (rc = sqlite3_create_module(db, "csv", &CsvModule, &module_opts) == SQLITE_OK) &&
+          (rc = create_csv_table(tmpfn ? tmpfn : input_filename, db, opts_used, max_cols, &module_opts,
+                                 data.use_cache && !tmpfn, &err_msg, 0)) == SQLITE_OK) {
         int i = 1;
-        for (struct string_list *sl = data.more_input_filenames; sl; sl = sl->next)
-          if (create_virtual_csv_table(sl->value, db, opts_used, max_cols, &err_msg, i++) != SQLITE_OK)
+        for (struct string_list *sl = data.more_input_filenames; sl; sl = sl->next) {
+          // a repeated input would share, and rename, the cache of its first occurrence
+          char use_cache = data.use_cache &&
+                           !zsv_sql_earlier_input(sl->value, input_filename, data.more_input_filenames, sl);
+          if (create_csv_table(sl->value, db, opts_used, max_cols, &module_opts, use_cache, &err_msg,
+                               i++) != SQLITE_OK)
             rc = SQLITE_ERROR;
+        }
+
+        // indexes are saved in the cache, so are only built the first time they are used
+        if (sqlite3_db_filename(db, "zsv_cache_data")) {
+          for (struct string_list *sl = data.cache_indexes; rc == SQLITE_OK && sl; sl = sl->next) {
+            if (!zsv_sql_has_column(db, "zsv_cache_data", "data", sl->value))
+              fprintf(stderr, "Column not found: %s\n", sl->value), rc = SQLITE_ERROR;
+            else
+              rc = zsv_sql_execf(db, &err_msg, "create index if not exists zsv_cache_data.\"data_%w\" on data(\"%w\")",
+                                 sl->value, sl->value);
+          }
+        }
       }
 
+      // without a sql statement, the join sql is run as a hash join (see sql_join.c)
+      const char hash_join = data.join_indexes && !my_sql;
       if (data.join_indexes) { // get column names, and construct the sql
         // sql template:
         // select t1.*, t2.*, t3.* from t1 left join (select * from t2 group by a) t2 left join (select * from t3 group
@@ -458,11 +845,33 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
           sqlite3_finalize(stmt);
       }
 
+      if (rc == SQLITE_OK && !err && hash_join) {
+        size_t input_count = 1;
+        for (struct string_list *sl = data.more_input_filenames; sl; sl = sl->next)
+          input_count++;
+        int join_rc = zsv_sql_hash_join(db, input_count, data.join_column_names, cw, data.join_memory);
+        if (join_rc != -1) { // else, run the sql instead
+          rc = join_rc;
+          my_sql = NULL;
+        }
+      }
+
       if (rc == SQLITE_OK && !err && my_sql) {
-        sqlite3_stmt *stmt;
-        err = sqlite3_prepare_v2(db, my_sql, -1, &stmt, NULL);
+        // statements before the last, e.g. to create a csv virtual table with its own
+        // delimiter= or other options, are run without output
+        sqlite3_stmt *stmt = NULL;
+        const char *sql_tail = my_sql;
+        while ((err = sqlite3_prepare_v2(db, sql_tail, -1, &stmt, &sql_tail)) == SQLITE_OK && stmt &&
+               zsv_sql_has_statement(sql_tail)) {
+          while ((err = sqlite3_step(stmt)) == SQLITE_ROW)
+            ;
+          sqlite3_finalize(stmt);
+          stmt = NULL;
+          if (err != SQLITE_DONE)
+            break;
+        }
         if (err != SQLITE_OK)
-          fprintf(stderr, "%s:\n  %s\n (or bad CSV/utf8 input)\n\n", sqlite3_errstr(err), my_sql);
+          fprintf(stderr, "%s:\n  %s\n (or bad CSV/utf8 input)\n\n", sqlite3_errmsg(db), my_sql);
         else {
           int col_count = sqlite3_column_count(stmt);
 
@@ -474,6 +883,11 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
 
           while (sqlite3_step(stmt) == SQLITE_ROW) {
             for (int i = 0; i < col_count; i++) {
+              if (sqlite3_column_type(stmt, i) == SQLITE_FLOAT) {
+                // shortest round-trip text, rather than sqlite's %!.15g
+                zsv_writer_cell_dbl(cw, !i, sqlite3_column_double(stmt, i));
+                continue;
+              }
               const unsigned char *text = sqlite3_column_text(stmt, i);
               int len = text ? sqlite3_column_bytes(stmt, i) : 0;
               zsv_writer_cell(cw, !i, text, len, 1);
@@ -507,9 +921,6 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       unlink(tmpfn);
       free(tmpfn);
     }
-    zsv_set_default_opts(original_default_opts); // restore default options
-    if (custom_prop_handler)
-      zsv_set_default_custom_prop_handler(original_default_custom_prop_handler);
   }
   return err;
 }
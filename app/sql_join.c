@@ -0,0 +1,544 @@
+/**
+ * Hash join for --join-indexes, when no sql statement is given
+ *
+ * The output is the same as that of the sql that --join-indexes otherwise runs:
+ *   select data.*, data2.*, ... from data
+ *     left join (select * from data2 group by <join columns>) data2 using (<join columns>) ...
+ * i.e. each row of data, in order, followed by the first row of each other
+ * input whose join columns equal those of the data row, or by NULLs if there
+ * is no such row
+ *
+ * Because only the first row per key of each other input is used, those are
+ * the inputs that are kept in memory, in one hash table each, and data is
+ * streamed against them. Rows are kept in an arena, serialized as a list of
+ * cells, each a 32-bit length (ZSV_SQL_JOIN_NULL for NULL) followed by the
+ * cell's bytes. In the join columns, the bytes start with a ZSV_SQL_JOIN_KEY_*
+ * tag, and a number is stored by value, so that as in sql, e.g. 1 and 1.0 are
+ * the same key
+ *
+ * If the hash tables outgrow the memory limit, all inputs are instead split
+ * by key hash into ZSV_SQL_JOIN_PARTITIONS temp files. Each partition is then
+ * joined in memory in turn, and since each partition's output is in the
+ * order of the data rows, the outputs are merged by data row number
+ */
+
+#define ZSV_SQL_JOIN_PARTITIONS 64
+// the low bits of the hash pick the bucket, so the high bits pick the partition
+#define ZSV_SQL_JOIN_PARTITION(hash) ((size_t)((hash) >> 58))
+#define ZSV_SQL_JOIN_ARENA_BLOCK_SIZE (1024 * 1024)
+#define ZSV_SQL_JOIN_NULL UINT32_MAX
+#define ZSV_SQL_JOIN_KEY_TEXT 't'
+#define ZSV_SQL_JOIN_KEY_INTEGER 'i'
+#define ZSV_SQL_JOIN_KEY_REAL 'r'
+
+struct zsv_sql_join_arena_block {
+  struct zsv_sql_join_arena_block *next;
+  size_t used;
+  size_t size;
+  unsigned char data[];
+};
+
+struct zsv_sql_join_entry {
+  struct zsv_sql_join_entry *next; // next entry in the same bucket
+  uint64_t hash;
+  uint32_t key_len;
+  uint32_t row_len;
+  unsigned char data[]; // serialized join column cells, then serialized row cells
+};
+
+struct zsv_sql_join_table {
+  sqlite3_stmt *stmt; // select * from data, data2, ...
+  int col_count;
+  int *key_ix; // index of each join column
+  struct zsv_sql_join_entry **buckets;
+  size_t bucket_count; // power of 2
+  size_t count;
+};
+
+/**
+ * Partition files hold records, each a header followed by key_len + row_len
+ * bytes of serialized cells. `id` is the table index for rows of the joined
+ * inputs, and the data row number for data rows and output rows
+ */
+struct zsv_sql_join_record {
+  uint64_t id;
+  uint64_t hash;
+  uint32_t key_len;
+  uint32_t row_len;
+};
+
+struct zsv_sql_join {
+  zsv_csv_writer cw;
+  size_t max_memory;
+  size_t memory; // bytes used by arena blocks and buckets
+
+  struct zsv_sql_join_table *tables; // [0] is data
+  size_t table_count;
+  struct zsv_sql_join_entry **matches; // match in each table for the current data row
+  size_t key_count;
+
+  struct zsv_sql_join_arena_block *arena;
+
+  unsigned char *buff; // scratch buffer for serialized rows
+  size_t buff_used;
+  size_t buff_size;
+
+  // with spill set, all rows go to partition files
+  FILE *right[ZSV_SQL_JOIN_PARTITIONS]; // rows of data2, data3, ...
+  FILE *left[ZSV_SQL_JOIN_PARTITIONS];  // rows of data
+  FILE *out[ZSV_SQL_JOIN_PARTITIONS];   // joined rows
+  unsigned char spill : 1;
+  unsigned char _ : 7;
+  int rc;
+};
+
+static void *zsv_sql_join_alloc(struct zsv_sql_join *j, size_t n) {
+  n = (n + 7) & ~(size_t)7;
+  struct zsv_sql_join_arena_block *b = j->arena;
+  if (!b || b->size - b->used < n) {
+    size_t size = n > ZSV_SQL_JOIN_ARENA_BLOCK_SIZE ? n : ZSV_SQL_JOIN_ARENA_BLOCK_SIZE;
+    if (!(b = malloc(sizeof(*b) + size)))
+      return NULL;
+    b->next = j->arena;
+    b->used = 0;
+    b->size = size;
+    j->arena = b;
+    j->memory += sizeof(*b) + size;
+  }
+  void *p = b->data + b->used;
+  b->used += n;
+  return p;
+}
+
+// free all hash table entries
+static void zsv_sql_join_clear(struct zsv_sql_join *j) {
+  for (struct zsv_sql_join_arena_block *next, *b = j->arena; b; b = next) {
+    next = b->next;
+    free(b);
+  }
+  j->arena = NULL;
+  for (size_t t = 0; t < j->table_count; t++) {
+    free(j->tables[t].buckets);
+    j->tables[t].buckets = NULL;
+    j->tables[t].bucket_count = j->tables[t].count = 0;
+  }
+  j->memory = 0;
+}
+
+static int zsv_sql_join_append(struct zsv_sql_join *j, const void *s, size_t len) {
+  if (j->buff_used + len > j->buff_size) {
+    size_t size = j->buff_size ? j->buff_size : 4096;
+    while (size < j->buff_used + len)
+      size *= 2;
+    unsigned char *buff = realloc(j->buff, size);
+    if (!buff)
+      return j->rc = SQLITE_NOMEM;
+    j->buff = buff;
+    j->buff_size = size;
+  }
+  memcpy(j->buff + j->buff_used, s, len);
+  j->buff_used += len;
+  return SQLITE_OK;
+}
+
+// append a serialized join column cell to j->buff; return 1 if the cell is NULL
+static char zsv_sql_join_append_key_cell(struct zsv_sql_join *j, sqlite3_stmt *stmt, int i) {
+  unsigned char number[1 + sizeof(sqlite3_int64)];
+  uint32_t len;
+  int type = sqlite3_column_type(stmt, i);
+  switch (type) {
+  case SQLITE_NULL:
+    len = ZSV_SQL_JOIN_NULL;
+    zsv_sql_join_append(j, &len, sizeof(len));
+    return 1;
+  case SQLITE_INTEGER:
+  case SQLITE_FLOAT: {
+    sqlite3_int64 n = type == SQLITE_INTEGER ? sqlite3_column_int64(stmt, i) : 0;
+    double d = type == SQLITE_FLOAT ? sqlite3_column_double(stmt, i) : 0;
+    // a real with an integer value is the same key as that integer
+    if (type == SQLITE_FLOAT && d >= -9223372036854775808.0 && d < 9223372036854775808.0 &&
+        (double)(sqlite3_int64)d == d)
+      n = (sqlite3_int64)d, type = SQLITE_INTEGER;
+    number[0] = type == SQLITE_INTEGER ? ZSV_SQL_JOIN_KEY_INTEGER : ZSV_SQL_JOIN_KEY_REAL;
+    if (type == SQLITE_INTEGER)
+      memcpy(number + 1, &n, sizeof(n));
+    else
+      memcpy(number + 1, &d, sizeof(d));
+    len = sizeof(number);
+    zsv_sql_join_append(j, &len, sizeof(len));
+    zsv_sql_join_append(j, number, len);
+    return 0;
+  }
+  default: {
+    const unsigned char *text = sqlite3_column_text(stmt, i);
+    unsigned char tag = ZSV_SQL_JOIN_KEY_TEXT;
+    len = 1 + (uint32_t)sqlite3_column_bytes(stmt, i);
+    zsv_sql_join_append(j, &len, sizeof(len));
+    zsv_sql_join_append(j, &tag, 1);
+    if (text)
+      zsv_sql_join_append(j, text, len - 1);
+    return 0;
+  }
+  }
+}
+
+// append a serialized cell to j->buff
+static void zsv_sql_join_append_cell(struct zsv_sql_join *j, sqlite3_stmt *stmt, int i) {
+  if (sqlite3_column_type(stmt, i) == SQLITE_FLOAT) {
+    // same text as zsv_writer_cell_dbl() writes for the sql output
+    char number[ZSV_NUM_BUFF_SIZE];
+    uint32_t len = (uint32_t)zsv_dtoa(sqlite3_column_double(stmt, i), number);
+    zsv_sql_join_append(j, &len, sizeof(len));
+    zsv_sql_join_append(j, number, len);
+    return;
+  }
+  const unsigned char *text = sqlite3_column_text(stmt, i);
+  uint32_t len = text ? (uint32_t)sqlite3_column_bytes(stmt, i) : ZSV_SQL_JOIN_NULL;
+  zsv_sql_join_append(j, &len, sizeof(len));
+  if (text)
+    zsv_sql_join_append(j, text, len);
+}
+
+/**
+ * Serialize the current row of table t into j->buff: its join columns, then
+ * all its columns
+ * @return 1 if any join column is NULL, in which case the row matches no other
+ */
+static char zsv_sql_join_serialize(struct zsv_sql_join *j, size_t t, struct zsv_sql_join_record *r) {
+  struct zsv_sql_join_table *table = &j->tables[t];
+  char null_key = 0;
+  j->buff_used = 0;
+  for (size_t k = 0; k < j->key_count; k++)
+    null_key |= zsv_sql_join_append_key_cell(j, table->stmt, table->key_ix[k]);
+  r->key_len = (uint32_t)j->buff_used;
+  for (int i = 0; i < table->col_count; i++)
+    zsv_sql_join_append_cell(j, table->stmt, i);
+  r->row_len = (uint32_t)(j->buff_used - r->key_len);
+  r->hash = zsv_hash_bytes(j->buff, r->key_len, 0, 0);
+  return null_key;
+}
+
+static struct zsv_sql_join_entry *zsv_sql_join_find(struct zsv_sql_join_table *table, uint64_t hash,
+                                                    const unsigned char *key, uint32_t key_len) {
+  if (!table->bucket_count)
+    return NULL;
+  for (struct zsv_sql_join_entry *e = table->buckets[hash & (table->bucket_count - 1)]; e; e = e->next)
+    if (e->hash == hash && e->key_len == key_len && !memcmp(e->data, key, key_len))
+      return e;
+  return NULL;
+}
+
+// add a row to table t, unless the table already has a row with the same key
+static int zsv_sql_join_insert(struct zsv_sql_join *j, size_t t, const struct zsv_sql_join_record *r,
+                               const unsigned char *data) {
+  struct zsv_sql_join_table *table = &j->tables[t];
+  if (zsv_sql_join_find(table, r->hash, data, r->key_len))
+    return SQLITE_OK;
+
+  if (table->count >= table->bucket_count) { // grow and rehash
+    size_t bucket_count = table->bucket_count ? table->bucket_count * 2 : 1024;
+    struct zsv_sql_join_entry **buckets = calloc(bucket_count, sizeof(*buckets));
+    if (!buckets)
+      return j->rc = SQLITE_NOMEM;
+    for (size_t i = 0; i < table->bucket_count; i++) {
+      for (struct zsv_sql_join_entry *next, *e = table->buckets[i]; e; e = next) {
+        next = e->next;
+        e->next = buckets[e->hash & (bucket_count - 1)];
+        buckets[e->hash & (bucket_count - 1)] = e;
+      }
+    }
+    free(table->buckets);
+    j->memory += (bucket_count - table->bucket_count) * sizeof(*buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+  }
+
+  struct zsv_sql_join_entry *e = zsv_sql_join_alloc(j, sizeof(*e) + r->key_len + r->row_len);
+  if (!e)
+    return j->rc = SQLITE_NOMEM;
+  e->hash = r->hash;
+  e->key_len = r->key_len;
+  e->row_len = r->row_len;
+  memcpy(e->data, data, r->key_len + r->row_len);
+  e->next = table->buckets[r->hash & (table->bucket_count - 1)];
+  table->buckets[r->hash & (table->bucket_count - 1)] = e;
+  table->count++;
+  return SQLITE_OK;
+}
+
+static int zsv_sql_join_write_record(struct zsv_sql_join *j, FILE *f, const struct zsv_sql_join_record *r,
+                                     const void *data) {
+  if (fwrite(r, sizeof(*r), 1, f) != 1 || (r->key_len + r->row_len && fwrite(data, r->key_len + r->row_len, 1, f) != 1))
+    return j->rc = SQLITE_IOERR;
+  return SQLITE_OK;
+}
+
+// read the data of a record whose header has been read into j->buff
+static int zsv_sql_join_read_record_data(struct zsv_sql_join *j, FILE *f, const struct zsv_sql_join_record *r) {
+  size_t len = (size_t)r->key_len + r->row_len;
+  if (len > j->buff_size) {
+    unsigned char *buff = realloc(j->buff, len);
+    if (!buff)
+      return j->rc = SQLITE_NOMEM;
+    j->buff = buff;
+    j->buff_size = len;
+  }
+  j->buff_used = len;
+  if (len && fread(j->buff, len, 1, f) != 1)
+    return j->rc = SQLITE_IOERR;
+  return SQLITE_OK;
+}
+
+// read the next record of f into j->buff; return 1 if a record was read
+static char zsv_sql_join_read_record(struct zsv_sql_join *j, FILE *f, struct zsv_sql_join_record *r) {
+  return fread(r, sizeof(*r), 1, f) == 1 && !zsv_sql_join_read_record_data(j, f, r);
+}
+
+// return 1 if any cell of a serialized key is NULL
+static char zsv_sql_join_null_key(const unsigned char *key, uint32_t key_len) {
+  for (const unsigned char *end = key + key_len; key < end;) {
+    uint32_t cell_len;
+    memcpy(&cell_len, key, sizeof(cell_len));
+    if (cell_len == ZSV_SQL_JOIN_NULL)
+      return 1;
+    key += sizeof(cell_len) + cell_len;
+  }
+  return 0;
+}
+
+// switch to partitioned mode: move the rows in memory to the partition files
+static int zsv_sql_join_spill(struct zsv_sql_join *j) {
+  for (size_t p = 0; p < ZSV_SQL_JOIN_PARTITIONS; p++)
+    if (!(j->right[p] = tmpfile()) || !(j->left[p] = tmpfile()) || !(j->out[p] = tmpfile()))
+      return j->rc = SQLITE_CANTOPEN;
+  j->spill = 1;
+  for (size_t t = 1; t < j->table_count && !j->rc; t++) {
+    struct zsv_sql_join_table *table = &j->tables[t];
+    for (size_t i = 0; i < table->bucket_count; i++) {
+      for (struct zsv_sql_join_entry *e = table->buckets[i]; e && !j->rc; e = e->next) {
+        struct zsv_sql_join_record r = {t, e->hash, e->key_len, e->row_len};
+        zsv_sql_join_write_record(j, j->right[ZSV_SQL_JOIN_PARTITION(e->hash)], &r, e->data);
+      }
+    }
+  }
+  zsv_sql_join_clear(j);
+  return j->rc;
+}
+
+// load the rows of the joined inputs
+static int zsv_sql_join_build(struct zsv_sql_join *j) {
+  for (size_t t = 1; t < j->table_count && !j->rc; t++) {
+    struct zsv_sql_join_table *table = &j->tables[t];
+    while (!j->rc && sqlite3_step(table->stmt) == SQLITE_ROW) {
+      struct zsv_sql_join_record r = {t, 0, 0, 0};
+      if (zsv_sql_join_serialize(j, t, &r) || j->rc)
+        continue; // a NULL key never matches
+      if (j->spill)
+        zsv_sql_join_write_record(j, j->right[ZSV_SQL_JOIN_PARTITION(r.hash)], &r, j->buff);
+      else if (!zsv_sql_join_insert(j, t, &r, j->buff) && j->memory > j->max_memory)
+        zsv_sql_join_spill(j);
+    }
+  }
+  return j->rc;
+}
+
+// write serialized cells as the next cells of the output row
+static void zsv_sql_join_write_cells(struct zsv_sql_join *j, const unsigned char *s, size_t len, char new_row) {
+  for (const unsigned char *end = s + len; s < end; new_row = 0) {
+    uint32_t cell_len;
+    memcpy(&cell_len, s, sizeof(cell_len));
+    s += sizeof(cell_len);
+    if (cell_len == ZSV_SQL_JOIN_NULL)
+      zsv_writer_cell(j->cw, new_row, NULL, 0, 1);
+    else {
+      zsv_writer_cell(j->cw, new_row, s, cell_len, 1);
+      s += cell_len;
+    }
+  }
+}
+
+/**
+ * Join a data row, serialized in j->buff, with its matches, and write the
+ * result to the output, or if out is not NULL, to out
+ */
+static int zsv_sql_join_probe(struct zsv_sql_join *j, const struct zsv_sql_join_record *r, char null_key, FILE *out) {
+  const unsigned char *key = j->buff;
+  const unsigned char *row = j->buff + r->key_len;
+  struct zsv_sql_join_entry **matches = j->matches;
+  struct zsv_sql_join_record out_r = {r->id, 0, 0, r->row_len};
+  for (size_t t = 1; t < j->table_count; t++) {
+    matches[t] = null_key ? NULL : zsv_sql_join_find(&j->tables[t], r->hash, key, r->key_len);
+    out_r.row_len +=
+      matches[t] ? matches[t]->row_len : (uint32_t)j->tables[t].col_count * (uint32_t)sizeof(uint32_t);
+  }
+
+  static const uint32_t null_cell = ZSV_SQL_JOIN_NULL;
+  if (!out) {
+    zsv_sql_join_write_cells(j, row, r->row_len, 1);
+    for (size_t t = 1; t < j->table_count; t++) {
+      if (matches[t])
+        zsv_sql_join_write_cells(j, matches[t]->data + matches[t]->key_len, matches[t]->row_len, 0);
+      else
+        for (int i = 0; i < j->tables[t].col_count; i++)
+          zsv_writer_cell(j->cw, 0, NULL, 0, 1);
+    }
+    return SQLITE_OK;
+  }
+
+  if (fwrite(&out_r, sizeof(out_r), 1, out) != 1 || (r->row_len && fwrite(row, r->row_len, 1, out) != 1))
+    return j->rc = SQLITE_IOERR;
+  for (size_t t = 1; t < j->table_count; t++) {
+    if (matches[t]) {
+      if (fwrite(matches[t]->data + matches[t]->key_len, matches[t]->row_len, 1, out) != 1)
+        return j->rc = SQLITE_IOERR;
+    } else
+      for (int i = 0; i < j->tables[t].col_count; i++)
+        if (fwrite(&null_cell, sizeof(null_cell), 1, out) != 1)
+          return j->rc = SQLITE_IOERR;
+  }
+  return SQLITE_OK;
+}
+
+// join each partition, then merge the results by data row number
+static int zsv_sql_join_partitions(struct zsv_sql_join *j) {
+  struct zsv_sql_join_record r;
+  for (size_t p = 0; p < ZSV_SQL_JOIN_PARTITIONS && !j->rc; p++) {
+    rewind(j->right[p]);
+    while (!j->rc && zsv_sql_join_read_record(j, j->right[p], &r))
+      zsv_sql_join_insert(j, (size_t)r.id, &r, j->buff);
+    rewind(j->left[p]);
+    while (!j->rc && zsv_sql_join_read_record(j, j->left[p], &r))
+      zsv_sql_join_probe(j, &r, zsv_sql_join_null_key(j->buff, r.key_len), j->out[p]);
+    zsv_sql_join_clear(j);
+    fclose(j->right[p]);
+    fclose(j->left[p]);
+    j->right[p] = j->left[p] = NULL;
+  }
+
+  // merge: each step writes the next row of the partition with the lowest row number
+  struct zsv_sql_join_record next[ZSV_SQL_JOIN_PARTITIONS];
+  for (size_t p = 0; p < ZSV_SQL_JOIN_PARTITIONS && !j->rc; p++) {
+    rewind(j->out[p]);
+    if (fread(&next[p], sizeof(next[p]), 1, j->out[p]) != 1)
+      next[p].id = UINT64_MAX;
+  }
+  while (!j->rc) {
+    size_t min_p = 0;
+    for (size_t p = 1; p < ZSV_SQL_JOIN_PARTITIONS; p++)
+      if (next[p].id < next[min_p].id)
+        min_p = p;
+    if (next[min_p].id == UINT64_MAX || zsv_sql_join_read_record_data(j, j->out[min_p], &next[min_p]))
+      break;
+    zsv_sql_join_write_cells(j, j->buff, next[min_p].row_len, 1);
+    if (fread(&next[min_p], sizeof(next[min_p]), 1, j->out[min_p]) != 1)
+      next[min_p].id = UINT64_MAX;
+  }
+  return j->rc;
+}
+
+/**
+ * Return 1 if a column declared with type decltype has INTEGER, REAL or NUMERIC
+ * affinity (see https://www.sqlite.org/datatype3.html#determination_of_column_affinity)
+ */
+static char zsv_sql_join_numeric_affinity(const char *decltype) {
+  if (!decltype || !*decltype)
+    return 0;
+  if (sqlite3_strlike("%INT%", decltype, 0) == 0)
+    return 1;
+  return sqlite3_strlike("%CHAR%", decltype, 0) && sqlite3_strlike("%CLOB%", decltype, 0) &&
+         sqlite3_strlike("%TEXT%", decltype, 0) && sqlite3_strlike("%BLOB%", decltype, 0);
+}
+
+/**
+ * Run the join of data with data2, data3, ... on the given columns
+ * @return SQLITE_OK on success, -1 if the inputs cannot be joined this way
+ *         (e.g. a join column is not in every input, or is numeric in one input
+ *         and text in another, so that sql would convert the text to compare it),
+ *         else a sqlite3 error code
+ */
+static int zsv_sql_hash_join(sqlite3 *db, size_t input_count, struct string_list *join_column_names,
+                             zsv_csv_writer cw, size_t max_memory) {
+  struct zsv_sql_join j = {0};
+  j.cw = cw;
+  j.max_memory = max_memory;
+  for (struct string_list *sl = join_column_names; sl; sl = sl->next)
+    j.key_count++;
+  if (!j.key_count || !(j.tables = calloc(input_count, sizeof(*j.tables))) ||
+      !(j.matches = calloc(input_count, sizeof(*j.matches)))) {
+    free(j.tables);
+    return -1;
+  }
+  j.table_count = input_count;
+
+  // prepare `select * from dataN` for each input, and find its join columns
+  for (size_t t = 0; t < j.table_count && !j.rc; t++) {
+    struct zsv_sql_join_table *table = &j.tables[t];
+    char *sql = t ? sqlite3_mprintf("select * from data%i", (int)t + 1) : sqlite3_mprintf("select * from data");
+    if (!sql || sqlite3_prepare_v2(db, sql, -1, &table->stmt, NULL) != SQLITE_OK ||
+        !(table->key_ix = calloc(j.key_count, sizeof(*table->key_ix))))
+      j.rc = -1;
+    sqlite3_free(sql);
+    if (j.rc)
+      break;
+    table->col_count = sqlite3_column_count(table->stmt);
+    size_t k = 0;
+    for (struct string_list *sl = join_column_names; sl; sl = sl->next, k++) {
+      int i = 0;
+      while (i < table->col_count && sqlite3_stricmp(sqlite3_column_name(table->stmt, i), sl->value))
+        i++;
+      if (i == table->col_count) {
+        j.rc = -1;
+        break;
+      }
+      table->key_ix[k] = i;
+      if (t && zsv_sql_join_numeric_affinity(sqlite3_column_decltype(table->stmt, i)) !=
+                 zsv_sql_join_numeric_affinity(sqlite3_column_decltype(j.tables[0].stmt, j.tables[0].key_ix[k]))) {
+        j.rc = -1;
+        break;
+      }
+    }
+  }
+
+  if (!j.rc && !zsv_sql_join_build(&j)) {
+    // write header row
+    for (size_t t = 0; t < j.table_count; t++) {
+      for (int i = 0; i < j.tables[t].col_count; i++) {
+        const char *colname = sqlite3_column_name(j.tables[t].stmt, i);
+        zsv_writer_cell(cw, !t && !i, (const unsigned char *)colname, colname ? strlen(colname) : 0, 1);
+      }
+    }
+
+    struct zsv_sql_join_record r = {0, 0, 0, 0};
+    while (!j.rc && sqlite3_step(j.tables[0].stmt) == SQLITE_ROW) {
+      char null_key = zsv_sql_join_serialize(&j, 0, &r);
+      if (j.rc)
+        break;
+      if (j.spill)
+        zsv_sql_join_write_record(&j, j.left[ZSV_SQL_JOIN_PARTITION(r.hash)], &r, j.buff);
+      else
+        zsv_sql_join_probe(&j, &r, null_key, NULL);
+      r.id++;
+    }
+    if (j.spill && !j.rc)
+      zsv_sql_join_partitions(&j);
+  }
+
+  int rc = j.rc;
+  zsv_sql_join_clear(&j);
+  for (size_t p = 0; p < ZSV_SQL_JOIN_PARTITIONS; p++) {
+    if (j.right[p])
+      fclose(j.right[p]);
+    if (j.left[p])
+      fclose(j.left[p]);
+    if (j.out[p])
+      fclose(j.out[p]);
+  }
+  for (size_t t = 0; t < j.table_count; t++) {
+    sqlite3_finalize(j.tables[t].stmt);
+    free(j.tables[t].key_ix);
+  }
+  free(j.tables);
+  free(j.matches);
+  free(j.buff);
+  return rc;
+}
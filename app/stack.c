@@ -23,7 +23,7 @@ const char *zsv_stack_usage_msg[] = {
   "Usage: " APPNAME " [options] filename [filename...]",
   "",
   "Options:",
-  "  -o <filename>: output file",
+  "  -o <filename>: output file; compressed if it ends in .gz or .zst",
   "  -b           : output with BOM",
   "  -q           : always add double-quotes",
   "  -T           : input is tab-delimited, instead of comma-delimited",
@@ -253,7 +253,11 @@ int ZSV_MAIN_FUNC(ZSV_COMMAND)(int argc, const char *argv[], struct zsv_opts *op
       if (arg_i >= argc)
         fprintf(stderr, "-o option: no filename specified\n");
       else {
-        if (!(writer_opts.stream = fopen(argv[arg_i], "wb"))) {
+        if ((writer_opts.compress = zsv_compression_from_filename(argv[arg_i])) &&
+            !zsv_compression_supported(writer_opts.compress)) {
+          data.err = 1;
+          fprintf(stderr, "Compressed output is not supported by this build: %s\n", argv[arg_i]);
+        } else if (!(writer_opts.stream = fopen(argv[arg_i], "wb"))) {
           data.err = 1;
           fprintf(stderr, "Unable to open file for writing: %s\n", argv[arg_i]);
         }
@@ -123,7 +123,7 @@ void zsv_set_default_completed_callback(zsv_completed_callback cb, void *ctx) {
  *     -u,--malformed-utf8-replacement <string>: replacement string (can be empty) in case of malformed UTF8
  * input (default for "desc" command is '?') -S,--keep-blank-headers  : disable default behavior of ignoring leading
  * blank rows -0,--header-row <header> : insert the provided CSV as the first row (in position 0) e.g. --header-row
- * 'col1,col2,\"my col 3\"'", -v,--verbose
+ * 'col1,col2,\"my col 3\"'", -E,--encoding <auto|utf8|utf16le|utf16be|latin1>: input encoding, -v,--verbose
  *
  * @param  argc      count of args to process
  * @param  argv      args to process
@@ -142,9 +142,9 @@ ZSV_EXPORT
 enum zsv_status zsv_args_to_opts(int argc, const char *argv[], int *argc_out, const char **argv_out,
                                  struct zsv_opts *opts_out, char *opts_used) {
 #ifdef ZSV_EXTRAS
-  static const char *short_args = "BcrtOqvRdSu0L";
+  static const char *short_args = "BcrtOqvRdSu0EL";
 #else
-  static const char *short_args = "BcrtOqvRdSu0";
+  static const char *short_args = "BcrtOqvRdSu0E";
 #endif
   assert(strlen(short_args) < ZSV_OPTS_SIZE_MAX);
 
@@ -161,6 +161,7 @@ enum zsv_status zsv_args_to_opts(int argc, const char *argv[], int *argc_out, co
     "keep-blank-headers",
     "malformed-utf8-replacement",
     "header-row",
+    "encoding",
 #ifdef ZSV_EXTRAS
     "limit-rows",
 #endif
@@ -221,6 +222,7 @@ enum zsv_status zsv_args_to_opts(int argc, const char *argv[], int *argc_out, co
     case 'd':
     case 'u':
     case '0':
+    case 'E':
       if (++i >= argc)
         err = fprintf(stderr, "Error: option %s requires a value\n", argv[i - 1]);
       else {
@@ -247,6 +249,20 @@ enum zsv_status zsv_args_to_opts(int argc, const char *argv[], int *argc_out, co
             err = fprintf(stderr, "Invalid empty Inserted header row\n");
           else
             opts_out->insert_header_row = argv[i];
+        } else if (arg == 'E') {
+          if (!strcmp(val, "auto"))
+            opts_out->encoding = zsv_encoding_auto;
+          else if (!strcmp(val, "utf8") || !strcmp(val, "utf-8"))
+            opts_out->encoding = zsv_encoding_utf8;
+          else if (!strcmp(val, "utf16le") || !strcmp(val, "utf-16le"))
+            opts_out->encoding = zsv_encoding_utf16le;
+          else if (!strcmp(val, "utf16be") || !strcmp(val, "utf-16be"))
+            opts_out->encoding = zsv_encoding_utf16be;
+          else if (!strcmp(val, "latin1") || !strcmp(val, "windows-1252"))
+            opts_out->encoding = zsv_encoding_latin1;
+          else
+            err = fprintf(stderr, "Error: unrecognized encoding %s (expected auto, utf8, utf16le, utf16be or latin1)\n",
+                          val);
         } else {
           /* arg = 'B', 'c', 'r', 'R', 'd', or 'L' (ZSV_EXTRAS only) */
           long n = atol(val);
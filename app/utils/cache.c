@@ -22,6 +22,8 @@ static const char *zsv_cache_type_name(enum zsv_cache_type t) {
     return ZSV_CACHE_PROPERTIES_NAME;
   case zsv_cache_type_tag:
     return "tag";
+  case zsv_cache_type_sql:
+    return "sql";
   default:
     return NULL;
   }
@@ -39,7 +41,8 @@ unsigned char *zsv_cache_filepath(const unsigned char *data_filepath, enum zsv_c
   }
 
   unsigned char *cache_filename;
-  asprintf((char **)&cache_filename, "%s.json%s", cache_filename_base, temp_file ? ZSV_TEMPFILE_SUFFIX : "");
+  asprintf((char **)&cache_filename, "%s.%s%s", cache_filename_base, type == zsv_cache_type_sql ? "db" : "json",
+           temp_file ? ZSV_TEMPFILE_SUFFIX : "");
 
   unsigned char *s = cache_filename ? zsv_cache_path(data_filepath, cache_filename, 0) : NULL;
   if (s && create_dir) {
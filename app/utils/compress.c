@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zsv/utils/compress.h>
+#include <zsv/utils/alloc.h>
+#include <zsv/utils/pool.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#define ZSV_COMPRESS_BLOCK_SIZE_DEFAULT (1024 * 1024)
+
+/**
+ * A block is filled by the caller, compressed by a pool task, and written by
+ * the task's completion callback, which runs in submission order on the
+ * thread that calls zsv_compressor_write(). Each block keeps its own
+ * compression context, which is reused when the block is refilled
+ */
+struct zsv_compress_block {
+  struct zsv_compressor *compressor;
+  unsigned char *in;
+  size_t in_len;
+  unsigned char *out;
+  size_t out_size; // capacity of out
+  size_t out_len;
+  void *ctx; // z_stream or ZSTD_CCtx
+  char error;
+};
+
+struct zsv_compressor {
+  enum zsv_compression type;
+  int level;
+  size_t block_size;
+  size_t (*write)(const void *restrict, size_t size, size_t nitems, void *restrict stream);
+  void *stream;
+  const struct zsv_allocator *allocator;
+
+  zsv_pool pool;
+  zsv_pool_group group;
+  struct zsv_compress_block *blocks;
+  size_t block_count;
+  size_t current; // index of the block being filled
+
+  char started; // at least one block has been submitted
+  char error;
+};
+
+enum zsv_compression zsv_compression_from_filename(const char *filename) {
+  size_t len = filename ? strlen(filename) : 0;
+  if (len > 3 && !strcmp(filename + len - 3, ".gz"))
+    return zsv_compression_gzip;
+  if (len > 4 && !strcmp(filename + len - 4, ".zst"))
+    return zsv_compression_zstd;
+  return zsv_compression_none;
+}
+
+int zsv_compression_supported(enum zsv_compression type) {
+  switch (type) {
+#ifdef HAVE_ZLIB
+  case zsv_compression_gzip:
+    return 1;
+#endif
+#ifdef HAVE_ZSTD
+  case zsv_compression_zstd:
+    return 1;
+#endif
+  default:
+    return 0;
+  }
+}
+
+// largest compressed size of a block of n bytes
+static size_t zsv_compress_bound(enum zsv_compression type, size_t n) {
+  switch (type) {
+#ifdef HAVE_ZLIB
+  case zsv_compression_gzip:
+    return compressBound((uLong)n) + 32; // gzip header and trailer are larger than zlib's
+#endif
+#ifdef HAVE_ZSTD
+  case zsv_compression_zstd:
+    return ZSTD_compressBound(n);
+#endif
+  default:
+    (void)n;
+    return 0;
+  }
+}
+
+static void zsv_compress_ctx_delete(enum zsv_compression type, void *ctx) {
+  if (!ctx)
+    return;
+  switch (type) {
+#ifdef HAVE_ZLIB
+  case zsv_compression_gzip:
+    deflateEnd(ctx);
+    free(ctx);
+    break;
+#endif
+#ifdef HAVE_ZSTD
+  case zsv_compression_zstd:
+    ZSTD_freeCCtx(ctx);
+    break;
+#endif
+  default:
+    break;
+  }
+}
+
+// pool task: compress b->in to b->out
+static void zsv_compress_block_run(void *arg) {
+  struct zsv_compress_block *b = arg;
+  struct zsv_compressor *c = b->compressor;
+  b->error = 1;
+  b->out_len = 0;
+  switch (c->type) {
+#ifdef HAVE_ZLIB
+  case zsv_compression_gzip: {
+    z_stream *z = b->ctx;
+    if (z) {
+      if (deflateReset(z) != Z_OK)
+        return;
+    } else {
+      if (!(z = calloc(1, sizeof(*z))))
+        return;
+      // windowBits + 16: gzip header and trailer
+      if (deflateInit2(z, c->level ? c->level : Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) !=
+          Z_OK) {
+        free(z);
+        return;
+      }
+      b->ctx = z;
+    }
+    z->next_in = b->in;
+    z->avail_in = (uInt)b->in_len;
+    z->next_out = b->out;
+    z->avail_out = (uInt)b->out_size;
+    if (deflate(z, Z_FINISH) == Z_STREAM_END) {
+      b->out_len = b->out_size - z->avail_out;
+      b->error = 0;
+    }
+  } break;
+#endif
+#ifdef HAVE_ZSTD
+  case zsv_compression_zstd: {
+    if (!b->ctx && !(b->ctx = ZSTD_createCCtx()))
+      return;
+    size_t n = ZSTD_compressCCtx(b->ctx, b->out, b->out_size, b->in, b->in_len, c->level ? c->level : 3);
+    if (!ZSTD_isError(n)) {
+      b->out_len = n;
+      b->error = 0;
+    }
+  } break;
+#endif
+  default:
+    break;
+  }
+}
+
+// pool completion: write the compressed block, and make it available to refill
+static void zsv_compress_block_complete(void *arg) {
+  struct zsv_compress_block *b = arg;
+  struct zsv_compressor *c = b->compressor;
+  if (b->error)
+    c->error = 1;
+  else if (!c->error && b->out_len && c->write(b->out, b->out_len, 1, c->stream) != 1)
+    c->error = 1;
+  b->in_len = 0;
+}
+
+// submit the current block, then move to the next one
+static void zsv_compressor_submit(struct zsv_compressor *c) {
+  struct zsv_compress_block *b = &c->blocks[c->current];
+  c->started = 1;
+  if (zsv_pool_submit(c->group, zsv_compress_block_run, zsv_compress_block_complete, b)) {
+    c->error = 1;
+    b->in_len = 0;
+    return;
+  }
+  // blocks are submitted and completed in order, and there is one more block than can be in flight,
+  // so the next block is free
+  c->current = (c->current + 1) % c->block_count;
+}
+
+static int zsv_compressor_free(struct zsv_compressor *c) {
+  if (c->group)
+    zsv_pool_group_delete(c->group);
+  zsv_pool_delete(c->pool);
+  int err = c->error;
+  const struct zsv_allocator *a = c->allocator;
+  if (c->blocks) {
+    for (size_t i = 0; i < c->block_count; i++) {
+      zsv_compress_ctx_delete(c->type, c->blocks[i].ctx);
+      zsv_free(a, c->blocks[i].in);
+      zsv_free(a, c->blocks[i].out);
+    }
+    zsv_free(a, c->blocks);
+  }
+  zsv_free(a, c);
+  return err;
+}
+
+zsv_compressor zsv_compressor_new(struct zsv_compressor_options *opts) {
+  if (!opts || !zsv_compression_supported(opts->type))
+    return NULL;
+  const struct zsv_allocator *a = opts->allocator;
+  struct zsv_compressor *c = zsv_calloc(a, 1, sizeof(*c));
+  if (!c)
+    return NULL;
+  c->type = opts->type;
+  c->level = opts->level;
+  c->block_size = opts->block_size ? opts->block_size : ZSV_COMPRESS_BLOCK_SIZE_DEFAULT;
+  if (opts->write) {
+    c->write = opts->write;
+    c->stream = opts->stream;
+  } else {
+    c->write = (size_t(*)(const void *restrict, size_t, size_t, void *restrict))fwrite;
+    c->stream = opts->stream ? opts->stream : stdout;
+  }
+  c->allocator = a;
+
+  unsigned int thread_count = opts->threads ? opts->threads : zsv_pool_cpu_count();
+  if (thread_count > 1)
+    c->pool = zsv_pool_new(thread_count);
+  size_t max_in_flight = c->pool ? (size_t)zsv_pool_thread_count(c->pool) * 2 : 1;
+  char ok = (thread_count == 1 || c->pool) && (c->group = zsv_pool_group_new(c->pool, max_in_flight));
+
+  c->block_count = max_in_flight + 1;
+  if (ok && !(c->blocks = zsv_calloc(a, c->block_count, sizeof(*c->blocks))))
+    ok = 0;
+  size_t out_size = zsv_compress_bound(c->type, c->block_size);
+  for (size_t i = 0; ok && i < c->block_count; i++) {
+    struct zsv_compress_block *b = &c->blocks[i];
+    b->compressor = c;
+    b->out_size = out_size;
+    if (!(b->in = zsv_alloc(a, c->block_size)) || !(b->out = zsv_alloc(a, out_size)))
+      ok = 0;
+  }
+  if (!ok) {
+    zsv_compressor_free(c);
+    return NULL;
+  }
+  return c;
+}
+
+size_t zsv_compressor_write(const void *restrict s, size_t size, size_t nitems, void *restrict compressor) {
+  struct zsv_compressor *c = compressor;
+  const unsigned char *p = s;
+  size_t n = size * nitems;
+  while (n && !c->error) {
+    struct zsv_compress_block *b = &c->blocks[c->current];
+    size_t len = c->block_size - b->in_len;
+    if (len > n)
+      len = n;
+    memcpy(b->in + b->in_len, p, len);
+    b->in_len += len;
+    p += len;
+    n -= len;
+    if (b->in_len == c->block_size)
+      zsv_compressor_submit(c);
+  }
+  return c->error ? 0 : nitems;
+}
+
+int zsv_compressor_flush(zsv_compressor c) {
+  // an empty stream is written as one empty member or frame, so that it can be decompressed
+  if (c->blocks[c->current].in_len || !c->started)
+    zsv_compressor_submit(c);
+  zsv_pool_group_wait(c->group);
+  return c->error;
+}
+
+int zsv_compressor_delete(zsv_compressor c) {
+  if (!c)
+    return 0;
+  zsv_compressor_flush(c);
+  return zsv_compressor_free(c);
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <zsv/utils/string.h>
 #include <zsv/utils/writer.h>
+#include <zsv/utils/num.h>
 #include <zsv/utils/jq.h>
 #include <jq.h>
 #include <jv.h>
@@ -67,10 +68,9 @@ static int jv_print_scalar(jv value, char inside_string, FILE *f, char as_csv) {
     jv_free(value);
     return 1;
   case JV_KIND_NUMBER: {
-    char s[64];
-    int n = snprintf(s, sizeof(s), "%lf", jv_number_value(value));
-    if (n > 0 && (size_t)n < sizeof(s))
-      fprintf(f, "%.*s", (int)zsv_strip_trailing_zeros(s, n), s);
+    char s[ZSV_NUM_BUFF_SIZE];
+    size_t n = zsv_dtoa(jv_number_value(value), s);
+    fwrite(s, 1, n, f);
   }
     jv_free(value);
     return 1;
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <zsv/utils/num.h>
+
+static const char zsv_num_digit_pairs[201] = "00010203040506070809"
+                                             "10111213141516171819"
+                                             "20212223242526272829"
+                                             "30313233343536373839"
+                                             "40414243444546474849"
+                                             "50515253545556575859"
+                                             "60616263646566676869"
+                                             "70717273747576777879"
+                                             "80818283848586878889"
+                                             "90919293949596979899";
+
+size_t zsv_u64toa(uint64_t v, char *buff) {
+  // write two digits at a time from the end of a scratch buffer, then move
+  char tmp[20];
+  char *p = tmp + sizeof(tmp);
+  while (v >= 100) {
+    const char *pair = zsv_num_digit_pairs + (v % 100) * 2;
+    v /= 100;
+    *--p = pair[1];
+    *--p = pair[0];
+  }
+  if (v >= 10) {
+    *--p = zsv_num_digit_pairs[v * 2 + 1];
+    *--p = zsv_num_digit_pairs[v * 2];
+  } else
+    *--p = (char)('0' + v);
+
+  size_t len = (size_t)(tmp + sizeof(tmp) - p);
+  memcpy(buff, p, len);
+  buff[len] = '\0';
+  return len;
+}
+
+size_t zsv_i64toa(int64_t v, char *buff) {
+  if (v < 0) {
+    *buff = '-';
+    return 1 + zsv_u64toa((uint64_t)0 - (uint64_t)v, buff + 1);
+  }
+  return zsv_u64toa((uint64_t)v, buff);
+}
+
+/*
+ * Grisu2, as described in Florian Loitsch, "Printing Floating-Point Numbers
+ * Quickly and Accurately with Integers" (PLDI 2010)
+ *
+ * A diy_fp is f * 2^e with a 64-bit significand. The value and its rounding
+ * boundaries are scaled by a cached power of ten into a range where the digits
+ * can be generated with integer arithmetic alone
+ */
+struct zsv_diy_fp {
+  uint64_t f;
+  int e;
+};
+
+#define ZSV_DBL_SIGNIFICAND_SIZE 52
+#define ZSV_DBL_EXPONENT_BIAS (0x3FF + ZSV_DBL_SIGNIFICAND_SIZE)
+#define ZSV_DBL_HIDDEN_BIT ((uint64_t)1 << ZSV_DBL_SIGNIFICAND_SIZE)
+#define ZSV_DBL_SIGNIFICAND_MASK (ZSV_DBL_HIDDEN_BIT - 1)
+#define ZSV_DBL_EXPONENT_MASK ((uint64_t)0x7FF << ZSV_DBL_SIGNIFICAND_SIZE)
+
+static inline struct zsv_diy_fp zsv_diy_fp_from_bits(uint64_t bits) {
+  struct zsv_diy_fp x;
+  int biased_e = (int)((bits & ZSV_DBL_EXPONENT_MASK) >> ZSV_DBL_SIGNIFICAND_SIZE);
+  uint64_t significand = bits & ZSV_DBL_SIGNIFICAND_MASK;
+  if (biased_e) {
+    x.f = significand + ZSV_DBL_HIDDEN_BIT;
+    x.e = biased_e - ZSV_DBL_EXPONENT_BIAS;
+  } else { // subnormal
+    x.f = significand;
+    x.e = 1 - ZSV_DBL_EXPONENT_BIAS;
+  }
+  return x;
+}
+
+static inline struct zsv_diy_fp zsv_diy_fp_normalize(struct zsv_diy_fp x) {
+  while (!(x.f & ((uint64_t)1 << 63))) {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 zsv_uint128;
+#endif
+
+// upper 64 bits of the 128-bit product, rounded
+static inline struct zsv_diy_fp zsv_diy_fp_mul(struct zsv_diy_fp x, struct zsv_diy_fp y) {
+  struct zsv_diy_fp r;
+#if defined(__SIZEOF_INT128__)
+  zsv_uint128 p = (zsv_uint128)x.f * y.f;
+  r.f = (uint64_t)(p >> 64) + (((uint64_t)p >> 63) & 1);
+#else
+  const uint64_t m32 = 0xFFFFFFFF;
+  uint64_t a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+  uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+  tmp += (uint64_t)1 << 31; // round
+  r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+#endif
+  r.e = x.e + y.e + 64;
+  return r;
+}
+
+// boundaries m- and m+ of the rounding interval, normalized to a common exponent
+static void zsv_diy_fp_boundaries(struct zsv_diy_fp v, struct zsv_diy_fp *minus, struct zsv_diy_fp *plus) {
+  struct zsv_diy_fp pl = {(v.f << 1) + 1, v.e - 1};
+  while (!(pl.f & (ZSV_DBL_HIDDEN_BIT << 1))) {
+    pl.f <<= 1;
+    pl.e--;
+  }
+  pl.f <<= 64 - ZSV_DBL_SIGNIFICAND_SIZE - 2;
+  pl.e -= 64 - ZSV_DBL_SIGNIFICAND_SIZE - 2;
+
+  struct zsv_diy_fp mi;
+  if (v.f == ZSV_DBL_HIDDEN_BIT) { // lower boundary is closer
+    mi.f = (v.f << 2) - 1;
+    mi.e = v.e - 2;
+  } else {
+    mi.f = (v.f << 1) - 1;
+    mi.e = v.e - 1;
+  }
+  mi.f <<= mi.e - pl.e;
+  mi.e = pl.e;
+  *plus = pl;
+  *minus = mi;
+}
+
+// 10^k for k = -348, -340, ..., 340
+static const struct zsv_diy_fp zsv_cached_powers[] = {
+  {0xfa8fd5a0081c0288ULL, -1220}, {0xbaaee17fa23ebf76ULL, -1193}, {0x8b16fb203055ac76ULL, -1166},
+  {0xcf42894a5dce35eaULL, -1140}, {0x9a6bb0aa55653b2dULL, -1113}, {0xe61acf033d1a45dfULL, -1087},
+  {0xab70fe17c79ac6caULL, -1060}, {0xff77b1fcbebcdc4fULL, -1034}, {0xbe5691ef416bd60cULL, -1007},
+  {0x8dd01fad907ffc3cULL, -980},  {0xd3515c2831559a83ULL, -954},  {0x9d71ac8fada6c9b5ULL, -927},
+  {0xea9c227723ee8bcbULL, -901},  {0xaecc49914078536dULL, -874},  {0x823c12795db6ce57ULL, -847},
+  {0xc21094364dfb5637ULL, -821},  {0x9096ea6f3848984fULL, -794},  {0xd77485cb25823ac7ULL, -768},
+  {0xa086cfcd97bf97f4ULL, -741},  {0xef340a98172aace5ULL, -715},  {0xb23867fb2a35b28eULL, -688},
+  {0x84c8d4dfd2c63f3bULL, -661},  {0xc5dd44271ad3cdbaULL, -635},  {0x936b9fcebb25c996ULL, -608},
+  {0xdbac6c247d62a584ULL, -582},  {0xa3ab66580d5fdaf6ULL, -555},  {0xf3e2f893dec3f126ULL, -529},
+  {0xb5b5ada8aaff80b8ULL, -502},  {0x87625f056c7c4a8bULL, -475},  {0xc9bcff6034c13053ULL, -449},
+  {0x964e858c91ba2655ULL, -422},  {0xdff9772470297ebdULL, -396},  {0xa6dfbd9fb8e5b88fULL, -369},
+  {0xf8a95fcf88747d94ULL, -343},  {0xb94470938fa89bcfULL, -316},  {0x8a08f0f8bf0f156bULL, -289},
+  {0xcdb02555653131b6ULL, -263},  {0x993fe2c6d07b7facULL, -236},  {0xe45c10c42a2b3b06ULL, -210},
+  {0xaa242499697392d3ULL, -183},  {0xfd87b5f28300ca0eULL, -157},  {0xbce5086492111aebULL, -130},
+  {0x8cbccc096f5088ccULL, -103},  {0xd1b71758e219652cULL, -77},   {0x9c40000000000000ULL, -50},
+  {0xe8d4a51000000000ULL, -24},   {0xad78ebc5ac620000ULL, 3},     {0x813f3978f8940984ULL, 30},
+  {0xc097ce7bc90715b3ULL, 56},    {0x8f7e32ce7bea5c70ULL, 83},    {0xd5d238a4abe98068ULL, 109},
+  {0x9f4f2726179a2245ULL, 136},   {0xed63a231d4c4fb27ULL, 162},   {0xb0de65388cc8ada8ULL, 189},
+  {0x83c7088e1aab65dbULL, 216},   {0xc45d1df942711d9aULL, 242},   {0x924d692ca61be758ULL, 269},
+  {0xda01ee641a708deaULL, 295},   {0xa26da3999aef774aULL, 322},   {0xf209787bb47d6b85ULL, 348},
+  {0xb454e4a179dd1877ULL, 375},   {0x865b86925b9bc5c2ULL, 402},   {0xc83553c5c8965d3dULL, 428},
+  {0x952ab45cfa97a0b3ULL, 455},   {0xde469fbd99a05fe3ULL, 481},   {0xa59bc234db398c25ULL, 508},
+  {0xf6c69a72a3989f5cULL, 534},   {0xb7dcbf5354e9beceULL, 561},   {0x88fcf317f22241e2ULL, 588},
+  {0xcc20ce9bd35c78a5ULL, 614},   {0x98165af37b2153dfULL, 641},   {0xe2a0b5dc971f303aULL, 667},
+  {0xa8d9d1535ce3b396ULL, 694},   {0xfb9b7cd9a4a7443cULL, 720},   {0xbb764c4ca7a44410ULL, 747},
+  {0x8bab8eefb6409c1aULL, 774},   {0xd01fef10a657842cULL, 800},   {0x9b10a4e5e9913129ULL, 827},
+  {0xe7109bfba19c0c9dULL, 853},   {0xac2820d9623bf429ULL, 880},   {0x80444b5e7aa7cf85ULL, 907},
+  {0xbf21e44003acdd2dULL, 933},   {0x8e679c2f5e44ff8fULL, 960},   {0xd433179d9c8cb841ULL, 986},
+  {0x9e19db92b4e31ba9ULL, 1013},  {0xeb96bf6ebadf77d9ULL, 1039},  {0xaf87023b9bf0ee6bULL, 1066},
+};
+
+// cached power c = 10^-k such that e + c.e + 64 is in [-60, -32]
+static inline struct zsv_diy_fp zsv_cached_power(int e, int *k) {
+  double dk = (-61 - e) * 0.30102999566398114 + 347; // log10(2)
+  int ik = (int)dk;
+  if (dk - ik > 0.0)
+    ik++;
+  unsigned index = (unsigned)((ik >> 3) + 1);
+  *k = -(-348 + (int)index * 8);
+  return zsv_cached_powers[index];
+}
+
+static const uint64_t zsv_pow10[] = {1ULL,
+                                     10ULL,
+                                     100ULL,
+                                     1000ULL,
+                                     10000ULL,
+                                     100000ULL,
+                                     1000000ULL,
+                                     10000000ULL,
+                                     100000000ULL,
+                                     1000000000ULL,
+                                     10000000000ULL,
+                                     100000000000ULL,
+                                     1000000000000ULL,
+                                     10000000000000ULL,
+                                     100000000000000ULL,
+                                     1000000000000000ULL,
+                                     10000000000000000ULL,
+                                     100000000000000000ULL,
+                                     1000000000000000000ULL,
+                                     10000000000000000000ULL};
+
+// move the last digit down while the result stays in range and gets closer to w
+static inline void zsv_grisu_round(char *buff, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa,
+                                   uint64_t wp_w) {
+  while (rest < wp_w && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+    buff[len - 1]--;
+    rest += ten_kappa;
+  }
+}
+
+static inline int zsv_count_digits32(uint32_t n) {
+  int count = 1;
+  while (n >= 10 && count < 10) {
+    n /= 10;
+    count++;
+  }
+  return count;
+}
+
+static int zsv_grisu_digits(struct zsv_diy_fp w, struct zsv_diy_fp mp, uint64_t delta, char *buff, int *k) {
+  const struct zsv_diy_fp one = {(uint64_t)1 << -mp.e, mp.e};
+  const uint64_t wp_w = mp.f - w.f;
+  uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+  uint64_t p2 = mp.f & (one.f - 1);
+  int kappa = zsv_count_digits32(p1);
+  int len = 0;
+
+  // integral part
+  while (kappa > 0) {
+    uint32_t div = (uint32_t)zsv_pow10[kappa - 1];
+    uint32_t d = p1 / div;
+    p1 %= div;
+    if (d || len)
+      buff[len++] = (char)('0' + d);
+    kappa--;
+    uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+    if (rest <= delta) {
+      *k += kappa;
+      zsv_grisu_round(buff, len, delta, rest, zsv_pow10[kappa] << -one.e, wp_w);
+      return len;
+    }
+  }
+
+  // fractional part
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    char d = (char)(p2 >> -one.e);
+    if (d || len)
+      buff[len++] = (char)('0' + d);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *k += kappa;
+      int index = -kappa;
+      zsv_grisu_round(buff, len, delta, p2, one.f, wp_w * (index < 20 ? zsv_pow10[index] : 0));
+      return len;
+    }
+  }
+}
+
+// write digits[0..len) * 10^k, as described in zsv_dtoa()
+static size_t zsv_dtoa_format(char *buff, int len, int k) {
+  const int kk = len + k; // position of the decimal point relative to the first digit
+  if (len <= kk && kk <= 21) { // integer: pad with zeros
+    memset(buff + len, '0', (size_t)k);
+    return (size_t)kk;
+  }
+  if (0 < kk && kk <= 21) { // 1234e-2 -> 12.34
+    memmove(buff + kk + 1, buff + kk, (size_t)(len - kk));
+    buff[kk] = '.';
+    return (size_t)len + 1;
+  }
+  if (-6 < kk && kk <= 0) { // 1234e-6 -> 0.001234
+    const int offset = 2 - kk;
+    memmove(buff + offset, buff, (size_t)len);
+    buff[0] = '0';
+    buff[1] = '.';
+    memset(buff + 2, '0', (size_t)(offset - 2));
+    return (size_t)(len + offset);
+  }
+
+  // exponential
+  size_t n = 1;
+  if (len > 1) { // 1234e30 -> 1.234e+33
+    memmove(buff + 2, buff + 1, (size_t)(len - 1));
+    buff[1] = '.';
+    n = (size_t)len + 1;
+  }
+  int exp = kk - 1;
+  buff[n++] = 'e';
+  if (exp < 0) {
+    buff[n++] = '-';
+    exp = -exp;
+  } else
+    buff[n++] = '+';
+  if (exp >= 100) {
+    buff[n++] = (char)('0' + exp / 100);
+    exp %= 100;
+    buff[n++] = zsv_num_digit_pairs[exp * 2];
+    buff[n++] = zsv_num_digit_pairs[exp * 2 + 1];
+  } else if (exp >= 10) {
+    buff[n++] = zsv_num_digit_pairs[exp * 2];
+    buff[n++] = zsv_num_digit_pairs[exp * 2 + 1];
+  } else
+    buff[n++] = (char)('0' + exp);
+  return n;
+}
+
+size_t zsv_dtoa(double d, char *buff) {
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+
+  char *s = buff;
+  if (bits >> 63)
+    *s++ = '-';
+  bits &= ~((uint64_t)1 << 63);
+
+  size_t n;
+  if ((bits & ZSV_DBL_EXPONENT_MASK) == ZSV_DBL_EXPONENT_MASK) {
+    if (bits & ZSV_DBL_SIGNIFICAND_MASK) {
+      s = buff; // no sign on nan
+      memcpy(s, "nan", 3);
+    } else
+      memcpy(s, "inf", 3);
+    n = 3;
+  } else if (!bits) {
+    *s = '0';
+    n = 1;
+  } else {
+    struct zsv_diy_fp v = zsv_diy_fp_from_bits(bits);
+    struct zsv_diy_fp w_m, w_p;
+    zsv_diy_fp_boundaries(v, &w_m, &w_p);
+    int k;
+    const struct zsv_diy_fp c_mk = zsv_cached_power(w_p.e, &k);
+    const struct zsv_diy_fp w = zsv_diy_fp_mul(zsv_diy_fp_normalize(v), c_mk);
+    struct zsv_diy_fp wp = zsv_diy_fp_mul(w_p, c_mk);
+    struct zsv_diy_fp wm = zsv_diy_fp_mul(w_m, c_mk);
+    wm.f++;
+    wp.f--;
+    int len = zsv_grisu_digits(w, wp, wp.f - wm.f, s, &k);
+    n = zsv_dtoa_format(s, len, k);
+  }
+  s[n] = '\0';
+  return (size_t)(s - buff) + n;
+}
+
+size_t zsv_ldtoa_fixed(long double v, unsigned int precision, char *buff) {
+#if defined(__SIZEOF_INT128__) && LDBL_MANT_DIG <= 64
+  static const uint64_t pow5[] = {1,          5,           25,           125,           625,
+                                  3125,       15625,       78125,        390625,        1953125,
+                                  9765625,    48828125,    244140625,    1220703125,    6103515625,
+                                  30517578125, 152587890625, 762939453125, 3814697265625, 19073486328125};
+  if (precision >= sizeof(pow5) / sizeof(*pow5) || !isfinite(v))
+    return 0;
+
+  // v = m * 2^e exactly, so v * 10^precision = (m * 5^precision) * 2^(e + precision)
+  // where m * 5^precision < 2^64 * 5^19 < 2^109
+  int e;
+  long double frac = frexpl(fabsl(v), &e);
+  uint64_t m = (uint64_t)ldexpl(frac, 64);
+  zsv_uint128 prod = (zsv_uint128)m * pow5[precision];
+  int shift = e - 64 + (int)precision;
+
+  // round to an integer, half to even as printf does
+  zsv_uint128 scaled;
+  if (shift >= 0) {
+    if (shift >= 64 || (prod >> (64 - shift)))
+      return 0;
+    scaled = prod << shift;
+  } else if (shift < -109)
+    scaled = 0; // less than 1/2
+  else {
+    zsv_uint128 half = (zsv_uint128)1 << (-shift - 1);
+    zsv_uint128 rest = prod & ((half << 1) - 1);
+    scaled = prod >> -shift;
+    if (rest > half || (rest == half && (scaled & 1)))
+      scaled++;
+  }
+  if (scaled >> 64)
+    return 0;
+
+  uint64_t pow10 = 1;
+  for (unsigned int i = 0; i < precision; i++)
+    pow10 *= 10;
+  uint64_t n = (uint64_t)scaled;
+
+  char *s = buff;
+  if (signbit(v))
+    *s++ = '-';
+  s += zsv_u64toa(n / pow10, s);
+  if (precision) {
+    *s++ = '.';
+    char *end = s + precision;
+    for (uint64_t f = n % pow10; end > s; f /= 10)
+      *--end = (char)('0' + f % 10);
+    s += precision;
+  }
+  *s = '\0';
+  return (size_t)(s - buff);
+#else
+  (void)v;
+  (void)precision;
+  (void)buff;
+  return 0;
+#endif
+}
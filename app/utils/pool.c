@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <zsv/utils/pool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+unsigned int zsv_pool_cpu_count(void) {
+#if defined(_WIN32)
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  return si.dwNumberOfProcessors > 0 ? (unsigned int)si.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (unsigned int)n : 1;
+#else
+  return 1;
+#endif
+}
+
+#define ZSV_POOL_MAX_THREADS 1024
+
+int zsv_pool_threads_arg(const char *value, unsigned int *thread_count) {
+  char *end;
+  if (!value || !*value)
+    return 1;
+  long n = strtol(value, &end, 10);
+  if (*end || n < 0 || n > ZSV_POOL_MAX_THREADS)
+    return 1;
+  *thread_count = (unsigned int)n;
+  return 0;
+}
+
+#ifdef NO_THREADING
+
+struct zsv_pool {
+  unsigned int thread_count;
+};
+
+struct zsv_pool_group {
+  zsv_pool pool;
+};
+
+zsv_pool zsv_pool_new(unsigned int thread_count) {
+  (void)(thread_count);
+  zsv_pool pool = calloc(1, sizeof(*pool));
+  if (pool)
+    pool->thread_count = 1;
+  return pool;
+}
+
+unsigned int zsv_pool_thread_count(zsv_pool pool) {
+  return pool->thread_count;
+}
+
+void zsv_pool_delete(zsv_pool pool) {
+  free(pool);
+}
+
+zsv_pool_group zsv_pool_group_new(zsv_pool pool, size_t max_in_flight) {
+  (void)(max_in_flight);
+  zsv_pool_group group = calloc(1, sizeof(*group));
+  if (group)
+    group->pool = pool;
+  return group;
+}
+
+int zsv_pool_submit(zsv_pool_group group, zsv_pool_task_func run, zsv_pool_task_func complete, void *arg) {
+  (void)(group);
+  run(arg);
+  if (complete)
+    complete(arg);
+  return 0;
+}
+
+void zsv_pool_group_wait(zsv_pool_group group) {
+  (void)(group);
+}
+
+void zsv_pool_group_delete(zsv_pool_group group) {
+  free(group);
+}
+
+#else
+
+#include <pthread.h>
+
+struct zsv_pool_task {
+  struct zsv_pool_task *next;          // next in worker queue
+  struct zsv_pool_task *next_in_group; // next in submission order
+  zsv_pool_group group;
+  zsv_pool_task_func run;
+  zsv_pool_task_func complete;
+  void *arg;
+  unsigned char done; // protected by group->lock
+};
+
+struct zsv_pool_queue {
+  pthread_mutex_t lock;
+  struct zsv_pool_task *head;
+  struct zsv_pool_task *tail;
+};
+
+struct zsv_pool_worker {
+  zsv_pool pool;
+  unsigned int ix;
+  pthread_t thread;
+  struct zsv_pool_queue queue;
+};
+
+struct zsv_pool {
+  unsigned int thread_count;
+  unsigned int threads_started;
+  struct zsv_pool_worker *workers;
+
+  pthread_mutex_t lock; // protects the below
+  pthread_cond_t work_available;
+  size_t queued; // number of tasks in worker queues
+  unsigned int next_worker;
+  unsigned char stopping;
+};
+
+struct zsv_pool_group {
+  zsv_pool pool;
+  pthread_mutex_t lock; // protects the below
+  pthread_cond_t changed;
+  struct zsv_pool_task *head; // submitted but not yet completed, in submission order
+  struct zsv_pool_task *tail;
+  size_t in_flight;
+  size_t max_in_flight;
+  unsigned char delivering;
+};
+
+static _Thread_local struct zsv_pool_worker *zsv_pool_this_worker = NULL;
+
+static void zsv_pool_queue_push(struct zsv_pool_queue *q, struct zsv_pool_task *t) {
+  t->next = NULL;
+  pthread_mutex_lock(&q->lock);
+  if (q->tail)
+    q->tail->next = t;
+  else
+    q->head = t;
+  q->tail = t;
+  pthread_mutex_unlock(&q->lock);
+}
+
+static struct zsv_pool_task *zsv_pool_queue_pop(struct zsv_pool_queue *q) {
+  pthread_mutex_lock(&q->lock);
+  struct zsv_pool_task *t = q->head;
+  if (t && !(q->head = t->next))
+    q->tail = NULL;
+  pthread_mutex_unlock(&q->lock);
+  return t;
+}
+
+/**
+ * Take the next task from our own queue or, if that is empty, steal from
+ * another worker's. Both owner and thief take the oldest task, so that
+ * tasks tend to finish in submission order and completions are not held up
+ */
+static struct zsv_pool_task *zsv_pool_take(struct zsv_pool_worker *w) {
+  zsv_pool pool = w->pool;
+  struct zsv_pool_task *t = zsv_pool_queue_pop(&w->queue);
+  for (unsigned int i = 1; !t && i < pool->thread_count; i++)
+    t = zsv_pool_queue_pop(&pool->workers[(w->ix + i) % pool->thread_count].queue);
+  if (t) {
+    pthread_mutex_lock(&pool->lock);
+    pool->queued--;
+    pthread_mutex_unlock(&pool->lock);
+  }
+  return t;
+}
+
+static void zsv_pool_run(struct zsv_pool_task *t) {
+  zsv_pool_group group = t->group;
+  t->run(t->arg);
+  pthread_mutex_lock(&group->lock);
+  t->done = 1;
+  pthread_cond_broadcast(&group->changed);
+  pthread_mutex_unlock(&group->lock);
+}
+
+static void *zsv_pool_worker_main(void *arg) {
+  struct zsv_pool_worker *w = arg;
+  zsv_pool pool = w->pool;
+  zsv_pool_this_worker = w;
+  for (;;) {
+    struct zsv_pool_task *t = zsv_pool_take(w);
+    if (t) {
+      zsv_pool_run(t);
+      continue;
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->queued && !pool->stopping)
+      pthread_cond_wait(&pool->work_available, &pool->lock);
+    char stop = pool->stopping && !pool->queued;
+    pthread_mutex_unlock(&pool->lock);
+    if (stop)
+      break;
+  }
+  return NULL;
+}
+
+zsv_pool zsv_pool_new(unsigned int thread_count) {
+  if (!thread_count)
+    thread_count = zsv_pool_cpu_count();
+  if (thread_count > ZSV_POOL_MAX_THREADS)
+    thread_count = ZSV_POOL_MAX_THREADS;
+
+  zsv_pool pool = calloc(1, sizeof(*pool));
+  if (!pool || !(pool->workers = calloc(thread_count, sizeof(*pool->workers)))) {
+    free(pool);
+    return NULL;
+  }
+  pool->thread_count = thread_count;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_available, NULL);
+  for (unsigned int i = 0; i < thread_count; i++) {
+    pool->workers[i].pool = pool;
+    pool->workers[i].ix = i;
+    pthread_mutex_init(&pool->workers[i].queue.lock, NULL);
+  }
+  for (unsigned int i = 0; i < thread_count; i++, pool->threads_started++) {
+    if (pthread_create(&pool->workers[i].thread, NULL, zsv_pool_worker_main, &pool->workers[i])) {
+      zsv_pool_delete(pool);
+      return NULL;
+    }
+  }
+  return pool;
+}
+
+unsigned int zsv_pool_thread_count(zsv_pool pool) {
+  return pool->thread_count;
+}
+
+void zsv_pool_delete(zsv_pool pool) {
+  if (pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->work_available);
+    pthread_mutex_unlock(&pool->lock);
+    for (unsigned int i = 0; i < pool->threads_started; i++)
+      pthread_join(pool->workers[i].thread, NULL);
+    for (unsigned int i = 0; i < pool->thread_count; i++)
+      pthread_mutex_destroy(&pool->workers[i].queue.lock);
+    pthread_cond_destroy(&pool->work_available);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+  }
+}
+
+zsv_pool_group zsv_pool_group_new(zsv_pool pool, size_t max_in_flight) {
+  zsv_pool_group group = calloc(1, sizeof(*group));
+  if (group) {
+    group->pool = pool;
+    group->max_in_flight = max_in_flight ? max_in_flight : pool ? pool->thread_count * 2 : 1;
+    pthread_mutex_init(&group->lock, NULL);
+    pthread_cond_init(&group->changed, NULL);
+  }
+  return group;
+}
+
+/**
+ * Call the completion callback of each finished task at the head of the group.
+ * Must be called with group->lock held
+ */
+static void zsv_pool_group_deliver(zsv_pool_group group) {
+  if (group->delivering)
+    return;
+  group->delivering = 1;
+  while (group->head && group->head->done) {
+    struct zsv_pool_task *t = group->head;
+    if (!(group->head = t->next_in_group))
+      group->tail = NULL;
+    pthread_mutex_unlock(&group->lock);
+    if (t->complete)
+      t->complete(t->arg);
+    free(t);
+    pthread_mutex_lock(&group->lock);
+    group->in_flight--;
+    pthread_cond_broadcast(&group->changed);
+  }
+  group->delivering = 0;
+}
+
+int zsv_pool_submit(zsv_pool_group group, zsv_pool_task_func run, zsv_pool_task_func complete, void *arg) {
+  if (!group->pool) { // no pool: run synchronously
+    run(arg);
+    if (complete)
+      complete(arg);
+    return 0;
+  }
+
+  struct zsv_pool_task *t = calloc(1, sizeof(*t));
+  if (!t)
+    return ENOMEM;
+  t->group = group;
+  t->run = run;
+  t->complete = complete;
+  t->arg = arg;
+
+  zsv_pool pool = group->pool;
+  struct zsv_pool_worker *self = zsv_pool_this_worker;
+  if (self && self->pool != pool)
+    self = NULL;
+
+  pthread_mutex_lock(&group->lock);
+  zsv_pool_group_deliver(group);
+  // a worker that blocked here could deadlock the pool, so it runs the task itself instead
+  while (!self && group->in_flight >= group->max_in_flight) {
+    pthread_cond_wait(&group->changed, &group->lock);
+    zsv_pool_group_deliver(group);
+  }
+  char run_here = self && group->in_flight >= group->max_in_flight;
+  if (group->tail)
+    group->tail->next_in_group = t;
+  else
+    group->head = t;
+  group->tail = t;
+  group->in_flight++;
+  pthread_mutex_unlock(&group->lock);
+
+  if (run_here)
+    zsv_pool_run(t);
+  else {
+    struct zsv_pool_worker *w = self;
+    pthread_mutex_lock(&pool->lock);
+    if (!w)
+      w = &pool->workers[pool->next_worker++ % pool->thread_count];
+    zsv_pool_queue_push(&w->queue, t);
+    pool->queued++;
+    pthread_cond_signal(&pool->work_available);
+    pthread_mutex_unlock(&pool->lock);
+  }
+  return 0;
+}
+
+void zsv_pool_group_wait(zsv_pool_group group) {
+  if (!group->pool)
+    return;
+  struct zsv_pool_worker *self = zsv_pool_this_worker;
+  if (self && self->pool != group->pool)
+    self = NULL;
+
+  pthread_mutex_lock(&group->lock);
+  for (;;) {
+    zsv_pool_group_deliver(group);
+    if (!group->in_flight)
+      break;
+    struct zsv_pool_task *t;
+    if (self && (t = zsv_pool_take(self))) { // a waiting worker helps out rather than sleep
+      pthread_mutex_unlock(&group->lock);
+      zsv_pool_run(t);
+      pthread_mutex_lock(&group->lock);
+    } else if (group->delivering || !group->head->done)
+      pthread_cond_wait(&group->changed, &group->lock);
+  }
+  pthread_mutex_unlock(&group->lock);
+}
+
+void zsv_pool_group_delete(zsv_pool_group group) {
+  if (group) {
+    zsv_pool_group_wait(group);
+    pthread_cond_destroy(&group->changed);
+    pthread_mutex_destroy(&group->lock);
+    free(group);
+  }
+}
+
+#endif
@@ -0,0 +1,876 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <zsv/utils/regex.h>
+#include <zsv/utils/search.h>
+
+#define ZSV_REGEX_MAX_REPEAT 1000  // max n or m in {n,m}
+#define ZSV_REGEX_MAX_DEPTH 256    // max group nesting
+#define ZSV_REGEX_MAX_PROG 65536   // max compiled instructions
+#define ZSV_REGEX_MAX_STATES 1024  // max cached DFA states before the cache is flushed; must be a power of 2
+#define ZSV_REGEX_MAX_LITERAL 255  // max length of the prefilter literal
+#define ZSV_REGEX_NONE UINT32_MAX
+
+struct zsv_regex_set {
+  uint32_t bits[8];
+};
+
+static inline void zsv_regex_set_add(struct zsv_regex_set *s, unsigned char c) {
+  s->bits[c >> 5] |= (uint32_t)1 << (c & 31);
+}
+
+static inline int zsv_regex_set_has(const struct zsv_regex_set *s, unsigned char c) {
+  return (s->bits[c >> 5] >> (c & 31)) & 1;
+}
+
+static void zsv_regex_set_add_range(struct zsv_regex_set *s, unsigned int lo, unsigned int hi) {
+  for (unsigned int c = lo; c <= hi; c++)
+    zsv_regex_set_add(s, (unsigned char)c);
+}
+
+static void zsv_regex_set_negate(struct zsv_regex_set *s) {
+  for (int i = 0; i < 8; i++)
+    s->bits[i] = ~s->bits[i];
+}
+
+static void zsv_regex_set_union(struct zsv_regex_set *s, const struct zsv_regex_set *other) {
+  for (int i = 0; i < 8; i++)
+    s->bits[i] |= other->bits[i];
+}
+
+/**
+ * Make ASCII letters in the set match either case
+ */
+static void zsv_regex_set_fold(struct zsv_regex_set *s) {
+  for (unsigned char c = 'a'; c <= 'z'; c++) {
+    if (zsv_regex_set_has(s, c) || zsv_regex_set_has(s, c - 'a' + 'A')) {
+      zsv_regex_set_add(s, c);
+      zsv_regex_set_add(s, c - 'a' + 'A');
+    }
+  }
+}
+
+/**
+ * Parse tree
+ */
+enum zsv_regex_node_type {
+  zsv_regex_node_empty = 0,
+  zsv_regex_node_set,
+  zsv_regex_node_cat,    // children in order
+  zsv_regex_node_alt,    // any of children
+  zsv_regex_node_repeat, // child repeated min to max (-1 = unbounded) times
+  zsv_regex_node_bol,
+  zsv_regex_node_eol
+};
+
+struct zsv_regex_node {
+  enum zsv_regex_node_type type;
+  struct zsv_regex_set set;
+  int min, max;
+  struct zsv_regex_node *child; // first child
+  struct zsv_regex_node *next;  // next sibling
+  struct zsv_regex_node *all;   // next allocated node, for cleanup
+};
+
+struct zsv_regex_parser {
+  const unsigned char *p, *end;
+  unsigned int flags;
+  unsigned int depth;
+  const char *err;
+  struct zsv_regex_node *nodes;
+};
+
+static struct zsv_regex_node *zsv_regex_node_new(struct zsv_regex_parser *ps, enum zsv_regex_node_type type) {
+  struct zsv_regex_node *n = calloc(1, sizeof(*n));
+  if (!n) {
+    ps->err = "out of memory";
+    return NULL;
+  }
+  n->type = type;
+  n->all = ps->nodes;
+  ps->nodes = n;
+  return n;
+}
+
+static struct zsv_regex_node *zsv_regex_parse_alt(struct zsv_regex_parser *ps);
+
+static int zsv_regex_hex(unsigned char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * Parse the escape sequence following a backslash, and add the byte(s) it
+ * matches to the given set
+ * @param single set to the byte matched, or -1 if more than one may be matched
+ * @return 0 on success
+ */
+static int zsv_regex_parse_escape(struct zsv_regex_parser *ps, struct zsv_regex_set *set, int *single) {
+  if (ps->p == ps->end) {
+    ps->err = "trailing \\";
+    return 1;
+  }
+  struct zsv_regex_set tmp = {0};
+  unsigned char c = *ps->p++;
+  *single = -1;
+  switch (c) {
+  case 'd':
+  case 'D':
+    zsv_regex_set_add_range(&tmp, '0', '9');
+    break;
+  case 'w':
+  case 'W':
+    zsv_regex_set_add_range(&tmp, '0', '9');
+    zsv_regex_set_add_range(&tmp, 'a', 'z');
+    zsv_regex_set_add_range(&tmp, 'A', 'Z');
+    zsv_regex_set_add(&tmp, '_');
+    break;
+  case 's':
+  case 'S':
+    zsv_regex_set_add(&tmp, ' ');
+    zsv_regex_set_add_range(&tmp, '\t', '\r');
+    break;
+  case 't':
+    *single = '\t';
+    break;
+  case 'n':
+    *single = '\n';
+    break;
+  case 'r':
+    *single = '\r';
+    break;
+  case 'f':
+    *single = '\f';
+    break;
+  case 'v':
+    *single = '\v';
+    break;
+  case 'x':
+    if (ps->end - ps->p < 2 || zsv_regex_hex(ps->p[0]) < 0 || zsv_regex_hex(ps->p[1]) < 0) {
+      ps->err = "invalid \\x escape";
+      return 1;
+    }
+    *single = zsv_regex_hex(ps->p[0]) * 16 + zsv_regex_hex(ps->p[1]);
+    ps->p += 2;
+    break;
+  default:
+    *single = c;
+  }
+  if (*single >= 0)
+    zsv_regex_set_add(set, (unsigned char)*single);
+  else {
+    if (c == 'D' || c == 'W' || c == 'S')
+      zsv_regex_set_negate(&tmp);
+    zsv_regex_set_union(set, &tmp);
+  }
+  return 0;
+}
+
+static int zsv_regex_parse_class(struct zsv_regex_parser *ps, struct zsv_regex_set *set) {
+  char negate = 0;
+  if (ps->p < ps->end && *ps->p == '^') {
+    negate = 1;
+    ps->p++;
+  }
+  for (char first = 1;; first = 0) {
+    if (ps->p == ps->end) {
+      ps->err = "missing ]";
+      return 1;
+    }
+    int lo, hi;
+    if (*ps->p == ']' && !first) {
+      ps->p++;
+      break;
+    }
+    if (*ps->p == '\\') {
+      ps->p++;
+      if (zsv_regex_parse_escape(ps, set, &lo))
+        return 1;
+      if (lo < 0)
+        continue;
+    } else {
+      lo = *ps->p++;
+      zsv_regex_set_add(set, (unsigned char)lo);
+    }
+
+    if (ps->end - ps->p >= 2 && *ps->p == '-' && ps->p[1] != ']') { // range
+      ps->p++;
+      if (*ps->p == '\\') {
+        struct zsv_regex_set tmp = {0};
+        ps->p++;
+        if (zsv_regex_parse_escape(ps, &tmp, &hi))
+          return 1;
+      } else
+        hi = *ps->p++;
+      if (hi < lo) {
+        ps->err = "invalid range";
+        return 1;
+      }
+      zsv_regex_set_add_range(set, (unsigned int)lo, (unsigned int)hi);
+    }
+  }
+  if (ps->flags & ZSV_REGEX_CASE_INSENSITIVE)
+    zsv_regex_set_fold(set);
+  if (negate)
+    zsv_regex_set_negate(set);
+  return 0;
+}
+
+static struct zsv_regex_node *zsv_regex_parse_atom(struct zsv_regex_parser *ps) {
+  unsigned char c = *ps->p++;
+  struct zsv_regex_node *n;
+  int single;
+  switch (c) {
+  case '(':
+    if (ps->depth >= ZSV_REGEX_MAX_DEPTH) {
+      ps->err = "groups nested too deeply";
+      return NULL;
+    }
+    if (ps->end - ps->p >= 2 && ps->p[0] == '?' && ps->p[1] == ':')
+      ps->p += 2;
+    ps->depth++;
+    n = zsv_regex_parse_alt(ps);
+    ps->depth--;
+    if (!n)
+      return NULL;
+    if (ps->p == ps->end || *ps->p != ')') {
+      ps->err = "missing )";
+      return NULL;
+    }
+    ps->p++;
+    return n;
+  case '*':
+  case '+':
+  case '?':
+    ps->err = "nothing to repeat";
+    return NULL;
+  case '^':
+    return zsv_regex_node_new(ps, zsv_regex_node_bol);
+  case '$':
+    return zsv_regex_node_new(ps, zsv_regex_node_eol);
+  }
+
+  if (!(n = zsv_regex_node_new(ps, zsv_regex_node_set)))
+    return NULL;
+  switch (c) {
+  case '.':
+    zsv_regex_set_negate(&n->set);
+    return n;
+  case '[':
+    return zsv_regex_parse_class(ps, &n->set) ? NULL : n;
+  case '\\':
+    if (zsv_regex_parse_escape(ps, &n->set, &single))
+      return NULL;
+    break;
+  default:
+    zsv_regex_set_add(&n->set, c);
+  }
+  if (ps->flags & ZSV_REGEX_CASE_INSENSITIVE)
+    zsv_regex_set_fold(&n->set);
+  return n;
+}
+
+/**
+ * Parse a {n}, {n,} or {n,m} quantifier
+ * @return number of bytes parsed, 0 if not a quantifier, or -1 if invalid
+ */
+static int zsv_regex_parse_braces(const unsigned char *p, const unsigned char *end, int *min, int *max) {
+  const unsigned char *s = p + 1;
+  int v = 0;
+  if (s == end || *s < '0' || *s > '9')
+    return 0;
+  for (; s < end && *s >= '0' && *s <= '9'; s++)
+    if ((v = v * 10 + (*s - '0')) > ZSV_REGEX_MAX_REPEAT)
+      return -1;
+  *min = *max = v;
+  if (s < end && *s == ',') {
+    s++;
+    *max = -1;
+    if (s < end && *s >= '0' && *s <= '9') {
+      for (v = 0; s < end && *s >= '0' && *s <= '9'; s++)
+        if ((v = v * 10 + (*s - '0')) > ZSV_REGEX_MAX_REPEAT)
+          return -1;
+      *max = v;
+    }
+  }
+  if (s == end || *s != '}')
+    return 0;
+  if (*max >= 0 && *max < *min)
+    return -1;
+  return (int)(s + 1 - p);
+}
+
+static struct zsv_regex_node *zsv_regex_parse_repeat(struct zsv_regex_parser *ps) {
+  struct zsv_regex_node *n = zsv_regex_parse_atom(ps);
+  while (n && ps->p < ps->end) {
+    int min, max, k;
+    switch (*ps->p) {
+    case '*':
+      min = 0, max = -1, k = 1;
+      break;
+    case '+':
+      min = 1, max = -1, k = 1;
+      break;
+    case '?':
+      min = 0, max = 1, k = 1;
+      break;
+    case '{':
+      k = zsv_regex_parse_braces(ps->p, ps->end, &min, &max);
+      if (k < 0) {
+        ps->err = "invalid repetition count";
+        return NULL;
+      }
+      break;
+    default:
+      k = 0;
+    }
+    if (!k)
+      break;
+    ps->p += k;
+    if (ps->p < ps->end && *ps->p == '?') // lazy: makes no difference to whether there is a match
+      ps->p++;
+    struct zsv_regex_node *r = zsv_regex_node_new(ps, zsv_regex_node_repeat);
+    if (r) {
+      r->child = n;
+      r->min = min;
+      r->max = max;
+    }
+    n = r;
+  }
+  return n;
+}
+
+static struct zsv_regex_node *zsv_regex_parse_cat(struct zsv_regex_parser *ps) {
+  struct zsv_regex_node *first = NULL, *last = NULL;
+  while (ps->p < ps->end && *ps->p != '|' && *ps->p != ')') {
+    struct zsv_regex_node *n = zsv_regex_parse_repeat(ps);
+    if (!n)
+      return NULL;
+    if (last)
+      last->next = n;
+    else
+      first = n;
+    last = n;
+  }
+  if (!first)
+    return zsv_regex_node_new(ps, zsv_regex_node_empty);
+  if (first == last)
+    return first;
+  struct zsv_regex_node *cat = zsv_regex_node_new(ps, zsv_regex_node_cat);
+  if (cat)
+    cat->child = first;
+  return cat;
+}
+
+static struct zsv_regex_node *zsv_regex_parse_alt(struct zsv_regex_parser *ps) {
+  struct zsv_regex_node *first = zsv_regex_parse_cat(ps);
+  if (!first || ps->p == ps->end || *ps->p != '|')
+    return first;
+  struct zsv_regex_node *alt = zsv_regex_node_new(ps, zsv_regex_node_alt);
+  if (!alt)
+    return NULL;
+  alt->child = first;
+  for (struct zsv_regex_node *last = first; ps->p < ps->end && *ps->p == '|'; last = last->next) {
+    ps->p++;
+    if (!(last->next = zsv_regex_parse_cat(ps)))
+      return NULL;
+  }
+  return alt;
+}
+
+/**
+ * Required literal: the longest string that every match must contain
+ */
+struct zsv_regex_literal {
+  unsigned char str[ZSV_REGEX_MAX_LITERAL];
+  size_t len;
+};
+
+/**
+ * Check if a node always matches exactly one given byte (or, if
+ * case-insensitive, one given letter in either case)
+ */
+static int zsv_regex_node_byte(const struct zsv_regex_node *n, unsigned int flags, unsigned char *byte) {
+  if (n->type != zsv_regex_node_set)
+    return 0;
+  int count = 0;
+  for (unsigned int c = 0; c < 256 && count < 3; c++) {
+    if (zsv_regex_set_has(&n->set, (unsigned char)c)) {
+      if (!count++)
+        *byte = (unsigned char)c;
+    }
+  }
+  if (count == 1)
+    return 1;
+  // an upper/lower case pair: A-Z sort before a-z
+  if (count == 2 && (flags & ZSV_REGEX_CASE_INSENSITIVE) && *byte >= 'A' && *byte <= 'Z' &&
+      zsv_regex_set_has(&n->set, *byte - 'A' + 'a')) {
+    *byte = *byte - 'A' + 'a';
+    return 1;
+  }
+  return 0;
+}
+
+static void zsv_regex_literal_keep(struct zsv_regex_literal *best, const struct zsv_regex_literal *candidate) {
+  if (candidate->len > best->len)
+    *best = *candidate;
+}
+
+static void zsv_regex_required_literal(const struct zsv_regex_node *n, unsigned int flags,
+                                       struct zsv_regex_literal *lit) {
+  unsigned char byte;
+  lit->len = 0;
+  switch (n->type) {
+  case zsv_regex_node_set:
+    if (zsv_regex_node_byte(n, flags, &byte)) {
+      lit->str[0] = byte;
+      lit->len = 1;
+    }
+    break;
+  case zsv_regex_node_repeat:
+    if (n->min > 0)
+      zsv_regex_required_literal(n->child, flags, lit);
+    break;
+  case zsv_regex_node_cat: {
+    struct zsv_regex_literal run, sub;
+    run.len = 0;
+    for (const struct zsv_regex_node *c = n->child; c; c = c->next) {
+      if (zsv_regex_node_byte(c, flags, &byte)) {
+        if (run.len < sizeof(run.str))
+          run.str[run.len++] = byte;
+        continue;
+      }
+      zsv_regex_literal_keep(lit, &run);
+      run.len = 0;
+      zsv_regex_required_literal(c, flags, &sub);
+      zsv_regex_literal_keep(lit, &sub);
+    }
+    zsv_regex_literal_keep(lit, &run);
+  } break;
+  default:
+    break;
+  }
+}
+
+/**
+ * Compiled program (NFA)
+ */
+enum zsv_regex_op {
+  zsv_regex_op_set = 0, // consume a byte in sets[x]
+  zsv_regex_op_split,   // continue at x and at y
+  zsv_regex_op_jmp,     // continue at x
+  zsv_regex_op_bol,
+  zsv_regex_op_eol,
+  zsv_regex_op_match
+};
+
+struct zsv_regex_inst {
+  enum zsv_regex_op op;
+  uint32_t x, y;
+};
+
+/**
+ * Cached DFA state: the set of NFA instructions that are live at a position
+ */
+struct zsv_regex_state {
+  int32_t next[256];     // next state for each byte, or -1 if not yet computed
+  uint32_t hash;
+  unsigned char match;        // a match has been found
+  unsigned char match_at_end; // a match is found if the input ends here
+  uint32_t count;
+  uint32_t pcs[]; // sorted
+};
+
+struct zsv_regex {
+  unsigned int flags;
+  const char *err;
+
+  struct zsv_regex_inst *prog;
+  uint32_t prog_len;
+  uint32_t prog_capacity;
+  struct zsv_regex_set *sets;
+  uint32_t set_count;
+  uint32_t set_capacity;
+
+  struct zsv_regex_literal literal;
+  zsv_search prefilter;
+
+  struct zsv_regex_state **states;
+  uint32_t state_count;
+  int32_t *table; // hash table of state indexes, or -1 if empty
+  uint32_t table_size;
+  int32_t start;
+  size_t flushes;
+
+  // work space for building states
+  uint32_t *stack;
+  uint32_t *list;
+  uint32_t *mark;
+  uint32_t gen;
+};
+
+static int32_t zsv_regex_emit_inst(struct zsv_regex *re, enum zsv_regex_op op, uint32_t x, uint32_t y) {
+  if (re->prog_len >= ZSV_REGEX_MAX_PROG) {
+    re->err = "pattern too large";
+    return -1;
+  }
+  if (re->prog_len == re->prog_capacity) {
+    uint32_t capacity = re->prog_capacity ? re->prog_capacity * 2 : 64;
+    struct zsv_regex_inst *prog = realloc(re->prog, capacity * sizeof(*prog));
+    if (!prog) {
+      re->err = "out of memory";
+      return -1;
+    }
+    re->prog = prog;
+    re->prog_capacity = capacity;
+  }
+  re->prog[re->prog_len].op = op;
+  re->prog[re->prog_len].x = x;
+  re->prog[re->prog_len].y = y;
+  return (int32_t)re->prog_len++;
+}
+
+static int zsv_regex_emit_set(struct zsv_regex *re, const struct zsv_regex_set *set) {
+  if (re->set_count == re->set_capacity) {
+    uint32_t capacity = re->set_capacity ? re->set_capacity * 2 : 16;
+    struct zsv_regex_set *sets = realloc(re->sets, capacity * sizeof(*sets));
+    if (!sets) {
+      re->err = "out of memory";
+      return 1;
+    }
+    re->sets = sets;
+    re->set_capacity = capacity;
+  }
+  re->sets[re->set_count] = *set;
+  return zsv_regex_emit_inst(re, zsv_regex_op_set, re->set_count++, 0) < 0;
+}
+
+/**
+ * Point each instruction in a chain of pending jumps at the given target.
+ * The chain is linked through the field that is to be patched
+ */
+static void zsv_regex_patch(struct zsv_regex *re, uint32_t pc, int use_y, uint32_t target) {
+  while (pc != ZSV_REGEX_NONE) {
+    uint32_t *field = use_y ? &re->prog[pc].y : &re->prog[pc].x;
+    pc = *field;
+    *field = target;
+  }
+}
+
+static int zsv_regex_emit(struct zsv_regex *re, const struct zsv_regex_node *n) {
+  switch (n->type) {
+  case zsv_regex_node_empty:
+    return 0;
+  case zsv_regex_node_set:
+    return zsv_regex_emit_set(re, &n->set);
+  case zsv_regex_node_bol:
+    return zsv_regex_emit_inst(re, zsv_regex_op_bol, 0, 0) < 0;
+  case zsv_regex_node_eol:
+    return zsv_regex_emit_inst(re, zsv_regex_op_eol, 0, 0) < 0;
+  case zsv_regex_node_cat:
+    for (const struct zsv_regex_node *c = n->child; c; c = c->next)
+      if (zsv_regex_emit(re, c))
+        return 1;
+    return 0;
+  case zsv_regex_node_alt: {
+    uint32_t jmps = ZSV_REGEX_NONE;
+    for (const struct zsv_regex_node *c = n->child; c; c = c->next) {
+      int32_t split = -1, jmp;
+      if (c->next && (split = zsv_regex_emit_inst(re, zsv_regex_op_split, re->prog_len + 1, 0)) < 0)
+        return 1;
+      if (zsv_regex_emit(re, c))
+        return 1;
+      if (c->next) {
+        if ((jmp = zsv_regex_emit_inst(re, zsv_regex_op_jmp, jmps, 0)) < 0)
+          return 1;
+        jmps = (uint32_t)jmp;
+        re->prog[split].y = re->prog_len;
+      }
+    }
+    zsv_regex_patch(re, jmps, 0, re->prog_len);
+    return 0;
+  }
+  case zsv_regex_node_repeat: {
+    int required = n->min;
+    if (n->max < 0 && required > 0)
+      required--; // the last required repetition is also the first of the loop
+    for (int i = 0; i < required; i++)
+      if (zsv_regex_emit(re, n->child))
+        return 1;
+    if (n->max < 0) {
+      if (n->min > 0) {
+        uint32_t loop = re->prog_len;
+        return zsv_regex_emit(re, n->child) || zsv_regex_emit_inst(re, zsv_regex_op_split, loop, re->prog_len + 1) < 0;
+      }
+      int32_t split = zsv_regex_emit_inst(re, zsv_regex_op_split, re->prog_len + 1, 0);
+      if (split < 0 || zsv_regex_emit(re, n->child) || zsv_regex_emit_inst(re, zsv_regex_op_jmp, split, 0) < 0)
+        return 1;
+      re->prog[split].y = re->prog_len;
+      return 0;
+    }
+    uint32_t splits = ZSV_REGEX_NONE;
+    for (int i = n->min; i < n->max; i++) {
+      int32_t split = zsv_regex_emit_inst(re, zsv_regex_op_split, re->prog_len + 1, splits);
+      if (split < 0 || zsv_regex_emit(re, n->child))
+        return 1;
+      splits = (uint32_t)split;
+    }
+    zsv_regex_patch(re, splits, 1, re->prog_len);
+    return 0;
+  }
+  }
+  return 0;
+}
+
+/**
+ * Add the instructions reachable from pc without consuming input to the
+ * work list, and check if they include a match
+ */
+static int zsv_regex_closure(struct zsv_regex *re, uint32_t pc, char at_bol, char at_eol, uint32_t *list_len) {
+  int matched = 0;
+  uint32_t sp = 0;
+  if (re->mark[pc] != re->gen) {
+    re->mark[pc] = re->gen;
+    re->stack[sp++] = pc;
+  }
+  while (sp) {
+    pc = re->stack[--sp];
+    const struct zsv_regex_inst *inst = &re->prog[pc];
+    uint32_t next[2];
+    int next_count = 0;
+    switch (inst->op) {
+    case zsv_regex_op_split:
+      next[next_count++] = inst->y;
+      next[next_count++] = inst->x;
+      break;
+    case zsv_regex_op_jmp:
+      next[next_count++] = inst->x;
+      break;
+    case zsv_regex_op_bol:
+      if (at_bol)
+        next[next_count++] = pc + 1;
+      break;
+    case zsv_regex_op_eol:
+      if (at_eol)
+        next[next_count++] = pc + 1;
+      else if (list_len)
+        re->list[(*list_len)++] = pc; // pending until we know if the input ends here
+      break;
+    case zsv_regex_op_match:
+      matched = 1;
+      // fall through
+    case zsv_regex_op_set:
+      if (list_len)
+        re->list[(*list_len)++] = pc;
+      break;
+    }
+    for (int i = 0; i < next_count; i++) {
+      if (re->mark[next[i]] != re->gen) {
+        re->mark[next[i]] = re->gen;
+        re->stack[sp++] = next[i];
+      }
+    }
+  }
+  return matched;
+}
+
+static void zsv_regex_next_gen(struct zsv_regex *re) {
+  if (++re->gen == 0) {
+    memset(re->mark, 0, re->prog_len * sizeof(*re->mark));
+    re->gen = 1;
+  }
+}
+
+static void zsv_regex_flush(struct zsv_regex *re) {
+  for (uint32_t i = 0; i < re->state_count; i++)
+    free(re->states[i]);
+  re->state_count = 0;
+  memset(re->table, 0xff, re->table_size * sizeof(*re->table));
+  re->start = -1;
+  re->flushes++;
+}
+
+static int zsv_regex_cmp_pc(const void *x, const void *y) {
+  uint32_t a = *(const uint32_t *)x, b = *(const uint32_t *)y;
+  return a < b ? -1 : a > b;
+}
+
+/**
+ * Find or create the state for the instructions in the work list
+ * @return state index, or -1 if out of memory
+ */
+static int32_t zsv_regex_state_get(struct zsv_regex *re, uint32_t count) {
+  qsort(re->list, count, sizeof(*re->list), zsv_regex_cmp_pc);
+  uint32_t hash = 2166136261u;
+  for (uint32_t i = 0; i < count; i++)
+    hash = (hash ^ re->list[i]) * 16777619u;
+
+  uint32_t slot;
+  for (int tries = 0; tries < 2; tries++) {
+    for (slot = hash & (re->table_size - 1); re->table[slot] >= 0; slot = (slot + 1) & (re->table_size - 1)) {
+      struct zsv_regex_state *s = re->states[re->table[slot]];
+      if (s->hash == hash && s->count == count && !memcmp(s->pcs, re->list, count * sizeof(*re->list)))
+        return re->table[slot];
+    }
+    if (re->state_count < ZSV_REGEX_MAX_STATES)
+      break;
+    zsv_regex_flush(re);
+  }
+
+  struct zsv_regex_state *s = malloc(sizeof(*s) + count * sizeof(*s->pcs));
+  if (!s)
+    return -1;
+  memset(s->next, 0xff, sizeof(s->next));
+  s->hash = hash;
+  s->count = count;
+  memcpy(s->pcs, re->list, count * sizeof(*re->list));
+  s->match = s->match_at_end = 0;
+  zsv_regex_next_gen(re);
+  // every pc is checked: op_match sorts last, after any eol whose closure matches at the end
+  for (uint32_t i = 0; i < count; i++) {
+    if (re->prog[s->pcs[i]].op == zsv_regex_op_match)
+      s->match = s->match_at_end = 1;
+    else if (re->prog[s->pcs[i]].op == zsv_regex_op_eol && !s->match_at_end)
+      s->match_at_end = (unsigned char)zsv_regex_closure(re, s->pcs[i] + 1, 0, 1, NULL);
+  }
+  re->table[slot] = (int32_t)re->state_count;
+  re->states[re->state_count] = s;
+  return (int32_t)re->state_count++;
+}
+
+static int32_t zsv_regex_start(struct zsv_regex *re) {
+  if (re->start < 0) {
+    uint32_t count = 0;
+    zsv_regex_next_gen(re);
+    zsv_regex_closure(re, 0, 1, 0, &count);
+    re->start = zsv_regex_state_get(re, count);
+  }
+  return re->start;
+}
+
+/**
+ * Compute and cache the transition from a state on a given byte
+ */
+static int32_t zsv_regex_step(struct zsv_regex *re, int32_t from, unsigned char c) {
+  const struct zsv_regex_state *s = re->states[from];
+  uint32_t count = 0;
+  zsv_regex_next_gen(re);
+  for (uint32_t i = 0; i < s->count; i++) {
+    const struct zsv_regex_inst *inst = &re->prog[s->pcs[i]];
+    if (inst->op == zsv_regex_op_set && zsv_regex_set_has(&re->sets[inst->x], c))
+      zsv_regex_closure(re, s->pcs[i] + 1, 0, 0, &count);
+  }
+  zsv_regex_closure(re, 0, 0, 0, &count); // unanchored: a match may also start at the next position
+
+  size_t flushes = re->flushes;
+  int32_t to = zsv_regex_state_get(re, count);
+  if (to >= 0 && flushes == re->flushes) // if the cache was flushed, `from` no longer exists
+    re->states[from]->next[c] = to;
+  return to;
+}
+
+zsv_regex zsv_regex_new(const unsigned char *pattern, size_t len, unsigned int flags, const char **err) {
+  struct zsv_regex_parser ps = {0};
+  const char *e = NULL;
+  struct zsv_regex *re = calloc(1, sizeof(*re));
+  if (!re)
+    e = "out of memory";
+  else {
+    re->flags = flags;
+    re->start = -1;
+    ps.p = pattern;
+    ps.end = pattern + len;
+    ps.flags = flags;
+    struct zsv_regex_node *root = zsv_regex_parse_alt(&ps);
+    if (root && ps.p < ps.end)
+      ps.err = "unmatched )";
+    if (!root || ps.err)
+      e = ps.err ? ps.err : "out of memory";
+    else if (zsv_regex_emit(re, root) || zsv_regex_emit_inst(re, zsv_regex_op_match, 0, 0) < 0)
+      e = re->err;
+    else {
+      re->table_size = ZSV_REGEX_MAX_STATES * 2;
+      re->states = calloc(ZSV_REGEX_MAX_STATES, sizeof(*re->states));
+      re->table = malloc(re->table_size * sizeof(*re->table));
+      re->stack = malloc(re->prog_len * sizeof(*re->stack));
+      re->list = malloc(re->prog_len * sizeof(*re->list));
+      re->mark = calloc(re->prog_len, sizeof(*re->mark));
+      if (!re->states || !re->table || !re->stack || !re->list || !re->mark)
+        e = "out of memory";
+      else {
+        memset(re->table, 0xff, re->table_size * sizeof(*re->table));
+        zsv_regex_required_literal(root, flags, &re->literal);
+        if (re->literal.len) {
+          re->prefilter = zsv_search_new(flags & ZSV_REGEX_CASE_INSENSITIVE ? ZSV_SEARCH_CASE_INSENSITIVE : 0);
+          if (!re->prefilter || zsv_search_add(re->prefilter, re->literal.str, re->literal.len) ||
+              zsv_search_compile(re->prefilter))
+            e = "out of memory";
+        }
+      }
+    }
+  }
+
+  for (struct zsv_regex_node *next; ps.nodes; ps.nodes = next) {
+    next = ps.nodes->all;
+    free(ps.nodes);
+  }
+  if (e) {
+    zsv_regex_delete(re);
+    if (err)
+      *err = e;
+    return NULL;
+  }
+  return re;
+}
+
+int zsv_regex_match(zsv_regex re, const unsigned char *s, size_t len) {
+  if (re->prefilter && !zsv_search_scan(re->prefilter, s, len, NULL, NULL))
+    return 0;
+  int32_t state = zsv_regex_start(re);
+  if (state < 0)
+    return -1;
+  for (size_t i = 0; i < len; i++) {
+    const struct zsv_regex_state *current = re->states[state];
+    if (current->match)
+      return 1;
+    int32_t next = current->next[s[i]];
+    if (next < 0 && (next = zsv_regex_step(re, state, s[i])) < 0)
+      return -1;
+    state = next;
+  }
+  return re->states[state]->match_at_end;
+}
+
+const unsigned char *zsv_regex_literal(zsv_regex re, size_t *len) {
+  *len = re->literal.len;
+  return re->literal.len ? re->literal.str : NULL;
+}
+
+void zsv_regex_delete(zsv_regex re) {
+  if (re) {
+    if (re->states && re->table)
+      zsv_regex_flush(re);
+    free(re->states);
+    free(re->table);
+    free(re->stack);
+    free(re->list);
+    free(re->mark);
+    free(re->prog);
+    free(re->sets);
+    zsv_search_delete(re->prefilter);
+    free(re);
+  }
+}
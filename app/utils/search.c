@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <zsv/utils/search.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ZSV_SEARCH_TEDDY 32
+typedef __m256i zsv_search_vec;
+#define zsv_search_vec_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define zsv_search_vec_table(t) _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(t)))
+#define zsv_search_vec_shuffle _mm256_shuffle_epi8
+#define zsv_search_vec_and _mm256_and_si256
+#define zsv_search_vec_srl4(v) _mm256_srli_epi16(v, 4)
+#define zsv_search_vec_set1 _mm256_set1_epi8
+#define zsv_search_vec_store(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define zsv_search_vec_zero_mask(v) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()))
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define ZSV_SEARCH_TEDDY 16
+typedef __m128i zsv_search_vec;
+#define zsv_search_vec_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define zsv_search_vec_table(t) _mm_loadu_si128((const __m128i *)(t))
+#define zsv_search_vec_shuffle _mm_shuffle_epi8
+#define zsv_search_vec_and _mm_and_si128
+#define zsv_search_vec_srl4(v) _mm_srli_epi16(v, 4)
+#define zsv_search_vec_set1 _mm_set1_epi8
+#define zsv_search_vec_store(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define zsv_search_vec_zero_mask(v) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()))
+#endif
+
+#define ZSV_SEARCH_TEDDY_MAX_STRINGS 64
+#define ZSV_SEARCH_TEDDY_BUCKETS 8
+#define ZSV_SEARCH_TEDDY_MAX_FINGERPRINT 3
+
+struct zsv_search_str {
+  unsigned char *str; // lower-cased, if case-insensitive
+  size_t len;
+};
+
+struct zsv_search {
+  unsigned int flags;
+  struct zsv_search_str *strs;
+  size_t count;
+  size_t capacity;
+  size_t min_len;
+
+  unsigned char compiled : 1;
+  unsigned char use_teddy : 1;
+  unsigned char _ : 6;
+
+  /**
+   * Teddy: each string is assigned to one of 8 buckets. For each of the first
+   * `fingerprint_len` byte positions, `lo` and `hi` map a byte's low and high
+   * nibble to the set of buckets with a string that has a byte with that
+   * nibble at that position. A position in the input where every byte of the
+   * fingerprint is in a common bucket is a candidate match for the strings in
+   * that bucket
+   */
+  struct {
+    unsigned int fingerprint_len;
+    unsigned char lo[ZSV_SEARCH_TEDDY_MAX_FINGERPRINT][16];
+    unsigned char hi[ZSV_SEARCH_TEDDY_MAX_FINGERPRINT][16];
+    size_t *buckets[ZSV_SEARCH_TEDDY_BUCKETS]; // string indexes
+    size_t bucket_count[ZSV_SEARCH_TEDDY_BUCKETS];
+  } teddy;
+
+  /**
+   * Aho-Corasick DFA. Input bytes are mapped to equivalence classes, so that
+   * each state's transition table only has an entry for each distinct byte
+   * used by the strings, plus one for all other bytes
+   */
+  struct {
+    uint16_t classes[256];
+    size_t class_count;
+    uint32_t *next;     // [state * class_count + class] => next state
+    uint32_t *out_len;  // length of the string that ends at this state, or 0
+    uint32_t *out_link; // nearest state on the failure path with out_len, or 0
+    size_t state_count;
+  } ac;
+};
+
+static inline unsigned char zsv_search_lower(unsigned char c) {
+  return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+static inline unsigned char zsv_search_upper(unsigned char c) {
+  return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+}
+
+zsv_search zsv_search_new(unsigned int flags) {
+  zsv_search s = calloc(1, sizeof(*s));
+  if (s)
+    s->flags = flags;
+  return s;
+}
+
+size_t zsv_search_count(zsv_search s) {
+  return s->count;
+}
+
+int zsv_search_add(zsv_search s, const unsigned char *str, size_t len) {
+  if (!len)
+    return 0;
+  if (s->compiled || len > UINT32_MAX)
+    return 1;
+
+  unsigned char *copy = malloc(len);
+  if (!copy)
+    return 1;
+  for (size_t i = 0; i < len; i++)
+    copy[i] = s->flags & ZSV_SEARCH_CASE_INSENSITIVE ? zsv_search_lower(str[i]) : str[i];
+
+  for (size_t i = 0; i < s->count; i++) {
+    if (s->strs[i].len == len && !memcmp(s->strs[i].str, copy, len)) {
+      free(copy); // duplicate
+      return 0;
+    }
+  }
+
+  if (s->count == s->capacity) {
+    size_t capacity = s->capacity ? s->capacity * 2 : 8;
+    struct zsv_search_str *strs = realloc(s->strs, capacity * sizeof(*strs));
+    if (!strs) {
+      free(copy);
+      return 1;
+    }
+    s->strs = strs;
+    s->capacity = capacity;
+  }
+  s->strs[s->count].str = copy;
+  s->strs[s->count].len = len;
+  s->count++;
+  if (!s->min_len || len < s->min_len)
+    s->min_len = len;
+  return 0;
+}
+
+#ifdef ZSV_SEARCH_TEDDY
+static void zsv_search_teddy_set(zsv_search s, unsigned int k, unsigned char c, unsigned char bucket_bit) {
+  s->teddy.lo[k][c & 0x0f] |= bucket_bit;
+  s->teddy.hi[k][c >> 4] |= bucket_bit;
+}
+
+static int zsv_search_compile_teddy(zsv_search s) {
+  unsigned int fingerprint_len =
+    s->min_len < ZSV_SEARCH_TEDDY_MAX_FINGERPRINT ? (unsigned int)s->min_len : ZSV_SEARCH_TEDDY_MAX_FINGERPRINT;
+  s->teddy.fingerprint_len = fingerprint_len;
+  unsigned char *bucket_of = malloc(s->count);
+  if (!bucket_of)
+    return 1;
+  for (size_t i = 0; i < s->count; i++) {
+    // strings with the same fingerprint share a bucket, which keeps the others selective
+    unsigned int h = 0;
+    for (unsigned int k = 0; k < fingerprint_len; k++)
+      h = h * 31 + s->strs[i].str[k];
+    unsigned char b = bucket_of[i] = (unsigned char)(h % ZSV_SEARCH_TEDDY_BUCKETS);
+    for (unsigned int k = 0; k < fingerprint_len; k++) {
+      unsigned char c = s->strs[i].str[k];
+      zsv_search_teddy_set(s, k, c, (unsigned char)(1 << b));
+      if (s->flags & ZSV_SEARCH_CASE_INSENSITIVE)
+        zsv_search_teddy_set(s, k, zsv_search_upper(c), (unsigned char)(1 << b));
+    }
+    s->teddy.bucket_count[b]++;
+  }
+  int err = 0;
+  for (unsigned int b = 0; b < ZSV_SEARCH_TEDDY_BUCKETS && !err; b++) {
+    if (s->teddy.bucket_count[b] && !(s->teddy.buckets[b] = malloc(s->teddy.bucket_count[b] * sizeof(size_t))))
+      err = 1;
+    s->teddy.bucket_count[b] = 0;
+  }
+  for (size_t i = 0; i < s->count && !err; i++)
+    s->teddy.buckets[bucket_of[i]][s->teddy.bucket_count[bucket_of[i]]++] = i;
+  free(bucket_of);
+  return err;
+}
+#endif
+
+static int zsv_search_compile_ac(zsv_search s) {
+  // assign equivalence classes; class 0 is for bytes that are in no string
+  size_t class_count = 1;
+  for (size_t i = 0; i < s->count; i++) {
+    for (size_t j = 0; j < s->strs[i].len; j++) {
+      unsigned char c = s->strs[i].str[j];
+      if (!s->ac.classes[c]) {
+        s->ac.classes[c] = (uint16_t)class_count;
+        if (s->flags & ZSV_SEARCH_CASE_INSENSITIVE)
+          s->ac.classes[zsv_search_upper(c)] = (uint16_t)class_count;
+        class_count++;
+      }
+    }
+  }
+  s->ac.class_count = class_count;
+
+  size_t max_states = 1;
+  for (size_t i = 0; i < s->count; i++)
+    max_states += s->strs[i].len;
+  if (max_states > UINT32_MAX)
+    return 1;
+
+  s->ac.next = calloc(max_states * class_count, sizeof(*s->ac.next));
+  s->ac.out_len = calloc(max_states, sizeof(*s->ac.out_len));
+  s->ac.out_link = calloc(max_states, sizeof(*s->ac.out_link));
+  uint32_t *fail = calloc(max_states, sizeof(*fail));
+  uint32_t *queue = calloc(max_states, sizeof(*queue));
+  int err = !(s->ac.next && s->ac.out_len && s->ac.out_link && fail && queue);
+
+  if (!err) {
+    // build the trie. State 0 is the root, so during the build 0 means "no edge"
+    uint32_t *next = s->ac.next;
+    size_t state_count = 1;
+    for (size_t i = 0; i < s->count; i++) {
+      uint32_t state = 0;
+      for (size_t j = 0; j < s->strs[i].len; j++) {
+        uint32_t *edge = &next[state * class_count + s->ac.classes[s->strs[i].str[j]]];
+        if (!*edge)
+          *edge = (uint32_t)state_count++;
+        state = *edge;
+      }
+      s->ac.out_len[state] = (uint32_t)s->strs[i].len;
+    }
+    s->ac.state_count = state_count;
+
+    // breadth-first, set failure links and fill in missing edges to make a DFA
+    size_t head = 0, tail = 0;
+    for (size_t c = 0; c < class_count; c++)
+      if (next[c])
+        queue[tail++] = next[c]; // fail and out_link are already 0
+    while (head < tail) {
+      uint32_t u = queue[head++];
+      for (size_t c = 0; c < class_count; c++) {
+        uint32_t *edge = &next[u * class_count + c];
+        uint32_t via_fail = next[fail[u] * class_count + c];
+        if (*edge) {
+          uint32_t v = *edge;
+          fail[v] = via_fail;
+          s->ac.out_link[v] = s->ac.out_len[via_fail] ? via_fail : s->ac.out_link[via_fail];
+          queue[tail++] = v;
+        } else
+          *edge = via_fail;
+      }
+    }
+  }
+  free(fail);
+  free(queue);
+  return err;
+}
+
+int zsv_search_compile(zsv_search s) {
+  if (s->compiled)
+    return 0;
+  int err;
+#ifdef ZSV_SEARCH_TEDDY
+  if (!(s->flags & ZSV_SEARCH_NO_SIMD) && s->count && s->count <= ZSV_SEARCH_TEDDY_MAX_STRINGS) {
+    s->use_teddy = 1;
+    err = zsv_search_compile_teddy(s);
+  } else
+#endif
+    err = zsv_search_compile_ac(s);
+  if (!err)
+    s->compiled = 1;
+  return err;
+}
+
+static inline int zsv_search_eq(zsv_search s, const unsigned char *buff, const struct zsv_search_str *str) {
+  if (!(s->flags & ZSV_SEARCH_CASE_INSENSITIVE))
+    return !memcmp(buff, str->str, str->len);
+  for (size_t i = 0; i < str->len; i++)
+    if (zsv_search_lower(buff[i]) != str->str[i])
+      return 0;
+  return 1;
+}
+
+#ifdef ZSV_SEARCH_TEDDY
+/**
+ * Verify a Teddy candidate at `pos` against the strings in the given buckets
+ */
+static int zsv_search_teddy_verify(zsv_search s, const unsigned char *buff, size_t len, size_t pos,
+                                   unsigned int buckets, zsv_search_accept accept, void *ctx) {
+  while (buckets) {
+    unsigned int b = (unsigned int)__builtin_ctz(buckets);
+    buckets &= buckets - 1;
+    for (size_t i = 0; i < s->teddy.bucket_count[b]; i++) {
+      const struct zsv_search_str *str = &s->strs[s->teddy.buckets[b][i]];
+      if (pos + str->len <= len && zsv_search_eq(s, buff + pos, str) && (!accept || accept(ctx, pos, str->len)))
+        return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * For each byte of `v`, the buckets that contain its low nibble and its high nibble
+ */
+static inline zsv_search_vec zsv_search_teddy_buckets(zsv_search_vec lo, zsv_search_vec hi, zsv_search_vec v,
+                                                      zsv_search_vec nibble_mask) {
+  return zsv_search_vec_and(zsv_search_vec_shuffle(lo, zsv_search_vec_and(v, nibble_mask)),
+                            zsv_search_vec_shuffle(hi, zsv_search_vec_and(zsv_search_vec_srl4(v), nibble_mask)));
+}
+
+static int zsv_search_scan_teddy(zsv_search s, const unsigned char *buff, size_t len, zsv_search_accept accept,
+                                 void *ctx) {
+  const unsigned int fingerprint_len = s->teddy.fingerprint_len;
+  size_t i = 0;
+  if (len >= ZSV_SEARCH_TEDDY + fingerprint_len - 1) {
+    zsv_search_vec lo[ZSV_SEARCH_TEDDY_MAX_FINGERPRINT], hi[ZSV_SEARCH_TEDDY_MAX_FINGERPRINT];
+    for (unsigned int k = 0; k < fingerprint_len; k++) {
+      lo[k] = zsv_search_vec_table(s->teddy.lo[k]);
+      hi[k] = zsv_search_vec_table(s->teddy.hi[k]);
+    }
+    const zsv_search_vec nibble_mask = zsv_search_vec_set1(0x0f);
+    const uint32_t all = ZSV_SEARCH_TEDDY == 32 ? UINT32_MAX : 0xffff;
+    for (; i + ZSV_SEARCH_TEDDY + fingerprint_len - 1 <= len; i += ZSV_SEARCH_TEDDY) {
+      zsv_search_vec res = zsv_search_teddy_buckets(lo[0], hi[0], zsv_search_vec_load(buff + i), nibble_mask);
+      for (unsigned int k = 1; k < fingerprint_len; k++)
+        res = zsv_search_vec_and(
+          res, zsv_search_teddy_buckets(lo[k], hi[k], zsv_search_vec_load(buff + i + k), nibble_mask));
+      uint32_t candidates = zsv_search_vec_zero_mask(res) ^ all;
+      if (candidates) {
+        unsigned char buckets[ZSV_SEARCH_TEDDY];
+        zsv_search_vec_store(buckets, res);
+        do {
+          unsigned int j = (unsigned int)__builtin_ctz(candidates);
+          candidates &= candidates - 1;
+          if (zsv_search_teddy_verify(s, buff, len, i + j, buckets[j], accept, ctx))
+            return 1;
+        } while (candidates);
+      }
+    }
+  }
+  // remainder, using the same tables one position at a time
+  for (; i + fingerprint_len <= len; i++) {
+    unsigned int buckets = 0xff;
+    for (unsigned int k = 0; k < fingerprint_len && buckets; k++)
+      buckets &= s->teddy.lo[k][buff[i + k] & 0x0f] & s->teddy.hi[k][buff[i + k] >> 4];
+    if (buckets && zsv_search_teddy_verify(s, buff, len, i, buckets, accept, ctx))
+      return 1;
+  }
+  return 0;
+}
+#endif
+
+static int zsv_search_scan_ac(zsv_search s, const unsigned char *buff, size_t len, zsv_search_accept accept,
+                              void *ctx) {
+  const uint32_t *next = s->ac.next;
+  const uint32_t *out_len = s->ac.out_len;
+  const uint32_t *out_link = s->ac.out_link;
+  const uint16_t *classes = s->ac.classes;
+  const size_t class_count = s->ac.class_count;
+  uint32_t state = 0;
+  for (size_t i = 0; i < len; i++) {
+    state = next[state * class_count + classes[buff[i]]];
+    if (out_len[state] | out_link[state]) {
+      for (uint32_t t = state; t; t = out_link[t]) {
+        if (out_len[t] && (!accept || accept(ctx, i + 1 - out_len[t], out_len[t])))
+          return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int zsv_search_scan(zsv_search s, const unsigned char *buff, size_t len, zsv_search_accept accept, void *ctx) {
+  if (!s->compiled || !s->count || len < s->min_len)
+    return 0;
+#ifdef ZSV_SEARCH_TEDDY
+  if (s->use_teddy)
+    return zsv_search_scan_teddy(s, buff, len, accept, ctx);
+#endif
+  return zsv_search_scan_ac(s, buff, len, accept, ctx);
+}
+
+void zsv_search_delete(zsv_search s) {
+  if (s) {
+    for (size_t i = 0; i < s->count; i++)
+      free(s->strs[i].str);
+    free(s->strs);
+    for (unsigned int b = 0; b < ZSV_SEARCH_TEDDY_BUCKETS; b++)
+      free(s->teddy.buckets[b]);
+    free(s->ac.next);
+    free(s->ac.out_len);
+    free(s->ac.out_link);
+    free(s);
+  }
+}
@@ -20,6 +20,8 @@
 #include "../../src/zsv_strencode.c"
 #endif
 
+#include "../../src/zsv_vector.h"
+
 #ifndef NO_UTF8PROC
 #include <utf8proc.h>
 
@@ -327,6 +329,185 @@ size_t zsv_strunescape_backslash(unsigned char *s, size_t len) {
   return j;
 }
 
+/**
+ * Return the number of leading bytes of s that no cleaning step changes: ASCII
+ * above space, other than '\\' if unescaping
+ */
+static size_t zsv_strclean_plain_len(const unsigned char *s, size_t len, char backslash) {
+  size_t i = 0;
+  // signed compare: bytes >= 0x80 are negative, so one compare flags both them and bytes <= ' '
+  zsv_sc_vector space, bs;
+  memset(&space, '!', sizeof(space));
+  memset(&bs, backslash ? '\\' : '!', sizeof(bs));
+  for (; i + sizeof(zsv_sc_vector) <= len; i += sizeof(zsv_sc_vector)) {
+    zsv_sc_vector v;
+    memcpy(&v, s + i, sizeof(v));
+    zsv_mask_t mask = movemask_pseudo((v < space) | (v == bs));
+    if (mask)
+      return i + (size_t)__builtin_ctzll(mask);
+  }
+  for (; i < len; i++)
+    if (s[i] <= ' ' || s[i] >= 128 || (backslash && s[i] == '\\'))
+      break;
+  return i;
+}
+
+static int zsv_strclean_has_escape(const unsigned char *s, size_t len) {
+  const unsigned char *end = s + len;
+  if (len < 2)
+    return 0;
+  for (const unsigned char *p = s; (p = memchr(p, '\\', end - p - 1)); p++)
+    if (p[1] == 't' || p[1] == 'n' || p[1] == 'r')
+      return 1;
+  return 0;
+}
+
+static inline int zsv_strclean_is_escape(const unsigned char *s, size_t i, size_t len, char backslash, char c) {
+  return backslash && s[i] == '\\' && i + 1 < len && s[i + 1] == c;
+}
+
+/**
+ * zsv_strclean(): apply, in a single pass, the same changes as
+ * zsv_strunescape_backslash(), zsv_strtrim(), zsv_strwhite() and embedded line
+ * end replacement, in that order. Runs of bytes that no step changes are
+ * skipped (and, once the value has shrunk, moved) in bulk
+ */
+unsigned char *zsv_strclean(unsigned char *s, size_t *lenp, char *quoted, unsigned int flags, unsigned char lineend) {
+  const size_t len = *lenp;
+  if ((flags & ZSV_STRCLEAN_UNESCAPE) && zsv_strclean_has_escape(s, len)) {
+    if (quoted)
+      *quoted = 1;
+  } else
+    flags &= ~ZSV_STRCLEAN_UNESCAPE;
+  if (!lineend || !quoted || !*quoted)
+    flags &= ~(ZSV_STRCLEAN_LINEEND | ZSV_STRCLEAN_LINEEND_TRIM);
+  else if (!(flags & ZSV_STRCLEAN_LINEEND))
+    flags &= ~ZSV_STRCLEAN_LINEEND_TRIM;
+
+  const char backslash = (flags & ZSV_STRCLEAN_UNESCAPE) != 0;
+  const char white = (flags & ZSV_STRCLEAN_WHITE) != 0;
+  const char newlines = !(flags & ZSV_STRCLEAN_WHITE_NO_NEWLINE);
+  const char replace_lineends = (flags & ZSV_STRCLEAN_LINEEND) != 0;
+  const char trim = (flags & (ZSV_STRCLEAN_TRIM | ZSV_STRCLEAN_LINEEND_TRIM)) != 0;
+  // a replaced line end is only trimmed if it is trimmed after replacement, and is replaced with a space
+  const char trim_lineends = (flags & ZSV_STRCLEAN_LINEEND_TRIM) && lineend == ' ';
+  // with white cleaning, trailing space is never output, and leading space is trimmed before cleaning
+  char leading = white ? (flags & ZSV_STRCLEAN_TRIM) != 0 : trim;
+
+  const size_t none = (size_t)-1;
+  size_t start = none; // start of output; output is written in place from s + start up to s + j
+  size_t j = 0, keep = 0;
+  char pending = 0, replacement = ' ';
+
+  for (size_t i = 0; i < len;) {
+    if (!pending) {
+      size_t n = zsv_strclean_plain_len(s + i, len - i, backslash);
+      if (n) {
+        if (start == none)
+          start = j = i;
+        else if (j != i)
+          memmove(s + j, s + i, n);
+        i += n, j += n, keep = j;
+        leading = 0;
+        continue;
+      }
+    }
+
+    size_t at = i, clen = 1;
+    int c = s[i];
+    char is_z = 0, is_space = 0, is_newline = 0, copy = 1;
+    if (UNLIKELY(backslash && c == '\\') && i + 1 < len && memchr("tnr", s[i + 1], 3)) {
+      c = s[i + 1] == 't' ? '\t' : s[i + 1] == 'n' ? '\n' : '\r';
+      clen = 2, copy = 0;
+    }
+
+    if (c < 128) {
+      if ((c == '\r' || c == '\n') && replace_lineends && !white) {
+        if (c == '\r') {
+          if (i + clen < len && s[i + clen] == '\n')
+            clen++;
+          else if (zsv_strclean_is_escape(s, i + clen, len, backslash, 'n'))
+            clen += 2;
+        }
+        c = lineend, copy = 0;
+        is_z = trim_lineends;
+      } else {
+        is_z = c == ' ';
+        is_space = isspace(c) != 0;
+        is_newline = (c == '\n' || c == '\r') && newlines;
+      }
+    } else {
+      utf8proc_int32_t codepoint;
+      utf8proc_ssize_t bytes_read = utf8proc_iterate(s + i, (utf8proc_ssize_t)(len - i), &codepoint);
+      if (UNLIKELY(bytes_read < 1)) { // bad UTF8
+        if (white)
+          c = '?', copy = 0;
+      } else {
+        clen = (size_t)bytes_read;
+        switch (utf8proc_category(codepoint)) {
+        case UTF8PROC_CATEGORY_ZL:
+        case UTF8PROC_CATEGORY_ZP:
+          is_newline = newlines;
+          // fall through
+        case UTF8PROC_CATEGORY_ZS:
+          is_z = is_space = 1;
+          break;
+        default:
+          break;
+        }
+      }
+    }
+    i += clen;
+
+    if (leading) {
+      if (is_z)
+        continue;
+      leading = 0;
+    }
+
+    if (white) {
+      if (is_space) {
+        if (is_newline)
+          replacement = '\n';
+        else if (!pending)
+          replacement = ' ';
+        pending = 1;
+        continue;
+      }
+      if (pending) {
+        unsigned char r = replacement == '\n' && replace_lineends ? lineend : replacement;
+        pending = 0;
+        if (start != none)
+          s[j++] = r;
+        else if (!((flags & ZSV_STRCLEAN_LINEEND_TRIM) && r == ' ')) {
+          start = j = at - 1; // the preceding space is at least one byte
+          s[j++] = r;
+        }
+      }
+    }
+
+    if (start == none)
+      start = j = at;
+    if (copy) {
+      if (j != at)
+        memmove(s + j, s + at, clen);
+      j += clen;
+    } else
+      s[j++] = (unsigned char)c;
+    if (!is_z)
+      keep = j;
+  }
+
+  if (start == none) {
+    *lenp = 0;
+    return s;
+  }
+  if (trim && !white)
+    j = keep;
+  *lenp = j - start;
+  return s + start;
+}
+
 // zsv_strtod_exact(const char *s): return error; if 0, set value of *d
 int zsv_strtod_exact(const char *s, double *d) {
   if (!*s)
@@ -341,7 +522,7 @@ int zsv_strtod_exact(const char *s, double *d) {
 #ifndef ZSV_STRING_LIB_ONLY
 struct zsv_cell zsv_get_cell_trimmed(zsv_parser parser, size_t ix) {
   struct zsv_cell c = zsv_get_cell(parser, ix);
-  c.str = (unsigned char *)zsv_strtrim(c.str, &c.len);
+  c.str = zsv_strclean(c.str, &c.len, NULL, ZSV_STRCLEAN_TRIM, 0);
   return c;
 }
 #endif
@@ -0,0 +1,759 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <zsv/utils/where.h>
+#include <zsv/utils/memmem.h>
+
+#define ZSV_WHERE_MAX_DEPTH 256
+#define ZSV_WHERE_NO_COLUMN SIZE_MAX
+
+enum zsv_where_op {
+  zsv_where_op_eq = 0,
+  zsv_where_op_ne,
+  zsv_where_op_lt,
+  zsv_where_op_le,
+  zsv_where_op_gt,
+  zsv_where_op_ge,
+  zsv_where_op_in,
+  zsv_where_op_contains,
+  zsv_where_op_startswith,
+  zsv_where_op_endswith
+};
+
+struct zsv_where_value {
+  const unsigned char *str;
+  size_t len;
+  double num;
+  char is_number;
+};
+
+/**
+ * A single test of one column against a value, a list of values or another column
+ */
+struct zsv_where_test {
+  enum zsv_where_op op;
+  char numeric; // compare as numbers
+  const char *col_name;
+  const char *col2_name; // NULL if comparing to a value
+  size_t col;
+  size_t col2;
+  struct zsv_where_value value;
+  struct zsv_where_value *list; // sorted, for `in`
+  size_t list_count;
+};
+
+/**
+ * Compiled code: tests, with jumps to short-circuit `and` and `or`. The result
+ * of the last test (or `not`) is kept in an accumulator
+ */
+enum zsv_where_opcode {
+  zsv_where_opcode_test = 0,      // acc = tests[arg]
+  zsv_where_opcode_jump_if_true,  // if acc, continue at arg
+  zsv_where_opcode_jump_if_false, // if !acc, continue at arg
+  zsv_where_opcode_not            // acc = !acc
+};
+
+struct zsv_where_inst {
+  enum zsv_where_opcode opcode;
+  uint32_t arg;
+};
+
+struct zsv_where {
+  struct zsv_where_test *tests;
+  size_t test_count;
+  size_t test_capacity;
+
+  struct zsv_where_inst *code;
+  size_t code_len;
+  size_t code_capacity;
+
+  void **allocs; // strings and lists, freed on delete
+  size_t alloc_count;
+  size_t alloc_capacity;
+
+  size_t column_count;
+};
+
+/**
+ * Parse tree
+ */
+enum zsv_where_node_type { zsv_where_node_test = 0, zsv_where_node_and, zsv_where_node_or, zsv_where_node_not };
+
+struct zsv_where_node {
+  enum zsv_where_node_type type;
+  struct zsv_where_node *left, *right; // right is unused for `not`
+  uint32_t test;
+  struct zsv_where_node *all; // next allocated node, for cleanup
+};
+
+enum zsv_where_token_type {
+  zsv_where_token_end = 0,
+  zsv_where_token_lparen,
+  zsv_where_token_rparen,
+  zsv_where_token_comma,
+  zsv_where_token_op,
+  zsv_where_token_word,   // bare column name or keyword
+  zsv_where_token_column, // double-quoted column name
+  zsv_where_token_string, // single-quoted string
+  zsv_where_token_number
+};
+
+struct zsv_where_token {
+  enum zsv_where_token_type type;
+  const unsigned char *str; // for a quoted token, excludes the quotes
+  size_t len;
+  enum zsv_where_op op;
+};
+
+struct zsv_where_parser {
+  const unsigned char *p, *end;
+  struct zsv_where_token tok;
+  unsigned int depth;
+  const char *err;
+  struct zsv_where *w;
+  struct zsv_where_node *nodes;
+};
+
+static void *zsv_where_alloc(struct zsv_where_parser *ps, size_t size) {
+  struct zsv_where *w = ps->w;
+  if (w->alloc_count == w->alloc_capacity) {
+    size_t capacity = w->alloc_capacity ? w->alloc_capacity * 2 : 16;
+    void **allocs = realloc(w->allocs, capacity * sizeof(*allocs));
+    if (!allocs) {
+      ps->err = "out of memory";
+      return NULL;
+    }
+    w->allocs = allocs;
+    w->alloc_capacity = capacity;
+  }
+  void *p = calloc(1, size ? size : 1);
+  if (!p)
+    ps->err = "out of memory";
+  else
+    w->allocs[w->alloc_count++] = p;
+  return p;
+}
+
+static int zsv_where_is_word_char(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' ||
+         c >= 0x80;
+}
+
+static int zsv_where_is_digit(unsigned char c) {
+  return c >= '0' && c <= '9';
+}
+
+/**
+ * Case-insensitive (ASCII) comparison of a token to a NUL-terminated string
+ */
+static int zsv_where_token_is(const struct zsv_where_token *tok, const char *s) {
+  if (tok->type != zsv_where_token_word || tok->len != strlen(s))
+    return 0;
+  for (size_t i = 0; i < tok->len; i++) {
+    unsigned char c = tok->str[i];
+    if (c >= 'A' && c <= 'Z')
+      c = c - 'A' + 'a';
+    if (c != (unsigned char)s[i])
+      return 0;
+  }
+  return 1;
+}
+
+static int zsv_where_next(struct zsv_where_parser *ps) {
+  struct zsv_where_token *tok = &ps->tok;
+  while (ps->p < ps->end && (*ps->p == ' ' || *ps->p == '\t' || *ps->p == '\r' || *ps->p == '\n'))
+    ps->p++;
+  memset(tok, 0, sizeof(*tok));
+  if (ps->p == ps->end)
+    return 0;
+
+  const unsigned char *s = ps->p;
+  tok->str = s;
+  switch (*s) {
+  case '(':
+    tok->type = zsv_where_token_lparen;
+    tok->len = 1;
+    break;
+  case ')':
+    tok->type = zsv_where_token_rparen;
+    tok->len = 1;
+    break;
+  case ',':
+    tok->type = zsv_where_token_comma;
+    tok->len = 1;
+    break;
+  case '=':
+    tok->type = zsv_where_token_op;
+    tok->op = zsv_where_op_eq;
+    tok->len = s + 1 < ps->end && s[1] == '=' ? 2 : 1;
+    break;
+  case '!':
+    if (s + 1 == ps->end || s[1] != '=') {
+      ps->err = "unexpected '!'";
+      return 1;
+    }
+    tok->type = zsv_where_token_op;
+    tok->op = zsv_where_op_ne;
+    tok->len = 2;
+    break;
+  case '<':
+  case '>':
+    tok->type = zsv_where_token_op;
+    tok->len = 1;
+    if (s + 1 < ps->end && s[1] == '=') {
+      tok->op = *s == '<' ? zsv_where_op_le : zsv_where_op_ge;
+      tok->len = 2;
+    } else if (*s == '<' && s + 1 < ps->end && s[1] == '>') {
+      tok->op = zsv_where_op_ne;
+      tok->len = 2;
+    } else
+      tok->op = *s == '<' ? zsv_where_op_lt : zsv_where_op_gt;
+    break;
+  case '\'':
+  case '"': {
+    // quoted string or column name; a doubled quote stands for itself
+    unsigned char q = *s;
+    const unsigned char *e = s + 1;
+    for (;; e++) {
+      if (e == ps->end) {
+        ps->err = q == '\'' ? "unterminated string" : "unterminated column name";
+        return 1;
+      }
+      if (*e == q) {
+        if (e + 1 < ps->end && e[1] == q)
+          e++;
+        else
+          break;
+      }
+    }
+    tok->type = q == '\'' ? zsv_where_token_string : zsv_where_token_column;
+    tok->str = s + 1;
+    tok->len = e - s - 1;
+    ps->p = e + 1;
+    return 0;
+  }
+  default: {
+    const unsigned char *e = s;
+    if ((*e == '-' || *e == '+') && e + 1 < ps->end && (zsv_where_is_digit(e[1]) || e[1] == '.'))
+      e++;
+    if (zsv_where_is_digit(*e) || (*e == '.' && e + 1 < ps->end && zsv_where_is_digit(e[1]))) {
+      while (e < ps->end && (zsv_where_is_digit(*e) || *e == '.'))
+        e++;
+      if (e < ps->end && (*e == 'e' || *e == 'E')) {
+        const unsigned char *x = e + 1;
+        if (x < ps->end && (*x == '-' || *x == '+'))
+          x++;
+        if (x < ps->end && zsv_where_is_digit(*x)) {
+          for (e = x; e < ps->end && zsv_where_is_digit(*e); e++)
+            ;
+        }
+      }
+      tok->type = zsv_where_token_number;
+    } else if (zsv_where_is_word_char(*e)) {
+      while (e < ps->end && zsv_where_is_word_char(*e))
+        e++;
+      tok->type = zsv_where_token_word;
+    } else {
+      ps->err = "unexpected character";
+      return 1;
+    }
+    tok->len = e - s;
+  }
+  }
+  ps->p = s + tok->len;
+  return 0;
+}
+
+/**
+ * Copy a token's text, replacing doubled quotes in quoted tokens
+ */
+static char *zsv_where_token_dup(struct zsv_where_parser *ps, size_t *lenp) {
+  const struct zsv_where_token *tok = &ps->tok;
+  char *s = zsv_where_alloc(ps, tok->len + 1);
+  if (s) {
+    size_t len = 0;
+    char quoted = tok->type == zsv_where_token_string || tok->type == zsv_where_token_column;
+    for (size_t i = 0; i < tok->len; i++) {
+      s[len++] = (char)tok->str[i];
+      if (quoted && tok->str[i] == tok->str[-1] && i + 1 < tok->len)
+        i++;
+    }
+    s[len] = '\0';
+    if (lenp)
+      *lenp = len;
+  }
+  return s;
+}
+
+struct zsv_where_operand {
+  const char *column; // NULL if a value
+  struct zsv_where_value value;
+};
+
+static int zsv_where_parse_value(struct zsv_where_parser *ps, struct zsv_where_value *v) {
+  if (ps->tok.type != zsv_where_token_string && ps->tok.type != zsv_where_token_number) {
+    ps->err = "expected a value";
+    return 1;
+  }
+  char *s = zsv_where_token_dup(ps, &v->len);
+  if (!s)
+    return 1;
+  v->str = (const unsigned char *)s;
+  if ((v->is_number = ps->tok.type == zsv_where_token_number))
+    v->num = strtod(s, NULL);
+  return zsv_where_next(ps);
+}
+
+static int zsv_where_parse_operand(struct zsv_where_parser *ps, struct zsv_where_operand *o) {
+  memset(o, 0, sizeof(*o));
+  if (ps->tok.type == zsv_where_token_word || ps->tok.type == zsv_where_token_column) {
+    if (!(o->column = zsv_where_token_dup(ps, NULL)))
+      return 1;
+    return zsv_where_next(ps);
+  }
+  return zsv_where_parse_value(ps, &o->value);
+}
+
+static int zsv_where_cmp_value_num(const void *x, const void *y) {
+  const struct zsv_where_value *a = x, *b = y;
+  return a->num < b->num ? -1 : a->num > b->num;
+}
+
+static int zsv_where_strcmp(const unsigned char *a, size_t alen, const unsigned char *b, size_t blen) {
+  int c = alen && blen ? memcmp(a, b, alen < blen ? alen : blen) : 0;
+  return c ? c : (alen > blen) - (alen < blen);
+}
+
+static int zsv_where_cmp_value_str(const void *x, const void *y) {
+  const struct zsv_where_value *a = x, *b = y;
+  return zsv_where_strcmp(a->str, a->len, b->str, b->len);
+}
+
+static int zsv_where_parse_list(struct zsv_where_parser *ps, struct zsv_where_test *t) {
+  if (ps->tok.type != zsv_where_token_lparen) {
+    ps->err = "expected '(' after in";
+    return 1;
+  }
+  // count the values first, so that the list can be allocated once
+  size_t count = 1;
+  for (const unsigned char *s = ps->p; s < ps->end && *s != ')'; s++) {
+    if (*s == '\'') {
+      for (s++; s < ps->end && *s != '\''; s++)
+        ;
+    } else if (*s == ',')
+      count++;
+  }
+  if (!(t->list = zsv_where_alloc(ps, count * sizeof(*t->list))))
+    return 1;
+  t->numeric = 1;
+  if (zsv_where_next(ps))
+    return 1;
+  for (;;) {
+    if (t->list_count == count) {
+      ps->err = "expected ')'";
+      return 1;
+    }
+    struct zsv_where_value *v = &t->list[t->list_count++];
+    if (zsv_where_parse_value(ps, v))
+      return 1;
+    if (!v->is_number)
+      t->numeric = 0;
+    if (ps->tok.type == zsv_where_token_rparen)
+      break;
+    if (ps->tok.type != zsv_where_token_comma) {
+      ps->err = "expected ',' or ')'";
+      return 1;
+    }
+    if (zsv_where_next(ps))
+      return 1;
+  }
+  qsort(t->list, t->list_count, sizeof(*t->list), t->numeric ? zsv_where_cmp_value_num : zsv_where_cmp_value_str);
+  return zsv_where_next(ps);
+}
+
+static struct zsv_where_node *zsv_where_node_new(struct zsv_where_parser *ps, enum zsv_where_node_type type,
+                                                 struct zsv_where_node *left, struct zsv_where_node *right) {
+  struct zsv_where_node *n = calloc(1, sizeof(*n));
+  if (!n) {
+    ps->err = "out of memory";
+    return NULL;
+  }
+  n->type = type;
+  n->left = left;
+  n->right = right;
+  n->all = ps->nodes;
+  ps->nodes = n;
+  return n;
+}
+
+static struct zsv_where_node *zsv_where_parse_test(struct zsv_where_parser *ps) {
+  struct zsv_where *w = ps->w;
+  struct zsv_where_test t;
+  struct zsv_where_operand left, right;
+  memset(&t, 0, sizeof(t));
+  t.col = t.col2 = ZSV_WHERE_NO_COLUMN;
+  if (zsv_where_parse_operand(ps, &left))
+    return NULL;
+
+  char negate = 0;
+  if (zsv_where_token_is(&ps->tok, "not")) {
+    negate = 1;
+    if (zsv_where_next(ps))
+      return NULL;
+  }
+
+  if (ps->tok.type == zsv_where_token_op && !negate) {
+    static const enum zsv_where_op flipped[] = {zsv_where_op_eq, zsv_where_op_ne, zsv_where_op_gt,
+                                                zsv_where_op_ge, zsv_where_op_lt, zsv_where_op_le};
+    t.op = ps->tok.op;
+    if (zsv_where_next(ps) || zsv_where_parse_operand(ps, &right))
+      return NULL;
+    if (!left.column && !right.column) {
+      ps->err = "a comparison must refer to a column";
+      return NULL;
+    }
+    if (!left.column) { // value <op> column
+      struct zsv_where_operand tmp = left;
+      left = right;
+      right = tmp;
+      t.op = flipped[t.op];
+    }
+    t.col_name = left.column;
+    if (right.column)
+      t.col2_name = right.column;
+    else {
+      t.value = right.value;
+      t.numeric = right.value.is_number;
+    }
+  } else {
+    if (zsv_where_token_is(&ps->tok, "in"))
+      t.op = zsv_where_op_in;
+    else if (zsv_where_token_is(&ps->tok, "contains"))
+      t.op = zsv_where_op_contains;
+    else if (zsv_where_token_is(&ps->tok, "startswith"))
+      t.op = zsv_where_op_startswith;
+    else if (zsv_where_token_is(&ps->tok, "endswith"))
+      t.op = zsv_where_op_endswith;
+    else {
+      ps->err = "expected a comparison";
+      return NULL;
+    }
+    if (!left.column) {
+      ps->err = "expected a column before in, contains, startswith or endswith";
+      return NULL;
+    }
+    t.col_name = left.column;
+    if (zsv_where_next(ps))
+      return NULL;
+    if (t.op == zsv_where_op_in ? zsv_where_parse_list(ps, &t) : zsv_where_parse_value(ps, &t.value))
+      return NULL;
+  }
+
+  if (w->test_count == w->test_capacity) {
+    size_t capacity = w->test_capacity ? w->test_capacity * 2 : 8;
+    struct zsv_where_test *tests = realloc(w->tests, capacity * sizeof(*tests));
+    if (!tests) {
+      ps->err = "out of memory";
+      return NULL;
+    }
+    w->tests = tests;
+    w->test_capacity = capacity;
+  }
+  w->tests[w->test_count] = t;
+  struct zsv_where_node *n = zsv_where_node_new(ps, zsv_where_node_test, NULL, NULL);
+  if (n)
+    n->test = (uint32_t)w->test_count++;
+  return n && negate ? zsv_where_node_new(ps, zsv_where_node_not, n, NULL) : n;
+}
+
+static struct zsv_where_node *zsv_where_parse_or(struct zsv_where_parser *ps);
+
+static struct zsv_where_node *zsv_where_parse_not(struct zsv_where_parser *ps) {
+  if (++ps->depth > ZSV_WHERE_MAX_DEPTH) {
+    ps->err = "expression nested too deeply";
+    return NULL;
+  }
+  struct zsv_where_node *n;
+  if (zsv_where_token_is(&ps->tok, "not")) {
+    if (zsv_where_next(ps) || !(n = zsv_where_parse_not(ps)))
+      return NULL;
+    n = zsv_where_node_new(ps, zsv_where_node_not, n, NULL);
+  } else if (ps->tok.type == zsv_where_token_lparen) {
+    if (zsv_where_next(ps) || !(n = zsv_where_parse_or(ps)))
+      return NULL;
+    if (ps->tok.type != zsv_where_token_rparen) {
+      ps->err = "expected ')'";
+      return NULL;
+    }
+    if (zsv_where_next(ps))
+      return NULL;
+  } else
+    n = zsv_where_parse_test(ps);
+  ps->depth--;
+  return n;
+}
+
+static struct zsv_where_node *zsv_where_parse_and(struct zsv_where_parser *ps) {
+  struct zsv_where_node *n = zsv_where_parse_not(ps);
+  while (n && zsv_where_token_is(&ps->tok, "and")) {
+    struct zsv_where_node *right;
+    if (zsv_where_next(ps) || !(right = zsv_where_parse_not(ps)))
+      return NULL;
+    n = zsv_where_node_new(ps, zsv_where_node_and, n, right);
+  }
+  return n;
+}
+
+static struct zsv_where_node *zsv_where_parse_or(struct zsv_where_parser *ps) {
+  struct zsv_where_node *n = zsv_where_parse_and(ps);
+  while (n && zsv_where_token_is(&ps->tok, "or")) {
+    struct zsv_where_node *right;
+    if (zsv_where_next(ps) || !(right = zsv_where_parse_and(ps)))
+      return NULL;
+    n = zsv_where_node_new(ps, zsv_where_node_or, n, right);
+  }
+  return n;
+}
+
+static int zsv_where_emit_inst(struct zsv_where *w, enum zsv_where_opcode opcode, uint32_t arg) {
+  if (w->code_len == w->code_capacity) {
+    size_t capacity = w->code_capacity ? w->code_capacity * 2 : 16;
+    struct zsv_where_inst *code = realloc(w->code, capacity * sizeof(*code));
+    if (!code)
+      return 1;
+    w->code = code;
+    w->code_capacity = capacity;
+  }
+  w->code[w->code_len].opcode = opcode;
+  w->code[w->code_len].arg = arg;
+  w->code_len++;
+  return 0;
+}
+
+static int zsv_where_emit(struct zsv_where *w, const struct zsv_where_node *n) {
+  switch (n->type) {
+  case zsv_where_node_test:
+    return zsv_where_emit_inst(w, zsv_where_opcode_test, n->test);
+  case zsv_where_node_not:
+    return zsv_where_emit(w, n->left) || zsv_where_emit_inst(w, zsv_where_opcode_not, 0);
+  case zsv_where_node_and:
+  case zsv_where_node_or: {
+    // evaluate the right side only if the left side does not decide the result
+    if (zsv_where_emit(w, n->left))
+      return 1;
+    size_t jump = w->code_len;
+    if (zsv_where_emit_inst(w,
+                            n->type == zsv_where_node_and ? zsv_where_opcode_jump_if_false
+                                                          : zsv_where_opcode_jump_if_true,
+                            0) ||
+        zsv_where_emit(w, n->right))
+      return 1;
+    w->code[jump].arg = (uint32_t)w->code_len;
+    return 0;
+  }
+  }
+  return 1;
+}
+
+zsv_where zsv_where_new(const unsigned char *expr, size_t len, const char **err) {
+  struct zsv_where_parser ps;
+  memset(&ps, 0, sizeof(ps));
+  if (!(ps.w = calloc(1, sizeof(*ps.w))))
+    ps.err = "out of memory";
+  else {
+    ps.p = expr;
+    ps.end = expr + len;
+    struct zsv_where_node *root = NULL;
+    if (!zsv_where_next(&ps)) {
+      if (ps.tok.type == zsv_where_token_end)
+        ps.err = "empty expression";
+      else if ((root = zsv_where_parse_or(&ps)) && ps.tok.type != zsv_where_token_end)
+        ps.err = ps.tok.type == zsv_where_token_rparen ? "unmatched ')'" : "expected and, or or end of expression";
+    }
+    if (root && !ps.err && zsv_where_emit(ps.w, root))
+      ps.err = "out of memory";
+    if (!ps.err && !root)
+      ps.err = "out of memory";
+  }
+
+  for (struct zsv_where_node *next; ps.nodes; ps.nodes = next) {
+    next = ps.nodes->all;
+    free(ps.nodes);
+  }
+  if (ps.err) {
+    zsv_where_delete(ps.w);
+    if (err)
+      *err = ps.err;
+    return NULL;
+  }
+  return ps.w;
+}
+
+static int zsv_where_stricmp(const char *a, const unsigned char *b) {
+  for (;; a++, b++) {
+    unsigned char x = (unsigned char)*a, y = *b;
+    if (x >= 'A' && x <= 'Z')
+      x = x - 'A' + 'a';
+    if (y >= 'A' && y <= 'Z')
+      y = y - 'A' + 'a';
+    if (x != y || !x)
+      return x != y;
+  }
+}
+
+static int zsv_where_find_column(const char *name, unsigned char *const *names, size_t count, size_t *ix) {
+  for (size_t i = 0; i < count; i++) {
+    if (names[i] && !zsv_where_stricmp(name, names[i])) {
+      *ix = i;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int zsv_where_bind(zsv_where w, unsigned char *const *names, size_t count, const char **missing) {
+  w->column_count = 0;
+  for (size_t i = 0; i < w->test_count; i++) {
+    struct zsv_where_test *t = &w->tests[i];
+    if (zsv_where_find_column(t->col_name, names, count, &t->col)) {
+      if (missing)
+        *missing = t->col_name;
+      return 1;
+    }
+    if (t->col2_name && zsv_where_find_column(t->col2_name, names, count, &t->col2)) {
+      if (missing)
+        *missing = t->col2_name;
+      return 1;
+    }
+    if (t->col + 1 > w->column_count)
+      w->column_count = t->col + 1;
+    if (t->col2_name && t->col2 + 1 > w->column_count)
+      w->column_count = t->col2 + 1;
+  }
+  return 0;
+}
+
+size_t zsv_where_column_count(zsv_where w) {
+  return w->column_count;
+}
+
+/**
+ * Parse a cell that consists entirely of a number
+ * @return 0 on success
+ */
+static int zsv_where_number(const unsigned char *s, size_t len, double *d) {
+  char buff[64];
+  if (!len || len >= sizeof(buff))
+    return 1;
+  memcpy(buff, s, len);
+  buff[len] = '\0';
+  char *end;
+  *d = strtod(buff, &end);
+  return end != buff + len;
+}
+
+static int zsv_where_test_eval(const struct zsv_where_test *t, zsv_where_get_cell get_cell, void *ctx) {
+  size_t len;
+  const unsigned char *s = get_cell(ctx, t->col, &len);
+  const struct zsv_where_value *v = &t->value;
+  double d;
+  int c;
+  switch (t->op) {
+  case zsv_where_op_contains:
+    return !v->len || (len >= v->len && memmem(s, len, v->str, v->len));
+  case zsv_where_op_startswith:
+    return len >= v->len && !memcmp(s, v->str, v->len);
+  case zsv_where_op_endswith:
+    return len >= v->len && !memcmp(s + len - v->len, v->str, v->len);
+  case zsv_where_op_in: {
+    struct zsv_where_value key;
+    memset(&key, 0, sizeof(key));
+    if (t->numeric) {
+      if (zsv_where_number(s, len, &key.num))
+        return 0;
+    } else {
+      key.str = s;
+      key.len = len;
+    }
+    return bsearch(&key, t->list, t->list_count, sizeof(*t->list),
+                   t->numeric ? zsv_where_cmp_value_num : zsv_where_cmp_value_str) != NULL;
+  }
+  default:
+    break;
+  }
+
+  if (t->col2_name) {
+    size_t len2;
+    const unsigned char *s2 = get_cell(ctx, t->col2, &len2);
+    double d2;
+    if (!zsv_where_number(s, len, &d) && !zsv_where_number(s2, len2, &d2))
+      c = (d > d2) - (d < d2);
+    else
+      c = zsv_where_strcmp(s, len, s2, len2);
+  } else if (t->numeric) {
+    if (zsv_where_number(s, len, &d))
+      return 0;
+    c = (d > v->num) - (d < v->num);
+  } else
+    c = zsv_where_strcmp(s, len, v->str, v->len);
+
+  switch (t->op) {
+  case zsv_where_op_eq:
+    return c == 0;
+  case zsv_where_op_ne:
+    return c != 0;
+  case zsv_where_op_lt:
+    return c < 0;
+  case zsv_where_op_le:
+    return c <= 0;
+  case zsv_where_op_gt:
+    return c > 0;
+  case zsv_where_op_ge:
+    return c >= 0;
+  default:
+    return 0;
+  }
+}
+
+int zsv_where_eval(zsv_where w, zsv_where_get_cell get_cell, void *ctx) {
+  int acc = 0;
+  for (size_t pc = 0; pc < w->code_len;) {
+    const struct zsv_where_inst *inst = &w->code[pc++];
+    switch (inst->opcode) {
+    case zsv_where_opcode_test:
+      acc = zsv_where_test_eval(&w->tests[inst->arg], get_cell, ctx);
+      break;
+    case zsv_where_opcode_jump_if_true:
+      if (acc)
+        pc = inst->arg;
+      break;
+    case zsv_where_opcode_jump_if_false:
+      if (!acc)
+        pc = inst->arg;
+      break;
+    case zsv_where_opcode_not:
+      acc = !acc;
+      break;
+    }
+  }
+  return acc;
+}
+
+void zsv_where_delete(zsv_where w) {
+  if (w) {
+    for (size_t i = 0; i < w->alloc_count; i++)
+      free(w->allocs[i]);
+    free(w->allocs);
+    free(w->tests);
+    free(w->code);
+    free(w);
+  }
+}
@@ -8,31 +8,27 @@
 
 #include <zsv/utils/writer.h>
 #include <zsv/utils/compiler.h>
+#include <zsv/utils/alloc.h>
+#include <zsv/utils/num.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 
-// clang-format off
-
-// return 0 on eof, +1 on error, > 0 if valid utf8 first byte read
-static inline char UTF8_charLenC_noerr(int c) {
-  char len;
-  if (c == EOF) len = 0;
-  else if (!(c & 128)) len = 1;
-  else if ((c & 224) == 192) len = 2; // 110xxxxx
-  else if ((c & 240) == 224) len = 3; // 1110xxxx
-  else if ((c & 248) == 240) len = 4; // 11110xxx
-  else if ((c & 252) == 248) len = 5; // 111110xx
-  else if ((c & 254) == 252) len = 6; // 1111110x
-  else len = 1; // error, but we are going to ignore and just call it a 1-byte char
-  return len;
-}
+#include "../../src/zsv_vector.h"
 
-// clang-format on
+#ifndef ZSVTLS
+#ifndef NO_THREADING
+#define ZSVTLS _Thread_local
+#else
+#define ZSVTLS
+#endif
+#endif
+// see arg.c
 
-static struct zsv_csv_writer_options zsv_csv_writer_default_opts = {0};
-static char zsv_writer_default_opts_initd = 0;
+ZSVTLS static struct zsv_csv_writer_options zsv_csv_writer_default_opts = {0};
+ZSVTLS static char zsv_writer_default_opts_initd = 0;
 void zsv_writer_set_default_opts(struct zsv_csv_writer_options opts) {
   zsv_writer_default_opts_initd = 1;
   zsv_csv_writer_default_opts = opts;
@@ -47,73 +43,145 @@ struct zsv_csv_writer_options zsv_writer_get_default_opts(void) {
   return zsv_csv_writer_default_opts;
 }
 
+static unsigned char *zsv_csv_quote_with(const struct zsv_allocator *a, const unsigned char *utf8_value, size_t len,
+                                         unsigned char *buff, size_t buffsize, size_t *lenp);
+
 // zsv_csv_quote() returns:
 // - NULL if no quoting needed
 // - buff if buff size was large enough to hold result
 // - newly-allocated char * if buff not large enough, and was able to get from heap
 // in last case, caller must free
 unsigned char *zsv_csv_quote(const unsigned char *utf8_value, size_t len, unsigned char *buff, size_t buffsize) {
+  return zsv_csv_quote_with(NULL, utf8_value, len, buff, buffsize, NULL);
+}
+
+/**
+ * Check whether a value needs quoting, i.e. contains a comma, dbl-quote or line
+ * end. Each of these is ASCII, so cannot be part of a multi-byte UTF8 char, and
+ * the value is scanned a vector at a time without decoding it
+ * @param quotesp set to the number of dbl-quotes
+ */
+static char zsv_csv_needs_quote(const unsigned char *utf8_value, size_t len, size_t *quotesp) {
   char need = 0;
-  unsigned quotes = 0;
-  char clen;
-  for (unsigned int i = 0; i < len; i += clen) {
-    if ((clen = UTF8_charLenC_noerr(utf8_value[i])) == 1)
-      switch (utf8_value[i]) {
-      case ',':
-      case '\n':
-      case '\r':
-        need = 1;
-        break;
-      case '"':
-        need = 1;
-        quotes++;
-        break;
-      }
+  size_t quotes = 0;
+  size_t i = 0;
+  zsv_uc_vector dq, comma, cr, lf;
+  memset(&dq, '"', sizeof(dq));
+  memset(&comma, ',', sizeof(comma));
+  memset(&cr, '\r', sizeof(cr));
+  memset(&lf, '\n', sizeof(lf));
+  for (; i + sizeof(zsv_uc_vector) <= len; i += sizeof(zsv_uc_vector)) {
+    zsv_uc_vector v;
+    memcpy(&v, utf8_value + i, sizeof(v));
+    zsv_mask_t q = movemask_pseudo(v == dq);
+    if (q) {
+      need = 1;
+      quotes += (size_t)__builtin_popcountll(q);
+    } else if (!need && movemask_pseudo((v == comma) | (v == cr) | (v == lf)))
+      need = 1;
+  }
+  for (; i < len; i++) {
+    switch (utf8_value[i]) {
+    case ',':
+    case '\n':
+    case '\r':
+      need = 1;
+      break;
+    case '"':
+      need = 1;
+      quotes++;
+      break;
+    }
+  }
+  *quotesp = quotes;
+  return need;
+}
+
+// copy a value to target, doubling any dbl-quotes; return the length written
+static size_t zsv_csv_quote_copy(unsigned char *target, const unsigned char *utf8_value, size_t len) {
+  size_t j = 0;
+  for (const unsigned char *end = utf8_value + len, *q; utf8_value < end; utf8_value = q + 1) {
+    if (!(q = memchr(utf8_value, '"', end - utf8_value))) {
+      memcpy(target + j, utf8_value, end - utf8_value);
+      j += end - utf8_value;
+      break;
+    }
+    memcpy(target + j, utf8_value, q - utf8_value + 1);
+    j += q - utf8_value + 1;
+    target[j++] = '"';
   }
-  if (!need)
+  return j;
+}
+
+// as zsv_csv_quote(), but any newly-allocated result comes from `a`, and the
+// length of the result (if any) is set in *lenp
+static unsigned char *zsv_csv_quote_with(const struct zsv_allocator *a, const unsigned char *utf8_value, size_t len,
+                                         unsigned char *buff, size_t buffsize, size_t *lenp) {
+  size_t quotes;
+  if (!zsv_csv_needs_quote(utf8_value, len, &quotes))
     return NULL;
 
   unsigned char *target;
-  unsigned mem_length = len + quotes + 3; // str + 2 quotes + terminating null
+  size_t mem_length = len + quotes + 3; // str + 2 quotes + terminating null
   if (mem_length < buffsize)
     target = buff;
   else
-    target = malloc(mem_length * sizeof(*target));
+    target = zsv_alloc(a, mem_length * sizeof(*target));
 
   if (target) {
     *target = '"';
     if (!quotes)
       memcpy(target + 1, utf8_value, len);
-    else {
-      for (unsigned int i = 0, j = 0; i < len; i += clen, j += clen) {
-        if (utf8_value[i] == '"')
-          target[++j] = '"';
-        clen = UTF8_charLenC_noerr(utf8_value[i]);
-        if (i + clen > len) // safety in case of invalid utf8 input
-          clen = len - i;
-        memcpy(target + 1 + j, utf8_value + i, clen);
-      }
-    }
+    else
+      zsv_csv_quote_copy(target + 1, utf8_value, len);
     target[mem_length - 2] = '"';
     target[mem_length - 1] = '\0';
+    if (lenp)
+      *lenp = mem_length - 1;
   }
   return target;
 }
 
 #define ZSV_OUTPUT_BUFF_SIZE 65536 * 4
 
+#ifndef NO_THREADING
+#include <pthread.h>
+
+/**
+ * With async output, a full buffer is swapped with `spare` and written by a
+ * separate thread, while the caller fills the other buffer
+ */
+struct zsv_output_async {
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond; // signaled when `pending` or `stop` changes
+  char *spare;         // buffer not being filled, which is being written if pending
+  size_t pending;      // number of bytes in spare to write, or 0 if none
+  int fd;              // if >= 0, written with write(2) instead of write()
+  char stop;
+};
+#endif
+
 struct zsv_output_buff {
-  char *buff; // will be ZSV_OUTPUT_BUFF_SIZE. to do: option to modify buff size
+  char *buff;  // of length `size`, which is ZSV_OUTPUT_BUFF_SIZE unless otherwise specified
+  size_t size; // capacity of buff
   size_t (*write)(const void *restrict, size_t size, size_t nitems, void *restrict stream);
   void *stream;
   size_t used;
+#ifndef NO_THREADING
+  struct zsv_output_async *async;
+#endif
+  char error; // a write failed; reported by the next flush
 };
 
 struct zsv_writer_data {
   size_t buffsize;     // corresponds to buf
   unsigned char *buff; // option
 
+  struct zsv_allocator allocator;
+
   struct zsv_output_buff out;
+  zsv_compressor compressor; // if set, out is written to the compressor
 
   void (*table_init)(void *);
   void *table_init_ctx;
@@ -126,18 +194,144 @@ struct zsv_writer_data {
 };
 
 #include <unistd.h> // write
+#include <errno.h>
+
+// write all of s, either with write(2) if fd >= 0 or else with b->write(); return 0 on error
+static char zsv_output_buff_write_all(struct zsv_output_buff *b, int fd, const char *s, size_t n) {
+  if (fd < 0)
+    return !n || b->write(s, n, 1, b->stream) == 1;
+  while (n) {
+    ssize_t written = write(fd, s, n);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return 0;
+    }
+    s += written;
+    n -= (size_t)written;
+  }
+  return 1;
+}
 
-static inline void zsv_output_buff_flush(struct zsv_output_buff *b) {
-  b->write(b->buff, b->used, 1, b->stream);
+#ifndef NO_THREADING
+static void *zsv_output_async_main(void *arg) {
+  struct zsv_output_buff *b = arg;
+  struct zsv_output_async *a = b->async;
+  pthread_mutex_lock(&a->mutex);
+  for (;;) {
+    while (!a->pending && !a->stop)
+      pthread_cond_wait(&a->cond, &a->mutex);
+    if (!a->pending)
+      break;
+    pthread_mutex_unlock(&a->mutex);
+    // spare and pending are not changed by the caller until pending is reset
+    char ok = zsv_output_buff_write_all(b, a->fd, a->spare, a->pending);
+    pthread_mutex_lock(&a->mutex);
+    if (!ok)
+      b->error = 1;
+    a->pending = 0;
+    pthread_cond_broadcast(&a->cond);
+  }
+  pthread_mutex_unlock(&a->mutex);
+  return NULL;
+}
+
+// wait for the writer thread to finish writing the spare buffer. caller must hold a->mutex
+static inline void zsv_output_async_wait(struct zsv_output_async *a) {
+  while (a->pending)
+    pthread_cond_wait(&a->cond, &a->mutex);
+}
+
+// hand the filled buffer to the writer thread, and continue with the spare one
+static void zsv_output_async_flush(struct zsv_output_buff *b, char wait) {
+  struct zsv_output_async *a = b->async;
+  pthread_mutex_lock(&a->mutex);
+  zsv_output_async_wait(a);
+  if (b->used) {
+    if (a->fd >= 0) // in case anything else was written to the stream since the last flush
+      fflush(b->stream);
+    char *full = b->buff;
+    b->buff = a->spare;
+    a->spare = full;
+    a->pending = b->used;
+    b->used = 0;
+    pthread_cond_broadcast(&a->cond);
+    if (wait)
+      zsv_output_async_wait(a);
+  }
+  pthread_mutex_unlock(&a->mutex);
+}
+
+static void zsv_output_async_delete(struct zsv_output_buff *b, const struct zsv_allocator *alloc) {
+  struct zsv_output_async *a = b->async;
+  pthread_mutex_lock(&a->mutex);
+  a->stop = 1;
+  pthread_cond_broadcast(&a->cond);
+  pthread_mutex_unlock(&a->mutex);
+  pthread_join(a->thread, NULL);
+  pthread_cond_destroy(&a->cond);
+  pthread_mutex_destroy(&a->mutex);
+  zsv_free(alloc, a->spare);
+  zsv_free(alloc, a);
+  b->async = NULL;
+}
+
+static void zsv_output_async_new(struct zsv_output_buff *b, const struct zsv_allocator *alloc) {
+  struct zsv_output_async *a = zsv_calloc(alloc, 1, sizeof(*a));
+  if (a && (a->spare = zsv_alloc(alloc, b->size))) {
+    a->fd = b->write == (size_t(*)(const void *restrict, size_t, size_t, void *restrict))fwrite
+              ? fileno((FILE *)b->stream)
+              : -1;
+    if (!pthread_mutex_init(&a->mutex, NULL)) {
+      if (!pthread_cond_init(&a->cond, NULL)) {
+        b->async = a;
+        if (!pthread_create(&a->thread, NULL, zsv_output_async_main, b))
+          return;
+        b->async = NULL;
+        pthread_cond_destroy(&a->cond);
+      }
+      pthread_mutex_destroy(&a->mutex);
+    }
+  }
+  // could not start a writer thread, so write synchronously
+  if (a)
+    zsv_free(alloc, a->spare);
+  zsv_free(alloc, a);
+}
+#endif
+
+// write out the buffer. if wait, also wait until all output has been written
+static inline void zsv_output_buff_flush(struct zsv_output_buff *b, char wait) {
+#ifndef NO_THREADING
+  if (b->async) {
+    zsv_output_async_flush(b, wait);
+    return;
+  }
+#endif
+  (void)wait;
+  if (!zsv_output_buff_write_all(b, -1, b->buff, b->used))
+    b->error = 1;
   b->used = 0;
 }
 
 static inline void zsv_output_buff_write(struct zsv_output_buff *b, const unsigned char *s, size_t n) {
   if (n) {
-    if (n + b->used > ZSV_OUTPUT_BUFF_SIZE) {
-      zsv_output_buff_flush(b);
-      if (n > ZSV_OUTPUT_BUFF_SIZE) { // n too big, so write directly
-        b->write(s, n, 1, b->stream);
+    if (n + b->used > b->size) {
+      // n too big, so write directly, after all that is already buffered
+      char direct = n > b->size;
+      zsv_output_buff_flush(b, direct);
+      if (direct) {
+#ifndef NO_THREADING
+        if (b->async) {
+          if (b->async->fd >= 0)
+            fflush(b->stream);
+          if (!zsv_output_buff_write_all(b, b->async->fd, (const char *)s, n))
+            b->error = 1;
+          return;
+        }
+#endif
+        if (!zsv_output_buff_write_all(b, -1, (const char *)s, n))
+          b->error = 1;
         return;
       }
     }
@@ -153,10 +347,16 @@ void zsv_writer_set_temp_buff(zsv_csv_writer w, unsigned char *buff, size_t buff
 }
 
 zsv_csv_writer zsv_writer_new(struct zsv_csv_writer_options *opts) {
-  struct zsv_writer_data *w = calloc(1, sizeof(*w));
+  const struct zsv_allocator *a = opts ? opts->allocator : NULL;
+  if (a && a->alloc && !(a->resize && a->release))
+    return NULL;
+  struct zsv_writer_data *w = zsv_calloc(a, 1, sizeof(*w));
   if (w) {
-    if (!(w->out.buff = malloc(ZSV_OUTPUT_BUFF_SIZE))) {
-      free(w); // out of memory!
+    if (a)
+      w->allocator = *a;
+    w->out.size = opts && opts->output_buffsize ? opts->output_buffsize : ZSV_OUTPUT_BUFF_SIZE;
+    if (!(w->out.buff = zsv_alloc(a, w->out.size))) {
+      zsv_free(a, w); // out of memory!
       return NULL;
     }
 
@@ -175,6 +375,26 @@ zsv_csv_writer zsv_writer_new(struct zsv_csv_writer_options *opts) {
       w->with_bom = opts->with_bom;
       w->table_init = opts->table_init;
       w->table_init_ctx = opts->table_init_ctx;
+      if (opts->compress) {
+        struct zsv_compressor_options copts = {0};
+        copts.type = opts->compress;
+        copts.level = opts->compress_level;
+        copts.threads = opts->compress_threads;
+        copts.write = w->out.write;
+        copts.stream = w->out.stream;
+        copts.allocator = a;
+        if (!(w->compressor = zsv_compressor_new(&copts))) {
+          zsv_free(a, w->out.buff);
+          zsv_free(a, w);
+          return NULL;
+        }
+        w->out.write = zsv_compressor_write;
+        w->out.stream = w->compressor;
+      }
+#ifndef NO_THREADING
+      if (opts->async)
+        zsv_output_async_new(&w->out, a);
+#endif
     }
   }
   return w;
@@ -184,46 +404,62 @@ enum zsv_writer_status zsv_writer_flush(zsv_csv_writer w) {
   if (!w)
     return zsv_writer_status_missing_handle;
 
-  zsv_output_buff_flush(&w->out);
-  return zsv_writer_status_ok;
+  zsv_output_buff_flush(&w->out, 1);
+  if (w->compressor && zsv_compressor_flush(w->compressor))
+    w->out.error = 1;
+  return w->out.error ? zsv_writer_status_error : zsv_writer_status_ok;
 }
 
 enum zsv_writer_status zsv_writer_delete(zsv_csv_writer w) {
   if (!w)
     return zsv_writer_status_missing_handle;
 
-  zsv_output_buff_flush(&w->out);
   if (w->started)
-    w->out.write("\n", 1, 1, w->out.stream);
-
+    zsv_output_buff_write(&w->out, (const unsigned char *)"\n", 1);
+  zsv_output_buff_flush(&w->out, 1);
+
+  struct zsv_allocator a = w->allocator;
+#ifndef NO_THREADING
+  if (w->out.async)
+    zsv_output_async_delete(&w->out, &a);
+#endif
+  if (w->compressor && zsv_compressor_delete(w->compressor))
+    w->out.error = 1;
+  enum zsv_writer_status stat = w->out.error ? zsv_writer_status_error : zsv_writer_status_ok;
   if (w->out.buff)
-    free(w->out.buff);
-  free(w);
-  return zsv_writer_status_ok;
+    zsv_free(&a, w->out.buff);
+  zsv_free(&a, w);
+  return stat;
 }
 
 static inline enum zsv_writer_status zsv_writer_cell_aux(zsv_csv_writer w, const unsigned char *s, size_t len,
                                                          char check_if_needs_quoting) {
   if (len) {
-    if (check_if_needs_quoting) {
-      unsigned char *quoted_s = zsv_csv_quote(s, len, w->buff, w->buffsize);
-      if (!quoted_s)
-        zsv_output_buff_write(&w->out, s, len);
-      else {
-        zsv_output_buff_write(&w->out, quoted_s, strlen((char *)quoted_s));
-        if (!(w->buff && quoted_s == w->buff))
-          free(quoted_s);
-      }
-    } else
+    // a cell that zsv parsed with quoted == 0 has nothing that needs quoting, so is not scanned
+    size_t quotes;
+    if (!check_if_needs_quoting || !zsv_csv_needs_quote(s, len, &quotes))
       zsv_output_buff_write(&w->out, s, len);
+    else if (!quotes) {
+      zsv_output_buff_write(&w->out, (const unsigned char *)"\"", 1);
+      zsv_output_buff_write(&w->out, s, len);
+      zsv_output_buff_write(&w->out, (const unsigned char *)"\"", 1);
+    } else {
+      size_t quoted_len = len + quotes + 2;
+      unsigned char *quoted_s = quoted_len < w->buffsize ? w->buff : zsv_alloc(&w->allocator, quoted_len + 1);
+      if (!quoted_s)
+        return zsv_writer_status_error;
+      *quoted_s = '"';
+      zsv_csv_quote_copy(quoted_s + 1, s, len);
+      quoted_s[quoted_len - 1] = '"';
+      zsv_output_buff_write(&w->out, quoted_s, quoted_len);
+      if (quoted_s != w->buff)
+        zsv_free(&w->allocator, quoted_s);
+    }
   }
   return zsv_writer_status_ok;
 }
 
-enum zsv_writer_status zsv_writer_cell(zsv_csv_writer w, char new_row, const unsigned char *s, size_t len,
-                                       char check_if_needs_quoting) {
-  if (!w)
-    return zsv_writer_status_missing_handle;
+static inline void zsv_writer_cell_start(zsv_csv_writer w, char new_row) {
   if (!w->started) {
     if (w->table_init)
       w->table_init(w->table_init_ctx);
@@ -234,16 +470,42 @@ enum zsv_writer_status zsv_writer_cell(zsv_csv_writer w, char new_row, const uns
     zsv_output_buff_write(&w->out, (const unsigned char *)"\n", 1);
   else
     zsv_output_buff_write(&w->out, (const unsigned char *)",", 1);
+}
+
+enum zsv_writer_status zsv_writer_row_raw(zsv_csv_writer w, const unsigned char *s, size_t len) {
+  if (!w)
+    return zsv_writer_status_missing_handle;
+  zsv_writer_cell_start(w, 1);
+  zsv_output_buff_write(&w->out, s, len);
+  return zsv_writer_status_ok;
+}
+
+enum zsv_writer_status zsv_writer_write(zsv_csv_writer w, const unsigned char *s, size_t len) {
+  if (!w)
+    return zsv_writer_status_missing_handle;
+  zsv_output_buff_write(&w->out, s, len);
+  return w->out.error ? zsv_writer_status_error : zsv_writer_status_ok;
+}
+
+enum zsv_writer_status zsv_writer_cell(zsv_csv_writer w, char new_row, const unsigned char *s, size_t len,
+                                       char check_if_needs_quoting) {
+  if (!w)
+    return zsv_writer_status_missing_handle;
+  zsv_writer_cell_start(w, new_row);
 
   if (VERY_UNLIKELY(w->cell_prepend && *w->cell_prepend)) {
-    char *tmp = NULL;
-    asprintf(&tmp, "%s%.*s", w->cell_prepend, (int)len, s ? s : (const unsigned char *)"");
+    size_t prepend_len = strlen(w->cell_prepend);
+    if (!s)
+      len = 0;
+    unsigned char *tmp = zsv_alloc(&w->allocator, prepend_len + len + 1);
     if (!tmp)
       return zsv_writer_status_error; // zsv_writer_status_memory;
-    s = (const unsigned char *)tmp;
-    len = len + strlen(w->cell_prepend);
-    enum zsv_writer_status stat = zsv_writer_cell_aux(w, s, len, 1);
-    free(tmp);
+    memcpy(tmp, w->cell_prepend, prepend_len);
+    if (len)
+      memcpy(tmp + prepend_len, s, len);
+    tmp[prepend_len + len] = '\0';
+    enum zsv_writer_status stat = zsv_writer_cell_aux(w, tmp, prepend_len + len, 1);
+    zsv_free(&w->allocator, tmp);
     return stat;
   }
   return zsv_writer_cell_aux(w, s, len, check_if_needs_quoting);
@@ -255,13 +517,21 @@ void zsv_writer_cell_prepend(zsv_csv_writer w, const unsigned char *s) {
 
 enum zsv_writer_status zsv_writer_cell_Lf(zsv_csv_writer w, char new_row, const char *fmt_spec, long double ldbl) {
   char s[128];
+  if (!fmt_spec || !*fmt_spec || (*fmt_spec == '.' && strspn(fmt_spec + 1, "0123456789") == strlen(fmt_spec + 1))) {
+    // plain precision e.g. ".2": format without printf if the value is in range
+    unsigned int precision = fmt_spec && *fmt_spec ? (unsigned int)strtoul(fmt_spec + 1, NULL, 10) : 6;
+    size_t len = zsv_ldtoa_fixed(ldbl, precision, s);
+    if (len)
+      return zsv_writer_cell(w, new_row, (unsigned char *)s, len, 0);
+  }
+
   char fmt[64];
   int n = snprintf(fmt, sizeof(fmt), "%%%sLf", fmt_spec ? fmt_spec : "");
   if (!(n > 0 && n < (int)sizeof(fmt)))
     fprintf(stderr, "Invalid format specifier, should be X for format %%XLf e.g. '.2'\n");
   else {
     n = snprintf(s, sizeof(s), fmt, ldbl);
-    if (!(n > 0 && n < (int)sizeof(fmt)))
+    if (!(n > 0 && n < (int)sizeof(s)))
       fprintf(stderr, "Unable to format value with fmt %s: %Lf\n", fmt, ldbl);
     else
       return zsv_writer_cell(w, new_row, (unsigned char *)s, n, 0);
@@ -275,10 +545,14 @@ enum zsv_writer_status zsv_writer_cell_blank(zsv_csv_writer w, char new_row) {
 }
 
 enum zsv_writer_status zsv_writer_cell_zu(zsv_csv_writer w, char new_row, size_t zu) {
-  char s[64];
-  int n = snprintf(s, sizeof(s), "%zu", zu);
-  if (n < 1 || n >= (int)sizeof(s))
-    n = 0; // unexpected overflow
+  char s[ZSV_NUM_BUFF_SIZE];
+  size_t n = zsv_u64toa(zu, s);
+  return zsv_writer_cell(w, new_row, (unsigned char *)s, n, 0);
+}
+
+enum zsv_writer_status zsv_writer_cell_dbl(zsv_csv_writer w, char new_row, double dbl) {
+  char s[ZSV_NUM_BUFF_SIZE];
+  size_t n = zsv_dtoa(dbl, s);
   return zsv_writer_cell(w, new_row, (unsigned char *)s, n, 0);
 }
 
@@ -0,0 +1,2571 @@
+/* This file was converted by gperf_unfold_key_conv.py
+      from gperf output file. */
+/* ANSI-C code produced by gperf version 3.0.3 */
+/* Command-line: /Library/Developer/CommandLineTools/usr/bin/gperf -n -C -T -c -t -j1 -L ANSI-C -F,-1,0 -N unicode_unfold_key unicode_unfold_key.gperf  */
+/* Computed positions: -k'1-3' */
+
+
+
+/* This gperf source file was generated by make_unicode_fold_data.py */
+#include <string.h>
+#include "regenc.h"
+
+#define TOTAL_KEYWORDS 1180
+#define MIN_WORD_LENGTH 3
+#define MAX_WORD_LENGTH 3
+#define MIN_HASH_VALUE 6
+#define MAX_HASH_VALUE 1572
+/* maximum key range = 1567, duplicates = 0 */
+
+#ifdef __GNUC__
+__inline
+#else
+#ifdef __cplusplus
+inline
+#endif
+#endif
+/*ARGSUSED*/
+static unsigned int
+hash(OnigCodePoint codes[])
+{
+  static const unsigned short asso_values[] =
+    {
+        52,    5,    3,    9,   68,    1,    7, 1573, 1573, 1573,
+      1573, 1573, 1573, 1573,  405, 1177,  394,   37,  382, 1175,
+       370, 1215,  349, 1170,  328,  128,  318, 1164,  304, 1159,
+       715,    2,    4, 1157,   22,   14,  360,  138,  293, 1145,
+       277, 1139,  266, 1133,  692,    0,  670, 1125,   99, 1119,
+        88, 1115,   43, 1071,   77, 1106,   32,  969,   66, 1100,
+        55, 1137,  717, 1085,  180,  981,  993,  521,  977,   54,
+       970, 1091,  836, 1082, 1074,  189,  308, 1204,  426,  693,
+       455,  484,  824,  383,  492,  915,  657, 1061,  252,  932,
+       203,  905,  647, 1040,  640, 1016,  633,  820,  615,  565,
+       511,  477,  231,  149,  176,  455, 1032,  426,  672,  418,
+       608,  382,  591,  777,  581,  371,  820,  200,  565, 1202,
+       553, 1201,  540, 1200,  529, 1188,  965, 1573,  954, 1573,
+      1196,  381, 1059, 1573, 1193,  542,  122,  436,  113,  268,
+      1042,  298,  812,  100,  800,  199,  784,  364,  472, 1183,
+       960, 1181,  508,  802,  162,  405,  503, 1179,  241, 1169,
+       484, 1163,  287,  452,  224, 1035,  215,  123,    8,  837,
+       790, 1158,  781, 1144,  133, 1009,  157,  999,  118,  989,
+       109,  924,  172,  921,  167,  895,  148, 1016,  465, 1015,
+       453,  577,  446,  978,  774,  994,  441,  894,  415,  967,
+       436,  946,  339,  813,  398,  630,  764,  620,  427,  559,
+       421,  916,  911,  686,  757,  741,  750,  814,  852,  903,
+      1012,  583,  891, 1125,  885, 1176,  627, 1053,  739,   44,
+       728, 1148,  600,  247,  846,  329,  705,  328,  880, 1573,
+       681,  270,  874, 1573,  870,  242,  866,  233,  862,  374,
+       858,  213,  343, 1573,  943,  127,   17,  143,  833,   72,
+      1005,  467,  261,  319,  522,   26,  141,   30,   25,   19
+    };
+  return asso_values[(unsigned char)onig_codes_byte_at(codes, 2)+14] + asso_values[(unsigned char)onig_codes_byte_at(codes, 1)+1] + asso_values[(unsigned char)onig_codes_byte_at(codes, 0)];
+}
+
+const struct ByUnfoldKey *
+unicode_unfold_key(OnigCodePoint code)
+{
+  static const struct ByUnfoldKey wordlist[] =
+    {
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0},
+
+      {0x1041f, 3060, 1},
+      {0xffffffff, -1, 0},
+
+      {0x10411, 3018, 1},
+      {0xffffffff, -1, 0},
+
+      {0x10412, 3021, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x10415, 3030, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x10414, 3027, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x10403, 2976, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x10426, 3081, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x2c1f, 2253, 1},
+
+      {0x041f, 932, 1},
+
+      {0x2c11, 2211, 1},
+
+      {0x0411, 890, 1},
+
+      {0x2c12, 2214, 1},
+
+      {0x0412, 893, 1},
+
+      {0x1e12, 1478, 1},
+
+      {0x0112, 198, 1},
+
+      {0x2c9a, 2364, 1},
+
+      {0x049a, 1106, 1},
+
+      {0x1e9a, 0, 2},
+
+      {0x0512, 1286, 1},
+
+      {0x1f9a, 179, 2},
+
+      {0x0212, 529, 1},
+
+      {0x2c15, 2223, 1},
+
+      {0x0415, 902, 1},
+
+      {0xa79a, 2865, 1},
+
+      {0x2cf2, 2481, 1},
+
+      {0x04f2, 1238, 1},
+
+      {0x1ef2, 1800, 1},
+
+      {0x01f2, 483, 1},
+
+      {0x1ff2, 257, 2},
+
+      {0x2c14, 2220, 1},
+
+      {0x0414, 899, 1},
+
+      {0x1e14, 1481, 1},
+
+      {0x0114, 201, 1},
+
+      {0x04fe, 1256, 1},
+
+      {0x1efe, 1818, 1},
+
+      {0x01fe, 499, 1},
+
+      {0x0514, 1289, 1},
+
+      {0x1ffb, 2004, 1},
+
+      {0x0214, 532, 1},
+
+      {0x2c2a, 2286, 1},
+
+      {0x042a, 965, 1},
+
+      {0x1e2a, 1514, 1},
+
+      {0x012a, 234, 1},
+
+      {0x1f2a, 1869, 1},
+
+      {0x2c03, 2169, 1},
+
+      {0x0403, 992, 1},
+
+      {0x052a, 1322, 1},
+
+      {0xa72a, 2727, 1},
+
+      {0x022a, 562, 1},
+
+      {0x10424, 3075, 1},
+
+      {0x2c26, 2274, 1},
+
+      {0x0426, 953, 1},
+
+      {0x1e26, 1508, 1},
+
+      {0x0126, 228, 1},
+
+      {0x01d7, 444, 1},
+
+      {0x1fd7, 31, 3},
+
+      {0xff2a, 2916, 1},
+
+      {0x0526, 1316, 1},
+
+      {0xa726, 2721, 1},
+
+      {0x0226, 556, 1},
+
+      {0x10422, 3069, 1},
+
+      {0x212a, 27, 1},
+
+      {0x2c2e, 2298, 1},
+
+      {0x042e, 977, 1},
+
+      {0x1e2e, 1520, 1},
+
+      {0x012e, 240, 1},
+
+      {0x1f2e, 1881, 1},
+
+      {0xff26, 2904, 1},
+
+      {0x0537, 1349, 1},
+
+      {0x052e, 1328, 1},
+
+      {0xa72e, 2733, 1},
+
+      {0x022e, 568, 1},
+
+      {0x2126, 817, 1},
+
+      {0x2c2c, 2292, 1},
+
+      {0x042c, 971, 1},
+
+      {0x1e2c, 1517, 1},
+
+      {0x012c, 237, 1},
+
+      {0x1f2c, 1875, 1},
+
+      {0xff37, 2955, 1},
+
+      {0xff2e, 2928, 1},
+
+      {0x052c, 1325, 1},
+
+      {0xa72c, 2730, 1},
+
+      {0x022c, 565, 1},
+
+      {0x039a, 769, 1},
+
+      {0x2c28, 2280, 1},
+
+      {0x0428, 959, 1},
+
+      {0x1e28, 1511, 1},
+
+      {0x0128, 231, 1},
+
+      {0x1f28, 1863, 1},
+
+      {0x1040b, 3000, 1},
+
+      {0xff2c, 2922, 1},
+
+      {0x0528, 1319, 1},
+
+      {0xa728, 2724, 1},
+
+      {0x0228, 559, 1},
+
+      {0x03ff, 721, 1},
+
+      {0x2c24, 2268, 1},
+
+      {0x0424, 947, 1},
+
+      {0x1e24, 1505, 1},
+
+      {0x0124, 225, 1},
+
+      {0x10417, 3036, 1},
+
+      {0x03fe, 718, 1},
+
+      {0xff28, 2910, 1},
+
+      {0x0524, 1313, 1},
+
+      {0xa724, 2718, 1},
+
+      {0x0224, 553, 1},
+
+      {0x03fd, 715, 1},
+
+      {0x2c22, 2262, 1},
+
+      {0x0422, 941, 1},
+
+      {0x1e22, 1502, 1},
+
+      {0x0122, 222, 1},
+
+      {0x0181, 613, 1},
+
+      {0x1f81, 134, 2},
+
+      {0xff24, 2898, 1},
+
+      {0x0522, 1310, 1},
+
+      {0xa722, 2715, 1},
+
+      {0x0222, 550, 1},
+
+      {0x2ca6, 2382, 1},
+
+      {0x04a6, 1124, 1},
+
+      {0x1ea6, 1686, 1},
+
+      {0x01a6, 676, 1},
+
+      {0x1fa6, 239, 2},
+
+      {0x047c, 1073, 1},
+
+      {0x1e7c, 1638, 1},
+
+      {0xff22, 2892, 1},
+
+      {0xa7a6, 2883, 1},
+
+      {0x2ca4, 2379, 1},
+
+      {0x04a4, 1121, 1},
+
+      {0x1ea4, 1683, 1},
+
+      {0x01a4, 390, 1},
+
+      {0x1fa4, 229, 2},
+
+      {0x047a, 1070, 1},
+
+      {0x1e7a, 1635, 1},
+
+      {0x1e99, 42, 2},
+
+      {0xa7a4, 2880, 1},
+
+      {0x1f99, 174, 2},
+
+      {0x2c0b, 2193, 1},
+
+      {0x040b, 1016, 1},
+
+      {0x01f1, 483, 1},
+
+      {0xa69a, 2712, 1},
+
+      {0x1f0b, 1830, 1},
+
+      {0x2ca0, 2373, 1},
+
+      {0x04a0, 1115, 1},
+
+      {0x1ea0, 1677, 1},
+
+      {0x01a0, 384, 1},
+
+      {0x1fa0, 209, 2},
+
+      {0x2c17, 2229, 1},
+
+      {0x0417, 908, 1},
+
+      {0x03f5, 749, 1},
+
+      {0xa7a0, 2874, 1},
+
+      {0x04fc, 1253, 1},
+
+      {0x1efc, 1815, 1},
+
+      {0x01fc, 496, 1},
+
+      {0x1ffc, 96, 2},
+
+      {0x10a6, 2502, 1},
+
+      {0x1ff3, 96, 2},
+
+      {0x2cac, 2391, 1},
+
+      {0x04ac, 1133, 1},
+
+      {0x1eac, 1695, 1},
+
+      {0x01ac, 396, 1},
+
+      {0x1fac, 229, 2},
+
+      {0x1f59, 1929, 1},
+
+      {0x0059, 71, 1},
+
+      {0x10a4, 2496, 1},
+
+      {0xa7ac, 637, 1},
+
+      {0x2ca2, 2376, 1},
+
+      {0x04a2, 1118, 1},
+
+      {0x1ea2, 1680, 1},
+
+      {0x01a2, 387, 1},
+
+      {0x1fa2, 219, 2},
+
+      {0x2c8c, 2343, 1},
+
+      {0x048c, 1085, 1},
+
+      {0x1e8c, 1662, 1},
+
+      {0xa7a2, 2877, 1},
+
+      {0x1f8c, 149, 2},
+
+      {0x2caa, 2388, 1},
+
+      {0x04aa, 1130, 1},
+
+      {0x1eaa, 1692, 1},
+
+      {0x10a0, 2484, 1},
+
+      {0x1faa, 219, 2},
+
+      {0x2ca8, 2385, 1},
+
+      {0x04a8, 1127, 1},
+
+      {0x1ea8, 1689, 1},
+
+      {0xa7aa, 646, 1},
+
+      {0x1fa8, 209, 2},
+
+      {0x03a6, 807, 1},
+
+      {0x1e5a, 1586, 1},
+
+      {0x015a, 300, 1},
+
+      {0xa7a8, 2886, 1},
+
+      {0x005a, 74, 1},
+
+      {0x1e32, 1526, 1},
+
+      {0x0132, 243, 1},
+
+      {0xa75a, 2796, 1},
+
+      {0x10ac, 2520, 1},
+
+      {0x03a4, 801, 1},
+
+      {0x0532, 1334, 1},
+
+      {0xa732, 2736, 1},
+
+      {0x0232, 574, 1},
+
+      {0x118a6, 3105, 1},
+
+      {0x0399, 764, 1},
+
+      {0x013d, 258, 1},
+
+      {0x1f3d, 1902, 1},
+
+      {0x10a2, 2490, 1},
+
+      {0x03f1, 793, 1},
+
+      {0x053d, 1367, 1},
+
+      {0xff32, 2940, 1},
+
+      {0x023d, 378, 1},
+
+      {0x118a4, 3099, 1},
+
+      {0x2c67, 2310, 1},
+
+      {0x03a0, 789, 1},
+
+      {0x2132, 2028, 1},
+
+      {0x1f83, 144, 2},
+
+      {0x10aa, 2514, 1},
+
+      {0x1e4c, 1565, 1},
+
+      {0x014c, 279, 1},
+
+      {0x1f4c, 1923, 1},
+
+      {0x004c, 31, 1},
+
+      {0x10a8, 2508, 1},
+
+      {0x054c, 1412, 1},
+
+      {0xa74c, 2775, 1},
+
+      {0x024c, 598, 1},
+
+      {0x2ced, 2478, 1},
+
+      {0x118a0, 3087, 1},
+
+      {0x2c98, 2361, 1},
+
+      {0x0498, 1103, 1},
+
+      {0x1e98, 38, 2},
+
+      {0x0198, 375, 1},
+
+      {0x1f98, 169, 2},
+
+      {0x1041c, 3051, 1},
+
+      {0x2183, 2079, 1},
+
+      {0x2167, 2052, 1},
+
+      {0xa798, 2862, 1},
+
+      {0x2c96, 2358, 1},
+
+      {0x0496, 1100, 1},
+
+      {0x1e96, 16, 2},
+
+      {0x0196, 652, 1},
+
+      {0x1f96, 199, 2},
+
+      {0x118ac, 3123, 1},
+
+      {0x038c, 827, 1},
+
+      {0x1041a, 3045, 1},
+
+      {0xa796, 2859, 1},
+
+      {0x1e58, 1583, 1},
+
+      {0x0158, 297, 1},
+
+      {0x03aa, 821, 1},
+
+      {0x0058, 68, 1},
+
+      {0x1fe9, 2022, 1},
+
+      {0x118a2, 3093, 1},
+
+      {0xa758, 2793, 1},
+
+      {0x03a8, 814, 1},
+
+      {0x2c90, 2349, 1},
+
+      {0x0490, 1091, 1},
+
+      {0x1e90, 1668, 1},
+
+      {0x0190, 628, 1},
+
+      {0x1f90, 169, 2},
+
+      {0x1fe7, 47, 3},
+
+      {0x10418, 3039, 1},
+
+      {0x118aa, 3117, 1},
+
+      {0xa790, 2853, 1},
+
+      {0x01db, 450, 1},
+
+      {0x1fdb, 1986, 1},
+
+      {0x00db, 156, 1},
+
+      {0x118a8, 3111, 1},
+
+      {0x1e4a, 1562, 1},
+
+      {0x014a, 276, 1},
+
+      {0x1f4a, 1917, 1},
+
+      {0x004a, 24, 1},
+
+      {0x1040e, 3009, 1},
+
+      {0x054a, 1406, 1},
+
+      {0xa74a, 2772, 1},
+
+      {0x024a, 595, 1},
+
+      {0x04f8, 1247, 1},
+
+      {0x1ef8, 1809, 1},
+
+      {0x01f8, 490, 1},
+
+      {0x1ff8, 1989, 1},
+
+      {0x2c1c, 2244, 1},
+
+      {0x041c, 923, 1},
+
+      {0x1e1c, 1493, 1},
+
+      {0x011c, 213, 1},
+
+      {0x1f1c, 1857, 1},
+
+      {0x017d, 351, 1},
+
+      {0x1040c, 3003, 1},
+
+      {0x051c, 1301, 1},
+
+      {0x1fe3, 41, 3},
+
+      {0x021c, 544, 1},
+
+      {0xa77d, 1445, 1},
+
+      {0x2c1a, 2238, 1},
+
+      {0x041a, 917, 1},
+
+      {0x1e1a, 1490, 1},
+
+      {0x011a, 210, 1},
+
+      {0x1f1a, 1851, 1},
+
+      {0x1040a, 2997, 1},
+
+      {0x0398, 759, 1},
+
+      {0x051a, 1298, 1},
+
+      {0xa68c, 2691, 1},
+
+      {0x021a, 541, 1},
+
+      {0x2c94, 2355, 1},
+
+      {0x0494, 1097, 1},
+
+      {0x1e94, 1674, 1},
+
+      {0x0194, 640, 1},
+
+      {0x1f94, 189, 2},
+
+      {0x0396, 753, 1},
+
+      {0x2c18, 2232, 1},
+
+      {0x0418, 911, 1},
+
+      {0x1e18, 1487, 1},
+
+      {0x0118, 207, 1},
+
+      {0x1f18, 1845, 1},
+
+      {0x2c7f, 583, 1},
+
+      {0xa65a, 2643, 1},
+
+      {0x0518, 1295, 1},
+
+      {0x017f, 52, 1},
+
+      {0x0218, 538, 1},
+
+      {0x10408, 2991, 1},
+
+      {0x2c0e, 2202, 1},
+
+      {0x040e, 1025, 1},
+
+      {0x1e0e, 1472, 1},
+
+      {0x010e, 192, 1},
+
+      {0x1f0e, 1839, 1},
+
+      {0x0390, 25, 3},
+
+      {0x1e3e, 1544, 1},
+
+      {0x050e, 1280, 1},
+
+      {0x1f3e, 1905, 1},
+
+      {0x020e, 523, 1},
+
+      {0x10416, 3033, 1},
+
+      {0x053e, 1370, 1},
+
+      {0xa73e, 2754, 1},
+
+      {0x023e, 2307, 1},
+
+      {0x2c0c, 2196, 1},
+
+      {0x040c, 1019, 1},
+
+      {0x1e0c, 1469, 1},
+
+      {0x010c, 189, 1},
+
+      {0x1f0c, 1833, 1},
+
+      {0x1ff9, 1992, 1},
+
+      {0x10406, 2985, 1},
+
+      {0x050c, 1277, 1},
+
+      {0xa64c, 2622, 1},
+
+      {0x020c, 520, 1},
+
+      {0x2c0a, 2190, 1},
+
+      {0x040a, 1013, 1},
+
+      {0x1e0a, 1466, 1},
+
+      {0x010a, 186, 1},
+
+      {0x1f0a, 1827, 1},
+
+      {0x00df, 24, 2},
+
+      {0x00dd, 162, 1},
+
+      {0x050a, 1274, 1},
+
+      {0x10404, 2979, 1},
+
+      {0x020a, 517, 1},
+
+      {0xa698, 2709, 1},
+
+      {0x2cbc, 2415, 1},
+
+      {0x04bc, 1157, 1},
+
+      {0x1ebc, 1719, 1},
+
+      {0x01bc, 411, 1},
+
+      {0x1fbc, 62, 2},
+
+      {0x04ee, 1232, 1},
+
+      {0x1eee, 1794, 1},
+
+      {0x01ee, 480, 1},
+
+      {0xa696, 2706, 1},
+
+      {0x10402, 2973, 1},
+
+      {0x2c08, 2184, 1},
+
+      {0x0408, 1007, 1},
+
+      {0x1e08, 1463, 1},
+
+      {0x0108, 183, 1},
+
+      {0x1f08, 1821, 1},
+
+      {0xa658, 2640, 1},
+
+      {0x0394, 746, 1},
+
+      {0x0508, 1271, 1},
+
+      {0xfb15, 113, 2},
+
+      {0x0208, 514, 1},
+
+      {0x10400, 2967, 1},
+
+      {0x2c16, 2226, 1},
+
+      {0x0416, 905, 1},
+
+      {0x1e16, 1484, 1},
+
+      {0x0116, 204, 1},
+
+      {0xa690, 2697, 1},
+
+      {0xfb14, 109, 2},
+
+      {0x037f, 878, 1},
+
+      {0x0516, 1292, 1},
+
+      {0x1f85, 154, 2},
+
+      {0x0216, 535, 1},
+
+      {0x2c06, 2178, 1},
+
+      {0x0406, 1001, 1},
+
+      {0x1e06, 1460, 1},
+
+      {0x0106, 180, 1},
+
+      {0x2ceb, 2475, 1},
+
+      {0xa64a, 2619, 1},
+
+      {0x10bc, 2568, 1},
+
+      {0x0506, 1268, 1},
+
+      {0x1feb, 1998, 1},
+
+      {0x0206, 511, 1},
+
+      {0xfb03, 0, 3},
+
+      {0x2c75, 2322, 1},
+
+      {0x2c04, 2172, 1},
+
+      {0x0404, 995, 1},
+
+      {0x1e04, 1457, 1},
+
+      {0x0104, 177, 1},
+
+      {0x0145, 270, 1},
+
+      {0x03f9, 875, 1},
+
+      {0x0045, 12, 1},
+
+      {0x0504, 1265, 1},
+
+      {0x0545, 1391, 1},
+
+      {0x0204, 508, 1},
+
+      {0x0245, 697, 1},
+
+      {0x2165, 2046, 1},
+
+      {0x2c02, 2166, 1},
+
+      {0x0402, 989, 1},
+
+      {0x1e02, 1454, 1},
+
+      {0x0102, 174, 1},
+
+      {0x2cbe, 2418, 1},
+
+      {0x04be, 1160, 1},
+
+      {0x1ebe, 1722, 1},
+
+      {0x0502, 1262, 1},
+
+      {0x1fbe, 764, 1},
+
+      {0x0202, 505, 1},
+
+      {0x2161, 2034, 1},
+
+      {0x2c00, 2160, 1},
+
+      {0x0400, 983, 1},
+
+      {0x1e00, 1451, 1},
+
+      {0x0100, 171, 1},
+
+      {0x1f8d, 154, 2},
+
+      {0xa694, 2703, 1},
+
+      {0x03ee, 872, 1},
+
+      {0x0500, 1259, 1},
+
+      {0xa78d, 643, 1},
+
+      {0x0200, 502, 1},
+
+      {0x2cb8, 2409, 1},
+
+      {0x04b8, 1151, 1},
+
+      {0x1eb8, 1713, 1},
+
+      {0x01b8, 408, 1},
+
+      {0x1fb8, 2007, 1},
+
+      {0x118bc, 3171, 1},
+
+      {0x2cc4, 2427, 1},
+
+      {0x1f5f, 1938, 1},
+
+      {0x1ec4, 1731, 1},
+
+      {0x01c4, 417, 1},
+
+      {0x1fc4, 54, 2},
+
+      {0x00c4, 89, 1},
+
+      {0x2cc2, 2424, 1},
+
+      {0x1e40, 1547, 1},
+
+      {0x1ec2, 1728, 1},
+
+      {0x1f5d, 1935, 1},
+
+      {0x1fc2, 253, 2},
+
+      {0x00c2, 83, 1},
+
+      {0x0540, 1376, 1},
+
+      {0xa740, 2757, 1},
+
+      {0x10be, 2574, 1},
+
+      {0x2cba, 2412, 1},
+
+      {0x04ba, 1154, 1},
+
+      {0x1eba, 1716, 1},
+
+      {0x017b, 348, 1},
+
+      {0x1fba, 1965, 1},
+
+      {0x2cb6, 2406, 1},
+
+      {0x04b6, 1148, 1},
+
+      {0x1eb6, 1710, 1},
+
+      {0xa77b, 2832, 1},
+
+      {0x1fb6, 58, 2},
+
+      {0x2cb2, 2400, 1},
+
+      {0x04b2, 1142, 1},
+
+      {0x1eb2, 1704, 1},
+
+      {0x01b2, 694, 1},
+
+      {0x1fb2, 249, 2},
+
+      {0x0345, 764, 1},
+
+      {0x10b8, 2556, 1},
+
+      {0x2cb0, 2397, 1},
+
+      {0x04b0, 1139, 1},
+
+      {0x1eb0, 1701, 1},
+
+      {0x1f95, 194, 2},
+
+      {0x1e42, 1550, 1},
+
+      {0x10c4, 2592, 1},
+
+      {0x1f5b, 1932, 1},
+
+      {0x0042, 3, 1},
+
+      {0xa7b0, 703, 1},
+
+      {0x0542, 1382, 1},
+
+      {0xa742, 2760, 1},
+
+      {0x10c2, 2586, 1},
+
+      {0x2cae, 2394, 1},
+
+      {0x04ae, 1136, 1},
+
+      {0x1eae, 1698, 1},
+
+      {0x01ae, 685, 1},
+
+      {0x1fae, 239, 2},
+
+      {0x01f7, 414, 1},
+
+      {0x1ff7, 67, 3},
+
+      {0x2c86, 2334, 1},
+
+      {0x10ba, 2562, 1},
+
+      {0x1e86, 1653, 1},
+
+      {0x0186, 616, 1},
+
+      {0x1f86, 159, 2},
+
+      {0x24bc, 2100, 1},
+
+      {0x10b6, 2550, 1},
+
+      {0x118be, 3177, 1},
+
+      {0xa786, 2847, 1},
+
+      {0xfb17, 117, 2},
+
+      {0x0057, 65, 1},
+
+      {0x10b2, 2538, 1},
+
+      {0x2c92, 2352, 1},
+
+      {0x0492, 1094, 1},
+
+      {0x1e92, 1671, 1},
+
+      {0x0143, 267, 1},
+
+      {0x1f92, 179, 2},
+
+      {0x0043, 6, 1},
+
+      {0x10b0, 2532, 1},
+
+      {0x0543, 1385, 1},
+
+      {0xa792, 2856, 1},
+
+      {0x0243, 354, 1},
+
+      {0x1e46, 1556, 1},
+
+      {0x03c2, 797, 1},
+
+      {0x118b8, 3159, 1},
+
+      {0x0046, 15, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0546, 1394, 1},
+
+      {0xa746, 2766, 1},
+
+      {0x0246, 589, 1},
+
+      {0x10ae, 2526, 1},
+
+      {0x2c8e, 2346, 1},
+
+      {0x048e, 1088, 1},
+
+      {0x1e8e, 1665, 1},
+
+      {0x018e, 453, 1},
+
+      {0x1f8e, 159, 2},
+
+      {0x2c8a, 2340, 1},
+
+      {0x048a, 1082, 1},
+
+      {0x1e8a, 1659, 1},
+
+      {0x018a, 622, 1},
+
+      {0x1f8a, 139, 2},
+
+      {0x1e56, 1580, 1},
+
+      {0x0156, 294, 1},
+
+      {0x1f56, 62, 3},
+
+      {0x0056, 62, 1},
+
+      {0x118ba, 3165, 1},
+
+      {0x0556, 1442, 1},
+
+      {0xa756, 2790, 1},
+
+      {0x0395, 749, 1},
+
+      {0x03b0, 41, 3},
+
+      {0x118b6, 3153, 1},
+
+      {0x04fa, 1250, 1},
+
+      {0x1efa, 1812, 1},
+
+      {0x01fa, 493, 1},
+
+      {0x1ffa, 2001, 1},
+
+      {0x118b2, 3141, 1},
+
+      {0x0535, 1343, 1},
+
+      {0x2c6e, 664, 1},
+
+      {0x046e, 1052, 1},
+
+      {0x1e6e, 1617, 1},
+
+      {0x016e, 330, 1},
+
+      {0x1f6e, 1959, 1},
+
+      {0x118b0, 3135, 1},
+
+      {0x03f7, 881, 1},
+
+      {0x24be, 2106, 1},
+
+      {0xa76e, 2826, 1},
+
+      {0xff35, 2949, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0386, 724, 1},
+
+      {0x046c, 1049, 1},
+
+      {0x1e6c, 1614, 1},
+
+      {0x016c, 327, 1},
+
+      {0x1f6c, 1953, 1},
+
+      {0x0179, 345, 1},
+
+      {0x118ae, 3129, 1},
+      {0xffffffff, -1, 0},
+
+      {0xa76c, 2823, 1},
+
+      {0xa640, 2604, 1},
+
+      {0xa779, 2829, 1},
+
+      {0x216e, 2073, 1},
+
+      {0x0392, 739, 1},
+
+      {0x24b8, 2088, 1},
+
+      {0x046a, 1046, 1},
+
+      {0x1e6a, 1611, 1},
+
+      {0x016a, 324, 1},
+
+      {0x1f6a, 1947, 1},
+      {0xffffffff, -1, 0},
+
+      {0x24c4, 2124, 1},
+
+      {0x04c3, 1166, 1},
+
+      {0xa76a, 2820, 1},
+
+      {0x216c, 2067, 1},
+
+      {0x1fc3, 71, 2},
+
+      {0x00c3, 86, 1},
+
+      {0x24c2, 2118, 1},
+
+      {0x0468, 1043, 1},
+
+      {0x1e68, 1608, 1},
+
+      {0x0168, 321, 1},
+
+      {0x1f68, 1941, 1},
+
+      {0x0055, 59, 1},
+
+      {0x038e, 830, 1},
+
+      {0x0555, 1439, 1},
+
+      {0xa768, 2817, 1},
+
+      {0x24ba, 2094, 1},
+
+      {0x216a, 2061, 1},
+
+      {0x038a, 733, 1},
+      {0xffffffff, -1, 0},
+
+      {0xa642, 2607, 1},
+
+      {0x24b6, 2082, 1},
+
+      {0x01b1, 691, 1},
+
+      {0x2c64, 673, 1},
+
+      {0x0464, 1037, 1},
+
+      {0x1e64, 1602, 1},
+
+      {0x0164, 315, 1},
+
+      {0xa7b1, 682, 1},
+
+      {0x01cf, 432, 1},
+
+      {0x2168, 2055, 1},
+
+      {0x00cf, 123, 1},
+
+      {0xa764, 2811, 1},
+
+      {0x03fa, 884, 1},
+
+      {0x2c62, 655, 1},
+
+      {0x0462, 1034, 1},
+
+      {0x1e62, 1599, 1},
+
+      {0x0162, 312, 1},
+
+      {0xa686, 2682, 1},
+
+      {0x10c3, 2589, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0xa762, 2808, 1},
+
+      {0x2cda, 2460, 1},
+
+      {0x04da, 1202, 1},
+
+      {0x1eda, 1764, 1},
+
+      {0x2164, 2043, 1},
+
+      {0x1fda, 1983, 1},
+
+      {0x00da, 153, 1},
+      {0xffffffff, -1, 0},
+
+      {0xa692, 2700, 1},
+
+      {0x2c60, 2301, 1},
+
+      {0x0460, 1031, 1},
+
+      {0x1e60, 1595, 1},
+
+      {0x0160, 309, 1},
+      {0xffffffff, -1, 0},
+
+      {0x2162, 2037, 1},
+
+      {0x10b1, 2535, 1},
+
+      {0xa646, 2613, 1},
+
+      {0xa760, 2805, 1},
+
+      {0x1e54, 1577, 1},
+
+      {0x0154, 291, 1},
+
+      {0x1f54, 57, 3},
+
+      {0x0054, 56, 1},
+
+      {0x04c1, 1163, 1},
+
+      {0x0554, 1436, 1},
+
+      {0xa754, 2787, 1},
+
+      {0x10420, 3063, 1},
+
+      {0x00c1, 80, 1},
+
+      {0xa68e, 2694, 1},
+
+      {0x2cd4, 2451, 1},
+
+      {0x04d4, 1193, 1},
+
+      {0x1ed4, 1755, 1},
+
+      {0x2160, 2031, 1},
+
+      {0xa68a, 2688, 1},
+
+      {0x00d4, 138, 1},
+      {0xffffffff, -1, 0},
+
+      {0xa656, 2637, 1},
+
+      {0x1e52, 1574, 1},
+
+      {0x0152, 288, 1},
+
+      {0x1f52, 52, 3},
+
+      {0x0052, 49, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0552, 1430, 1},
+
+      {0xa752, 2784, 1},
+
+      {0x1e50, 1571, 1},
+
+      {0x0150, 285, 1},
+
+      {0x1f50, 84, 2},
+
+      {0x0050, 43, 1},
+
+      {0x1041e, 3057, 1},
+
+      {0x0550, 1424, 1},
+
+      {0xa750, 2781, 1},
+
+      {0x1e4e, 1568, 1},
+
+      {0x014e, 282, 1},
+
+      {0x03cf, 836, 1},
+
+      {0x004e, 37, 1},
+      {0xffffffff, -1, 0},
+
+      {0x054e, 1418, 1},
+
+      {0xa74e, 2778, 1},
+
+      {0x024e, 601, 1},
+
+      {0x10c1, 2583, 1},
+
+      {0x118b1, 3138, 1},
+
+      {0x1e48, 1559, 1},
+      {0xffffffff, -1, 0},
+
+      {0x1f48, 1911, 1},
+
+      {0x0048, 21, 1},
+
+      {0xa66c, 2670, 1},
+
+      {0x0548, 1400, 1},
+
+      {0xa748, 2769, 1},
+
+      {0x0248, 592, 1},
+
+      {0x10bf, 2577, 1},
+
+      {0x03da, 842, 1},
+
+      {0x10410, 3015, 1},
+
+      {0x2c20, 2256, 1},
+
+      {0x0420, 935, 1},
+
+      {0x1e20, 1499, 1},
+
+      {0x0120, 219, 1},
+
+      {0x1e5e, 1592, 1},
+
+      {0x015e, 306, 1},
+
+      {0xa66a, 2667, 1},
+
+      {0x0520, 1307, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0220, 381, 1},
+
+      {0xa75e, 2802, 1},
+
+      {0x2ce2, 2472, 1},
+
+      {0x04e2, 1214, 1},
+
+      {0x1ee2, 1776, 1},
+
+      {0x01e2, 462, 1},
+
+      {0x1fe2, 36, 3},
+      {0xffffffff, -1, 0},
+
+      {0x04c7, 1172, 1},
+
+      {0xa668, 2664, 1},
+
+      {0x01c7, 421, 1},
+
+      {0x1fc7, 15, 3},
+
+      {0x00c7, 99, 1},
+
+      {0x2c1e, 2250, 1},
+
+      {0x041e, 929, 1},
+
+      {0x1e1e, 1496, 1},
+
+      {0x011e, 216, 1},
+
+      {0x0141, 264, 1},
+
+      {0x24c3, 2121, 1},
+
+      {0x0041, 0, 1},
+
+      {0x051e, 1304, 1},
+
+      {0x0541, 1379, 1},
+
+      {0x021e, 547, 1},
+
+      {0x0241, 586, 1},
+
+      {0xfb16, 125, 2},
+
+      {0xa664, 2658, 1},
+
+      {0x2cde, 2466, 1},
+
+      {0x04de, 1208, 1},
+
+      {0x1ede, 1770, 1},
+
+      {0x01de, 456, 1},
+      {0xffffffff, -1, 0},
+
+      {0x00de, 165, 1},
+
+      {0x118bf, 3180, 1},
+      {0xffffffff, -1, 0},
+
+      {0xfb06, 29, 2},
+
+      {0xa662, 2655, 1},
+
+      {0x2c10, 2208, 1},
+
+      {0x0410, 887, 1},
+
+      {0x1e10, 1475, 1},
+
+      {0x0110, 195, 1},
+
+      {0x1e30, 1523, 1},
+
+      {0x0130, 261, 2},
+
+      {0x24cf, 2157, 1},
+
+      {0x0510, 1283, 1},
+
+      {0x10c7, 2598, 1},
+
+      {0x0210, 526, 1},
+
+      {0xfb04, 5, 3},
+
+      {0x0230, 571, 1},
+      {0xffffffff, -1, 0},
+
+      {0x2cd8, 2457, 1},
+
+      {0x04d8, 1199, 1},
+
+      {0x1ed8, 1761, 1},
+
+      {0xa660, 2652, 1},
+
+      {0x1fd8, 2013, 1},
+
+      {0x00d8, 147, 1},
+
+      {0xff30, 2934, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0xfb02, 12, 2},
+
+      {0xa654, 2634, 1},
+
+      {0x2cd6, 2454, 1},
+
+      {0x04d6, 1196, 1},
+
+      {0x1ed6, 1758, 1},
+
+      {0x04c9, 1175, 1},
+
+      {0x1fd6, 76, 2},
+
+      {0x00d6, 144, 1},
+
+      {0x1fc9, 1974, 1},
+
+      {0x00c9, 105, 1},
+      {0xffffffff, -1, 0},
+
+      {0xfb00, 4, 2},
+
+      {0x03e2, 854, 1},
+
+      {0x2cca, 2436, 1},
+      {0xffffffff, -1, 0},
+
+      {0x1eca, 1740, 1},
+
+      {0x01ca, 425, 1},
+
+      {0x1fca, 1977, 1},
+
+      {0x00ca, 108, 1},
+
+      {0xa652, 2631, 1},
+
+      {0x2cc8, 2433, 1},
+
+      {0x24c1, 2115, 1},
+
+      {0x1ec8, 1737, 1},
+
+      {0x01c8, 421, 1},
+
+      {0x1fc8, 1971, 1},
+
+      {0x00c8, 102, 1},
+
+      {0xa650, 2628, 1},
+
+      {0x2cc0, 2421, 1},
+
+      {0x04c0, 1184, 1},
+
+      {0x1ec0, 1725, 1},
+      {0xffffffff, -1, 0},
+
+      {0x24bf, 2109, 1},
+
+      {0x00c0, 77, 1},
+
+      {0xa64e, 2625, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x03de, 848, 1},
+
+      {0x2cb4, 2403, 1},
+
+      {0x04b4, 1145, 1},
+
+      {0x1eb4, 1707, 1},
+
+      {0x2c63, 1448, 1},
+
+      {0x1fb4, 50, 2},
+      {0xffffffff, -1, 0},
+
+      {0xa648, 2616, 1},
+
+      {0x2c9e, 2370, 1},
+
+      {0x049e, 1112, 1},
+
+      {0x1e9e, 24, 2},
+
+      {0x2c84, 2331, 1},
+
+      {0x1f9e, 199, 2},
+
+      {0x1e84, 1650, 1},
+
+      {0x0184, 360, 1},
+
+      {0x1f84, 149, 2},
+
+      {0xa79e, 2871, 1},
+
+      {0x2c9c, 2367, 1},
+
+      {0x049c, 1109, 1},
+
+      {0xa784, 2844, 1},
+
+      {0x019c, 661, 1},
+
+      {0x1f9c, 189, 2},
+
+      {0xa65e, 2649, 1},
+
+      {0x03d8, 839, 1},
+      {0xffffffff, -1, 0},
+
+      {0xa79c, 2868, 1},
+
+      {0x2163, 2040, 1},
+
+      {0x2c82, 2328, 1},
+
+      {0x10c0, 2580, 1},
+
+      {0x1e82, 1647, 1},
+
+      {0x0182, 357, 1},
+
+      {0x1f82, 139, 2},
+
+      {0x018b, 366, 1},
+
+      {0x1f8b, 144, 2},
+
+      {0x03d6, 789, 1},
+
+      {0xa782, 2841, 1},
+      {0xffffffff, -1, 0},
+
+      {0xa78b, 2850, 1},
+
+      {0x10b4, 2544, 1},
+
+      {0x2c80, 2325, 1},
+
+      {0x0480, 1079, 1},
+
+      {0x1e80, 1644, 1},
+
+      {0x04cb, 1178, 1},
+
+      {0x1f80, 129, 2},
+
+      {0x01cb, 425, 1},
+
+      {0x1fcb, 1980, 1},
+
+      {0x00cb, 111, 1},
+
+      {0xa780, 2838, 1},
+
+      {0x0466, 1040, 1},
+
+      {0x1e66, 1605, 1},
+
+      {0x0166, 318, 1},
+
+      {0x24c7, 2133, 1},
+
+      {0x0053, 52, 1},
+
+      {0x1e44, 1553, 1},
+
+      {0x0553, 1433, 1},
+
+      {0xa766, 2814, 1},
+
+      {0x0044, 9, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0544, 1388, 1},
+
+      {0xa744, 2763, 1},
+
+      {0x0244, 688, 1},
+
+      {0x04f4, 1241, 1},
+
+      {0x1ef4, 1803, 1},
+
+      {0x01f4, 487, 1},
+
+      {0x1ff4, 101, 2},
+
+      {0x1e3a, 1538, 1},
+
+      {0x1e9b, 1595, 1},
+
+      {0x1f3a, 1893, 1},
+
+      {0x1f9b, 184, 2},
+
+      {0x2166, 2049, 1},
+
+      {0x053a, 1358, 1},
+
+      {0xa73a, 2748, 1},
+
+      {0x023a, 2304, 1},
+
+      {0x2cdc, 2463, 1},
+
+      {0x04dc, 1205, 1},
+
+      {0x1edc, 1767, 1},
+
+      {0x039e, 783, 1},
+
+      {0x10bd, 2571, 1},
+
+      {0x00dc, 159, 1},
+
+      {0x2ccc, 2439, 1},
+
+      {0xff3a, 2964, 1},
+
+      {0x1ecc, 1743, 1},
+
+      {0x118b4, 3147, 1},
+
+      {0x1fcc, 71, 2},
+
+      {0x00cc, 114, 1},
+
+      {0x039c, 776, 1},
+
+      {0x04ec, 1229, 1},
+
+      {0x1eec, 1791, 1},
+
+      {0x01ec, 477, 1},
+
+      {0x1fec, 2025, 1},
+
+      {0x04ea, 1226, 1},
+
+      {0x1eea, 1788, 1},
+
+      {0x01ea, 474, 1},
+
+      {0x1fea, 1995, 1},
+
+      {0x04e8, 1223, 1},
+
+      {0x1ee8, 1785, 1},
+
+      {0x01e8, 471, 1},
+
+      {0x1fe8, 2019, 1},
+
+      {0x04e6, 1220, 1},
+
+      {0x1ee6, 1782, 1},
+
+      {0x01e6, 468, 1},
+
+      {0x1fe6, 88, 2},
+
+      {0x04e4, 1217, 1},
+
+      {0x1ee4, 1779, 1},
+
+      {0x01e4, 465, 1},
+
+      {0x1fe4, 80, 2},
+
+      {0x24c9, 2139, 1},
+
+      {0x2ce0, 2469, 1},
+
+      {0x04e0, 1211, 1},
+
+      {0x1ee0, 1773, 1},
+
+      {0x01e0, 459, 1},
+      {0xffffffff, -1, 0},
+
+      {0x2cd2, 2448, 1},
+
+      {0x04d2, 1190, 1},
+
+      {0x1ed2, 1752, 1},
+
+      {0x24ca, 2142, 1},
+
+      {0x1fd2, 20, 3},
+
+      {0x00d2, 132, 1},
+
+      {0x2cd0, 2445, 1},
+
+      {0x04d0, 1187, 1},
+
+      {0x1ed0, 1749, 1},
+
+      {0x118bd, 3174, 1},
+
+      {0x24c8, 2136, 1},
+
+      {0x00d0, 126, 1},
+
+      {0x01b7, 700, 1},
+
+      {0x1fb7, 10, 3},
+
+      {0x1fab, 224, 2},
+      {0xffffffff, -1, 0},
+
+      {0x03f4, 759, 1},
+
+      {0x24c0, 2112, 1},
+
+      {0xa7ab, 631, 1},
+
+      {0x04cd, 1181, 1},
+
+      {0x039b, 773, 1},
+
+      {0x01cd, 429, 1},
+
+      {0xa684, 2679, 1},
+
+      {0x00cd, 117, 1},
+
+      {0x1f4d, 1926, 1},
+
+      {0x004d, 34, 1},
+
+      {0x2cc6, 2430, 1},
+
+      {0x054d, 1415, 1},
+
+      {0x1ec6, 1734, 1},
+
+      {0x03dc, 845, 1},
+
+      {0x1fc6, 67, 2},
+
+      {0x00c6, 96, 1},
+
+      {0x04c5, 1169, 1},
+
+      {0x0147, 273, 1},
+
+      {0x01c5, 417, 1},
+
+      {0x0047, 18, 1},
+
+      {0x00c5, 92, 1},
+
+      {0x0547, 1397, 1},
+
+      {0xa682, 2676, 1},
+
+      {0x01a9, 679, 1},
+
+      {0x1fa9, 214, 2},
+
+      {0x03ec, 869, 1},
+
+      {0x01a7, 393, 1},
+
+      {0x1fa7, 244, 2},
+      {0xffffffff, -1, 0},
+
+      {0x03ea, 866, 1},
+
+      {0x10b7, 2553, 1},
+
+      {0x10ab, 2517, 1},
+      {0xffffffff, -1, 0},
+
+      {0x03e8, 863, 1},
+
+      {0xa680, 2673, 1},
+
+      {0x1f4b, 1920, 1},
+
+      {0x004b, 27, 1},
+
+      {0x03e6, 860, 1},
+
+      {0x054b, 1409, 1},
+
+      {0x10cd, 2601, 1},
+      {0xffffffff, -1, 0},
+
+      {0x03e4, 857, 1},
+
+      {0xa666, 2661, 1},
+
+      {0x04f0, 1235, 1},
+
+      {0x1ef0, 1797, 1},
+
+      {0x01f0, 20, 2},
+
+      {0xa644, 2610, 1},
+
+      {0x03e0, 851, 1},
+      {0xffffffff, -1, 0},
+
+      {0x1fbb, 1968, 1},
+
+      {0x24bd, 2103, 1},
+
+      {0x24cb, 2145, 1},
+
+      {0x10c5, 2595, 1},
+
+      {0x2c72, 2319, 1},
+
+      {0x0472, 1058, 1},
+
+      {0x1e72, 1623, 1},
+
+      {0x0172, 336, 1},
+
+      {0x10a9, 2511, 1},
+
+      {0x03d0, 739, 1},
+
+      {0x2c88, 2337, 1},
+
+      {0x10a7, 2505, 1},
+
+      {0x1e88, 1656, 1},
+
+      {0x03ab, 824, 1},
+
+      {0x1f88, 129, 2},
+
+      {0x2c70, 610, 1},
+
+      {0x0470, 1055, 1},
+
+      {0x1e70, 1620, 1},
+
+      {0x0170, 333, 1},
+
+      {0x2c2b, 2289, 1},
+
+      {0x042b, 968, 1},
+
+      {0x1fb9, 2010, 1},
+
+      {0x1e38, 1535, 1},
+
+      {0x1f2b, 1872, 1},
+
+      {0x1f38, 1887, 1},
+
+      {0x118b7, 3156, 1},
+
+      {0x118ab, 3120, 1},
+
+      {0x0538, 1352, 1},
+
+      {0xa738, 2745, 1},
+
+      {0x1e36, 1532, 1},
+
+      {0x0136, 249, 1},
+
+      {0x01b3, 402, 1},
+
+      {0x1fb3, 62, 2},
+
+      {0x10bb, 2565, 1},
+
+      {0x0536, 1346, 1},
+
+      {0xa736, 2742, 1},
+
+      {0xff2b, 2919, 1},
+
+      {0xff38, 2958, 1},
+
+      {0x0533, 1337, 1},
+
+      {0x03a9, 817, 1},
+
+      {0x24cc, 2148, 1},
+
+      {0x212b, 92, 1},
+
+      {0x03a7, 811, 1},
+
+      {0x1fa5, 234, 2},
+
+      {0xff36, 2952, 1},
+
+      {0x1e34, 1529, 1},
+
+      {0x0134, 246, 1},
+
+      {0x01b5, 405, 1},
+
+      {0xff33, 2943, 1},
+
+      {0x00b5, 776, 1},
+
+      {0x0534, 1340, 1},
+
+      {0xa734, 2739, 1},
+
+      {0x118a9, 3114, 1},
+
+      {0x1fa3, 224, 2},
+
+      {0x10b9, 2559, 1},
+
+      {0x118a7, 3108, 1},
+
+      {0x04f6, 1244, 1},
+
+      {0x1ef6, 1806, 1},
+
+      {0x01f6, 372, 1},
+
+      {0x1ff6, 92, 2},
+
+      {0xff34, 2946, 1},
+
+      {0x03f0, 769, 1},
+
+      {0x2cce, 2442, 1},
+
+      {0x1fa1, 214, 2},
+
+      {0x1ece, 1746, 1},
+
+      {0x10b3, 2541, 1},
+      {0xffffffff, -1, 0},
+
+      {0x00ce, 120, 1},
+
+      {0x01af, 399, 1},
+
+      {0x1faf, 244, 2},
+
+      {0x1fad, 234, 2},
+
+      {0x0051, 46, 1},
+
+      {0x0372, 709, 1},
+
+      {0x0551, 1427, 1},
+
+      {0xa7ad, 658, 1},
+
+      {0x10427, 3084, 1},
+
+      {0x10a5, 2499, 1},
+
+      {0x118bb, 3168, 1},
+
+      {0x0388, 727, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x10b5, 2547, 1},
+
+      {0x24b7, 2085, 1},
+
+      {0x0370, 706, 1},
+
+      {0x1e5c, 1589, 1},
+
+      {0x015c, 303, 1},
+
+      {0x10a3, 2493, 1},
+
+      {0x1e97, 34, 2},
+
+      {0x0197, 649, 1},
+
+      {0x1f97, 204, 2},
+
+      {0xa75c, 2799, 1},
+
+      {0x24cd, 2151, 1},
+
+      {0x2c7e, 580, 1},
+
+      {0x047e, 1076, 1},
+
+      {0x1e7e, 1641, 1},
+
+      {0x004f, 40, 1},
+
+      {0x10a1, 2487, 1},
+
+      {0x054f, 1421, 1},
+
+      {0x118b9, 3162, 1},
+
+      {0x24c6, 2130, 1},
+
+      {0xa77e, 2835, 1},
+      {0xffffffff, -1, 0},
+
+      {0x10af, 2529, 1},
+
+      {0x10ad, 2523, 1},
+
+      {0x24c5, 2127, 1},
+      {0xffffffff, -1, 0},
+
+      {0x01d5, 441, 1},
+
+      {0x03a5, 804, 1},
+
+      {0x00d5, 141, 1},
+
+      {0x118b3, 3144, 1},
+
+      {0x0476, 1064, 1},
+
+      {0x1e76, 1629, 1},
+
+      {0x0176, 342, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0149, 46, 2},
+
+      {0x1f49, 1914, 1},
+
+      {0x0049, 3183, 1},
+
+      {0x03a3, 797, 1},
+
+      {0x0549, 1403, 1},
+
+      {0x10425, 3078, 1},
+
+      {0x118a5, 3102, 1},
+
+      {0x2c27, 2277, 1},
+
+      {0x0427, 956, 1},
+
+      {0x10423, 3072, 1},
+      {0xffffffff, -1, 0},
+
+      {0x118b5, 3150, 1},
+
+      {0x1e3c, 1541, 1},
+
+      {0x03a1, 793, 1},
+
+      {0x1f3c, 1899, 1},
+
+      {0x10421, 3066, 1},
+
+      {0x118a3, 3096, 1},
+
+      {0x053c, 1364, 1},
+
+      {0xa73c, 2751, 1},
+
+      {0xa688, 2685, 1},
+
+      {0x24bb, 2097, 1},
+
+      {0x013b, 255, 1},
+
+      {0x1f3b, 1896, 1},
+
+      {0x1041d, 3054, 1},
+
+      {0xff27, 2907, 1},
+
+      {0x053b, 1361, 1},
+
+      {0x118a1, 3090, 1},
+
+      {0x023b, 577, 1},
+
+      {0x0531, 1331, 1},
+
+      {0x1041b, 3048, 1},
+
+      {0x0139, 252, 1},
+
+      {0x1f39, 1890, 1},
+
+      {0x118af, 3132, 1},
+
+      {0x118ad, 3126, 1},
+
+      {0x0539, 1355, 1},
+
+      {0x10419, 3042, 1},
+
+      {0x2c2d, 2295, 1},
+
+      {0x042d, 974, 1},
+
+      {0xff31, 2937, 1},
+
+      {0x0397, 756, 1},
+
+      {0x1f2d, 1878, 1},
+
+      {0x24b9, 2091, 1},
+
+      {0x2c29, 2283, 1},
+
+      {0x0429, 962, 1},
+
+      {0xff39, 2961, 1},
+      {0xffffffff, -1, 0},
+
+      {0x1f29, 1866, 1},
+
+      {0x10413, 3024, 1},
+      {0xffffffff, -1, 0},
+
+      {0x1040f, 3012, 1},
+      {0xffffffff, -1, 0},
+
+      {0x2c25, 2271, 1},
+
+      {0x0425, 950, 1},
+
+      {0xff2d, 2925, 1},
+
+      {0x1040d, 3006, 1},
+
+      {0x2c23, 2265, 1},
+
+      {0x0423, 944, 1},
+
+      {0x03d5, 807, 1},
+      {0xffffffff, -1, 0},
+
+      {0xff29, 2913, 1},
+
+      {0x10409, 2994, 1},
+
+      {0x2c21, 2259, 1},
+
+      {0x0421, 938, 1},
+
+      {0x0376, 712, 1},
+
+      {0x01d1, 435, 1},
+
+      {0x10405, 2982, 1},
+
+      {0x00d1, 129, 1},
+
+      {0x10401, 2970, 1},
+
+      {0xff25, 2901, 1},
+
+      {0x2c1d, 2247, 1},
+
+      {0x041d, 926, 1},
+      {0xffffffff, -1, 0},
+
+      {0xff23, 2895, 1},
+
+      {0x1f1d, 1860, 1},
+
+      {0x042f, 980, 1},
+
+      {0x2c1b, 2241, 1},
+
+      {0x041b, 920, 1},
+
+      {0x1f2f, 1884, 1},
+
+      {0xff21, 2889, 1},
+
+      {0x1f1b, 1854, 1},
+      {0xffffffff, -1, 0},
+
+      {0x2c19, 2235, 1},
+
+      {0x0419, 914, 1},
+
+      {0x019f, 670, 1},
+
+      {0x1f9f, 204, 2},
+
+      {0x1f19, 1848, 1},
+
+      {0x24ce, 2154, 1},
+
+      {0x01d9, 447, 1},
+
+      {0x1fd9, 2016, 1},
+
+      {0x00d9, 150, 1},
+
+      {0xff2f, 2931, 1},
+
+      {0xa65c, 2646, 1},
+      {0xffffffff, -1, 0},
+
+      {0x2c13, 2217, 1},
+
+      {0x0413, 896, 1},
+
+      {0x2c0f, 2205, 1},
+
+      {0x040f, 1028, 1},
+
+      {0x019d, 667, 1},
+
+      {0x1f9d, 194, 2},
+
+      {0x1f0f, 1842, 1},
+
+      {0x2c0d, 2199, 1},
+
+      {0x040d, 1022, 1},
+
+      {0x0193, 634, 1},
+
+      {0x1f93, 184, 2},
+
+      {0x1f0d, 1836, 1},
+
+      {0x10407, 2988, 1},
+
+      {0x2c09, 2187, 1},
+
+      {0x0409, 1010, 1},
+
+      {0x0191, 369, 1},
+
+      {0x1f91, 174, 2},
+
+      {0x1f09, 1824, 1},
+
+      {0x2c05, 2175, 1},
+
+      {0x0405, 998, 1},
+
+      {0x2c01, 2163, 1},
+
+      {0x0401, 986, 1},
+
+      {0x01d3, 438, 1},
+
+      {0x1fd3, 25, 3},
+
+      {0x00d3, 135, 1},
+
+      {0x018f, 625, 1},
+
+      {0x1f8f, 164, 2},
+
+      {0x0189, 619, 1},
+
+      {0x1f89, 134, 2},
+
+      {0x0187, 363, 1},
+
+      {0x1f87, 164, 2},
+
+      {0x2c6f, 604, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0587, 105, 2},
+      {0xffffffff, -1, 0},
+
+      {0x1f6f, 1962, 1},
+
+      {0x03d1, 759, 1},
+
+      {0x0478, 1067, 1},
+
+      {0x1e78, 1632, 1},
+
+      {0x0178, 168, 1},
+
+      {0x0474, 1061, 1},
+
+      {0x1e74, 1626, 1},
+
+      {0x0174, 339, 1},
+
+      {0x2c6d, 607, 1},
+
+      {0x2c6b, 2316, 1},
+
+      {0x2c69, 2313, 1},
+      {0xffffffff, -1, 0},
+
+      {0x1f6d, 1956, 1},
+
+      {0x1f6b, 1950, 1},
+
+      {0x1f69, 1944, 1},
+
+      {0x013f, 261, 1},
+
+      {0x1f3f, 1908, 1},
+      {0xffffffff, -1, 0},
+
+      {0x216f, 2076, 1},
+
+      {0x053f, 1373, 1},
+
+      {0x039f, 786, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x2c07, 2181, 1},
+
+      {0x0407, 1004, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x216d, 2070, 1},
+
+      {0x216b, 2064, 1},
+
+      {0x2169, 2058, 1},
+      {0xffffffff, -1, 0},
+
+      {0x039d, 780, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x0393, 743, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x0391, 736, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0x038f, 833, 1},
+      {0xffffffff, -1, 0},
+
+      {0x0389, 730, 1},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0xfb13, 121, 2},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+      {0xffffffff, -1, 0}, {0xffffffff, -1, 0},
+
+      {0xfb05, 29, 2},
+      {0xffffffff, -1, 0},
+
+      {0xfb01, 8, 2}
+    };
+
+  if (0 == 0)
+    {
+      int key = hash(&code);
+
+      if (key <= MAX_HASH_VALUE)
+        {
+          OnigCodePoint gcode = wordlist[key].code;
+
+          if (code == gcode)
+            return &wordlist[key];
+        }
+    }
+  return 0;
+}
+
+
@@ -0,0 +1 @@
+#define JQ_VERSION "1.6"
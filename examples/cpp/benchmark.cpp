@@ -0,0 +1,179 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <zsv/zsv.hpp>
+
+/**
+ * Compare the per-row cost of parsing via the C API row_handler callback with
+ * that of the C++ wrapper's templated handler, pull iteration and column binding
+ *
+ * Each method reads the given file `repeat` times and sums the length of every
+ * cell, so that all cells are actually fetched. The sums are checked against
+ * each other, and the time per row is output for each method
+ *
+ * Example:
+ *   `build/benchmark ../../data/loans_1.csv 20`
+ */
+
+namespace {
+
+struct totals {
+  size_t rows = 0;
+  size_t bytes = 0;
+};
+
+struct c_data {
+  zsv_parser parser;
+  totals *t;
+};
+
+extern "C" void c_row_handler(void *ctx) {
+  struct c_data *data = static_cast<struct c_data *>(ctx);
+  size_t n = zsv_cell_count(data->parser);
+  for (size_t i = 0; i < n; i++)
+    data->t->bytes += zsv_get_cell(data->parser, i).len;
+  data->t->rows++;
+}
+
+int c_callback(FILE *f, totals &t) {
+  struct zsv_opts opts = {};
+  struct c_data data = {nullptr, &t};
+  opts.stream = f;
+  opts.row_handler = c_row_handler;
+  opts.ctx = &data;
+  if (!(data.parser = zsv_new(&opts)))
+    return 1;
+  while (zsv_parse_more(data.parser) == zsv_status_ok)
+    ;
+  zsv_finish(data.parser);
+  zsv_delete(data.parser);
+  return 0;
+}
+
+int c_pull(FILE *f, totals &t) {
+  struct zsv_opts opts = {};
+  opts.stream = f;
+  zsv_parser parser = zsv_new(&opts);
+  if (!parser)
+    return 1;
+  while (zsv_next_row(parser) == zsv_status_row) {
+    size_t n = zsv_cell_count(parser);
+    for (size_t i = 0; i < n; i++)
+      t.bytes += zsv_get_cell(parser, i).len;
+    t.rows++;
+  }
+  zsv_delete(parser);
+  return 0;
+}
+
+int cpp_handler(FILE *f, totals &t) {
+  zsv::parser parser(f);
+  if (!parser)
+    return 1;
+  parser.parse([&t](const zsv::row &row) {
+    for (std::string_view cell : row)
+      t.bytes += cell.size();
+    t.rows++;
+  });
+  return 0;
+}
+
+int cpp_rows(FILE *f, totals &t) {
+  zsv::parser parser(f);
+  if (!parser)
+    return 1;
+  for (const zsv::row &row : parser.rows()) {
+    for (std::string_view cell : row)
+      t.bytes += cell.size();
+    t.rows++;
+  }
+  return 0;
+}
+
+/**
+ * Bind the first and last header names, resolve them once from the header row
+ * and then fetch only those two cells per row. The byte total is not comparable
+ * with the other methods, which fetch every cell
+ */
+int cpp_bound(FILE *f, totals &t) {
+  zsv::parser parser(f);
+  if (!parser)
+    return 1;
+  std::string first_name, last_name;
+  zsv::columns<2> cols("", "");
+  parser.parse([&](const zsv::row &row) {
+    if (!cols.resolved()) {
+      if (row.size()) {
+        first_name = row[0];
+        last_name = row[row.size() - 1];
+      }
+      cols = zsv::bind(first_name, last_name);
+      cols.resolve(row);
+      return;
+    }
+    auto values = cols(row);
+    t.bytes += values[0].size() + values[1].size();
+    t.rows++;
+  });
+  t.rows++; // header row
+  return 0;
+}
+
+struct method {
+  const char *name;
+  int (*run)(FILE *, totals &);
+  bool compare_bytes;
+};
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Compares the per-row cost of C and C++ parsing methods\n");
+    fprintf(stderr, "Usage: benchmark <filename> [repeat count, default 10]\n");
+    return 0;
+  }
+  int repeat = argc > 2 ? atoi(argv[2]) : 10;
+  if (repeat < 1)
+    repeat = 1;
+
+  const method methods[] = {
+    {"C row_handler callback", c_callback, true},
+    {"C zsv_next_row", c_pull, true},
+    {"C++ templated handler", cpp_handler, true},
+    {"C++ rows() iteration", cpp_rows, true},
+    {"C++ bound columns", cpp_bound, false},
+  };
+
+  totals expected;
+  int err = 0;
+  for (const method &m : methods) {
+    totals t;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat && !err; i++) {
+      FILE *f = fopen(argv[1], "rb");
+      if (!f) {
+        perror(argv[1]);
+        return 1;
+      }
+      err = m.run(f, t);
+      fclose(f);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (err) {
+      fprintf(stderr, "%s: could not allocate parser!\n", m.name);
+      return 1;
+    }
+    if (m.run == c_callback)
+      expected = t;
+    else if (t.rows != expected.rows || (m.compare_bytes && t.bytes != expected.bytes)) {
+      fprintf(stderr, "%s: got %zu rows / %zu bytes, expected %zu / %zu\n", m.name, t.rows, t.bytes, expected.rows,
+              expected.bytes);
+      err = 1;
+    }
+    printf("%-24s %10zu rows %8.2f ns/row\n", m.name, t.rows, t.rows ? (double)ns / t.rows : 0.0);
+  }
+  return err;
+}
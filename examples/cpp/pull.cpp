@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <cstring>
+#include <zsv/zsv.hpp>
+
+/**
+ * Same as simple.cpp, but uses pull parsing, iterating over parser.rows()
+ */
+
+int main(int argc, const char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Reads a CSV file or stdin, and for each row,\n"
+                    " output counts of total and blank cells\n");
+    fprintf(stderr, "Usage: pull <filename or dash(-) for stdin>\n");
+    return 0;
+  }
+
+  FILE *f = strcmp(argv[1], "-") ? fopen(argv[1], "rb") : stdin;
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  int err = 0;
+  {
+    zsv::parser parser(f);
+    if (!parser) {
+      fprintf(stderr, "Could not allocate parser!\n");
+      err = -1;
+    } else {
+      size_t row_num = 0;
+      for (const zsv::row &row : parser.rows()) {
+        size_t nonblank = 0;
+        for (size_t i = 0, n = row.size(); i < n; i++)
+          if (!row[i].empty())
+            nonblank++;
+        printf("Row %zu has %zu columns of which %zu %s non-blank\n", ++row_num, row.size(), nonblank,
+               nonblank == 1 ? "is" : "are");
+      }
+      if (parser.last_status() != zsv_status_done) {
+        fprintf(stderr, "Parse error: %s\n", (const char *)zsv_parse_status_desc(parser.last_status()));
+        err = 1;
+      }
+    }
+  }
+
+  if (f != stdin)
+    fclose(f);
+  return err;
+}
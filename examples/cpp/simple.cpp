@@ -0,0 +1,58 @@
+#include <cstdio>
+#include <cstring>
+#include <zsv/zsv.hpp>
+
+/**
+ * Simple example using the C++ wrapper (zsv/zsv.hpp) to parse a CSV file
+ *
+ * This is the same as ../lib/simple.c, but the row handler is a lambda that is
+ * inlined into the parser's row callback, and cells are std::string_view
+ *
+ * Example:
+ *   `echo 'abc,def\nghi,,,' | build/simple -`
+ * Outputs:
+ *   Row 1 has 2 columns of which 0 are non-blank
+ *   Row 2 has 4 columns of which 3 are non-blank
+ */
+
+int main(int argc, const char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Reads a CSV file or stdin, and for each row,\n"
+                    " output counts of total and blank cells\n");
+    fprintf(stderr, "Usage: simple <filename or dash(-) for stdin>\n");
+    return 0;
+  }
+
+  FILE *f = strcmp(argv[1], "-") ? fopen(argv[1], "rb") : stdin;
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  int err = 0;
+  {
+    zsv::parser parser(f);
+    if (!parser) {
+      fprintf(stderr, "Could not allocate parser!\n");
+      err = -1;
+    } else {
+      size_t row_num = 0;
+      zsv::status stat = parser.parse([&](const zsv::row &row) {
+        size_t nonblank = 0;
+        for (std::string_view cell : row)
+          if (!cell.empty())
+            nonblank++;
+        printf("Row %zu has %zu columns of which %zu %s non-blank\n", ++row_num, row.size(), nonblank,
+               nonblank == 1 ? "is" : "are");
+      });
+      if (stat != zsv_status_ok) {
+        fprintf(stderr, "Parse error: %s\n", (const char *)zsv_parse_status_desc(stat));
+        err = 1;
+      }
+    }
+  } // parser is deleted here
+
+  if (f != stdin)
+    fclose(f);
+  return err;
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zsv.h>
+
+/**
+ * Example using a custom allocator with libzsv, to measure parser memory usage
+ *
+ * All memory that the parser allocates goes through the allocator set in
+ * `opts.allocator`. Here, the allocator simply counts bytes in use, so that
+ * we can report the peak usage and check that everything was freed
+ *
+ * Example:
+ *   `build/alloc_stats mydata.csv`
+ * Outputs:
+ *   Rows: 100; allocations: 4; peak bytes: 270384; bytes outstanding: 0
+ *
+ * An optional second argument sets the number of rows that the header spans,
+ * which exercises additional parser allocations
+ */
+
+struct alloc_stats {
+  size_t in_use;
+  size_t peak;
+  size_t allocations;
+};
+
+/*
+ * Each block is prefixed with its size, so that we know how much is freed
+ */
+union alloc_header {
+  size_t size;
+  max_align_t align;
+};
+
+static void *stats_alloc(void *ctx, size_t size) {
+  struct alloc_stats *stats = ctx;
+  union alloc_header *h = malloc(sizeof(*h) + size);
+  if (!h)
+    return NULL;
+  h->size = size;
+  stats->allocations++;
+  stats->in_use += size;
+  if (stats->in_use > stats->peak)
+    stats->peak = stats->in_use;
+  return h + 1;
+}
+
+static void stats_release(void *ctx, void *p) {
+  struct alloc_stats *stats = ctx;
+  union alloc_header *h = (union alloc_header *)p - 1;
+  stats->in_use -= h->size;
+  free(h);
+}
+
+static void *stats_resize(void *ctx, void *p, size_t size) {
+  if (!p)
+    return stats_alloc(ctx, size);
+  struct alloc_stats *stats = ctx;
+  union alloc_header *h = (union alloc_header *)p - 1;
+  size_t old_size = h->size;
+  if (!(h = realloc(h, sizeof(*h) + size)))
+    return NULL;
+  h->size = size;
+  stats->in_use = stats->in_use - old_size + size;
+  if (stats->in_use > stats->peak)
+    stats->peak = stats->in_use;
+  return h + 1;
+}
+
+int main(int argc, const char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Reads a CSV file or stdin, and outputs the parser's memory usage\n");
+    fprintf(stderr, "Usage: alloc_stats <filename or dash(-) for stdin> [header row span]\n");
+    return 0;
+  }
+
+  FILE *f = strcmp(argv[1], "-") ? fopen(argv[1], "rb") : stdin;
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  struct alloc_stats stats = {0};
+  struct zsv_opts opts = {0};
+  opts.stream = f;
+  if (argc > 2)
+    opts.header_span = atoi(argv[2]);
+  opts.allocator.alloc = stats_alloc;
+  opts.allocator.resize = stats_resize;
+  opts.allocator.release = stats_release;
+  opts.allocator.ctx = &stats;
+
+  zsv_parser parser = zsv_new(&opts);
+  if (!parser) {
+    fprintf(stderr, "Could not allocate parser!\n");
+    return -1;
+  }
+
+  size_t row_count = 0;
+  while (zsv_next_row(parser) == zsv_status_row)
+    row_count++;
+
+  zsv_finish(parser);
+  zsv_delete(parser);
+  if (f != stdin)
+    fclose(f);
+
+  printf("Rows: %zu; allocations: %zu; peak bytes: %zu; bytes outstanding: %zu\n", row_count, stats.allocations,
+         stats.peak, stats.in_use);
+  return stats.allocations == 0 || stats.in_use != 0;
+}
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zsv.h>
+
+/**
+ * Example using checkpoints to stop and later resume parsing, and to follow a
+ * file that is being appended to
+ *
+ * Each row is output as its row number followed by its cells. If a state file
+ * is given and exists, parsing resumes from the checkpoint saved in it;
+ * otherwise parsing starts at the beginning. When parsing stops, a checkpoint
+ * is saved to the state file
+ *
+ * Example:
+ *   `build/checkpoint --state /tmp/mystate --max-rows 10 mydata.csv`
+ *   `build/checkpoint --state /tmp/mystate mydata.csv`
+ * The first command outputs the header and the first 9 data rows, then saves
+ * its position; the second outputs the rest of the rows
+ *
+ * With --follow, after all input is parsed, the file is polled for more data
+ * until no more is added for the specified number of polls
+ */
+
+struct my_data {
+  zsv_parser parser;
+  size_t row_num;       // number of the next row, where the header row is 0
+  size_t rows_left;     // if --max-rows was specified, number of rows left before stopping
+  struct zsv_checkpoint checkpoint;
+  unsigned char stopped;
+  unsigned char pull;
+  unsigned int idle_polls; // with --follow, stop after this many polls with no new data
+  unsigned int idle_count;
+  size_t rows_at_last_poll;
+};
+
+static void output_row(struct my_data *data) {
+  printf("%zu:", data->row_num++);
+  for (size_t i = 0, j = zsv_cell_count(data->parser); i < j; i++) {
+    struct zsv_cell c = zsv_get_cell(data->parser, i);
+    printf("%s%.*s", i ? "|" : " ", (int)c.len, c.str);
+  }
+  printf("\n");
+}
+
+/**
+ * Output the row. If we have reached our max, save our position and stop
+ */
+static void my_row_handler(void *ctx) {
+  struct my_data *data = ctx;
+  output_row(data);
+  if (data->rows_left && !--data->rows_left) {
+    if (zsv_checkpoint(data->parser, &data->checkpoint) == zsv_status_ok)
+      data->stopped = 1;
+    zsv_abort(data->parser);
+  }
+}
+
+static int my_idle(void *ctx) {
+  struct my_data *data = ctx;
+  if (data->row_num != data->rows_at_last_poll) {
+    data->rows_at_last_poll = data->row_num;
+    data->idle_count = 0;
+  } else
+    data->idle_count++;
+  fflush(stdout);
+  return data->idle_count >= data->idle_polls;
+}
+
+static int load_checkpoint(const char *fn, struct zsv_checkpoint *cp) {
+  FILE *f = fopen(fn, "rb");
+  if (!f)
+    return 0; // no saved state: start from the beginning
+  unsigned char buff[ZSV_CHECKPOINT_SIZE];
+  int err = fread(buff, 1, sizeof(buff), f) != sizeof(buff) || zsv_checkpoint_decode(buff, cp) != zsv_status_ok;
+  fclose(f);
+  if (err)
+    fprintf(stderr, "Invalid state file %s\n", fn);
+  return err ? -1 : 1;
+}
+
+static int save_checkpoint(const char *fn, const struct zsv_checkpoint *cp) {
+  unsigned char buff[ZSV_CHECKPOINT_SIZE];
+  zsv_checkpoint_encode(cp, buff);
+  FILE *f = fopen(fn, "wb");
+  int err = !f || fwrite(buff, 1, sizeof(buff), f) != sizeof(buff);
+  if (f && fclose(f))
+    err = 1;
+  if (err)
+    perror(fn);
+  return err;
+}
+
+int main(int argc, const char *argv[]) {
+  const char *state_fn = NULL;
+  const char *input_fn = NULL;
+  char follow = 0;
+  unsigned int poll_ms = 50;
+  struct my_data data = {0};
+  data.idle_polls = 20;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--state") && i + 1 < argc)
+      state_fn = argv[++i];
+    else if (!strcmp(argv[i], "--max-rows") && i + 1 < argc)
+      data.rows_left = strtoul(argv[++i], NULL, 10);
+    else if (!strcmp(argv[i], "--follow"))
+      follow = 1;
+    else if (!strcmp(argv[i], "--idle") && i + 1 < argc)
+      data.idle_polls = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--poll-ms") && i + 1 < argc)
+      poll_ms = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--pull"))
+      data.pull = 1;
+    else if (!input_fn && *argv[i] != '-')
+      input_fn = argv[i];
+    else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (!input_fn) {
+    fprintf(stderr, "Reads a CSV file, saving its position when stopped so that it can later be resumed\n");
+    fprintf(stderr, "Usage: checkpoint [--state <file>] [--max-rows <n>] [--pull]\n"
+                    "                  [--follow [--idle <polls, default 20>] [--poll-ms <ms, default 50>]]\n"
+                    "                  <filename>\n");
+    return 0;
+  }
+
+  struct zsv_checkpoint cp = {0};
+  int have_state = state_fn ? load_checkpoint(state_fn, &cp) : 0;
+  if (have_state < 0)
+    return 1;
+
+  FILE *f = fopen(input_fn, "rb");
+  if (!f) {
+    perror(input_fn);
+    return 1;
+  }
+
+  struct zsv_opts opts = {0};
+  opts.stream = f;
+  if (!data.pull) {
+    opts.row_handler = my_row_handler;
+    opts.ctx = &data;
+  }
+  data.parser = have_state ? zsv_new_from_checkpoint(&opts, &cp) : zsv_new(&opts);
+  if (!data.parser) {
+    fprintf(stderr, "Could not create parser!\n");
+    fclose(f);
+    return 1;
+  }
+  data.row_num = cp.data_row_count;
+
+  enum zsv_status stat = zsv_status_ok;
+  if (data.pull) {
+    while (!data.stopped && (stat = zsv_next_row(data.parser)) == zsv_status_row) {
+      output_row(&data);
+      if (data.rows_left && !--data.rows_left && zsv_checkpoint(data.parser, &data.checkpoint) == zsv_status_ok)
+        data.stopped = 1;
+    }
+  } else if (follow) {
+    struct zsv_follow_opts follow_opts = {0};
+    follow_opts.poll_ms = poll_ms;
+    follow_opts.idle = my_idle;
+    follow_opts.ctx = &data;
+    stat = zsv_follow(data.parser, &follow_opts);
+    // save our position without finishing, so that any incomplete last row
+    // is parsed when we resume
+    if (stat == zsv_status_ok && zsv_checkpoint(data.parser, &data.checkpoint) == zsv_status_ok)
+      data.stopped = 1;
+  } else {
+    while ((stat = zsv_parse_more(data.parser)) == zsv_status_ok)
+      ;
+    if (stat == zsv_status_no_more_input)
+      zsv_finish(data.parser);
+  }
+
+  // if we read all input, save the end position
+  if (!data.stopped && zsv_checkpoint(data.parser, &data.checkpoint) == zsv_status_ok)
+    data.stopped = 1;
+
+  int err = 0;
+  if (state_fn && data.stopped)
+    err = save_checkpoint(state_fn, &data.checkpoint);
+
+  zsv_delete(data.parser);
+  fclose(f);
+  return err;
+}
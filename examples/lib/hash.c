@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <string.h>
+#include <zsv.h>
+
+/**
+ * Example using the libzsv hashing functions
+ *
+ * For each row, we output the hash of each cell, then the hash of all cells
+ * combined (as would be used for a compound key), then the hash of the raw row
+ *
+ * Example:
+ *   `printf 'ab,c\na,bc\n' | build/hash -`
+ * Outputs one line per row, in the form:
+ *   <cell 1 hash>,<cell 2 hash>	<combined hash>	<row hash>
+ *
+ * Since cell boundaries are significant, the combined hashes of the two rows
+ * above differ, even though their cell values concatenate to the same bytes.
+ * With -i and/or -t, hashing ignores ASCII case and/or leading and trailing
+ * whitespace
+ */
+
+int main(int argc, const char *argv[]) {
+  unsigned int flags = 0;
+  int i;
+  for (i = 1; i < argc - 1; i++) {
+    if (!strcmp(argv[i], "-i"))
+      flags |= ZSV_HASH_CASE_INSENSITIVE;
+    else if (!strcmp(argv[i], "-t"))
+      flags |= ZSV_HASH_TRIM;
+    else
+      break;
+  }
+  if (i != argc - 1) {
+    fprintf(stderr, "Reads a CSV file or stdin, and for each row, outputs the hash of\n"
+                    " each cell, of all cells combined, and of the raw row\n");
+    fprintf(stderr, "Usage: hash [-i (case-insensitive)] [-t (trim)] <filename or dash(-) for stdin>\n");
+    return 0;
+  }
+
+  FILE *f = strcmp(argv[i], "-") ? fopen(argv[i], "rb") : stdin;
+  if (!f) {
+    perror(argv[i]);
+    return 1;
+  }
+
+  struct zsv_opts opts = {0};
+  opts.stream = f;
+  zsv_parser parser = zsv_new(&opts);
+  if (!parser) {
+    fprintf(stderr, "Could not allocate parser!\n");
+    return -1;
+  }
+
+  size_t indexes[256];
+  for (size_t j = 0; j < sizeof(indexes) / sizeof(*indexes); j++)
+    indexes[j] = j;
+
+  while (zsv_next_row(parser) == zsv_status_row) {
+    size_t cell_count = zsv_cell_count(parser);
+    if (cell_count > sizeof(indexes) / sizeof(*indexes))
+      cell_count = sizeof(indexes) / sizeof(*indexes);
+    for (size_t j = 0; j < cell_count; j++)
+      printf("%s%016llx", j ? "," : "", (unsigned long long)zsv_hash_cell(parser, j, flags));
+    printf("\t%016llx", (unsigned long long)zsv_hash_cells(parser, indexes, cell_count, flags));
+    printf("\t%016llx\n", (unsigned long long)zsv_hash_row(parser, flags));
+  }
+
+  zsv_delete(parser);
+  if (f != stdin)
+    fclose(f);
+  return 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_H
+#define ZSV_H
+
+#ifndef ZSV_EXTRAS
+#define ZSV_EXTRAS
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "zsv/common.h"
+#include "zsv/api.h"
+
+#endif
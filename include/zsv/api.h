@@ -219,6 +219,24 @@ ZSV_EXPORT enum zsv_status zsv_set_scan_filter(zsv_parser parser,
  */
 ZSV_EXPORT enum zsv_status zsv_set_fixed_offsets(zsv_parser parser, size_t count, size_t *offsets);
 
+/**
+ * Process only the cells of the given columns. Cells in other columns are
+ * still scanned, so that column positions do not change, but they are not
+ * unquoted, checked for malformed UTF-8 or passed to a cell handler, and
+ * `zsv_get_cell()` returns them as empty. Cells after the last used column
+ * are not counted by `zsv_cell_count()`
+ *
+ * This is intended to be called after the header row has been parsed, and
+ * applies to delimited (not fixed-width) input
+ *
+ * @return status code
+ * @param parser parser handle
+ * @param count  number of elements in used
+ * @param used   non-zero for each column to process. Columns at or after
+ *               count are not processed. NULL to process all columns
+ */
+ZSV_EXPORT enum zsv_status zsv_set_column_mask(zsv_parser parser, size_t count, const unsigned char *used);
+
 /**
  * Parse a buffer of bytes. This function is usually not needed, but
  * can be used to parse in a push instead of pull manner
@@ -259,6 +277,59 @@ ZSV_EXPORT size_t zsv_cum_scanned_length(zsv_parser parser);
  */
 ZSV_EXPORT size_t zsv_row_length_raw_bytes(zsv_parser parser);
 
+/**
+ * @return the raw bytes of this row, not including its row end, of length
+ *         zsv_row_length_raw_bytes(). Only valid until the next row is parsed
+ */
+ZSV_EXPORT const unsigned char *zsv_row_raw_bytes(zsv_parser parser);
+
+/******************************************************************************
+ * hashing functions, for use in hash-based lookup of cell or row values
+ * - zsv_hash_bytes(): hash an arbitrary byte string
+ * - zsv_hash_cell(): hash a cell value
+ * - zsv_hash_cells(): hash a combination of cell values, e.g. a compound key
+ * - zsv_hash_row(): hash the raw (unparsed) bytes of the current row
+ *
+ * Hashes are 64-bit and are computed with CRC32C, using SSE4.2 or ARMv8 CRC
+ * instructions where available. Results are the same with or without hardware
+ * support, but are not guaranteed to be stable across zsv versions and should
+ * not be persisted
+ *
+ * The cell and row functions should be called from within a row_handler()
+ * callback, or after zsv_next_row()
+ ******************************************************************************/
+#define ZSV_HASH_CASE_INSENSITIVE 1 // ignore ASCII case
+#define ZSV_HASH_TRIM 2             // ignore leading and trailing ASCII whitespace
+
+/**
+ * @param data  bytes to hash
+ * @param len   number of bytes to hash
+ * @param seed  initial value; can be used to chain hashes
+ * @param flags bitfield of ZSV_HASH_XXX flags, or 0
+ * @return 64-bit hash value
+ */
+ZSV_EXPORT uint64_t zsv_hash_bytes(const void *data, size_t len, uint64_t seed, unsigned int flags);
+
+/**
+ * @param ix    0-based index of the cell to hash. If out of range, hashes as an empty cell
+ */
+ZSV_EXPORT uint64_t zsv_hash_cell(zsv_parser parser, size_t ix, unsigned int flags);
+
+/**
+ * Hash multiple cells in the given order. Cell boundaries are significant,
+ * so e.g. the cells ("ab", "c") and ("a", "bc") hash differently
+ *
+ * @param indexes 0-based indexes of the cells to hash
+ * @param count   number of indexes
+ */
+ZSV_EXPORT uint64_t zsv_hash_cells(zsv_parser parser, const size_t *indexes, size_t count, unsigned int flags);
+
+/**
+ * Hash the raw bytes of the current row, excluding its line end, without
+ * regard to how the row was parsed into cells
+ */
+ZSV_EXPORT uint64_t zsv_hash_row(zsv_parser parser, unsigned int flags);
+
 /**
  * Check the quoted status of the last cell that was read. This function is only
  * applicable when called from within a cell_handler() callback. Furthermore, this
@@ -310,6 +381,97 @@ ZSV_EXPORT void zsv_opts_delete(struct zsv_opts *);
 ZSV_EXPORT
 enum zsv_status zsv_next_row(zsv_parser parser);
 
+/******************************************************************************
+ * Checkpoint and resume functions
+ * - zsv_checkpoint(): get the parser position at a row boundary
+ * - zsv_new_from_checkpoint(): create a parser that resumes from a checkpoint
+ * - zsv_checkpoint_encode() / zsv_checkpoint_decode(): serialize a checkpoint
+ * - zsv_follow(): parse input that is still being appended to
+ *
+ * Checkpoints are not supported for fixed-width input, transcoded (non-UTF8)
+ * input or when a scan filter is set
+ ******************************************************************************/
+
+/**
+ * Get a checkpoint from which parsing can be resumed after the current row.
+ * May be called:
+ * - from within a row_handler() callback
+ * - after zsv_next_row() returned zsv_status_row
+ * - between calls to zsv_parse_more(), in which case the checkpoint is at the
+ *   start of the next (not yet complete) row
+ * - before parsing has started
+ *
+ * @param  parser parser handle
+ * @param  cp     checkpoint to populate
+ * @return zsv_status_ok on success, or zsv_status_invalid_option if the parser
+ *         is still in its header rows or its input cannot be checkpointed
+ */
+ZSV_EXPORT enum zsv_status zsv_checkpoint(zsv_parser parser, struct zsv_checkpoint *cp);
+
+/**
+ * Create a parser that resumes parsing from a checkpoint. The input must be the
+ * same as (or an appended-to version of) the input of the checkpointed parser.
+ * It is positioned at the checkpoint offset, by seeking if it is a seekable
+ * FILE *, and otherwise by reading and discarding the bytes preceding the
+ * offset. If `opts->read` is set, the caller must position the input itself
+ *
+ * Header rows are not parsed again: if the header was done at the checkpoint,
+ * the row handler is next called with the first row after the checkpoint, and
+ * `rows_to_ignore`, `header_span`, `insert_header_row` and
+ * `keep_empty_header_rows` are ignored
+ *
+ * @param  opts same options as passed to zsv_new() for the checkpointed parser
+ * @param  cp   checkpoint from zsv_checkpoint() or zsv_checkpoint_decode()
+ * @return parser handle, or NULL on error
+ */
+ZSV_EXPORT zsv_parser zsv_new_from_checkpoint(struct zsv_opts *opts, const struct zsv_checkpoint *cp);
+
+/**
+ * Serialize a checkpoint into ZSV_CHECKPOINT_SIZE bytes, independent of
+ * platform byte order
+ */
+ZSV_EXPORT void zsv_checkpoint_encode(const struct zsv_checkpoint *cp, unsigned char buff[ZSV_CHECKPOINT_SIZE]);
+
+/**
+ * Deserialize a checkpoint that was serialized with zsv_checkpoint_encode()
+ * @return zsv_status_ok, or zsv_status_error if the data is not a valid checkpoint
+ */
+ZSV_EXPORT enum zsv_status zsv_checkpoint_decode(const unsigned char buff[ZSV_CHECKPOINT_SIZE],
+                                                 struct zsv_checkpoint *cp);
+
+/**
+ * Options for zsv_follow()
+ */
+struct zsv_follow_opts {
+  /**
+   * milliseconds to wait before checking for more input. Defaults to 250
+   */
+  unsigned int poll_ms;
+
+  /**
+   * Optional callback, called each time no more input is available. Return
+   * non-zero to stop following. If not set, zsv_follow() continues until it
+   * is aborted via zsv_abort()
+   */
+  int (*idle)(void *ctx);
+  void *ctx;
+};
+
+/**
+ * Tail-follow an append-only input: parse all available input, then poll for
+ * more and parse only the newly appended bytes, until stopped by the idle
+ * callback or by zsv_abort(). A partial last row is held until it is
+ * completed by appended input, or until zsv_finish() is called
+ *
+ * The input must be a FILE * read with the default read function. To follow
+ * from a saved position, pass a parser created with zsv_new_from_checkpoint();
+ * to save the position when stopped, call zsv_checkpoint() before zsv_finish()
+ *
+ * @return zsv_status_ok if stopped by the idle callback, else the status that
+ *         stopped parsing
+ */
+ZSV_EXPORT enum zsv_status zsv_follow(zsv_parser parser, const struct zsv_follow_opts *opts);
+
 /******************************************************************************
  * Miscellaneous functions used by the parser that may have standalone utility
  ******************************************************************************/
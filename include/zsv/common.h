@@ -9,6 +9,9 @@
 #ifndef ZSV_COMMON_H
 #define ZSV_COMMON_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 #define ZSV_BEGIN_DECL extern "C" {
 #define ZSV_END_DECL }
@@ -71,6 +74,17 @@ struct zsv_cell {
   unsigned char overwritten : 1;
 };
 
+/**
+ * Input encodings that can be transcoded to UTF-8 as they are read
+ */
+enum zsv_encoding {
+  zsv_encoding_auto = 0, // UTF-8, or UTF-16 if the input starts with a UTF-16 BOM
+  zsv_encoding_utf8,
+  zsv_encoding_utf16le,
+  zsv_encoding_utf16be,
+  zsv_encoding_latin1 // ISO-8859-1, with 0x80-0x9F decoded as Windows-1252
+};
+
 typedef size_t (*zsv_generic_write)(const void *restrict, size_t, size_t, void *restrict);
 typedef size_t (*zsv_generic_read)(void *restrict, size_t n, size_t size, void *restrict);
 
@@ -93,23 +107,50 @@ typedef void (*zsv_completed_callback)(void *ctx, int code);
 /**
  * Data can be "overwritten" on-the-fly by providing a source for
  *   (row, column, value) tuples
- * Supported source formats are CSV and SQLITE3
+ * Supported sources are CSV, and any other source (such as SQLITE3) via a
+ * caller-provided fetch function
+ *
+ * Tuples may be provided in any order. All are loaded when the parser is
+ * created, and if a cell is given more than once, the last value is used
  */
 enum zsv_overwrite_type {
   zsv_overwrite_type_unknown = 0, // do not change
   zsv_overwrite_type_none = 1,    // do not change
-  zsv_overwrite_type_csv
-  // to do: zsv_overwrite_type_sqlite3
+  zsv_overwrite_type_csv,         // ctx is a FILE * of CSV with columns row,col,value
+  zsv_overwrite_type_fetch        // tuples are fetched by calling fetch(ctx, ...)
 };
 
 struct zsv_opt_overwrite {
   enum zsv_overwrite_type type;
   void *ctx;
+
+  /**
+   * if set, called to close ctx after all overwrites have been loaded
+   */
   int (*close_ctx)(void *);
+
+  /**
+   * for zsv_overwrite_type_fetch: fetch the next tuple. The value need only
+   * remain valid until the next call
+   * @return 1 if a tuple was fetched, 0 if there are no more, or -1 on error
+   */
+  int (*fetch)(void *ctx, size_t *row_ix, size_t *col_ix, const unsigned char **val, size_t *len);
 };
 
 #endif
 
+/**
+ * Custom memory allocator. If `alloc` is set, then `resize` and `release` must
+ * also be set, and are used in place of malloc(), realloc() and free(). Each
+ * function is passed `ctx` as its first argument
+ */
+struct zsv_allocator {
+  void *(*alloc)(void *ctx, size_t size);
+  void *(*resize)(void *ctx, void *ptr, size_t size);
+  void (*release)(void *ctx, void *ptr);
+  void *ctx;
+};
+
 struct zsv_opts {
   /**
    * Callback that is called for each row that is parsed. In most use cases,
@@ -178,6 +219,8 @@ struct zsv_opts {
 
   /**
    * Maximum number of columns to parse. defaults to 1024
+   * Row storage is allocated on demand, so a large value does not by itself
+   * incur a large memory cost
    *
    * cli option: -c,--max-column-count
    */
@@ -252,6 +295,24 @@ struct zsv_opts {
 #define ZSV_MALFORMED_UTF8_REMOVE -1
   char malformed_utf8_replace;
 
+  /**
+   * encoding of the input. By default (zsv_encoding_auto), input is assumed
+   * to be UTF-8 unless it starts with a UTF-16 BOM, in which case it is
+   * transcoded from UTF-16. Any other non-UTF8 encoding must be set explicitly.
+   * Transcoding applies to input read via `read` / `stream`, and not to
+   * zsv_parse_bytes()
+   *
+   * cli option: -E,--encoding <auto|utf8|utf16le|utf16be|latin1>
+   */
+  enum zsv_encoding encoding;
+
+  /**
+   * optional allocator for all memory that the parser allocates, e.g. to
+   * allocate from an arena or pool, or to measure usage. Defaults to malloc(),
+   * realloc() and free()
+   */
+  struct zsv_allocator allocator;
+
 #ifdef ZSV_EXTRAS
   struct {
     /**
@@ -299,4 +360,40 @@ struct zsv_opts {
 #endif
 };
 
+/**
+ * Parser position at a row boundary, from which parsing can later be resumed
+ * by `zsv_new_from_checkpoint()`. See `zsv_checkpoint()` in api.h
+ */
+#define ZSV_CHECKPOINT_VERSION 1
+
+#define ZSV_CHECKPOINT_HAD_BOM 1     /* input began with a UTF-8 BOM */
+#define ZSV_CHECKPOINT_HEADER_DONE 2 /* all header rows have been parsed */
+#define ZSV_CHECKPOINT_SKIP_LF 4     /* the prior row ended with \r at the end of the input read thus far */
+
+struct zsv_checkpoint {
+  uint32_t version; /* ZSV_CHECKPOINT_VERSION */
+  uint32_t flags;   /* bitfield of ZSV_CHECKPOINT_XXX flags */
+
+  /**
+   * byte offset, in the raw input, of the next row to parse
+   */
+  uint64_t offset;
+
+  /**
+   * value that `data_row_count` will have for the next row (1 = first data row)
+   */
+  uint64_t data_row_count;
+
+  /**
+   * row and column of the next pending overwrite, if any (see `zsv_opts.overwrite`)
+   */
+  uint64_t overwrite_row;
+  uint64_t overwrite_col;
+};
+
+/**
+ * Size of a checkpoint serialized by `zsv_checkpoint_encode()`
+ */
+#define ZSV_CHECKPOINT_SIZE 40
+
 #endif
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_ALLOC_H
+#define ZSV_ALLOC_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <zsv/common.h>
+
+/*
+ * Allocate via a struct zsv_allocator, falling back to malloc() / realloc() / free()
+ * if `a` is NULL or has no `alloc` function
+ */
+
+static inline void *zsv_alloc(const struct zsv_allocator *a, size_t size) {
+  return a && a->alloc ? a->alloc(a->ctx, size) : malloc(size);
+}
+
+static inline void *zsv_calloc(const struct zsv_allocator *a, size_t n, size_t size) {
+  if (!(a && a->alloc))
+    return calloc(n, size);
+  if (size && n > (size_t)-1 / size)
+    return NULL;
+  void *p = a->alloc(a->ctx, n * size);
+  if (p)
+    memset(p, 0, n * size);
+  return p;
+}
+
+static inline void *zsv_realloc(const struct zsv_allocator *a, void *ptr, size_t size) {
+  return a && a->alloc ? a->resize(a->ctx, ptr, size) : realloc(ptr, size);
+}
+
+static inline void zsv_free(const struct zsv_allocator *a, void *ptr) {
+  if (a && a->alloc) {
+    if (ptr)
+      a->release(a->ctx, ptr);
+  } else
+    free(ptr);
+}
+
+#endif
@@ -17,7 +17,8 @@
 char havearg(const char *arg, const char *form1, size_t min_len1, const char *form2, size_t min_len2);
 
 /**
- * set or get default parser options
+ * set or get default parser options. Defaults are per-thread, so a thread
+ * that changes them does not affect parsers created by other threads
  */
 void zsv_set_default_opts(struct zsv_opts);
 
@@ -60,6 +61,7 @@ void zsv_set_default_completed_callback(zsv_completed_callback cb, void *ctx);
  *     -q,--no-quote
  *     -S,--keep-blank-headers: disable default behavior of ignoring leading blank rows
  *     -d,--header-row-span <n>: apply header depth (rowspan) of n
+ *     -E,--encoding <enc>: input encoding (auto, utf8, utf16le, utf16be or latin1)
  *     -v,--verbose
  *
  * @param  argc      count of args to process
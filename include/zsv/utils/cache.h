@@ -32,7 +32,8 @@ unsigned char *zsv_cache_path(const unsigned char *data_filepath, const unsigned
 
 enum zsv_cache_type {
   zsv_cache_type_property = 1,
-  zsv_cache_type_tag
+  zsv_cache_type_tag,
+  zsv_cache_type_sql // sqlite3 database of the parsed data (see `sql --cache`)
 };
 
 unsigned char *zsv_cache_filepath(const unsigned char *data_filepath, enum zsv_cache_type type, char create_dir,
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_UTILS_COMPRESS_H
+#define ZSV_UTILS_COMPRESS_H
+
+#include <stddef.h>
+
+/**
+ * Parallel output compression
+ *
+ * Output is split into blocks that are compressed independently on a
+ * zsv_pool, and written in order as they complete. Each block is a complete
+ * gzip member or zstd frame, and the concatenation of members or frames is a
+ * valid gzip or zstd stream (as written by pigz --independent or zstd -T).
+ *
+ * gzip requires zlib (configure --enable-zlib) and zstd requires libzstd
+ * (configure --enable-zstd)
+ *
+ * Example:
+ *   struct zsv_compressor_options opts = {0};
+ *   opts.type = zsv_compression_gzip;
+ *   opts.stream = f;
+ *   zsv_compressor c = zsv_compressor_new(&opts);
+ *   zsv_compressor_write(data, 1, len, c);
+ *   if (zsv_compressor_delete(c)) ... error
+ */
+
+enum zsv_compression {
+  zsv_compression_none = 0,
+  zsv_compression_gzip,
+  zsv_compression_zstd
+};
+
+typedef struct zsv_compressor *zsv_compressor;
+
+struct zsv_allocator;
+
+struct zsv_compressor_options {
+  enum zsv_compression type;
+
+  /**
+   * compression level, or 0 for the library default (6 for gzip, 3 for zstd)
+   */
+  int level;
+
+  /**
+   * number of threads to compress on; 0 for one per processor. With 1 thread
+   * or if compiled with NO_THREADING, blocks are compressed as they are filled
+   */
+  unsigned int threads;
+
+  /**
+   * uncompressed size of each block, or 0 for the default of 1MB
+   */
+  size_t block_size;
+
+  /**
+   * where compressed output is written. If `write` is NULL, `stream` is written with fwrite()
+   */
+  size_t (*write)(const void *restrict, size_t size, size_t nitems, void *restrict stream);
+  void *stream;
+
+  /**
+   * optional allocator for the block buffers (see zsv_opts.allocator)
+   */
+  const struct zsv_allocator *allocator;
+};
+
+/**
+ * @return zsv_compression_gzip if filename ends in .gz, zsv_compression_zstd if
+ * it ends in .zst, else zsv_compression_none
+ */
+enum zsv_compression zsv_compression_from_filename(const char *filename);
+
+/**
+ * @return 1 if this build supports the given compression type, else 0
+ */
+int zsv_compression_supported(enum zsv_compression type);
+
+/**
+ * @return new compressor, or NULL on error or if the type is not supported
+ */
+zsv_compressor zsv_compressor_new(struct zsv_compressor_options *opts);
+
+/**
+ * Compress data. Has the same signature as fwrite(), so that a compressor can
+ * be used as the `write` and `stream` of other writers
+ * @return nitems, or 0 if an error has occurred
+ */
+size_t zsv_compressor_write(const void *restrict s, size_t size, size_t nitems, void *restrict compressor);
+
+/**
+ * Compress and write all data written so far. The next data will start a new
+ * block
+ * @return 0 on success, non-zero if any error has occurred
+ */
+int zsv_compressor_flush(zsv_compressor c);
+
+/**
+ * Flush and free a compressor
+ * @return 0 on success, non-zero if any error has occurred
+ */
+int zsv_compressor_delete(zsv_compressor c);
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_UTILS_NUM_H
+#define ZSV_UTILS_NUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Number to text conversion without printf
+ *
+ * Each function writes to `buff`, which must hold at least ZSV_NUM_BUFF_SIZE
+ * bytes, appends a terminating null, and returns the length of the text (not
+ * counting the null)
+ */
+#define ZSV_NUM_BUFF_SIZE 32
+
+/**
+ * Same output as "%" PRIu64
+ */
+size_t zsv_u64toa(uint64_t v, char *buff);
+
+/**
+ * Same output as "%" PRId64
+ */
+size_t zsv_i64toa(int64_t v, char *buff);
+
+/**
+ * Write the shortest decimal that strtod() reads back as exactly `d`
+ *
+ * Digits are generated with the Grisu2 algorithm, which is shortest for all
+ * but a tiny fraction of values (for those, one extra digit is written), and
+ * the result always round-trips
+ *
+ * The text is formatted as in JavaScript: integers have no decimal point, and
+ * exponential notation (e.g. 1e+21, 1.5e-7) is used only if the exponent is
+ * < -6 or > 20. Non-finite values are written as nan, inf or -inf
+ */
+size_t zsv_dtoa(double d, char *buff);
+
+/**
+ * Same output as "%.<precision>Lf", for values that can be formatted exactly
+ * from a 128-bit product (|v| * 10^precision < 2^64, precision <= 19)
+ *
+ * Returns 0, without writing to `buff`, if `v` is out of that range, is not
+ * finite, or if this platform has no 128-bit integers or has a long double
+ * wider than 64 bits of precision; the caller should then use printf
+ */
+size_t zsv_ldtoa_fixed(long double v, unsigned int precision, char *buff);
+
+#endif
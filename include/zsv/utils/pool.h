@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_UTILS_POOL_H
+#define ZSV_UTILS_POOL_H
+
+#include <stddef.h>
+
+/**
+ * Work-stealing task pool, for commands that process work on multiple threads
+ *
+ * Each worker thread has its own task queue. Tasks submitted from within a
+ * running task go to the current worker's queue, other tasks are spread across
+ * the workers, and a worker whose queue is empty steals from the others.
+ *
+ * Tasks are submitted to a group, which:
+ * - bounds the number of its tasks in flight: zsv_pool_submit() blocks when full
+ * - calls each task's `complete` callback in submission order, on the thread
+ *   that calls zsv_pool_submit() or zsv_pool_group_wait(). Completion callbacks
+ *   can therefore write output without any locking
+ *
+ * If compiled with NO_THREADING, tasks run synchronously when submitted
+ *
+ * Example:
+ *   zsv_pool pool = zsv_pool_new(0);
+ *   zsv_pool_group g = zsv_pool_group_new(pool, 0);
+ *   for (int i = 0; i < n; i++)
+ *     zsv_pool_submit(g, process_file, print_result, &files[i]);
+ *   zsv_pool_group_delete(g); // waits for all tasks to complete
+ *   zsv_pool_delete(pool);
+ */
+
+typedef struct zsv_pool *zsv_pool;
+typedef struct zsv_pool_group *zsv_pool_group;
+
+typedef void (*zsv_pool_task_func)(void *arg);
+
+/**
+ * @return number of online processors, or 1 if unknown
+ */
+unsigned int zsv_pool_cpu_count(void);
+
+/**
+ * Create a pool
+ * @param thread_count number of worker threads; 0 for one per processor
+ * @return new pool, or NULL on error
+ */
+zsv_pool zsv_pool_new(unsigned int thread_count);
+
+/**
+ * @return number of worker threads in the pool
+ */
+unsigned int zsv_pool_thread_count(zsv_pool pool);
+
+/**
+ * Stop and free a pool. All groups must be deleted first
+ */
+void zsv_pool_delete(zsv_pool pool);
+
+/**
+ * Create a task group
+ * @param pool          pool to run tasks in. If NULL, each task runs
+ *                      synchronously when submitted
+ * @param max_in_flight maximum number of submitted tasks that have not yet been
+ *                      completed. 0 for the default of twice the thread count
+ * @return new group, or NULL on error
+ */
+zsv_pool_group zsv_pool_group_new(zsv_pool pool, size_t max_in_flight);
+
+/**
+ * Submit a task. Blocks while the group is full, meanwhile delivering completed
+ * tasks to their `complete` callback
+ * @param run      function to run on a worker thread
+ * @param complete optional function to call, in submission order, after `run`
+ *                 has finished
+ * @param arg      argument passed to both `run` and `complete`
+ * @return 0 on success, non-zero on error
+ */
+int zsv_pool_submit(zsv_pool_group group, zsv_pool_task_func run, zsv_pool_task_func complete, void *arg);
+
+/**
+ * Wait until all tasks submitted to the group have run and been completed
+ */
+void zsv_pool_group_wait(zsv_pool_group group);
+
+/**
+ * Wait for all tasks in the group, then free it
+ */
+void zsv_pool_group_delete(zsv_pool_group group);
+
+/**
+ * Parse the value of a `--threads` option: a positive number of threads, or 0
+ * for one per processor
+ * @return 0 on success, non-zero if the value is invalid
+ */
+int zsv_pool_threads_arg(const char *value, unsigned int *thread_count);
+
+#endif
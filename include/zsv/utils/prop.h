@@ -26,7 +26,7 @@ const unsigned char *zsv_properties_parser_get_filepath(void *property_parser);
 struct zsv_opts *zsv_properties_parser_get_opts(void *property_parser_);
 
 /**
- * set or get default custom property handler
+ * set or get default custom property handler. Defaults are per-thread
  */
 void zsv_set_default_custom_prop_handler(struct zsv_prop_handler custom_prop_handler);
 
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_UTILS_REGEX_H
+#define ZSV_UTILS_REGEX_H
+
+#include <stddef.h>
+
+/**
+ * Byte-oriented regular expressions, matched in linear time
+ *
+ * A pattern is compiled to an NFA, which is then run as a DFA whose states
+ * are built lazily, as input is seen, and cached; there is no backtracking.
+ * If the cache grows too large, it is flushed and rebuilt
+ *
+ * If every match must contain some literal string, that string is searched
+ * for first, and the automaton is only run on input that contains it
+ *
+ * Supported syntax:
+ *   .            any byte
+ *   [abc] [^a-z] byte classes, which may include \d \w \s
+ *   \d \w \s     digit, word and whitespace bytes (ASCII); \D \W \S negate
+ *   \t \n \r \xHH, or \ followed by any other byte to match that byte
+ *   ^ $          start / end of the input
+ *   (...) (?:...) grouping
+ *   a|b          alternation
+ *   * + ? {n} {n,} {n,m}  repetition (a trailing ? for lazy matching is
+ *                accepted and ignored)
+ *
+ * Example:
+ *   const char *err;
+ *   zsv_regex re = zsv_regex_new((const unsigned char *)"^ab+c", 5, 0, &err);
+ *   if (re && zsv_regex_match(re, buff, len) > 0)
+ *     ... buff matches ...
+ *   zsv_regex_delete(re);
+ */
+
+typedef struct zsv_regex *zsv_regex;
+
+#define ZSV_REGEX_CASE_INSENSITIVE 1 // ASCII letters match either case
+
+/**
+ * @param pattern pattern to compile
+ * @param len     length of pattern
+ * @param flags   bitwise-or of ZSV_REGEX_ flags
+ * @param err     if not NULL, on error, set to a description of the error
+ * @return new regex, or NULL on error
+ */
+zsv_regex zsv_regex_new(const unsigned char *pattern, size_t len, unsigned int flags, const char **err);
+
+/**
+ * Check if any part of the input matches
+ * @return 1 if matched, 0 if not matched, or -1 if out of memory
+ */
+int zsv_regex_match(zsv_regex re, const unsigned char *s, size_t len);
+
+/**
+ * Get the longest literal string that every match must contain, if any.
+ * If the regex is case-insensitive, the literal is lower-cased
+ * @return literal, or NULL if none
+ */
+const unsigned char *zsv_regex_literal(zsv_regex re, size_t *len);
+
+void zsv_regex_delete(zsv_regex re);
+
+#endif
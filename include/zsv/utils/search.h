@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_UTILS_SEARCH_H
+#define ZSV_UTILS_SEARCH_H
+
+#include <stddef.h>
+
+/**
+ * Multi-literal search: find occurrences of any of a set of strings in a
+ * buffer, in a single pass regardless of the number of strings
+ *
+ * The strings are compiled once. Small sets use a SIMD prefilter (the "Teddy"
+ * algorithm: candidate positions are found by matching a fingerprint of the
+ * first few bytes of each string, 16 or 32 positions at a time, then
+ * verified); larger sets, or builds without SSSE3, use an Aho-Corasick
+ * automaton
+ *
+ * Example:
+ *   zsv_search s = zsv_search_new(ZSV_SEARCH_CASE_INSENSITIVE);
+ *   zsv_search_add(s, (const unsigned char *)"foo", 3);
+ *   zsv_search_add(s, (const unsigned char *)"bar", 3);
+ *   if (!zsv_search_compile(s) && zsv_search_scan(s, buff, len, NULL, NULL))
+ *     ... buff contains foo or bar ...
+ *   zsv_search_delete(s);
+ */
+
+typedef struct zsv_search *zsv_search;
+
+#define ZSV_SEARCH_CASE_INSENSITIVE 1 // ASCII letters match either case
+#define ZSV_SEARCH_NO_SIMD 2          // always use Aho-Corasick
+
+/**
+ * Called for each match found by zsv_search_scan()
+ * @param offset offset of the match in the scanned buffer
+ * @param len    length of the match
+ * @return non-zero to accept the match and stop scanning, or 0 to continue
+ */
+typedef int (*zsv_search_accept)(void *ctx, size_t offset, size_t len);
+
+/**
+ * @param flags bitwise-or of ZSV_SEARCH_ flags
+ * @return new search, or NULL if out of memory
+ */
+zsv_search zsv_search_new(unsigned int flags);
+
+/**
+ * Add a search string. Empty strings are ignored
+ * @return 0 on success
+ */
+int zsv_search_add(zsv_search s, const unsigned char *str, size_t len);
+
+/**
+ * Compile the strings added so far. Must be called before zsv_search_scan()
+ * @return 0 on success
+ */
+int zsv_search_compile(zsv_search s);
+
+/**
+ * @return number of distinct strings to search for
+ */
+size_t zsv_search_count(zsv_search s);
+
+/**
+ * Scan a buffer for matches. Matches are reported in the order in which they
+ * are found, which is not necessarily the order of their offsets
+ * @param accept optional callback to filter matches; if NULL, the first
+ *               match is accepted
+ * @return 1 if a match was accepted, else 0
+ */
+int zsv_search_scan(zsv_search s, const unsigned char *buff, size_t len, zsv_search_accept accept, void *ctx);
+
+void zsv_search_delete(zsv_search s);
+
+#endif
@@ -97,6 +97,28 @@ const unsigned char *zsv_strtrim(const char unsigned *restrict s, size_t *lenp);
  */
 size_t zsv_strunescape_backslash(unsigned char *s, size_t len);
 
+#define ZSV_STRCLEAN_UNESCAPE 1          // convert backslash-escaped \t, \n and \r
+#define ZSV_STRCLEAN_TRIM 2              // trim leading and trailing whitespace
+#define ZSV_STRCLEAN_WHITE 4             // convert consecutive white to single space
+#define ZSV_STRCLEAN_WHITE_NO_NEWLINE 8  // with ZSV_STRCLEAN_WHITE: as ZSV_STRWHITE_FLAG_NO_EMBEDDED_NEWLINE
+#define ZSV_STRCLEAN_LINEEND 16          // replace embedded line ends with `lineend` if the value is quoted
+#define ZSV_STRCLEAN_LINEEND_TRIM 32     // with ZSV_STRCLEAN_LINEEND: trim again after replacing line ends
+
+/**
+ * zsv_strclean(): clean a string in place, in a single pass, with the same
+ * result as applying zsv_strunescape_backslash(), zsv_strtrim(), zsv_strwhite()
+ * and embedded line end replacement in that order
+ *
+ * @param s       string to clean
+ * @param lenp    length of input string; set to the length of the result
+ * @param quoted  optional: whether the value was quoted. Set to 1 if any
+ *                escapes were converted
+ * @param flags   bitfield of ZSV_STRCLEAN_XXX values
+ * @param lineend char to replace embedded line ends with
+ * @returns pointer to the start of the result, which is within s
+ */
+unsigned char *zsv_strclean(unsigned char *s, size_t *lenp, char *quoted, unsigned int flags, unsigned char lineend);
+
 /**
  * Get the next UTF8 codepoint in a string
  * Return: length of next character (in bytes), or 0 on error or end of string
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_UTILS_WHERE_H
+#define ZSV_UTILS_WHERE_H
+
+#include <stddef.h>
+
+/**
+ * Row predicates
+ *
+ * An expression is parsed and compiled once, then evaluated on each row by
+ * fetching only the cells that it refers to. Syntax:
+ *
+ *   <column> <op> <value>    op is one of = == != <> < <= > >=
+ *   <column> <op> <column>
+ *   <column> [not] in (<value>, ...)
+ *   <column> [not] contains|startswith|endswith <value>
+ *   <expr> and <expr>, <expr> or <expr>, not <expr>, (<expr>)
+ *
+ * A column is a bare name (letters, digits, '_' and '.') or a name in double
+ * quotes. A value is a number, or a string in single quotes ('' for a quote).
+ * Keywords and column names are case-insensitive
+ *
+ * Comparisons to numbers are numeric, and are false if the cell is not a
+ * number; comparisons to strings are bytewise. Two columns are compared as
+ * numbers if both are numeric, otherwise as strings
+ *
+ * Example:
+ *   const char *err, *expr = "amount > 1000 and status = 'OPEN'";
+ *   zsv_where w = zsv_where_new((const unsigned char *)expr, strlen(expr), &err);
+ *   if (w && !zsv_where_bind(w, header_names, header_count, &err))
+ *     ... for each row: if (zsv_where_eval(w, get_cell, ctx)) ...
+ *   zsv_where_delete(w);
+ */
+
+typedef struct zsv_where *zsv_where;
+
+/**
+ * Called by zsv_where_eval() to get a cell of the current row
+ * @param ix  column index
+ * @param len set to the length of the cell value
+ * @return cell value
+ */
+typedef const unsigned char *(*zsv_where_get_cell)(void *ctx, size_t ix, size_t *len);
+
+/**
+ * @param err if not NULL, on error, set to a description of the error
+ * @return new predicate, or NULL on error
+ */
+zsv_where zsv_where_new(const unsigned char *expr, size_t len, const char **err);
+
+/**
+ * Resolve the column names in the predicate to column indexes
+ * @param names header names
+ * @param count number of header names
+ * @param missing if not NULL, on error, set to the name that was not found
+ * @return 0 on success
+ */
+int zsv_where_bind(zsv_where w, unsigned char *const *names, size_t count, const char **missing);
+
+/**
+ * @return one more than the highest column index that the predicate refers to
+ */
+size_t zsv_where_column_count(zsv_where w);
+
+/**
+ * @return 1 if the current row satisfies the predicate, else 0
+ */
+int zsv_where_eval(zsv_where w, zsv_where_get_cell get_cell, void *ctx);
+
+void zsv_where_delete(zsv_where w);
+
+#endif
@@ -10,19 +10,57 @@
 #define ZSV_WRITER_H
 
 #include <stdio.h>
+#include <zsv/utils/compress.h>
 
 #define ZSV_WRITER_NEW_ROW 1
 #define ZSV_WRITER_SAME_ROW 0
 
 /*** csv writer ***/
+struct zsv_allocator;
+
 struct zsv_csv_writer_options {
   char with_bom;
   size_t (*write)(const void *restrict, size_t size, size_t nitems, void *restrict stream);
   void *stream;
   void (*table_init)(void *);
   void *table_init_ctx;
+
+  /**
+   * optional allocator for all memory that the writer allocates (see zsv_opts.allocator)
+   * the allocator is copied by zsv_writer_new(), but its ctx must remain valid until
+   * zsv_writer_delete() is called
+   */
+  const struct zsv_allocator *allocator;
+
+  /**
+   * optional size of the output buffer, in bytes. Defaults to 256k
+   */
+  size_t output_buffsize;
+
+  /**
+   * if non-zero, each full output buffer is written by a separate thread while
+   * the next one is filled, so that output overlaps with processing. If `write`
+   * is not set, `stream` is written with write(2) on its file descriptor, so it
+   * should not be written to directly except after zsv_writer_flush().
+   * zsv_writer_flush() and zsv_writer_delete() return when all output has been
+   * written, and return zsv_writer_status_error if any write failed
+   */
+  char async;
+
+  /**
+   * optional compression of the output, on `compress_threads` threads (0 for
+   * one per processor). zsv_writer_new() returns NULL if this build does not
+   * support the compression type (see zsv/utils/compress.h). Each call to
+   * zsv_writer_flush() ends a compressed block
+   */
+  enum zsv_compression compress;
+  int compress_level; // 0 for the default
+  unsigned int compress_threads;
 };
 
+/**
+ * set or get default writer options. Defaults are per-thread
+ */
 void zsv_writer_set_default_opts(struct zsv_csv_writer_options opts);
 struct zsv_csv_writer_options zsv_writer_get_default_opts(void);
 
@@ -47,6 +85,20 @@ enum zsv_writer_status zsv_writer_cell(zsv_csv_writer,
                                        char new_row, // ZSV_WRITER_NEW_ROW or ZSV_WRITER_SAME_ROW
                                        const unsigned char *s, size_t len, char check_if_needs_quoting);
 
+/**
+ * Write bytes to the output as-is, without any row or cell handling, so that
+ * output that was formatted elsewhere shares this writer's buffering and
+ * compression
+ */
+enum zsv_writer_status zsv_writer_write(zsv_csv_writer w, const unsigned char *s, size_t len);
+
+/**
+ * Write a row that is already CSV, such as the raw bytes of an input row that
+ * is output unchanged, without checking whether any of it needs quoting
+ * @param s   row contents, not including a row end
+ */
+enum zsv_writer_status zsv_writer_row_raw(zsv_csv_writer w, const unsigned char *s, size_t len);
+
 unsigned char *zsv_writer_str_to_csv(const unsigned char *s, size_t len);
 
 /*
@@ -62,10 +114,14 @@ enum zsv_writer_status zsv_writer_cell_zu(zsv_csv_writer w, char new_row, size_t
 enum zsv_writer_status zsv_writer_cell_s(zsv_csv_writer w, char new_row, const unsigned char *s,
                                          char check_if_needs_quoting);
 
+// a plain precision spec (e.g. ".2") is formatted without printf when possible (see zsv_ldtoa_fixed())
 enum zsv_writer_status zsv_writer_cell_Lf(zsv_csv_writer w, char new_row,
                                           const char *fmt_spec, // provide X in %XLf e.g. ".2" or ""
                                           long double ldbl);
 
+// write the shortest text that reads back as the same double (see zsv_dtoa())
+enum zsv_writer_status zsv_writer_cell_dbl(zsv_csv_writer w, char new_row, double dbl);
+
 // write a blank cell
 enum zsv_writer_status zsv_writer_cell_blank(zsv_csv_writer w, char new_row);
 
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef ZSV_HPP
+#define ZSV_HPP
+
+/**
+ * Optional header-only C++17 wrapper for libzsv
+ *
+ * The row handler is a template parameter, so each handler gets its own
+ * trampoline with the handler body inlined into it: per row, there is one
+ * indirect call (the same as with a C row handler), and no void * casts in
+ * user code. Cells are returned as std::string_view, which point into the
+ * parser buffer and are valid only until the next row is parsed.
+ *
+ * Errors are reported as `enum zsv_status`, as with the C API; the wrapper
+ * does not throw, so it can be used with -fno-exceptions
+ *
+ * Push parsing:
+ *   zsv::parser p(stdin);
+ *   size_t n = 0;
+ *   p.parse([&](const zsv::row &r) { n += r.size(); });
+ *
+ * Pull parsing:
+ *   for (const zsv::row &r : p.rows())
+ *     std::cout << r[0] << "\n";
+ *
+ * Binding column names to indexes, once, from the header row:
+ *   auto cols = zsv::bind("id", "amount");
+ *   p.parse([&](const zsv::row &r) {
+ *     if (!cols.resolved())
+ *       cols.resolve(r); // header row
+ *     else
+ *       total += atof(std::string(cols.get<1>(r)).c_str());
+ *   });
+ * With C++20, names can also be given as template arguments:
+ *   auto cols = zsv::bind<"id", "amount">();
+ */
+
+#if !(__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#error "zsv.hpp requires C++17 or later"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// the C headers use the C99 `restrict` qualifier, which C++ spells differently
+#pragma push_macro("restrict")
+#undef restrict
+#define restrict __restrict
+extern "C" {
+#include <zsv.h>
+}
+#pragma pop_macro("restrict")
+
+namespace zsv {
+
+using status = enum zsv_status;
+
+inline std::string_view to_string_view(const struct zsv_cell &c) noexcept {
+  return std::string_view(reinterpret_cast<const char *>(c.str), c.len);
+}
+
+/**
+ * View of the parser's current row. Valid only until the next row is parsed
+ */
+class row {
+public:
+  explicit row(zsv_parser p) noexcept : p_(p) {
+  }
+
+  std::size_t size() const noexcept {
+    return zsv_cell_count(p_);
+  }
+
+  std::string_view operator[](std::size_t ix) const noexcept {
+    return to_string_view(zsv_get_cell(p_, ix));
+  }
+
+  struct zsv_cell cell(std::size_t ix) const noexcept {
+    return zsv_get_cell(p_, ix);
+  }
+
+  bool blank() const noexcept {
+    return zsv_row_is_blank(p_);
+  }
+
+  zsv_parser handle() const noexcept {
+    return p_;
+  }
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    iterator(zsv_parser p, std::size_t ix) noexcept : p_(p), ix_(ix) {
+    }
+    std::string_view operator*() const noexcept {
+      return to_string_view(zsv_get_cell(p_, ix_));
+    }
+    iterator &operator++() noexcept {
+      ++ix_;
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      iterator tmp = *this;
+      ++ix_;
+      return tmp;
+    }
+    bool operator==(const iterator &other) const noexcept {
+      return ix_ == other.ix_;
+    }
+    bool operator!=(const iterator &other) const noexcept {
+      return ix_ != other.ix_;
+    }
+
+  private:
+    zsv_parser p_;
+    std::size_t ix_;
+  };
+
+  iterator begin() const noexcept {
+    return iterator(p_, 0);
+  }
+  iterator end() const noexcept {
+    return iterator(p_, size());
+  }
+
+private:
+  zsv_parser p_;
+};
+
+/**
+ * A set of N column names, bound to column indexes by resolve() from a header
+ * row. After that, cells are fetched by compile-time position with no further
+ * name lookups
+ */
+template <std::size_t N> class columns {
+public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  template <class... Names> explicit columns(const Names &...names) noexcept : names_{std::string_view(names)...} {
+    static_assert(sizeof...(Names) == N, "wrong number of column names");
+    ix_.fill(npos);
+  }
+
+  /**
+   * Look up each column name in the given header row. The first matching
+   * column is used
+   * @return true if every name was found
+   */
+  bool resolve(const row &header) noexcept {
+    std::size_t found = 0;
+    ix_.fill(npos);
+    for (std::size_t i = 0, n = header.size(); i < n && found < N; i++) {
+      std::string_view name = header[i];
+      for (std::size_t j = 0; j < N; j++) {
+        if (ix_[j] == npos && names_[j] == name) {
+          ix_[j] = i;
+          found++;
+          break;
+        }
+      }
+    }
+    resolved_ = true;
+    return found == N;
+  }
+
+  bool resolved() const noexcept {
+    return resolved_;
+  }
+
+  /**
+   * @return index of the I-th bound column, or npos if it was not found
+   */
+  template <std::size_t I> std::size_t index() const noexcept {
+    static_assert(I < N, "column position out of range");
+    return ix_[I];
+  }
+
+  /**
+   * @return value of the I-th bound column in the given row, or an empty
+   *         view if the column was not found or the row is too short
+   */
+  template <std::size_t I> std::string_view get(const row &r) const noexcept {
+    static_assert(I < N, "column position out of range");
+    return ix_[I] < r.size() ? r[ix_[I]] : std::string_view();
+  }
+
+  std::array<std::string_view, N> operator()(const row &r) const noexcept {
+    std::array<std::string_view, N> values;
+    for (std::size_t j = 0; j < N; j++)
+      values[j] = ix_[j] < r.size() ? r[ix_[j]] : std::string_view();
+    return values;
+  }
+
+private:
+  std::array<std::string_view, N> names_;
+  std::array<std::size_t, N> ix_;
+  bool resolved_ = false;
+};
+
+/**
+ * Bind column names. The names are not copied, and must outlive the result
+ */
+template <class... Names> columns<sizeof...(Names)> bind(const Names &...names) noexcept {
+  return columns<sizeof...(Names)>(names...);
+}
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+/**
+ * String literal usable as a template argument (C++20), so that column names
+ * can be given at compile time: zsv::bind<"id", "amount">()
+ */
+template <std::size_t L> struct column_name {
+  constexpr column_name(const char (&s)[L]) noexcept {
+    for (std::size_t i = 0; i < L; i++)
+      str[i] = s[i];
+  }
+  char str[L];
+};
+
+template <column_name... Names> columns<sizeof...(Names)> bind() noexcept {
+  return columns<sizeof...(Names)>(std::string_view(Names.str, sizeof(Names.str) - 1)...);
+}
+#endif
+
+class parser {
+public:
+  parser() noexcept = default;
+
+  explicit parser(struct zsv_opts opts) noexcept : p_(zsv_new(&opts)) {
+  }
+
+  explicit parser(FILE *f, struct zsv_opts opts = {}) noexcept {
+    opts.stream = f;
+    p_ = zsv_new(&opts);
+  }
+
+  parser(const parser &) = delete;
+  parser &operator=(const parser &) = delete;
+
+  parser(parser &&other) noexcept : p_(std::exchange(other.p_, nullptr)) {
+  }
+
+  parser &operator=(parser &&other) noexcept {
+    if (this != &other) {
+      reset();
+      p_ = std::exchange(other.p_, nullptr);
+    }
+    return *this;
+  }
+
+  ~parser() {
+    reset();
+  }
+
+  explicit operator bool() const noexcept {
+    return p_ != nullptr;
+  }
+
+  zsv_parser handle() const noexcept {
+    return p_;
+  }
+
+  /**
+   * Push-parse all remaining input, calling handler(const zsv::row &) for
+   * each row. If the handler returns bool, returning false stops parsing
+   * @return zsv_status_ok when all input was parsed, else the error or
+   *         zsv_status_cancelled
+   */
+  template <class Handler> status parse(Handler &&handler) {
+    if (!p_)
+      return zsv_status_error;
+    using handler_type = std::remove_reference_t<Handler>;
+    struct context {
+      handler_type *handler;
+      zsv_parser p;
+    } ctx = {&handler, p_};
+
+    zsv_set_row_handler(p_, [](void *c) {
+      context *ctx = static_cast<context *>(c);
+      row r(ctx->p);
+      if constexpr (std::is_same_v<std::invoke_result_t<handler_type &, const row &>, bool>) {
+        if (!(*ctx->handler)(r))
+          zsv_abort(ctx->p);
+      } else
+        (*ctx->handler)(r);
+    });
+    zsv_set_context(p_, &ctx);
+
+    status stat;
+    while ((stat = zsv_parse_more(p_)) == zsv_status_ok)
+      ;
+    if (stat == zsv_status_no_more_input)
+      stat = zsv_finish(p_);
+    return stat;
+  }
+
+  /**
+   * Pull-parse the next row. A parser used for pull parsing cannot also be
+   * used for push parsing
+   * @return zsv_status_row on success
+   */
+  status next_row() noexcept {
+    return p_ ? zsv_next_row(p_) : zsv_status_error;
+  }
+
+  /**
+   * The current row, after next_row() returned zsv_status_row or from within
+   * a handler
+   */
+  row current() const noexcept {
+    return row(p_);
+  }
+
+  /**
+   * Range of rows for pull parsing:
+   *   for (const zsv::row &r : p.rows()) ...
+   * After the loop, last_status() is zsv_status_done if all input was read,
+   * else the error
+   */
+  class row_range {
+  public:
+    class iterator {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = row;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const row *;
+      using reference = const row &;
+
+      explicit iterator(parser *owner) noexcept : owner_(owner), row_(owner ? owner->p_ : nullptr) {
+        advance();
+      }
+      const row &operator*() const noexcept {
+        return row_;
+      }
+      const row *operator->() const noexcept {
+        return &row_;
+      }
+      iterator &operator++() noexcept {
+        advance();
+        return *this;
+      }
+      bool operator==(const iterator &other) const noexcept {
+        return owner_ == other.owner_;
+      }
+      bool operator!=(const iterator &other) const noexcept {
+        return owner_ != other.owner_;
+      }
+
+    private:
+      void advance() noexcept {
+        if (owner_ && (owner_->last_ = owner_->next_row()) != zsv_status_row)
+          owner_ = nullptr;
+      }
+      parser *owner_;
+      row row_;
+    };
+
+    explicit row_range(parser *owner) noexcept : owner_(owner) {
+    }
+    iterator begin() noexcept {
+      return iterator(owner_);
+    }
+    iterator end() noexcept {
+      return iterator(nullptr);
+    }
+
+  private:
+    parser *owner_;
+  };
+
+  row_range rows() noexcept {
+    return row_range(this);
+  }
+
+  /**
+   * @return the status of the last next_row() call made via rows()
+   */
+  status last_status() const noexcept {
+    return last_;
+  }
+
+private:
+  void reset() noexcept {
+    if (p_)
+      zsv_delete(p_);
+    p_ = nullptr;
+  }
+
+  zsv_parser p_ = nullptr;
+  status last_ = zsv_status_ok;
+};
+
+} // namespace zsv
+
+#endif
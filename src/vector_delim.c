@@ -58,3 +58,24 @@ __attribute__((always_inline)) static inline int vec_delims(const unsigned char
   }
   return total_bytes; // nothing found in entire buffer
 }
+
+// vec_row_end: return the offset of the first byte in s that matches any of the 3 chars, or n if there is none
+__attribute__((always_inline)) static inline size_t vec_row_end(const unsigned char *s, size_t n,
+                                                                zsv_uc_vector *char_match1, zsv_uc_vector *char_match2,
+                                                                zsv_uc_vector *char_match3) {
+  zsv_uc_vector str_simd;
+  size_t i = 0;
+  for (; i + sizeof(str_simd) <= n; i += sizeof(str_simd)) {
+    memcpy(&str_simd, s + i, sizeof(str_simd));
+    zsv_uc_vector vtmp = str_simd == *char_match1;
+    vtmp += (str_simd == *char_match2);
+    vtmp += (str_simd == *char_match3);
+    zsv_mask_t mask = movemask_pseudo(vtmp);
+    if (mask != 0)
+      return i + NEXT_BIT(mask) - 1;
+  }
+  for (; i < n; i++)
+    if (s[i] == (*char_match1)[0] || s[i] == (*char_match2)[0] || s[i] == (*char_match3)[0])
+      return i;
+  return n;
+}
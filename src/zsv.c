@@ -19,6 +19,7 @@
 static struct zsv_cell zsv_get_cell_1(zsv_parser parser, size_t ix);
 static struct zsv_cell zsv_get_cell_with_overwrite(zsv_parser parser, size_t col_ix);
 #include "zsv_internal.c"
+#include "zsv_transcode.c"
 
 #ifndef ZSV_VERSION
 #define ZSV_VERSION "unknown"
@@ -30,6 +31,8 @@ const char *zsv_lib_version(void) {
 }
 
 #include "zsv_strencode.c"
+#include "zsv_hash.c"
+#include "zsv_checkpoint.c"
 
 /**
  * When we parse a chunk, if it was not the first parse call, we might have a partial
@@ -39,7 +42,9 @@ const char *zsv_lib_version(void) {
  */
 // __attribute__((always_inline))
 inline static size_t scanner_pre_parse(struct zsv_scanner *scanner) {
-  scanner->last = '\0';
+  // if the prior call read no input, `last` is kept as is, so that a row end
+  // of \r\n that is split across reads is still recognized when more input
+  // becomes available (see zsv_follow())
   if (VERY_LIKELY(scanner->old_bytes_read)) {
     scanner->last = scanner->buff.buff[scanner->old_bytes_read - 1];
     if (scanner->row_start < scanner->old_bytes_read) {
@@ -53,7 +58,7 @@ inline static size_t scanner_pre_parse(struct zsv_scanner *scanner) {
     }
     scanner->cell_start -= scanner->row_start;
     for (size_t i2 = 0; i2 < scanner->row.used; i2++)
-      scanner->row.cells[i2].str -= scanner->row_start;
+      scanner->row.cells[i2].offset -= scanner->row_start;
     scanner->row_start = 0;
     scanner->old_bytes_read = 0;
   }
@@ -95,6 +100,7 @@ static enum zsv_status zsv_insert_string(struct zsv_scanner *scanner) {
     scanner->buff.buff[len] = '\n';
   enum zsv_status stat = zsv_scan(scanner, scanner->buff.buff, len + 1);
   scanner->insert_string = NULL;
+  scanner->inserted_length = len + 1;
   return stat;
 }
 
@@ -117,8 +123,21 @@ enum zsv_status zsv_parse_more(struct zsv_scanner *scanner) {
 #endif
     size_t bom_len = strlen(ZSV_BOM);
     scanner->checked_bom = 1;
-    if ((bytes_read = scanner->read(scanner->buff.buff, 1, bom_len, scanner->in)) == bom_len &&
-        !memcmp(scanner->buff.buff, ZSV_BOM, bom_len)) {
+    if (scanner->opts.encoding > zsv_encoding_utf8 && !scanner->transcode &&
+        zsv_transcode_start(scanner, scanner->opts.encoding, NULL, 0) != zsv_status_ok)
+      return zsv_status_memory;
+    bytes_read = scanner->read(scanner->buff.buff, 1, bom_len, scanner->in);
+    if (scanner->opts.encoding == zsv_encoding_auto && !scanner->transcode) {
+      // UTF-16 BOM: transcode everything, starting with the bytes we just read. The
+      // BOM itself is transcoded to a UTF-8 BOM, which is then handled as usual
+      enum zsv_encoding utf16 = zsv_utf16_bom_encoding(scanner->buff.buff, bytes_read);
+      if (utf16 != zsv_encoding_auto) {
+        if (zsv_transcode_start(scanner, utf16, scanner->buff.buff, bytes_read) != zsv_status_ok)
+          return zsv_status_memory;
+        bytes_read = scanner->read(scanner->buff.buff, 1, bom_len, scanner->in);
+      }
+    }
+    if (bytes_read == bom_len && !memcmp(scanner->buff.buff, ZSV_BOM, bom_len)) {
       // have bom. disregard what we just read
       bytes_read = scanner->read(scanner->buff.buff, 1, capacity, scanner->in);
       scanner->had_bom = 1;
@@ -126,9 +145,20 @@ enum zsv_status zsv_parse_more(struct zsv_scanner *scanner) {
       // bytes_read = bom_len + scanner->read(scanner->buff.buff + bom_len, 1, capacity - bom_len, scanner->in);
       if (bytes_read == bom_len) // maybe we only read < 3 bytes
         bytes_read += scanner->read(scanner->buff.buff + bom_len, 1, capacity - bom_len, scanner->in);
+      else if (!bytes_read && !scanner->transcode)
+        scanner->checked_bom = 0; // no input yet; check again if more arrives (see zsv_follow())
     }
   } else // already checked bom. read as usual
     bytes_read = scanner->read(scanner->buff.buff + scanner->partial_row_length, 1, capacity, scanner->in);
+  if (VERY_UNLIKELY(scanner->skip_lf) && bytes_read) {
+    // resumed from a checkpoint after a \r; skip the \n of a \r\n row end
+    scanner->skip_lf = 0;
+    if (scanner->buff.buff[scanner->partial_row_length] == '\n') {
+      memmove(scanner->buff.buff + scanner->partial_row_length, scanner->buff.buff + scanner->partial_row_length + 1,
+              --bytes_read);
+      scanner->cum_scanned_length++;
+    }
+  }
   scanner->started = 1;
   if (VERY_UNLIKELY(scanner->filter != NULL))
     bytes_read = scanner->filter(scanner->filter_ctx, scanner->buff.buff + scanner->partial_row_length, bytes_read);
@@ -164,7 +194,7 @@ enum zsv_status zsv_next_row(zsv_parser parser) {
   if (VERY_UNLIKELY(!parser->pull.regs)) {
     if (parser->started)
       return zsv_status_error; // error: already started a push parser
-    if (!(parser->pull.regs = calloc(1, sizeof(*parser->pull.regs))))
+    if (!(parser->pull.regs = zsv_calloc(&parser->opts.allocator, 1, sizeof(*parser->pull.regs))))
       return zsv_status_memory;
     parser->mode = ZSV_MODE_DELIM_PULL;
     zsv_set_row_handler(parser, zsv_pull_row);
@@ -174,8 +204,10 @@ enum zsv_status zsv_next_row(zsv_parser parser) {
     if (parser->pull.stat == zsv_status_row)
       return parser->pull.stat;
   }
-  if (VERY_LIKELY(parser->pull.stat == zsv_status_row))
+  if (VERY_LIKELY(parser->pull.stat == zsv_status_row)) {
+    parser->row.base = parser->buff.buff; // in case the prior row was a collated header
     parser->pull.stat = zsv_scan_delim_pull(parser, parser->pull.buff, parser->pull.bytes_read);
+  }
   if (VERY_UNLIKELY(parser->pull.stat == zsv_status_ok)) {
     do {
       parser->pull.stat = zsv_parse_more(parser); // should return zsv_status_row or zsv_status_no_more_input
@@ -220,12 +252,18 @@ void zsv_set_context(zsv_parser parser, void *ctx) {
 
 ZSV_EXPORT
 void zsv_set_read(zsv_parser parser, size_t (*read_func)(void *restrict, size_t n, size_t size, void *restrict)) {
-  parser->read = read_func;
+  if (parser->transcode)
+    parser->transcode->read = read_func;
+  else
+    parser->read = read_func;
 }
 
 ZSV_EXPORT
 void zsv_set_input(zsv_parser parser, void *in) {
-  parser->in = in;
+  if (parser->transcode)
+    parser->transcode->in = in;
+  else
+    parser->in = in;
 }
 
 ZSV_EXPORT
@@ -235,7 +273,7 @@ char zsv_quoted(zsv_parser parser) {
 
 static struct zsv_cell zsv_get_cell_1(zsv_parser parser, size_t ix) {
   if (VERY_LIKELY(ix < parser->row.used))
-    return parser->row.cells[ix];
+    return zsv_row_get_cell(&parser->row, ix);
 
   struct zsv_cell c = {0, 0, 0, 0};
   return c;
@@ -288,8 +326,8 @@ ZSV_EXPORT enum zsv_status zsv_set_fixed_offsets(zsv_parser parser, size_t count
     return zsv_status_invalid_option;
   }
 
-  free(parser->fixed.offsets);
-  parser->fixed.offsets = calloc(count, sizeof(*parser->fixed.offsets));
+  zsv_free(&parser->opts.allocator, parser->fixed.offsets);
+  parser->fixed.offsets = zsv_calloc(&parser->opts.allocator, count, sizeof(*parser->fixed.offsets));
   if (!parser->fixed.offsets) {
     fprintf(stderr, "Out of memory!\n");
     return zsv_status_memory;
@@ -306,6 +344,27 @@ ZSV_EXPORT enum zsv_status zsv_set_fixed_offsets(zsv_parser parser, size_t count
   return zsv_status_ok;
 }
 
+ZSV_EXPORT enum zsv_status zsv_set_column_mask(zsv_parser parser, size_t count, const unsigned char *used) {
+  zsv_free(&parser->opts.allocator, parser->column_mask.used);
+  parser->column_mask.used = NULL;
+  parser->column_mask.count = 0;
+  if (!used)
+    return zsv_status_ok;
+
+  while (count && !used[count - 1])
+    count--;
+  // allocate at least one element, so that a mask with no used columns is not NULL
+  parser->column_mask.used = zsv_calloc(&parser->opts.allocator, count ? count : 1, 1);
+  if (!parser->column_mask.used) {
+    fprintf(stderr, "Out of memory!\n");
+    return zsv_status_memory;
+  }
+  if (count)
+    memcpy(parser->column_mask.used, used, count);
+  parser->column_mask.count = count;
+  return zsv_status_ok;
+}
+
 ZSV_EXPORT
 int zsv_peek(zsv_parser z) {
   if (z->scanned_length + 1 < z->buff.size)
@@ -334,8 +393,13 @@ zsv_parser zsv_new(struct zsv_opts *opts) {
     fprintf(stderr, "Invalid delimiter\n");
     return NULL;
   }
-  struct zsv_scanner *scanner = calloc(1, sizeof(*scanner));
+  if (opts->allocator.alloc && !(opts->allocator.resize && opts->allocator.release)) {
+    fprintf(stderr, "Invalid allocator: alloc, resize and release must all be set\n");
+    return NULL;
+  }
+  struct zsv_scanner *scanner = zsv_calloc(&opts->allocator, 1, sizeof(*scanner));
   if (scanner) {
+    scanner->opts.allocator = opts->allocator; // in case init fails before copying opts
     if (zsv_scanner_init(scanner, opts)) {
       zsv_delete(scanner);
       scanner = NULL;
@@ -393,22 +457,22 @@ enum zsv_status zsv_finish(struct zsv_scanner *scanner) {
 ZSV_EXPORT
 enum zsv_status zsv_delete(zsv_parser parser) {
   if (parser) {
+    struct zsv_allocator a = parser->opts.allocator;
     if (parser->free_buff && parser->buff.buff)
-      free(parser->buff.buff);
+      zsv_free(&a, parser->buff.buff);
 
-    free(parser->row.cells);
-    free(parser->fixed.offsets);
-    collate_header_destroy(&parser->collate_header);
-    free(parser->pull.regs);
+    zsv_free(&a, parser->row.cells);
+    zsv_free(&a, parser->fixed.offsets);
+    zsv_free(&a, parser->column_mask.used);
+    collate_header_destroy(&parser->collate_header, &a);
+    zsv_free(&a, parser->pull.regs);
+    zsv_transcode_delete(parser->transcode, &a);
 
 #ifdef ZSV_EXTRAS
-    if (parser->overwrite.ctx && parser->overwrite.close_ctx)
-      parser->overwrite.close_ctx(parser->overwrite.ctx);
-    if (parser->overwrite.reader && parser->overwrite.close_reader)
-      parser->overwrite.close_reader(parser->overwrite.reader);
+    zsv_overwrite_delete(&parser->overwrite, &a);
 #endif
 
-    free(parser);
+    zsv_free(&a, parser);
   }
   return zsv_status_ok;
 }
@@ -456,6 +520,11 @@ size_t zsv_row_length_raw_bytes(zsv_parser parser) {
   return parser->scanned_length - parser->row_start;
 }
 
+ZSV_EXPORT
+const unsigned char *zsv_row_raw_bytes(zsv_parser parser) {
+  return parser->buff.buff + parser->row_start;
+}
+
 /**
  * @param parser parser handle
  * @param buff   the input buffer. Note: this buffer may not overlap with
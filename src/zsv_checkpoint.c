@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+/**
+ * Checkpoint / resume of parser state at row boundaries, and tail-follow
+ *
+ * A checkpoint is the raw input offset of the next row to parse, plus the
+ * little state that must carry over to a new parser: row count, header and
+ * BOM status, a pending \r\n row end, and the overwrite cursor. Everything
+ * else (buffer contents, partial cells) is rebuilt by re-reading from the offset
+ */
+
+#include <inttypes.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ * Input offset of position `pos` in the scanner buffer
+ */
+static uint64_t zsv_checkpoint_offset(zsv_parser parser, size_t pos) {
+  return (uint64_t)parser->cum_scanned_length + pos + (parser->had_bom ? strlen(ZSV_BOM) : 0) -
+         parser->inserted_length;
+}
+
+ZSV_EXPORT
+enum zsv_status zsv_checkpoint(zsv_parser parser, struct zsv_checkpoint *cp) {
+  memset(cp, 0, sizeof(*cp));
+  cp->version = ZSV_CHECKPOINT_VERSION;
+  if (parser->mode == ZSV_MODE_FIXED || parser->transcode || parser->filter)
+    return zsv_status_invalid_option;
+
+  char at_row_end =
+    parser->in_row_handler || (parser->mode == ZSV_MODE_DELIM_PULL && parser->pull.stat == zsv_status_row);
+  if (!parser->checked_bom && !at_row_end)
+    return zsv_status_ok; // nothing parsed yet: resume from the start
+  if (!parser->header_done)
+    return zsv_status_invalid_option;
+
+  cp->flags = ZSV_CHECKPOINT_HEADER_DONE | (parser->had_bom ? ZSV_CHECKPOINT_HAD_BOM : 0);
+  unsigned char prev; // last byte before the checkpoint offset
+  if (parser->finished) {
+    // all input has been read; any partial row was handled by zsv_finish()
+    cp->offset = zsv_checkpoint_offset(parser, parser->partial_row_length);
+    cp->data_row_count = parser->data_row_count + (parser->partial_row_length ? 1 : 0);
+    prev = parser->partial_row_length ? 0 : parser->last;
+  } else if (at_row_end) {
+    // the current row ends at scanned_length
+    size_t pos = parser->scanned_length;
+    unsigned char *buff = parser->buff.buff;
+    cp->offset = zsv_checkpoint_offset(parser, pos + 1);
+    cp->data_row_count = parser->data_row_count + 1;
+    prev = buff[pos];
+    if (prev == '\r' && pos + 1 < parser->buffer_end) {
+      if (buff[pos + 1] == '\n')
+        cp->offset++;
+      prev = 0;
+    }
+  } else {
+    // between zsv_parse_more() calls: the next row starts at row_start
+    cp->offset = zsv_checkpoint_offset(parser, parser->row_start);
+    cp->data_row_count = parser->data_row_count;
+    if (parser->row_start)
+      prev = parser->buff.buff[parser->row_start - 1];
+    else
+      prev = parser->partial_row_length ? 0 : parser->last;
+  }
+  if (prev == '\r')
+    cp->flags |= ZSV_CHECKPOINT_SKIP_LF;
+
+#ifdef ZSV_EXTRAS
+  const struct zsv_overwrite *overwrite = &parser->overwrite;
+  if (overwrite->next < overwrite->count) {
+    cp->overwrite_row = overwrite->entries[overwrite->next].row_ix;
+    cp->overwrite_col = overwrite->entries[overwrite->next].col_ix;
+  }
+#endif
+  return zsv_status_ok;
+}
+
+/**
+ * Position a FILE * at the given offset, by seeking or, if the stream is not
+ * seekable, by reading
+ */
+static int zsv_checkpoint_seek(FILE *f, uint64_t offset) {
+#ifdef _WIN32
+  if (!_fseeki64(f, (__int64)offset, SEEK_SET))
+    return 0;
+#else
+  if (!fseeko(f, (off_t)offset, SEEK_SET))
+    return 0;
+#endif
+  char buff[4096];
+  while (offset) {
+    size_t n = fread(buff, 1, offset < sizeof(buff) ? offset : sizeof(buff), f);
+    if (!n)
+      return 1;
+    offset -= n;
+  }
+  return 0;
+}
+
+ZSV_EXPORT
+zsv_parser zsv_new_from_checkpoint(struct zsv_opts *opts, const struct zsv_checkpoint *cp) {
+  if (!cp || cp->version != ZSV_CHECKPOINT_VERSION) {
+    fprintf(stderr, "Invalid checkpoint\n");
+    return NULL;
+  }
+  if (!(cp->flags & ZSV_CHECKPOINT_HEADER_DONE)) {
+    if (cp->offset) {
+      fprintf(stderr, "Invalid checkpoint\n");
+      return NULL;
+    }
+    return zsv_new(opts); // checkpoint was taken before parsing started
+  }
+
+  struct zsv_opts resume_opts;
+  if (opts)
+    resume_opts = *opts;
+  else
+    memset(&resume_opts, 0, sizeof(resume_opts));
+  if (resume_opts.encoding > zsv_encoding_utf8) {
+    fprintf(stderr, "Cannot resume transcoded input from a checkpoint\n");
+    return NULL;
+  }
+  resume_opts.rows_to_ignore = 0;
+  resume_opts.header_span = 0;
+  resume_opts.insert_header_row = NULL;
+  resume_opts.keep_empty_header_rows = 1;
+
+  size_t bom_len = cp->flags & ZSV_CHECKPOINT_HAD_BOM ? strlen(ZSV_BOM) : 0;
+  if (cp->offset < bom_len) {
+    fprintf(stderr, "Invalid checkpoint\n");
+    return NULL;
+  }
+  if (!resume_opts.read && zsv_checkpoint_seek(resume_opts.stream ? resume_opts.stream : stdin, cp->offset)) {
+    fprintf(stderr, "Unable to position input at checkpoint offset %" PRIu64 "\n", cp->offset);
+    return NULL;
+  }
+
+  zsv_parser parser = zsv_new(&resume_opts);
+  if (parser) {
+    parser->checked_bom = 1;
+    parser->had_bom = bom_len > 0;
+    parser->skip_lf = (cp->flags & ZSV_CHECKPOINT_SKIP_LF) != 0;
+    parser->cum_scanned_length = cp->offset - bom_len;
+    parser->data_row_count = cp->data_row_count;
+  }
+  return parser;
+}
+
+static void zsv_checkpoint_put(unsigned char *p, uint64_t v, unsigned int bytes) {
+  for (unsigned int i = 0; i < bytes; i++, v >>= 8)
+    p[i] = (unsigned char)(v & 0xff);
+}
+
+static uint64_t zsv_checkpoint_get(const unsigned char *p, unsigned int bytes) {
+  uint64_t v = 0;
+  for (unsigned int i = bytes; i > 0; i--)
+    v = (v << 8) | p[i - 1];
+  return v;
+}
+
+ZSV_EXPORT
+void zsv_checkpoint_encode(const struct zsv_checkpoint *cp, unsigned char buff[ZSV_CHECKPOINT_SIZE]) {
+  zsv_checkpoint_put(buff, cp->version, 4);
+  zsv_checkpoint_put(buff + 4, cp->flags, 4);
+  zsv_checkpoint_put(buff + 8, cp->offset, 8);
+  zsv_checkpoint_put(buff + 16, cp->data_row_count, 8);
+  zsv_checkpoint_put(buff + 24, cp->overwrite_row, 8);
+  zsv_checkpoint_put(buff + 32, cp->overwrite_col, 8);
+}
+
+ZSV_EXPORT
+enum zsv_status zsv_checkpoint_decode(const unsigned char buff[ZSV_CHECKPOINT_SIZE], struct zsv_checkpoint *cp) {
+  cp->version = (uint32_t)zsv_checkpoint_get(buff, 4);
+  cp->flags = (uint32_t)zsv_checkpoint_get(buff + 4, 4);
+  cp->offset = zsv_checkpoint_get(buff + 8, 8);
+  cp->data_row_count = zsv_checkpoint_get(buff + 16, 8);
+  cp->overwrite_row = zsv_checkpoint_get(buff + 24, 8);
+  cp->overwrite_col = zsv_checkpoint_get(buff + 32, 8);
+  if (cp->version != ZSV_CHECKPOINT_VERSION ||
+      (cp->flags & ~(ZSV_CHECKPOINT_HAD_BOM | ZSV_CHECKPOINT_HEADER_DONE | ZSV_CHECKPOINT_SKIP_LF)))
+    return zsv_status_error;
+  return zsv_status_ok;
+}
+
+static void zsv_sleep_ms(unsigned int ms) {
+#ifdef _WIN32
+  Sleep(ms);
+#else
+  struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+  nanosleep(&ts, NULL);
+#endif
+}
+
+ZSV_EXPORT
+enum zsv_status zsv_follow(zsv_parser parser, const struct zsv_follow_opts *opts) {
+  if (parser->mode != ZSV_MODE_DELIM || parser->transcode || parser->read != (zsv_generic_read)fread) {
+    fprintf(stderr, "Follow requires delimited input from a FILE *\n");
+    return zsv_status_invalid_option;
+  }
+  unsigned int poll_ms = opts && opts->poll_ms ? opts->poll_ms : 250;
+  for (;;) {
+    enum zsv_status stat;
+    while ((stat = zsv_parse_more(parser)) == zsv_status_ok)
+      ;
+    if (stat != zsv_status_no_more_input)
+      return stat;
+    if (opts && opts->idle && opts->idle(opts->ctx))
+      return zsv_status_ok;
+    if (parser->abort)
+      return zsv_status_cancelled;
+    clearerr((FILE *)parser->in);
+    zsv_sleep_ms(poll_ms);
+  }
+}
@@ -19,47 +19,31 @@
 #include <zsv/utils/utf8.h>
 #include <zsv/utils/compiler.h>
 #include <zsv/utils/string.h>
+#include <zsv/utils/alloc.h>
 
-#if !defined(__AVX2__) // -mavx2 compiler flag not present
-#define ZSV_NO_AVX
-#define zsv_mask_t uint16_t
-#define VECTOR_BYTES 16
-#define NEXT_BIT __builtin_ffs
-#if defined(__AVX__)
-#include <emmintrin.h>
-#define zsv_mask_t uint16_t
-#define VECTOR_BYTES 16
-#define NEXT_BIT __builtin_ffs
-#define movemask_pseudo(x) _mm_movemask_epi8((__m128i)x)
-#endif
-#elif defined(HAVE_AVX512)
-#ifndef __AVX512BW__
-#error AVX512 requested, but __AVX512BW__ macro not defined
-#else
-#include <immintrin.h>
-#define VECTOR_BYTES 64
-#define zsv_mask_t uint64_t
-#define movemask_pseudo(x) _mm512_movepi8_mask((__m512i)x)
-#define NEXT_BIT __builtin_ffsl
-#endif
-#elif defined(__AVX2__) // have avx2, not avx512
-#include <immintrin.h>
-#define VECTOR_BYTES 32
-#define zsv_mask_t uint32_t
-#define movemask_pseudo(x) _mm256_movemask_epi8((__m256i)x)
-#define NEXT_BIT __builtin_ffs
-#else
-#define ZSV_NO_AVX
-#define zsv_mask_t uint16_t
-#define VECTOR_BYTES 16
-#define NEXT_BIT __builtin_ffs
+#include "zsv_vector.h"
+
+/**
+ * Row cells are stored as 32-bit offsets relative to `zsv_row.base` (normally
+ * the scanner buffer, whose size is capped accordingly), which halves the
+ * per-cell footprint vs a pointer + size_t. The cell array starts small and
+ * grows on demand up to max_columns, so very wide inputs do not require
+ * preallocating max_columns cells
+ */
+#ifndef ZSV_ROW_CELLS_INITIAL
+#define ZSV_ROW_CELLS_INITIAL 1024
 #endif
 
-typedef unsigned char zsv_uc_vector __attribute__((vector_size(VECTOR_BYTES)));
+struct zsv_row_cell {
+  uint32_t offset;
+  uint32_t len;
+  unsigned char quoted;
+};
 
 struct zsv_row {
   size_t used, allocated, overflow;
-  struct zsv_cell *cells;
+  unsigned char *base; // start of memory that cell offsets are relative to
+  struct zsv_row_cell *cells;
 };
 
 struct collate_header {
@@ -68,6 +52,7 @@ struct collate_header {
     size_t used;
   } buff;
   size_t *lengths; // length PLUS 1 of each cell
+  size_t lengths_allocated;
   size_t column_count;
 };
 
@@ -90,27 +75,26 @@ struct zsv_scan_fixed_regs {
 };
 
 #ifdef ZSV_EXTRAS
-#include <inttypes.h>
-
-struct zsv_overwrite_data {
-  struct zsv_cell row;
-  struct zsv_cell col;
-  struct zsv_cell val;
+struct zsv_overwrite_entry {
+  size_t row_ix;   // 0-based
+  uint32_t col_ix; // 0-based
+  uint32_t len;    // length of value
+  size_t offset;   // offset of value in arena
 };
 
 struct zsv_overwrite {
-  void (*next)(struct zsv_overwrite *overwrite, struct zsv_overwrite_data *data);
-
-  size_t row_ix; // 0-based
-  size_t col_ix; // 0-based
-  struct zsv_cell val;
-  char have; // 1 = we have unprocessed overwrites
-
-  void *ctx;
-  int (*close_ctx)(void *);
-
-  void *reader;
-  int (*close_reader)(void *);
+  struct zsv_overwrite_entry *entries; // sorted by row_ix, col_ix
+  size_t count;
+  size_t capacity;
+
+  unsigned char *arena; // values
+  size_t arena_used;
+  size_t arena_capacity;
+
+  size_t row_ix;     // row that the cursor is positioned at
+  size_t begin, end; // entries for row_ix
+  size_t next;       // next entry to check in the current row
+  char have;         // 1 = we have overwrites
 };
 #endif
 
@@ -134,6 +118,10 @@ struct zsv_scanner {
   unsigned char have_cell : 1;
   unsigned char started : 1;
 
+  unsigned char in_row_handler : 1; // set while row_dl() calls the row handler
+  unsigned char header_done : 1;    // all header rows have been parsed
+  unsigned char skip_lf : 1;        // resumed after a \r: skip a leading \n
+
   size_t quote_close_position;
   struct zsv_opts opts;
 
@@ -150,10 +138,13 @@ struct zsv_scanner {
   size_t (*filter)(void *ctx, unsigned char *buff, size_t bytes_read);
   void *filter_ctx;
 
+  struct zsv_transcode *transcode; // non-NULL if input is being transcoded to UTF-8
+
   size_t buffer_end;
   size_t old_bytes_read; // only non-zero if we must shift upon next parse_more()
 
   const char *insert_string;
+  size_t inserted_length; // bytes of insert_string that were scanned, which are not in the raw input
 
   size_t empty_header_rows;
 
@@ -168,6 +159,11 @@ struct zsv_scanner {
     unsigned count;    // number of offsets
   } fixed;
 
+  struct {
+    unsigned char *used; // non-zero for each column whose cells are processed; NULL to process all
+    size_t count;        // number of elements in used, through the last used column
+  } column_mask;
+
   struct collate_header *collate_header;
   size_t data_row_count; /* 0 = in header row; 1 = first data row */
   struct zsv_cell (*get_cell)(zsv_parser parser, size_t ix);
@@ -196,37 +192,50 @@ struct zsv_scanner {
 #endif
 };
 
-void collate_header_destroy(struct collate_header **chp) {
+void collate_header_destroy(struct collate_header **chp, const struct zsv_allocator *a) {
   if (*chp) {
     struct collate_header *ch = *chp;
-    free(ch->buff.buff);
-    free(ch->lengths);
-    free(ch);
+    zsv_free(a, ch->buff.buff);
+    zsv_free(a, ch->lengths);
+    zsv_free(a, ch);
     *chp = NULL;
   }
 }
 
 /* collate_header_append(): return err */
 static int collate_header_append(struct zsv_scanner *scanner, struct collate_header **chp) {
+  const struct zsv_allocator *a = &scanner->opts.allocator;
   if (!*chp) {
-    if ((*chp = calloc(1, sizeof(struct collate_header))))
-      (*chp)->lengths = calloc(scanner->row.allocated, sizeof(*(*chp)->lengths));
+    if ((*chp = zsv_calloc(a, 1, sizeof(struct collate_header))))
+      (*chp)->lengths = zsv_calloc(a, scanner->row.allocated, sizeof(*(*chp)->lengths));
     if (!(*chp) || !(*chp)->lengths) {
-      free(*chp);
+      zsv_free(a, *chp);
+      *chp = NULL;
       fprintf(stderr, "Out of memory!\n");
       return -1;
     }
+    (*chp)->lengths_allocated = scanner->row.allocated;
   }
   struct collate_header *ch = *chp;
   size_t this_row_size = 0;
   size_t column_count = zsv_cell_count(scanner);
+  if (column_count > ch->lengths_allocated) { // row cells grew since the prior header row
+    size_t *lengths = zsv_realloc(a, ch->lengths, column_count * sizeof(*lengths));
+    if (!lengths) {
+      fprintf(stderr, "Out of memory!\n");
+      return -1;
+    }
+    memset(lengths + ch->lengths_allocated, 0, (column_count - ch->lengths_allocated) * sizeof(*lengths));
+    ch->lengths = lengths;
+    ch->lengths_allocated = column_count;
+  }
   for (size_t i = 0, j = column_count; i < j; i++) {
     struct zsv_cell c = zsv_get_cell_1(scanner, i);
     if (c.len)
       this_row_size += c.len + 1; // +1: terminating null or delim
   }
   size_t new_row_size = ch->buff.used + this_row_size;
-  unsigned char *new_row = realloc(ch->buff.buff, new_row_size);
+  unsigned char *new_row = zsv_realloc(a, ch->buff.buff, new_row_size);
   if (!new_row) {
     fprintf(stderr, "Out of memory!\n");
     return -1;
@@ -277,8 +286,57 @@ __attribute__((always_inline)) static inline void zsv_clear_cell(struct zsv_scan
   scanner->quoted = 0;
 }
 
+/**
+ * Grow the row cell array (doubling, capped at max_columns)
+ * Returns 0 on success, non-zero if the row is already at max_columns or on
+ * memory allocation failure
+ */
+__attribute__((noinline, cold)) static int zsv_row_grow(struct zsv_row *row, size_t max_columns,
+                                                       const struct zsv_allocator *a) {
+  size_t new_allocated = row->allocated ? row->allocated * 2 : ZSV_ROW_CELLS_INITIAL;
+  if (new_allocated > max_columns)
+    new_allocated = max_columns;
+  if (new_allocated <= row->allocated)
+    return 1;
+  struct zsv_row_cell *cells = zsv_realloc(a, row->cells, new_allocated * sizeof(*cells));
+  if (!cells)
+    return 1;
+  memset(cells + row->allocated, 0, (new_allocated - row->allocated) * sizeof(*cells));
+  row->cells = cells;
+  row->allocated = new_allocated;
+  return 0;
+}
+
+__attribute__((always_inline)) static inline struct zsv_cell zsv_row_get_cell(struct zsv_row *row, size_t ix) {
+  struct zsv_row_cell *rc = &row->cells[ix];
+  struct zsv_cell c = {row->base + rc->offset, rc->len, rc->quoted, 0};
+  return c;
+}
+
+/**
+ * Skip a cell in a column that is not in the column mask: keep an empty cell
+ * for its position, unless it is after the last used column
+ */
+__attribute__((always_inline)) static inline void cell_skip(struct zsv_scanner *scanner, unsigned char *s) {
+  struct zsv_row *row = &scanner->row;
+  if (row->used < scanner->column_mask.count &&
+      (VERY_LIKELY(row->used < row->allocated) ||
+       !zsv_row_grow(row, scanner->opts.max_columns, &scanner->opts.allocator))) {
+    struct zsv_row_cell c = {(uint32_t)(s - row->base), 0, 0};
+    row->cells[row->used++] = c;
+  }
+  scanner->have_cell = 1;
+  zsv_clear_cell(scanner);
+}
+
 // always_inline has a noticeable impact. do not remove without benchmarking!
 __attribute__((always_inline)) static inline void cell_dl(struct zsv_scanner *scanner, unsigned char *s, size_t n) {
+  if (UNLIKELY(scanner->column_mask.used != NULL) &&
+      (scanner->row.used >= scanner->column_mask.count || !scanner->column_mask.used[scanner->row.used])) {
+    cell_skip(scanner, s);
+    return;
+  }
+
   // handle quoting
   if (UNLIKELY(scanner->quoted > 0)) {
     if (LIKELY(scanner->quote_close_position + 1 == n)) {
@@ -336,12 +394,13 @@ __attribute__((always_inline)) static inline void cell_dl(struct zsv_scanner *sc
 
   if (UNLIKELY(scanner->opts.cell_handler != NULL))
     scanner->opts.cell_handler(scanner->opts.ctx, s, n);
-  if (VERY_LIKELY(scanner->row.used < scanner->row.allocated)) {
-    struct zsv_row *row = &scanner->row;
-    struct zsv_cell c = {s, n, scanner->opts.no_quotes ? 1 : scanner->quoted, 0};
+  struct zsv_row *row = &scanner->row;
+  if (VERY_LIKELY(row->used < row->allocated) ||
+      !zsv_row_grow(row, scanner->opts.max_columns, &scanner->opts.allocator)) {
+    struct zsv_row_cell c = {(uint32_t)(s - row->base), (uint32_t)n, scanner->opts.no_quotes ? 1 : scanner->quoted};
     row->cells[row->used++] = c;
   } else
-    scanner->row.overflow++;
+    row->overflow++;
   scanner->have_cell = 1;
 
   zsv_clear_cell(scanner);
@@ -350,14 +409,17 @@ __attribute__((always_inline)) static inline void cell_dl(struct zsv_scanner *sc
 __attribute__((always_inline)) static inline enum zsv_status row_dl(struct zsv_scanner *scanner) {
   if (VERY_UNLIKELY(scanner->row.overflow)) {
     fprintf(stderr, "Warning: number of columns (%zu) exceeds row max (%zu)\n",
-            scanner->row.allocated + scanner->row.overflow, scanner->row.allocated);
+            scanner->row.used + scanner->row.overflow, scanner->row.used);
     scanner->row.overflow = 0;
   }
-  if (VERY_LIKELY(scanner->opts.row_handler != NULL)) // TO DO: disallow row_handler to be null; if null, set to dummy
+  if (VERY_LIKELY(scanner->opts.row_handler != NULL)) { // TO DO: disallow row_handler to be null; if null, set to dummy
+    scanner->in_row_handler = 1;
     scanner->opts.row_handler(scanner->opts.ctx);
-    // Note: scanner->data_row_count will be incremented AFTER this call
-    //       in order to accommodate pull parsing, in which case incrementing here
-    //       would be too early
+    scanner->in_row_handler = 0;
+  }
+  // Note: scanner->data_row_count will be incremented AFTER this call
+  //       in order to accommodate pull parsing, in which case incrementing here
+  //       would be too early
 #ifdef ZSV_EXTRAS
   scanner->progress.cum_row_count++;
   if (VERY_UNLIKELY(scanner->opts.progress.rows_interval &&
@@ -405,63 +467,28 @@ __attribute__((always_inline)) static inline enum zsv_status cell_and_row_dl(str
   return row_dl(scanner);
 }
 
-#ifndef movemask_pseudo
-/*
-  provide our own pseudo-movemask, which sets the 1 bit for each corresponding
-  non-zero value in the vector (as opposed to real movemask which sets the bit
-  only for each corresponding non-zero highest-bit value in the vector)
-*/
-
-#if defined(__EMSCRIPTEN__) && defined(__SSE2__)
-#include <wasm_simd128.h>
-#define movemask_pseudo(x) wasm_i8x16_bitmask(x)
-
-#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
-#include <arm_neon.h>
-static inline zsv_mask_t movemask_pseudo(zsv_uc_vector v) {
-  // see https://stackoverflow.com/questions/11870910/
-  static const uint8_t __attribute__((aligned(16)))
-  _powers[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
-  uint8x16_t mm_powers = vld1q_u8(_powers);
-
-  // compute the mask from the input
-  uint64x2_t imask = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vandq_u8(v, mm_powers))));
-
-  // Get the resulting bytes
-  uint16_t mask;
-  vst1q_lane_u8((uint8_t *)&mask + 0, (uint8x16_t)imask, 0);
-  vst1q_lane_u8((uint8_t *)&mask + 1, (uint8x16_t)imask, 8);
-  return mask;
-}
-
-#elif defined(__SSE2__)
-
-typedef char zsv_c_vector __attribute__((vector_size(VECTOR_BYTES)));
-#define movemask_pseudo(x) __builtin_ia32_pmovmskb128((zsv_c_vector)x)
-
-#else
-
-// slow path
-#if defined(__EMSCRIPTEN__)
-#warning                                                                                                               \
-  "Compiling with emscripten, without using SIMD. To use SIMD, compile with -msse2 -msimd128 -experimental-wasm-simd and -I/path/to/emsdk/upstream/lib/clang/16.0.0/include"
-#endif
+#include "vector_delim.c"
 
-static inline zsv_mask_t movemask_pseudo(zsv_uc_vector v) {
-  zsv_mask_t mask = 0, tmp = 1;
-  for (size_t i = 0; i < sizeof(zsv_uc_vector); i++) {
-    mask |= (v[i] ? tmp : 0);
-    tmp <<= 1;
+/**
+ * Called after the delimiter at buff[i] when no later cell of the row is used
+ * (see zsv_set_column_mask()): skip the rest of the row up to the next row end
+ * or quote char, without processing the delimiters in between, and return the
+ * position before it, from which the scan loop continues
+ */
+static size_t zsv_skip_unused_cells(struct zsv_scanner *scanner, unsigned char *buff, size_t i, size_t bytes_read,
+                                    zsv_uc_vector *nl, zsv_uc_vector *cr, zsv_uc_vector *qt, int quote) {
+  size_t k = i + 1;
+  while ((k += vec_row_end(buff + k, bytes_read - k, nl, cr, qt)) < bytes_read) {
+    if (buff[k] == '\n' || buff[k] == '\r' || buff[k] == quote)
+      break;
+    k++; // with no_quotes, qt is a null char
   }
-
-  return mask;
+  // a quote char opens a quoted cell only if it starts the cell; in any other
+  // case, the skipped cell just needs to be non-empty
+  scanner->cell_start = buff[k - 1] == scanner->opts.delimiter ? k : k - 1;
+  return k - 1;
 }
 
-#endif // __EMSCRIPTEN__
-#endif // ndef movemask_pseudo
-
-#include "vector_delim.c"
-
 #ifdef ZSV_SUPPORT_PULL_PARSER
 #undef ZSV_SUPPORT_PULL_PARSER
 #endif
@@ -520,7 +547,7 @@ static void apply_callbacks(struct zsv_scanner *scanner) {
 static void set_callbacks(struct zsv_scanner *scanner);
 
 static char zsv_internal_row_is_blank(zsv_parser parser) {
-  for (unsigned int i = 0; i < parser->row.used; i++)
+  for (size_t i = 0; i < parser->row.used; i++)
     if (parser->row.cells[i].len)
       return 0;
   return 1;
@@ -557,6 +584,9 @@ static void collate_header_row(void *ctx) {
 
     // first, make sure this row has at least as many cells as the largest prior row
     if (scanner->collate_header) {
+      while (scanner->row.allocated < scanner->collate_header->column_count &&
+             !zsv_row_grow(&scanner->row, scanner->collate_header->column_count, &scanner->opts.allocator))
+        ;
       for (size_t i = zsv_cell_count(scanner); i < scanner->row.allocated && i < scanner->collate_header->column_count;
            i++)
         memset(&scanner->row.cells[i], 0, sizeof(scanner->row.cells[i]));
@@ -572,9 +602,10 @@ static void collate_header_row(void *ctx) {
     set_callbacks(scanner);
     if (scanner->collate_header) {
       size_t offset = 0;
+      scanner->row.base = scanner->collate_header->buff.buff;
       for (size_t i = 0; i < scanner->collate_header->column_count; i++) {
         size_t len_plus1 = scanner->collate_header->lengths[i];
-        scanner->row.cells[i].str = scanner->collate_header->buff.buff + offset;
+        scanner->row.cells[i].offset = offset;
         if (len_plus1) {
           scanner->row.cells[i].len = len_plus1 - 1;
           scanner->row.cells[i].quoted = 1;
@@ -585,8 +616,10 @@ static void collate_header_row(void *ctx) {
     }
 
     apply_callbacks(scanner);
-    if (scanner->mode != ZSV_MODE_DELIM_PULL)
-      collate_header_destroy(&scanner->collate_header);
+    if (scanner->mode != ZSV_MODE_DELIM_PULL) {
+      scanner->row.base = scanner->buff.buff;
+      collate_header_destroy(&scanner->collate_header, &scanner->opts.allocator);
+    }
   }
 }
 
@@ -609,6 +642,7 @@ static void set_callbacks(struct zsv_scanner *scanner) {
     else
       scanner->get_cell = zsv_get_cell_1;
     scanner->data_row_count = 0;
+    scanner->header_done = 1;
     scanner->opts.row_handler = scanner->opts_orig.row_handler;
     scanner->opts.cell_handler = scanner->opts_orig.cell_handler;
     scanner->opts.ctx = scanner->opts_orig.ctx;
@@ -626,99 +660,7 @@ static void zsv_throwaway_row(void *ctx) {
 }
 
 #ifdef ZSV_EXTRAS
-static int zsv_delete_v(void *p) {
-  return zsv_delete((zsv_parser)p);
-}
-
-static void zsv_next_overwrite_csv(struct zsv_overwrite *overwrite, struct zsv_overwrite_data *data) {
-  // row, column, value
-  data->row = zsv_get_cell_1(overwrite->reader, 0);
-  data->col = zsv_get_cell_1(overwrite->reader, 1);
-  data->val = zsv_get_cell_1(overwrite->reader, 2);
-}
-
-// TO DO: consolidate with zsv_echo_get_next_overwrite()
-static void zsv_next_overwrite(struct zsv_overwrite *overwrite) {
-  if (overwrite->have) {
-    if (zsv_next_row(overwrite->reader) != zsv_status_row)
-      overwrite->have = 0;
-    else {
-      struct zsv_overwrite_data data;
-      overwrite->next(overwrite, &data);
-      if (data.row.len && data.col.len) {
-        char *end = (char *)(data.row.str + data.row.len);
-        char **endp = &end;
-        overwrite->row_ix = strtoumax((char *)data.row.str, endp, 10);
-        end = (char *)(data.col.str + data.col.len);
-        overwrite->col_ix = strtoumax((char *)data.col.str, endp, 10);
-        overwrite->val = data.val;
-      } else {
-        overwrite->row_ix = 0;
-        overwrite->col_ix = 0;
-        overwrite->val.len = 0;
-      }
-    }
-  }
-}
-
-static enum zsv_status zsv_init_overwrites(zsv_parser parser, struct zsv_opt_overwrite *overwrite_opts) {
-  if (overwrite_opts->type <= zsv_overwrite_type_none)
-    return zsv_status_ok;
-  struct zsv_overwrite *overwrite = &parser->overwrite;
-  switch (overwrite_opts->type) {
-  case zsv_overwrite_type_csv: {
-    struct zsv_opts opts = {0};
-    overwrite->ctx = opts.stream = overwrite_opts->ctx;
-    overwrite->close_ctx = overwrite_opts->close_ctx;
-    if (!(overwrite->reader = zsv_new(&opts)))
-      return zsv_status_memory;
-    overwrite->close_reader = zsv_delete_v;
-    overwrite->next = zsv_next_overwrite_csv;
-  } break;
-  default:
-    fprintf(stderr, "Unrecognized overwrite type\n");
-    return zsv_status_error;
-  }
-
-  overwrite->have = 0;
-  if (zsv_next_row(overwrite->reader) == zsv_status_row) {
-    // to do: check that column names are row, col, value
-    struct zsv_overwrite_data data;
-    overwrite->next(overwrite, &data);
-    if (data.row.len < 3 || memcmp(data.row.str, "row", 3) || data.col.len < 3 || memcmp(data.col.str, "col", 3) ||
-        data.val.len < 3 || memcmp(data.val.str, "val", 3))
-      fprintf(stderr, "Warning! overwrite expects 'row,col,value' header, got '%.*s,%.*s,%.*s'\n", (int)data.row.len,
-              data.row.str, (int)data.col.len, data.col.str, (int)data.val.len, data.val.str);
-    overwrite->have = 1;
-    zsv_next_overwrite(overwrite);
-  }
-  return overwrite->have ? zsv_status_ok : zsv_status_error;
-}
-
-static int zsv_have_overwrite(zsv_parser parser, size_t row_ix, size_t col_ix) {
-  struct zsv_overwrite *overwrite = &parser->overwrite;
-  while (overwrite->have && overwrite->row_ix < row_ix)
-    zsv_next_overwrite(overwrite);
-  while (overwrite->have && overwrite->row_ix == row_ix && overwrite->col_ix < col_ix)
-    zsv_next_overwrite(overwrite);
-  if (!overwrite->have)
-    parser->get_cell = zsv_get_cell_1;
-  return overwrite->have && overwrite->row_ix == row_ix && overwrite->col_ix == col_ix;
-}
-
-static struct zsv_cell zsv_get_cell_with_overwrite(zsv_parser parser, size_t col_ix) {
-  if (VERY_LIKELY(col_ix < parser->row.used)) {
-    size_t row_ix = parser->data_row_count;
-    if (!zsv_have_overwrite(parser, row_ix, col_ix))
-      return parser->row.cells[col_ix];
-
-    struct zsv_cell c = parser->overwrite.val;
-    c.overwritten = 1;
-    return c;
-  }
-  struct zsv_cell c = {0, 0, 0, 0};
-  return c;
-}
+#include "zsv_overwrite.c"
 #endif
 
 static int zsv_scanner_init(struct zsv_scanner *scanner, struct zsv_opts *opts) {
@@ -752,6 +694,10 @@ static int zsv_scanner_init(struct zsv_scanner *scanner, struct zsv_opts *opts)
     opts->buffsize = ZSV_DEFAULT_SCANNER_BUFFSIZE;
   else if (opts->buffsize < ZSV_MIN_SCANNER_BUFFSIZE)
     opts->buffsize = ZSV_MIN_SCANNER_BUFFSIZE;
+  else if (opts->buffsize > UINT32_MAX) { // cells are stored as 32-bit offsets into the buffer
+    fprintf(stderr, "Reducing --buff-size to maximum %zu\n", (size_t)UINT32_MAX);
+    opts->buffsize = UINT32_MAX;
+  }
 
   scanner->in = opts->stream;
   if (!opts->read) {
@@ -766,7 +712,7 @@ static int zsv_scanner_init(struct zsv_scanner *scanner, struct zsv_opts *opts)
   scanner->buff.size = opts->buffsize;
 
   if (opts->buffsize && !opts->buff) {
-    scanner->buff.buff = malloc(opts->buffsize);
+    scanner->buff.buff = zsv_alloc(&opts->allocator, opts->buffsize);
     scanner->free_buff = 1;
   }
 
@@ -779,14 +725,15 @@ static int zsv_scanner_init(struct zsv_scanner *scanner, struct zsv_opts *opts)
     scanner->opts_orig = *opts;
     if (!scanner->opts.max_columns)
       scanner->opts.max_columns = 1024;
-    set_callbacks(scanner);
-    if ((scanner->row.allocated = scanner->opts.max_columns) &&
-        (scanner->row.cells = calloc(scanner->row.allocated, sizeof(*scanner->row.cells))))
 #ifdef ZSV_EXTRAS
-      // initialize overwrites
-      if (zsv_init_overwrites(scanner, &scanner->opts.overwrite) == zsv_status_ok)
+    // initialize overwrites before set_callbacks(), which decides whether to apply them
+    if (zsv_init_overwrites(scanner, &scanner->opts.overwrite) != zsv_status_ok)
+      return 1;
 #endif
-        return 0;
+    set_callbacks(scanner);
+    scanner->row.base = scanner->buff.buff;
+    if (!zsv_row_grow(&scanner->row, scanner->opts.max_columns, &scanner->opts.allocator))
+      return 0;
   }
   return 1;
 }
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+/**
+ * Cell overwrites
+ *
+ * All (row, column, value) tuples are loaded once, when the parser is created,
+ * into an array of entries that is then sorted by row and column. Values are
+ * copied into a single arena and referenced by offset. Sources may therefore
+ * list overwrites in any order, and if a cell is listed more than once, the
+ * last value wins
+ *
+ * Rows are parsed in order, so lookups move a cursor forward through the
+ * sorted entries rather than searching, making each lookup O(1) amortized
+ */
+
+#define ZSV_OVERWRITE_INITIAL_ENTRIES 256
+#define ZSV_OVERWRITE_INITIAL_ARENA 4096
+
+static enum zsv_status zsv_overwrite_add(struct zsv_overwrite *o, const struct zsv_allocator *a, size_t row_ix,
+                                         size_t col_ix, const unsigned char *val, size_t len) {
+  if (col_ix > UINT32_MAX || len > UINT32_MAX)
+    return zsv_status_ok; // can never match a parsed cell / too big to keep
+
+  if (o->count == o->capacity) {
+    size_t capacity = o->capacity ? o->capacity * 2 : ZSV_OVERWRITE_INITIAL_ENTRIES;
+    struct zsv_overwrite_entry *entries = zsv_realloc(a, o->entries, capacity * sizeof(*entries));
+    if (!entries)
+      return zsv_status_memory;
+    o->entries = entries;
+    o->capacity = capacity;
+  }
+  if (o->arena_used + len > o->arena_capacity) {
+    size_t capacity = o->arena_capacity ? o->arena_capacity : ZSV_OVERWRITE_INITIAL_ARENA;
+    while (capacity < o->arena_used + len)
+      capacity *= 2;
+    unsigned char *arena = zsv_realloc(a, o->arena, capacity);
+    if (!arena)
+      return zsv_status_memory;
+    o->arena = arena;
+    o->arena_capacity = capacity;
+  }
+
+  struct zsv_overwrite_entry *e = &o->entries[o->count++];
+  e->row_ix = row_ix;
+  e->col_ix = (uint32_t)col_ix;
+  e->len = (uint32_t)len;
+  e->offset = o->arena_used;
+  if (len)
+    memcpy(o->arena + o->arena_used, val, len);
+  o->arena_used += len;
+  return zsv_status_ok;
+}
+
+/**
+ * Order by row and column, then by insertion order, which for entries of the
+ * same cell is also the order of their offsets and lengths in the arena
+ */
+static int zsv_overwrite_entry_cmp(const void *x, const void *y) {
+  const struct zsv_overwrite_entry *a = x, *b = y;
+  if (a->row_ix != b->row_ix)
+    return a->row_ix < b->row_ix ? -1 : 1;
+  if (a->col_ix != b->col_ix)
+    return a->col_ix < b->col_ix ? -1 : 1;
+  if (a->offset != b->offset)
+    return a->offset < b->offset ? -1 : 1;
+  return a->len < b->len ? -1 : a->len > b->len;
+}
+
+/**
+ * Sort entries, then remove duplicates, keeping the last value given for each cell
+ */
+static void zsv_overwrite_index(struct zsv_overwrite *o) {
+  if (o->count > 1) {
+    qsort(o->entries, o->count, sizeof(*o->entries), zsv_overwrite_entry_cmp);
+    size_t n = 0;
+    for (size_t i = 0; i < o->count; i++) {
+      if (n && o->entries[n - 1].row_ix == o->entries[i].row_ix && o->entries[n - 1].col_ix == o->entries[i].col_ix)
+        n--;
+      o->entries[n++] = o->entries[i];
+    }
+    o->count = n;
+  }
+  o->row_ix = SIZE_MAX;
+  o->begin = o->end = o->next = 0;
+}
+
+/**
+ * Parse an unsigned decimal row or column number that spans the entire cell
+ * @return non-zero if the cell is not a valid number
+ */
+static int zsv_overwrite_parse_ix(struct zsv_cell c, size_t *ix) {
+  size_t v = 0;
+  if (!c.len)
+    return 1;
+  for (size_t i = 0; i < c.len; i++) {
+    if (c.str[i] < '0' || c.str[i] > '9' || v > (SIZE_MAX - 9) / 10)
+      return 1;
+    v = v * 10 + (c.str[i] - '0');
+  }
+  *ix = v;
+  return 0;
+}
+
+static enum zsv_status zsv_overwrite_load_csv(struct zsv_overwrite *o, const struct zsv_allocator *a, void *stream) {
+  struct zsv_opts opts = {0};
+  opts.allocator = *a;
+  opts.stream = stream;
+  zsv_parser reader = zsv_new(&opts);
+  if (!reader)
+    return zsv_status_memory;
+
+  enum zsv_status stat = zsv_status_ok;
+  if (zsv_next_row(reader) == zsv_status_row) {
+    struct zsv_cell row = zsv_get_cell_1(reader, 0);
+    struct zsv_cell col = zsv_get_cell_1(reader, 1);
+    struct zsv_cell val = zsv_get_cell_1(reader, 2);
+    if (row.len < 3 || memcmp(row.str, "row", 3) || col.len < 3 || memcmp(col.str, "col", 3) || val.len < 3 ||
+        memcmp(val.str, "val", 3))
+      fprintf(stderr, "Warning! overwrite expects 'row,col,value' header, got '%.*s,%.*s,%.*s'\n", (int)row.len,
+              row.str, (int)col.len, col.str, (int)val.len, val.str);
+
+    size_t skipped = 0;
+    while (stat == zsv_status_ok && zsv_next_row(reader) == zsv_status_row) {
+      size_t row_ix, col_ix;
+      if (zsv_overwrite_parse_ix(zsv_get_cell_1(reader, 0), &row_ix) ||
+          zsv_overwrite_parse_ix(zsv_get_cell_1(reader, 1), &col_ix)) {
+        if (zsv_cell_count(reader) > 1 || zsv_get_cell_1(reader, 0).len)
+          skipped++;
+        continue;
+      }
+      val = zsv_get_cell_1(reader, 2);
+      stat = zsv_overwrite_add(o, a, row_ix, col_ix, val.str, val.len);
+    }
+    if (skipped)
+      fprintf(stderr, "Warning! skipped %zu overwrite(s) with invalid row or column\n", skipped);
+  } else
+    stat = zsv_status_error;
+  zsv_delete(reader);
+  return stat;
+}
+
+static enum zsv_status zsv_overwrite_load_fetch(struct zsv_overwrite *o, const struct zsv_allocator *a,
+                                                struct zsv_opt_overwrite *overwrite_opts) {
+  size_t row_ix, col_ix, len;
+  const unsigned char *val;
+  int rc;
+  enum zsv_status stat = zsv_status_ok;
+  while (stat == zsv_status_ok && (rc = overwrite_opts->fetch(overwrite_opts->ctx, &row_ix, &col_ix, &val, &len)) > 0)
+    stat = zsv_overwrite_add(o, a, row_ix, col_ix, val, len);
+  if (stat == zsv_status_ok && rc < 0)
+    stat = zsv_status_error;
+  return stat;
+}
+
+static enum zsv_status zsv_init_overwrites(zsv_parser parser, struct zsv_opt_overwrite *overwrite_opts) {
+  if (overwrite_opts->type <= zsv_overwrite_type_none)
+    return zsv_status_ok;
+  struct zsv_overwrite *overwrite = &parser->overwrite;
+  const struct zsv_allocator *a = &parser->opts.allocator;
+  enum zsv_status stat;
+  switch (overwrite_opts->type) {
+  case zsv_overwrite_type_csv:
+    stat = zsv_overwrite_load_csv(overwrite, a, overwrite_opts->ctx);
+    break;
+  case zsv_overwrite_type_fetch:
+    if (!overwrite_opts->fetch) {
+      fprintf(stderr, "Overwrite fetch function not specified\n");
+      stat = zsv_status_invalid_option;
+    } else
+      stat = zsv_overwrite_load_fetch(overwrite, a, overwrite_opts);
+    break;
+  default:
+    fprintf(stderr, "Unrecognized overwrite type\n");
+    stat = zsv_status_error;
+  }
+
+  // the source is no longer needed once loaded
+  if (overwrite_opts->ctx && overwrite_opts->close_ctx)
+    overwrite_opts->close_ctx(overwrite_opts->ctx);
+  overwrite_opts->ctx = NULL;
+
+  if (stat == zsv_status_memory)
+    fprintf(stderr, "Out of memory!\n");
+  if (stat == zsv_status_ok) {
+    zsv_overwrite_index(overwrite);
+    overwrite->have = overwrite->count > 0;
+  }
+  return stat;
+}
+
+static void zsv_overwrite_delete(struct zsv_overwrite *overwrite, const struct zsv_allocator *a) {
+  zsv_free(a, overwrite->entries);
+  zsv_free(a, overwrite->arena);
+  memset(overwrite, 0, sizeof(*overwrite));
+}
+
+/**
+ * Position the row cursor at the entries for the given row
+ */
+static void zsv_overwrite_seek_row(struct zsv_overwrite *o, size_t row_ix) {
+  size_t i;
+  if (o->row_ix == SIZE_MAX || row_ix > o->row_ix)
+    i = o->row_ix == SIZE_MAX ? 0 : o->end;
+  else
+    i = 0; // moved backwards
+  if (i < o->count && o->entries[i].row_ix < row_ix) {
+    // skipped past one or more rows that have overwrites: binary search for the first entry >= row_ix
+    size_t hi = o->count;
+    while (i < hi) {
+      size_t mid = i + (hi - i) / 2;
+      if (o->entries[mid].row_ix < row_ix)
+        i = mid + 1;
+      else
+        hi = mid;
+    }
+  }
+  o->row_ix = row_ix;
+  o->begin = o->next = o->end = i;
+  while (o->end < o->count && o->entries[o->end].row_ix == row_ix)
+    o->end++;
+}
+
+static const struct zsv_overwrite_entry *zsv_overwrite_find(struct zsv_overwrite *o, size_t row_ix, size_t col_ix) {
+  if (row_ix != o->row_ix)
+    zsv_overwrite_seek_row(o, row_ix);
+  size_t j = o->next;
+  if (j > o->begin && o->entries[j - 1].col_ix >= col_ix)
+    j = o->begin; // columns requested out of order
+  while (j < o->end && o->entries[j].col_ix < col_ix)
+    j++;
+  o->next = j;
+  return j < o->end && o->entries[j].col_ix == col_ix ? &o->entries[j] : NULL;
+}
+
+static struct zsv_cell zsv_get_cell_with_overwrite(zsv_parser parser, size_t col_ix) {
+  if (VERY_LIKELY(col_ix < parser->row.used)) {
+    struct zsv_overwrite *overwrite = &parser->overwrite;
+    const struct zsv_overwrite_entry *e = zsv_overwrite_find(overwrite, parser->data_row_count, col_ix);
+    if (!e) {
+      if (overwrite->begin == overwrite->count)
+        parser->get_cell = zsv_get_cell_1; // no overwrites remain for this or any later row
+      return zsv_row_get_cell(&parser->row, col_ix);
+    }
+    struct zsv_cell c = {0, 0, 0, 0};
+    if ((c.len = e->len))
+      c.str = overwrite->arena + e->offset;
+    c.quoted = 1; // value was not scanned, so the caller must check if it needs quoting
+    c.overwritten = 1;
+    return c;
+  }
+  struct zsv_cell c = {0, 0, 0, 0};
+  return c;
+}
@@ -139,6 +139,10 @@ static enum zsv_status ZSV_SCAN_DELIM(struct zsv_scanner *scanner, unsigned char
         cell_dl(scanner, buff + scanner->cell_start, i - scanner->cell_start);
         scanner->cell_start = i + 1;
         c = 0;
+        if (UNLIKELY(scanner->column_mask.used != NULL) && scanner->row.used >= scanner->column_mask.count) {
+          i = zsv_skip_unused_cells(scanner, buff, i, bytes_read, &v.nl, &v.cr, &v.qt, quote);
+          mask = 0;
+        }
         continue; // this char is not part of the cell content
       } else
         // we are inside an open quote, which is needed to escape this char
@@ -7,7 +7,10 @@ static inline char row_fx(struct zsv_scanner *scanner, unsigned char *buff, size
     unsigned char *s = buff + cell_start;
     if (UNLIKELY(scanner->opts.cell_handler != NULL))
       scanner->opts.cell_handler(scanner->opts.ctx, s, cell_length);
-    struct zsv_cell c = {s, cell_length, 1, 0};
+    if (VERY_UNLIKELY(scanner->row.used == scanner->row.allocated) &&
+        zsv_row_grow(&scanner->row, scanner->opts.max_columns, &scanner->opts.allocator))
+      break;
+    struct zsv_row_cell c = {(uint32_t)(s - scanner->row.base), (uint32_t)cell_length, 1};
     scanner->row.cells[scanner->row.used++] = c;
 
     cell_start = cell_end;
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2021 Liquidaty and the zsv/lib contributors
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+/**
+ * Transcoding of UTF-16 and Latin-1 / Windows-1252 input to UTF-8
+ *
+ * When active, the transcoder sits between the caller's read function and the
+ * scanner buffer: raw input is read into the transcoder's own buffer and UTF-8
+ * is written into the scanner buffer, so everything downstream (BOM handling,
+ * any scan filter, and the delimiter scan) only ever sees UTF-8. Runs of ASCII
+ * are detected and converted a vector at a time
+ */
+
+#ifndef ZSV_TRANSCODE_BUFFSIZE
+#define ZSV_TRANSCODE_BUFFSIZE (64 * 1024)
+#endif
+
+struct zsv_transcode {
+  enum zsv_encoding encoding;
+  zsv_generic_read read; // caller's read function
+  void *in;              // caller's stream
+  unsigned char *raw;
+  size_t raw_pos;
+  size_t raw_used;
+  unsigned char pending[4]; // encoded output that did not fit into the prior read
+  unsigned char pending_len;
+  unsigned char eof : 1;
+  unsigned char _ : 7;
+};
+
+// Windows-1252 code points for bytes 0x80 - 0x9F. Undefined bytes map to the same code point as in Latin-1
+static const uint16_t zsv_cp1252_80_9f[32] = {
+  0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160,
+  0x2039, 0x0152, 0x008D, 0x017D, 0x008F, 0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+  0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178};
+
+#define ZSV_REPLACEMENT_CODEPOINT 0xFFFD
+
+__attribute__((always_inline)) static inline size_t zsv_utf8_encode(uint32_t cp, unsigned char *out) {
+  if (cp < 0x80) {
+    out[0] = cp;
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = 0xC0 | (cp >> 6);
+    out[1] = 0x80 | (cp & 0x3F);
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = 0xE0 | (cp >> 12);
+    out[1] = 0x80 | ((cp >> 6) & 0x3F);
+    out[2] = 0x80 | (cp & 0x3F);
+    return 3;
+  }
+  out[0] = 0xF0 | (cp >> 18);
+  out[1] = 0x80 | ((cp >> 12) & 0x3F);
+  out[2] = 0x80 | ((cp >> 6) & 0x3F);
+  out[3] = 0x80 | (cp & 0x3F);
+  return 4;
+}
+
+/**
+ * Write the UTF-8 encoding of a code point to out. If it does not entirely fit,
+ * save the remainder for the next read
+ * Returns the number of bytes written to out
+ */
+__attribute__((always_inline)) static inline size_t zsv_transcode_put(struct zsv_transcode *t, uint32_t cp,
+                                                                      unsigned char *out, size_t out_len) {
+  unsigned char tmp[4];
+  size_t len = zsv_utf8_encode(cp, tmp);
+  if (VERY_LIKELY(len <= out_len)) {
+    memcpy(out, tmp, len);
+    return len;
+  }
+  memcpy(out, tmp, out_len);
+  t->pending_len = len - out_len;
+  memcpy(t->pending, tmp + out_len, t->pending_len);
+  return out_len;
+}
+
+static size_t zsv_transcode_latin1(struct zsv_transcode *t, unsigned char *out, size_t out_len) {
+  const unsigned char *p = t->raw + t->raw_pos;
+  const unsigned char *end = t->raw + t->raw_used;
+  size_t o = 0;
+  while (p < end && o < out_len) {
+    // fast path: copy whole vectors of ASCII
+    while (end - p >= (ptrdiff_t)sizeof(zsv_uc_vector) && out_len - o >= sizeof(zsv_uc_vector)) {
+      zsv_uc_vector v;
+      memcpy(&v, p, sizeof(v));
+      zsv_uc_vector high_bits = v & 0x80;
+      if (movemask_pseudo(high_bits))
+        break;
+      memcpy(out + o, p, sizeof(v));
+      p += sizeof(v);
+      o += sizeof(v);
+    }
+
+    // slow path: up to one vector's worth of input
+    const unsigned char *chunk_end = end - p > (ptrdiff_t)sizeof(zsv_uc_vector) ? p + sizeof(zsv_uc_vector) : end;
+    for (; p < chunk_end && o < out_len; p++) {
+      if (*p < 0x80)
+        out[o++] = *p;
+      else
+        o += zsv_transcode_put(t, *p < 0xA0 ? zsv_cp1252_80_9f[*p - 0x80] : *p, out + o, out_len - o);
+    }
+  }
+  t->raw_pos = p - t->raw;
+  return o;
+}
+
+static size_t zsv_transcode_utf16(struct zsv_transcode *t, unsigned char *out, size_t out_len) {
+  const unsigned char *p = t->raw + t->raw_pos;
+  const unsigned char *end = t->raw + t->raw_used;
+  const int big_endian = t->encoding == zsv_encoding_utf16be;
+  const int lo = big_endian; // position of the low byte in each 2-byte unit
+  // in a vector of ASCII-only units, every high byte is zero
+  const zsv_mask_t hi_lanes = big_endian ? (zsv_mask_t)0x5555555555555555ULL : (zsv_mask_t)0xAAAAAAAAAAAAAAAAULL;
+  size_t o = 0;
+  char need_more = 0;
+
+  while (end - p >= 2 && o < out_len && !need_more) {
+    // fast path: narrow whole vectors of ASCII
+    while (end - p >= (ptrdiff_t)sizeof(zsv_uc_vector) && out_len - o >= sizeof(zsv_uc_vector) / 2) {
+      zsv_uc_vector v;
+      memcpy(&v, p, sizeof(v));
+      zsv_uc_vector high_bits = v & 0x80;
+      zsv_uc_vector nonzero = v != 0;
+      if (movemask_pseudo(high_bits) || (movemask_pseudo(nonzero) & hi_lanes))
+        break;
+      for (size_t i = 0; i < sizeof(v) / 2; i++)
+        out[o + i] = p[i * 2 + lo];
+      p += sizeof(v);
+      o += sizeof(v) / 2;
+    }
+
+    // slow path: up to one vector's worth of input
+    const unsigned char *chunk_end = end - p > (ptrdiff_t)sizeof(zsv_uc_vector) ? p + sizeof(zsv_uc_vector) : end;
+    while (chunk_end - p >= 2 && o < out_len) {
+      uint32_t cp = big_endian ? (p[0] << 8) | p[1] : p[0] | (p[1] << 8);
+      size_t unit_bytes = 2;
+      if (UNLIKELY(cp >= 0xD800 && cp < 0xE000)) {
+        if (cp >= 0xDC00) // unpaired low surrogate
+          cp = ZSV_REPLACEMENT_CODEPOINT;
+        else if (end - p < 4) {
+          if (!t->eof) { // wait for the rest of the surrogate pair
+            need_more = 1;
+            break;
+          }
+          cp = ZSV_REPLACEMENT_CODEPOINT;
+        } else {
+          uint32_t cp2 = big_endian ? (p[2] << 8) | p[3] : p[2] | (p[3] << 8);
+          if (cp2 >= 0xDC00 && cp2 < 0xE000) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (cp2 - 0xDC00);
+            unit_bytes = 4;
+          } else // unpaired high surrogate
+            cp = ZSV_REPLACEMENT_CODEPOINT;
+        }
+      }
+      p += unit_bytes;
+      if (LIKELY(cp < 0x80))
+        out[o++] = cp;
+      else
+        o += zsv_transcode_put(t, cp, out + o, out_len - o);
+    }
+    if (chunk_end == end && end - p < 2)
+      break;
+  }
+
+  if (end - p == 1 && t->eof && o < out_len) { // dangling odd byte at the end of the input
+    p++;
+    o += zsv_transcode_put(t, ZSV_REPLACEMENT_CODEPOINT, out + o, out_len - o);
+  }
+  t->raw_pos = p - t->raw;
+  return o;
+}
+
+static void zsv_transcode_fill(struct zsv_transcode *t) {
+  size_t remaining = t->raw_used - t->raw_pos;
+  if (remaining && t->raw_pos)
+    memmove(t->raw, t->raw + t->raw_pos, remaining);
+  t->raw_pos = 0;
+  t->raw_used = remaining;
+  size_t bytes_read = t->read(t->raw + t->raw_used, 1, ZSV_TRANSCODE_BUFFSIZE - t->raw_used, t->in);
+  if (!bytes_read)
+    t->eof = 1;
+  t->raw_used += bytes_read;
+}
+
+/**
+ * Read function that is swapped in for the caller's read function when
+ * transcoding. Returns 0 only when the underlying input is exhausted
+ */
+static size_t zsv_transcode_read(void *restrict buff, size_t n, size_t size, void *restrict ctx) {
+  struct zsv_transcode *t = ctx;
+  unsigned char *out = buff;
+  size_t out_len = n * size;
+  size_t used = 0;
+
+  if (t->pending_len) {
+    used = t->pending_len < out_len ? t->pending_len : out_len;
+    memcpy(out, t->pending, used);
+    t->pending_len -= used;
+    memmove(t->pending, t->pending + used, t->pending_len);
+  }
+
+  while (used < out_len && !t->pending_len) {
+    if (t->raw_used - t->raw_pos < 4 && !t->eof)
+      zsv_transcode_fill(t);
+    if (t->raw_pos == t->raw_used)
+      break;
+    size_t before = used;
+    if (t->encoding == zsv_encoding_latin1)
+      used += zsv_transcode_latin1(t, out + used, out_len - used);
+    else
+      used += zsv_transcode_utf16(t, out + used, out_len - used);
+    if (used == before && (t->eof || t->raw_used - t->raw_pos >= 4))
+      break; // no progress possible
+  }
+  return used;
+}
+
+static void zsv_transcode_delete(struct zsv_transcode *t, const struct zsv_allocator *a) {
+  if (t) {
+    zsv_free(a, t->raw);
+    zsv_free(a, t);
+  }
+}
+
+/**
+ * Start transcoding the scanner's input from the given encoding
+ * Any bytes already read from the input can be passed in `initial` so that
+ * they are transcoded ahead of the remaining input
+ */
+static enum zsv_status zsv_transcode_start(struct zsv_scanner *scanner, enum zsv_encoding encoding,
+                                           const unsigned char *initial, size_t initial_len) {
+  const struct zsv_allocator *a = &scanner->opts.allocator;
+  struct zsv_transcode *t = zsv_calloc(a, 1, sizeof(*t));
+  if (!t || !(t->raw = zsv_alloc(a, ZSV_TRANSCODE_BUFFSIZE))) {
+    zsv_free(a, t);
+    return zsv_status_memory;
+  }
+  t->encoding = encoding;
+  t->read = scanner->read;
+  t->in = scanner->in;
+  if (initial_len) {
+    memcpy(t->raw, initial, initial_len);
+    t->raw_used = initial_len;
+  }
+  scanner->transcode = t;
+  scanner->read = zsv_transcode_read;
+  scanner->in = t;
+  return zsv_status_ok;
+}
+
+/**
+ * Check for a UTF-16 BOM. Returns the corresponding encoding, or zsv_encoding_auto if none
+ */
+static enum zsv_encoding zsv_utf16_bom_encoding(const unsigned char *s, size_t len) {
+  if (len >= 2) {
+    if (s[0] == 0xFF && s[1] == 0xFE)
+      return zsv_encoding_utf16le;
+    if (s[0] == 0xFE && s[1] == 0xFF)
+      return zsv_encoding_utf16be;
+  }
+  return zsv_encoding_auto;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2021 Tai Chi Minh Ralph Eastwood (self), Matt Wong (Guarnerix Inc dba Liquidaty)
+ * All rights reserved
+ *
+ * This file is part of zsv/lib, distributed under the license defined at
+ * https://opensource.org/licenses/MIT
+ */
+
+/**
+ * Byte vectors for SIMD scanning, shared by the parser and the app utilities
+ *
+ * zsv_uc_vector is a GCC vector of VECTOR_BYTES unsigned chars, so that e.g.
+ * `v == c` compares each byte. movemask_pseudo() converts a compare result to
+ * a zsv_mask_t with one bit per byte, using AVX-512, AVX2, SSE2, NEON or wasm
+ * where available and otherwise a portable loop
+ */
+
+#ifndef ZSV_VECTOR_H
+#define ZSV_VECTOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if !defined(__AVX2__) // -mavx2 compiler flag not present
+#define ZSV_NO_AVX
+#define zsv_mask_t uint16_t
+#define VECTOR_BYTES 16
+#define NEXT_BIT __builtin_ffs
+#if defined(__AVX__)
+#include <emmintrin.h>
+#define zsv_mask_t uint16_t
+#define VECTOR_BYTES 16
+#define NEXT_BIT __builtin_ffs
+#define movemask_pseudo(x) _mm_movemask_epi8((__m128i)(x))
+#endif
+#elif defined(HAVE_AVX512)
+#ifndef __AVX512BW__
+#error AVX512 requested, but __AVX512BW__ macro not defined
+#else
+#include <immintrin.h>
+#define VECTOR_BYTES 64
+#define zsv_mask_t uint64_t
+#define movemask_pseudo(x) _mm512_movepi8_mask((__m512i)(x))
+#define NEXT_BIT __builtin_ffsl
+#endif
+#elif defined(__AVX2__) // have avx2, not avx512
+#include <immintrin.h>
+#define VECTOR_BYTES 32
+#define zsv_mask_t uint32_t
+#define movemask_pseudo(x) _mm256_movemask_epi8((__m256i)(x))
+#define NEXT_BIT __builtin_ffs
+#else
+#define ZSV_NO_AVX
+#define zsv_mask_t uint16_t
+#define VECTOR_BYTES 16
+#define NEXT_BIT __builtin_ffs
+#endif
+
+typedef unsigned char zsv_uc_vector __attribute__((vector_size(VECTOR_BYTES)));
+typedef signed char zsv_sc_vector __attribute__((vector_size(VECTOR_BYTES))); // for signed compares
+
+#ifndef movemask_pseudo
+/*
+  provide our own pseudo-movemask, which sets the 1 bit for each corresponding
+  non-zero value in the vector (as opposed to real movemask which sets the bit
+  only for each corresponding non-zero highest-bit value in the vector)
+*/
+
+#if defined(__EMSCRIPTEN__) && defined(__SSE2__)
+#include <wasm_simd128.h>
+#define movemask_pseudo(x) wasm_i8x16_bitmask(x)
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+static inline zsv_mask_t movemask_pseudo(zsv_uc_vector v) {
+  // see https://stackoverflow.com/questions/11870910/
+  static const uint8_t __attribute__((aligned(16)))
+  _powers[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t mm_powers = vld1q_u8(_powers);
+
+  // compute the mask from the input
+  uint64x2_t imask = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vandq_u8(v, mm_powers))));
+
+  // Get the resulting bytes
+  uint16_t mask;
+  vst1q_lane_u8((uint8_t *)&mask + 0, (uint8x16_t)imask, 0);
+  vst1q_lane_u8((uint8_t *)&mask + 1, (uint8x16_t)imask, 8);
+  return mask;
+}
+
+#elif defined(__SSE2__)
+
+typedef char zsv_c_vector __attribute__((vector_size(VECTOR_BYTES)));
+#define movemask_pseudo(x) __builtin_ia32_pmovmskb128((zsv_c_vector)(x))
+
+#else
+
+// slow path
+#if defined(__EMSCRIPTEN__)
+#warning                                                                                                               \
+  "Compiling with emscripten, without using SIMD. To use SIMD, compile with -msse2 -msimd128 -experimental-wasm-simd and -I/path/to/emsdk/upstream/lib/clang/16.0.0/include"
+#endif
+
+static inline zsv_mask_t movemask_pseudo(zsv_uc_vector v) {
+  zsv_mask_t mask = 0, tmp = 1;
+  for (size_t i = 0; i < sizeof(zsv_uc_vector); i++) {
+    mask |= (v[i] ? tmp : 0);
+    tmp <<= 1;
+  }
+
+  return mask;
+}
+
+#endif // __EMSCRIPTEN__
+#endif // ndef movemask_pseudo
+
+#endif // ZSV_VECTOR_H
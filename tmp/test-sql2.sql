@@ -0,0 +1 @@
+select [Loan Number] from data
@@ -0,0 +1 @@
+1318918 /root/repo/tmp/.zsv/data/test-sql8.csv/sql.db